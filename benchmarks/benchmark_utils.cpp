@@ -0,0 +1,113 @@
+#include "benchmark_utils.h"
+#include <ctime>
+#include <limits>
+
+/***************************************************************
+ * Microbenchmark harness
+ **************************************************************/
+
+BenchmarkRunner::BenchmarkRunner(const double mtime, const int reps) :
+	min_time(mtime), repetitions(reps)
+{
+	if (min_time <= 0.0 || repetitions < 1) {
+		throw std::invalid_argument("Benchmarks need positive time and number of repetitions");
+	}
+}
+
+// Calibrate, then repeat
+void BenchmarkRunner::run(const std::string& name, const std::map<std::string, double>& parameters,
+							const double items, const std::function<void(long long)>& kernel)
+{
+	if (!is_selected(name)) {
+		return;
+	}
+	// Grow until a run is long enough to time, then scale to min_time
+	long long n = 1;
+	double elapsed = time_kernel(kernel, n);
+	while (elapsed < min_time/10.0 && n < (1LL << 40)) {
+		n *= (elapsed > 0.0) ? std::min(100LL, std::max(2LL,
+					static_cast<long long>(min_time/10.0/elapsed))) : 100LL;
+		elapsed = time_kernel(kernel, n);
+	}
+	n = std::max(1LL, static_cast<long long>(n*min_time/std::max(elapsed, 1e-9)));
+
+	BenchmarkResult result;
+	result.name = name;
+	result.parameters = parameters;
+	result.iterations = n;
+	result.repetitions = repetitions;
+	result.items = items;
+	result.min_ns = std::numeric_limits<double>::max();
+	for (int ir = 0; ir < repetitions; ++ir) {
+		const double ns = 1e9*time_kernel(kernel, n)/static_cast<double>(n);
+		result.mean_ns += ns/repetitions;
+		result.min_ns = std::min(result.min_ns, ns);
+	}
+	results.push_back(result);
+}
+
+double BenchmarkRunner::time_kernel(const std::function<void(long long)>& kernel, const long long n)
+{
+	const auto start = std::chrono::steady_clock::now();
+	kernel(n);
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+// One line per benchmark
+void BenchmarkRunner::print_results(std::ostream& where) const
+{
+	const std::ios_base::fmtflags flags = where.flags();
+	const std::streamsize precision = where.precision();
+	where << std::left << std::setw(80) << "benchmark" << std::right << std::setw(14) << "iterations"
+		  << std::setw(14) << "mean [ns]" << std::setw(14) << "min [ns]"
+		  << std::setw(14) << "ns/item" << std::endl;
+	where << std::fixed << std::setprecision(1);
+	for (const auto& result : results) {
+		std::string label = result.name;
+		for (const auto& param : result.parameters) {
+			std::ostringstream value;
+			value << param.second;
+			label += "/" + param.first + ":" + value.str();
+		}
+		where << std::left << std::setw(80) << label << std::right << std::setw(14) << result.iterations
+			  << std::setw(14) << result.mean_ns << std::setw(14) << result.min_ns
+			  << std::setw(14) << result.mean_ns/result.items << std::endl;
+	}
+	where.flags(flags);
+	where.precision(precision);
+}
+
+// Settings of the run and all results
+void BenchmarkRunner::write_json(const std::string& fname, const std::string& build_flags) const
+{
+	std::ofstream out(fname);
+	if (!out.is_open()) {
+		std::cerr << "Error opening file " << fname << std::endl;
+		throw std::runtime_error("Cannot open benchmark output file");
+	}
+	char date[32] = {0};
+	const std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	out << std::setprecision(10);
+	out << "{\n\"context\": {\"date\": \"" << date << "\", \"compiler\": \"" << __VERSION__
+		<< "\", \"flags\": \"" << build_flags << "\", \"min_time\": " << min_time
+		<< ", \"repetitions\": " << repetitions << "},\n\"benchmarks\": [";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const BenchmarkResult& result = results.at(i);
+		out << (i == 0 ? "\n" : ",\n") << "{\"name\": \"" << result.name << "\", \"parameters\": {";
+		bool first = true;
+		for (const auto& param : result.parameters) {
+			out << (first ? "" : ", ") << "\"" << param.first << "\": " << param.second;
+			first = false;
+		}
+		out << "}, \"iterations\": " << result.iterations << ", \"repetitions\": " << result.repetitions
+			<< ", \"mean_ns\": " << result.mean_ns << ", \"min_ns\": " << result.min_ns
+			<< ", \"items\": " << result.items << ", \"ns_per_item\": " << result.mean_ns/result.items << "}";
+	}
+	out << "\n]\n}\n";
+	if (!out.good()) {
+		throw std::runtime_error("Error writing to " + fname);
+	}
+}
@@ -0,0 +1,94 @@
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include "../include/common.h"
+
+/***************************************************************
+ * Microbenchmark harness
+ *
+ * Each benchmark is a function that runs the measured kernel
+ * a given number of times. The number of iterations is
+ * increased until a run takes at least the minimum time,
+ * then the benchmark is repeated and the mean and fastest
+ * time per iteration are reported. Results can be printed
+ * and saved as JSON to compare between versions
+ * (compare_benchmarks.py).
+ **************************************************************/
+
+/// Result of one benchmark
+struct BenchmarkResult {
+	std::string name = {};
+	/// Name and value of each parameter, e.g. place size
+	std::map<std::string, double> parameters = {};
+	/// Iterations per repetition
+	long long iterations = 0;
+	int repetitions = 0;
+	/// Time per iteration in ns, mean and minimum over repetitions
+	double mean_ns = 0.0;
+	double min_ns = 0.0;
+	/// Number of processed items (agents, places, draws) in one iteration
+	double items = 1.0;
+};
+
+class BenchmarkRunner {
+public:
+
+	/**
+	 * \brief Runner with measurement settings
+	 * \details Throws std::invalid_argument for non-positive values
+	 * @param min_time - minimum time of one repetition in seconds
+	 * @param repetitions - number of measured repetitions
+	 */
+	BenchmarkRunner(const double min_time = 0.2, const int repetitions = 5);
+
+	/// Run only benchmarks with names that contain filter
+	void set_filter(const std::string& flt) { filter = flt; }
+
+	/// True if a benchmark with this name passes the filter
+	bool is_selected(const std::string& name) const
+		{ return name.find(filter) != std::string::npos; }
+
+	/**
+	 * \brief Measure a kernel
+	 * @param name - name of the benchmark
+	 * @param parameters - name and value of each parameter
+	 * @param items - items processed in one iteration, time per
+	 *		item is time per iteration divided by this
+	 * @param kernel - runs the measured code as many times as requested
+	 */
+	void run(const std::string& name, const std::map<std::string, double>& parameters,
+				const double items, const std::function<void(long long)>& kernel);
+
+	/// Results in the order of running
+	const std::vector<BenchmarkResult>& get_results() const { return results; }
+
+	/// Table of the results
+	void print_results(std::ostream& where) const;
+
+	/**
+	 * \brief Save the results and the build settings as JSON
+	 * \details Throws std::runtime_error if the file cannot be opened
+	 */
+	void write_json(const std::string& fname, const std::string& build_flags = "") const;
+
+private:
+	double min_time = 0.2;
+	int repetitions = 5;
+	std::string filter = {};
+	std::vector<BenchmarkResult> results = {};
+
+	// Seconds taken by n iterations
+	static double time_kernel(const std::function<void(long long)>& kernel, const long long n);
+};
+
+/// Keep a value the compiler would otherwise remove as unused
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif
@@ -0,0 +1,64 @@
+import json, sys
+
+py_path = '../scripts/'
+sys.path.insert(0, py_path)
+
+import utils as ut
+from colors import *
+
+#
+# Compare two sets of benchmark results
+#
+
+# Usage: python3 compare_benchmarks.py old.json new.json [threshold]
+# Threshold is the relative slowdown reported as a regression,
+# default 0.1 (10%); exits with 1 if there are regressions
+
+def load_results(fname):
+	''' Mean time per iteration of each benchmark and its parameters '''
+	with open(fname, 'r') as fin:
+		data = json.load(fin)
+	results = {}
+	for bench in data['benchmarks']:
+		params = '/'.join([key + ':' + str(bench['parameters'][key]) for key in sorted(bench['parameters'])])
+		results[(bench['name'], params)] = bench['mean_ns']
+	return data['context'], results
+
+if len(sys.argv) < 3:
+	print('Usage: python3 compare_benchmarks.py old.json new.json [threshold]')
+	sys.exit(2)
+
+threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 0.1
+old_context, old_results = load_results(sys.argv[1])
+new_context, new_results = load_results(sys.argv[2])
+
+if old_context['flags'] != new_context['flags']:
+	ut.msg('Different build flags: ' + old_context['flags'] + ' vs. ' + new_context['flags'], CYAN)
+
+n_regressions = 0
+def label(key):
+	''' Name and parameters of a benchmark '''
+	return key[0] + ('/' + key[1] if key[1] else '')
+
+for key in sorted(new_results):
+	if key not in old_results:
+		ut.msg('  ' + label(key) + ': new', CYAN)
+		continue
+	ratio = new_results[key]/old_results[key] if old_results[key] > 0 else 1.0
+	text = '  {0}: {1:.1f} -> {2:.1f} ns ({3:+.1f}%)'.format(label(key), old_results[key], 
+					new_results[key], 100.0*(ratio - 1.0))
+	if ratio > 1.0 + threshold:
+		ut.msg(text, MAGENTA)
+		n_regressions += 1
+	elif ratio < 1.0 - threshold:
+		ut.msg(text, GREEN)
+	else:
+		print(text)
+
+for key in sorted(old_results):
+	if key not in new_results:
+		ut.msg('  ' + label(key) + ': missing', CYAN)
+
+if n_regressions > 0:
+	ut.msg(str(n_regressions) + ' benchmarks slower by more than ' + str(100*threshold) + '%', MAGENTA)
+	sys.exit(1)
@@ -0,0 +1,81 @@
+import subprocess
+
+#
+# Input 
+#
+
+# Path to the main directory
+path = '../src/'
+# Compiler options - benchmarks are measured optimized
+cx = 'g++'
+std = '-std=c++11'
+opt = '-O3'
+# Background thread of the output recorder
+threads = '-pthread'
+# Saved with the results
+flags = ' '.join([cx, std, opt])
+src_files = path + 'abm.cpp' 
+src_files += ' ' + path + 'data_management_interface.cpp'
+src_files += ' ' + path + 'agent.cpp' 
+src_files += ' ' + path + 'infection.cpp'
+src_files += ' ' + path + 'mobility.cpp'
+src_files += ' ' + path + 'town.cpp'
+src_files += ' ' + path + 'step_stats.cpp'
+src_files += ' ' + path + 'event_timeline.cpp'
+src_files += ' ' + path + 'distributed/household_partition.cpp'
+src_files += ' ' + path + 'testing.cpp'
+src_files += ' ' + path + 'vaccinations.cpp'
+src_files += ' ' + path + 'contact_tracing.cpp'
+src_files += ' ' + path + 'contributions.cpp'
+src_files += ' ' + path + 'transitions/transitions.cpp'
+src_files += ' ' + path + 'transitions/regular_transitions.cpp'
+src_files += ' ' + path + 'transitions/hsp_employee_transitions.cpp'
+src_files += ' ' + path + 'transitions/hsp_patient_transitions.cpp'
+src_files += ' ' + path + 'transitions/flu_transitions.cpp'
+src_files += ' ' + path + 'states_manager/states_manager.cpp'
+src_files += ' ' + path + 'states_manager/regular_states_manager.cpp'
+src_files += ' ' + path + 'states_manager/hsp_employee_states_manager.cpp'
+src_files += ' ' + path + 'flu.cpp'
+src_files += ' ' + path + 'utils.cpp'
+src_files += ' ' + path + 'three_part_function.cpp'
+src_files += ' ' + path + 'four_part_function.cpp'
+src_files += ' ' + path + 'places/place.cpp'
+src_files += ' ' + path + 'places/household.cpp'
+src_files += ' ' + path + 'places/workplace.cpp'
+src_files += ' ' + path + 'places/school.cpp'
+src_files += ' ' + path + 'places/hospital.cpp'
+src_files += ' ' + path + 'places/retirement_home.cpp'
+src_files += ' ' + path + 'places/transit.cpp'
+src_files += ' ' + path + 'places/leisure.cpp'
+src_files += ' ' + path + 'io_operations/FileHandler.cpp'
+src_files += ' ' + path + 'io_operations/load_parameters.cpp'
+src_files += ' ' + path + 'io_operations/mapped_reader.cpp'
+src_files += ' ' + path + 'io_operations/town_image.cpp'
+src_files += ' ' + path + 'io_operations/recorder.cpp'
+src_files += ' ' + path + 'io_operations/tracer.cpp'
+src_files += ' ' + path + 'ensemble.cpp'
+src_files += ' ' + path + 'parameter_sweep.cpp'
+# Harness
+bench_files = 'benchmark_utils.cpp'
+
+#
+# Benchmarks
+#
+
+# Kernels of the agent and place loops
+# Name of the executable
+exe_name = 'kernels_benchmark'
+# Files needed only for this build
+spec_files = 'kernels_benchmark.cpp '
+compile_com = ' '.join([cx, std, opt, threads, '-DBENCHMARK_FLAGS=\'"' + flags + '"\'',
+						'-o', exe_name, spec_files, bench_files, src_files])
+subprocess.call([compile_com], shell=True)
+
+# Whole simulation steps on towns of growing size,
+# distributed when started with mpirun
+# Name of the executable
+exe_name = 'scaling_benchmark'
+# Files needed only for this build
+spec_files = 'scaling_benchmark.cpp ' + path + 'distributed/mpi_communicator.cpp'
+compile_com = ' '.join(['mpicxx', std, opt, threads, '-DABM_MPI', '-o', exe_name, spec_files, src_files])
+subprocess.call([compile_com], shell=True)
@@ -0,0 +1,368 @@
+#include "benchmark_utils.h"
+#include "../include/abm.h"
+
+/***************************************************************
+ * Microbenchmarks of the kernels called for agents and
+ * places at every step
+ *
+ * Usage: ./kernels_benchmark [output JSON] [name filter]
+ *
+ * Kernels that need a town use the test population of
+ * tests/abm, created by its create_test_population.py
+ **************************************************************/
+
+#ifndef BENCHMARK_FLAGS
+#define BENCHMARK_FLAGS "unknown"
+#endif
+
+/// Model of the test town, set up when first needed
+class TestTown {
+public:
+	ABM& get();
+private:
+	std::unique_ptr<ABM> abm = nullptr;
+};
+
+// Benchmarks without a town
+void rng_benchmarks(BenchmarkRunner&);
+void add_lambdas_benchmarks(BenchmarkRunner&);
+void remove_agent_benchmarks(BenchmarkRunner&);
+void flu_benchmarks(BenchmarkRunner&);
+
+// Benchmarks with the test town
+void exposed_contributions_benchmarks(BenchmarkRunner&, TestTown&);
+void susceptible_lambda_benchmarks(BenchmarkRunner&, TestTown&);
+void leisure_location_benchmarks(BenchmarkRunner&, TestTown&);
+void isolate_school_benchmarks(BenchmarkRunner&, TestTown&);
+void filter_general_benchmarks(BenchmarkRunner&, TestTown&);
+
+int main(int argc, char** argv)
+{
+	const std::string fout = (argc > 1) ? argv[1] : "benchmark_results.json";
+	BenchmarkRunner runner;
+	if (argc > 2) {
+		runner.set_filter(argv[2]);
+	}
+
+	rng_benchmarks(runner);
+	add_lambdas_benchmarks(runner);
+	remove_agent_benchmarks(runner);
+	flu_benchmarks(runner);
+
+	TestTown town;
+	exposed_contributions_benchmarks(runner, town);
+	susceptible_lambda_benchmarks(runner, town);
+	leisure_location_benchmarks(runner, town);
+	isolate_school_benchmarks(runner, town);
+	filter_general_benchmarks(runner, town);
+
+	runner.print_results(std::cout);
+	runner.write_json(fout, BENCHMARK_FLAGS);
+}
+
+/// Distributions and sampling of the RNG class
+void rng_benchmarks(BenchmarkRunner& runner)
+{
+	RNG rng(2022);
+	runner.run("RNG::get_random", {}, 1, [&rng](long long n){
+		double sum = 0.0;
+		for (long long i = 0; i < n; ++i) {
+			sum += rng.get_random(0.0, 1.0);
+		}
+		do_not_optimize(sum);
+	});
+	runner.run("RNG::get_random_int", {}, 1, [&rng](long long n){
+		int sum = 0;
+		for (long long i = 0; i < n; ++i) {
+			sum += rng.get_random_int(0, 100);
+		}
+		do_not_optimize(sum);
+	});
+	runner.run("RNG::get_random_gamma", {}, 1, [&rng](long long n){
+		double sum = 0.0;
+		for (long long i = 0; i < n; ++i) {
+			sum += rng.get_random_gamma(2.0, 1.5);
+		}
+		do_not_optimize(sum);
+	});
+	runner.run("RNG::get_random_lognormal", {}, 1, [&rng](long long n){
+		double sum = 0.0;
+		for (long long i = 0; i < n; ++i) {
+			sum += rng.get_random_lognormal(1.0, 0.5);
+		}
+		do_not_optimize(sum);
+	});
+	runner.run("RNG::get_random_weibull", {}, 1, [&rng](long long n){
+		double sum = 0.0;
+		for (long long i = 0; i < n; ++i) {
+			sum += rng.get_random_weibull(2.0, 3.0);
+		}
+		do_not_optimize(sum);
+	});
+
+	// Sampling k out of n
+	const int n_pool = 100000;
+	std::vector<int> pool(n_pool, 0);
+	std::iota(pool.begin(), pool.end(), 1);
+	for (const int k : {10, 100, 1000}) {
+		runner.run("RNG::partial_shuffle", {{"n", n_pool}, {"k", k}}, k, [&rng, &pool, k](long long n){
+			for (long long i = 0; i < n; ++i) {
+				rng.partial_shuffle(pool, k);
+				do_not_optimize(pool.front());
+			}
+		});
+		runner.run("RNG::sample_without_replacement", {{"n", n_pool}, {"k", k}}, k, [&rng, k](long long n){
+			for (long long i = 0; i < n; ++i) {
+				std::vector<int> sample = rng.sample_without_replacement(n_pool, k);
+				do_not_optimize(sample.front());
+			}
+		});
+	}
+}
+
+/// Sums of place contributions as in compute_susceptible_lambda
+void add_lambdas_benchmarks(BenchmarkRunner& runner)
+{
+	const int n_strains = 2;
+	const std::vector<double> factor(n_strains, 0.8);
+	const std::vector<std::vector<double>> places(5, std::vector<double>(n_strains, 0.01));
+	for (const int n_places : {2, 3, 5}) {
+		runner.run("add_lambdas", {{"locations", n_places}, {"strains", n_strains}}, 1,
+			[&places, &factor, n_places](long long n){
+				for (long long i = 0; i < n; ++i) {
+					std::vector<double> lambda = add_lambdas(
+							std::vector<std::vector<double>>(places.begin(), places.begin() + n_places),
+							{{1, factor}});
+					do_not_optimize(lambda.front());
+				}
+			});
+	}
+}
+
+/// Removal from places of growing size, the agent is added back
+void remove_agent_benchmarks(BenchmarkRunner& runner)
+{
+	for (const int size : {10, 100, 1000, 10000}) {
+		Household house(1, 0.0, 0.0, 1.0, 1.0, 2);
+		for (int aID = 1; aID <= size; ++aID) {
+			house.add_agent(aID);
+		}
+		runner.run("Place::remove_agent", {{"place size", size}}, 1, [&house, size](long long n){
+			for (long long i = 0; i < n; ++i) {
+				// Spread over the whole place
+				const int aID = 1 + static_cast<int>((i*7919) % size);
+				house.remove_agent(aID);
+				house.add_agent(aID);
+			}
+			do_not_optimize(house.get_number_of_agents());
+		});
+	}
+}
+
+/// Recovery from flu and a new random case
+void flu_benchmarks(BenchmarkRunner& runner)
+{
+	for (const int population : {1000, 10000, 100000}) {
+		Flu flu;
+		flu.seed(2022);
+		for (int aID = 1; aID <= population; ++aID) {
+			flu.add_susceptible_agent(aID);
+		}
+		flu.set_fraction(0.05);
+		flu.generate_flu();
+		runner.run("Flu::swap_flu_agent", {{"population", population}}, 1, [&flu](long long n){
+			for (long long i = 0; i < n; ++i) {
+				// Recovered agent can get flu again, sizes stay the same
+				const int aID = flu.get_flu_IDs().at(i % flu.get_flu_IDs().size());
+				do_not_optimize(flu.swap_flu_agent(aID));
+				flu.add_susceptible_agent(aID);
+			}
+		});
+	}
+}
+
+/// Contributions of exposed agents to their places
+void exposed_contributions_benchmarks(BenchmarkRunner& runner, TestTown& town)
+{
+	const std::string name("Contributions::compute_exposed_contributions");
+	if (!runner.is_selected(name)) {
+		return;
+	}
+	ABM& abm = town.get();
+	std::vector<int> exposed;
+	for (const auto& agent : abm.get_vector_of_agents()) {
+		if (agent.exposed()) {
+			exposed.push_back(agent.get_ID());
+		}
+	}
+	Contributions contributions;
+	for (const int n_agents : {100, 1000, 10000}) {
+		const int n_exp = std::min(n_agents, static_cast<int>(exposed.size()));
+		runner.run(name, {{"agents", n_exp}}, n_exp, [&abm, &contributions, &exposed, n_exp](long long n){
+			const std::vector<Agent>& agents = abm.get_vector_of_agents();
+			for (long long i = 0; i < n; ++i) {
+				for (int ia = 0; ia < n_exp; ++ia) {
+					contributions.compute_exposed_contributions(agents.at(exposed.at(ia)-1),
+							abm.get_time(), abm.vector_of_households(), abm.vector_of_schools(),
+							abm.vector_of_workplaces(), abm.vector_of_hospitals(),
+							abm.vector_of_retirement_homes(), abm.vector_of_carpools(),
+							abm.vector_of_public_transit(), abm.vector_of_leisure_locations());
+				}
+			}
+		});
+	}
+	abm.reset_contributions();
+}
+
+/// Infection probability of susceptible agents
+void susceptible_lambda_benchmarks(BenchmarkRunner& runner, TestTown& town)
+{
+	const std::string name("RegularTransitions::compute_susceptible_lambda");
+	if (!runner.is_selected(name)) {
+		return;
+	}
+	ABM& abm = town.get();
+	abm.compute_place_contributions();
+	// Agents handled by RegularTransitions
+	std::vector<int> susceptible;
+	for (const auto& agent : abm.get_vector_of_agents()) {
+		if (!agent.infected() && !agent.hospital_employee() && !agent.hospital_non_covid_patient()) {
+			susceptible.push_back(agent.get_ID());
+		}
+	}
+	RegularTransitions transitions;
+	const int n_strains = static_cast<int>(abm.get_infection_parameters().at("number of strains"));
+	for (const int n_agents : {1000, 10000, static_cast<int>(susceptible.size())}) {
+		runner.run(name, {{"agents", n_agents}}, n_agents,
+			[&abm, &transitions, &susceptible, n_agents, n_strains](long long n){
+				const std::vector<Agent>& agents = abm.get_vector_of_agents();
+				for (long long i = 0; i < n; ++i) {
+					for (int ia = 0; ia < n_agents; ++ia) {
+						std::vector<double> lambda = transitions.compute_susceptible_lambda(
+								agents.at(susceptible.at(ia)-1), abm.get_time(),
+								abm.get_vector_of_households(), abm.get_vector_of_schools(),
+								abm.get_vector_of_workplaces(), abm.get_vector_of_retirement_homes(),
+								abm.get_vector_of_carpools(), abm.get_vector_of_public_transit(),
+								abm.get_vector_of_leisure_locations(), n_strains);
+						do_not_optimize(lambda.front());
+					}
+				}
+			});
+	}
+	abm.reset_contributions();
+}
+
+/// Choice of a leisure location for a household
+void leisure_location_benchmarks(BenchmarkRunner& runner, TestTown& town)
+{
+	const std::string name("Mobility::assign_leisure_location");
+	if (!runner.is_selected(name)) {
+		return;
+	}
+	ABM& abm = town.get();
+	const std::map<std::string, double>& parameters = abm.get_infection_parameters();
+	Mobility mobility;
+	mobility.set_probability_parameters(parameters.at("leisure - dr0"),
+			parameters.at("leisure - beta"), parameters.at("leisure - kappa"));
+	mobility.set_shared_public_probabilities(abm.get_town()->get_shared_public_probabilities());
+	Infection& infection = abm.get_infection_object();
+	const int n_houses = static_cast<int>(abm.get_vector_of_households().size());
+	const int n_leisure = static_cast<int>(abm.get_vector_of_leisure_locations().size());
+	// Only public locations, and the default split with households
+	for (const double house_prob : {0.0, 0.5}) {
+		runner.run(name, {{"leisure locations", n_leisure}, {"household probability", house_prob}}, 1,
+			[&mobility, &infection, n_houses, house_prob](long long n){
+				bool is_house = false, is_public = false;
+				for (long long i = 0; i < n; ++i) {
+					const int house_ID = 1 + static_cast<int>(i % n_houses);
+					do_not_optimize(mobility.assign_leisure_location(infection, house_ID,
+											is_house, is_public, house_prob));
+				}
+			});
+	}
+}
+
+/// Tracing of a student in schools of different size
+void isolate_school_benchmarks(BenchmarkRunner& runner, TestTown& town)
+{
+	const std::string name("Contact_tracing::isolate_school");
+	if (!runner.is_selected(name)) {
+		return;
+	}
+	ABM& abm = town.get();
+	// Isolation changes the agents
+	std::vector<Agent> agents = abm.get_vector_of_agents();
+	const std::vector<School>& schools = abm.get_vector_of_schools();
+	const std::map<std::string, double>& parameters = abm.get_infection_parameters();
+	Contact_tracing contact_tracing(agents.size(), abm.get_vector_of_households().size(),
+						parameters.at("maximum number of visits to track"));
+	Infection& infection = abm.get_infection_object();
+	const double n_students = parameters.at("max contacts at school");
+
+	// Smallest, median, and largest school with students
+	std::vector<int> school_IDs;
+	for (const auto& school : schools) {
+		if (school.get_number_of_agents() > 1) {
+			school_IDs.push_back(school.get_ID());
+		}
+	}
+	std::sort(school_IDs.begin(), school_IDs.end(), [&schools](const int a, const int b)
+		{ return schools.at(a-1).get_number_of_agents() < schools.at(b-1).get_number_of_agents(); });
+	if (school_IDs.empty()) {
+		return;
+	}
+	for (const int sID : {school_IDs.front(), school_IDs.at(school_IDs.size()/2), school_IDs.back()}) {
+		const School& school = schools.at(sID-1);
+		int student_ID = 0;
+		for (const int aID : school.get_agent_IDs()) {
+			if (agents.at(aID-1).student() && agents.at(aID-1).get_school_ID() == sID) {
+				student_ID = aID;
+				break;
+			}
+		}
+		if (student_ID == 0) {
+			continue;
+		}
+		runner.run(name, {{"place size", school.get_number_of_agents()}}, 1,
+			[&contact_tracing, &agents, &school, &infection, student_ID, n_students](long long n){
+				for (long long i = 0; i < n; ++i) {
+					std::vector<int> traced = contact_tracing.isolate_school(student_ID, agents,
+													school, n_students, infection);
+					do_not_optimize(traced.size());
+				}
+			});
+	}
+}
+
+/// Selection of agents eligible for vaccination
+void filter_general_benchmarks(BenchmarkRunner& runner, TestTown& town)
+{
+	const std::string name("Vaccinations::filter_general");
+	if (!runner.is_selected(name)) {
+		return;
+	}
+	ABM& abm = town.get();
+	const std::vector<Agent>& all_agents = abm.get_vector_of_agents();
+	Vaccinations vaccinations = abm.get_vaccinations_object();
+	for (const size_t population : {size_t(1000), size_t(10000), all_agents.size()}) {
+		const std::vector<Agent> agents(all_agents.begin(), all_agents.begin() + population);
+		runner.run(name, {{"population", population}}, population, [&vaccinations, &agents](long long n){
+			for (long long i = 0; i < n; ++i) {
+				int max_boost = 0;
+				std::vector<int> eligible = vaccinations.filter_general(agents, max_boost);
+				do_not_optimize(eligible.size());
+			}
+		});
+	}
+}
+
+// Setup with many exposed agents
+ABM& TestTown::get()
+{
+	if (!abm) {
+		abm.reset(new ABM(0.25));
+		abm->simulation_setup("test_data/input_files_all.txt", {0, 1000, 10000});
+		abm->set_seed(2022);
+	}
+	return *abm;
+}
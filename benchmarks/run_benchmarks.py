@@ -0,0 +1,31 @@
+import subprocess, os, sys
+
+py_path = '../scripts/'
+sys.path.insert(0, py_path)
+
+import utils as ut
+from colors import *
+
+py_version = 'python3'
+
+#
+# Compile and run the microbenchmarks
+#
+
+# Usage: python3 run_benchmarks.py [output JSON] [name filter]
+# Compare two outputs with compare_benchmarks.py
+
+out_file = sys.argv[1] if len(sys.argv) > 1 else 'benchmark_results.json'
+name_filter = sys.argv[2] if len(sys.argv) > 2 else ''
+
+# Uses the test town of the ABM tests, create it if missing
+if not os.path.exists('../tests/abm/test_data/NR_agents.txt'):
+	ut.msg('Creating the test population', CYAN)
+	subprocess.call(['cd ../tests/abm && ' + py_version + ' create_test_population.py'], shell=True)
+
+# Compile
+subprocess.call([py_version + ' compilation.py'], shell=True)
+
+# Run
+ut.msg('Kernel microbenchmarks', CYAN)
+subprocess.call(['./kernels_benchmark ' + out_file + ' "' + name_filter + '"'], shell=True)
@@ -0,0 +1,100 @@
+import subprocess, os, sys, json
+
+py_path = '../scripts/'
+sys.path.insert(0, py_path)
+
+import utils as ut
+from colors import *
+
+py_version = 'python3'
+
+#
+# Strong and weak scaling of whole simulation steps
+#
+
+# Usage: python3 run_scaling.py [strong town size] [agents per process]
+#			[processes, comma separated] [steps] [report file]
+#
+# Strong scaling runs one town on an increasing number of
+# processes, weak scaling grows the town with the number of
+# processes. Towns are generated with tools/town_generator,
+# runs are distributed with mpirun. Raw results of each run
+# are appended to scaling_results.jsonl.
+#
+# Note: the setup of mobility is quadratic in town size, keep
+# the towns at tens of thousands of agents unless much memory
+# is available.
+
+strong_size = int(sys.argv[1]) if len(sys.argv) > 1 else 50000
+weak_size = int(sys.argv[2]) if len(sys.argv) > 2 else 25000
+processes = [int(x) for x in sys.argv[3].split(',')] if len(sys.argv) > 3 else [1, 2]
+n_steps = int(sys.argv[4]) if len(sys.argv) > 4 else 50
+report_file = sys.argv[5] if len(sys.argv) > 5 else 'scaling_report.md'
+
+seed = 2022
+town_dir = 'scaling_towns/'
+results_file = 'scaling_results.jsonl'
+template = 'test_data/input_files_all.txt'
+
+def generate_town(n_agents):
+	''' Generate a town of n_agents unless it exists, return its input file list '''
+	path = town_dir + 'town_' + str(n_agents) + '/'
+	if not os.path.exists(path + 'input_files_all.txt'):
+		ut.msg('Generating a town of ' + str(n_agents) + ' agents', CYAN)
+		subprocess.call(['../tools/town_generator/generate_town ' + str(n_agents) + ' ' + path
+							+ ' ' + str(seed) + ' ' + template], shell=True)
+	return path + 'input_files_all.txt'
+
+def run_case(label, n_agents, n_proc):
+	''' One run, returns its results '''
+	input_file = generate_town(n_agents)
+	# Initially infected with the second strain, 1 per 1000 agents
+	inf0 = '0,' + str(max(1, n_agents//1000)) + ',0'
+	if os.path.exists('run_result.jsonl'):
+		os.remove('run_result.jsonl')
+	ut.msg(label + ' scaling, ' + str(n_agents) + ' agents, ' + str(n_proc) + ' processes', CYAN)
+	subprocess.call(['mpirun --oversubscribe -np ' + str(n_proc) + ' ./scaling_benchmark --input ' + input_file
+						+ ' --inf0 ' + inf0 + ' --steps ' + str(n_steps) + ' --seed ' + str(seed)
+						+ ' --label ' + label + ' --output run_result.jsonl'], shell=True)
+	with open('run_result.jsonl', 'r') as fin:
+		line = fin.readline()
+	with open(results_file, 'a') as fout:
+		fout.write(line)
+	return json.loads(line)
+
+def table(title, results, efficiency):
+	''' Markdown table of a scaling study, speedup in agent-steps per second,
+		efficiency(base, result) '''
+	base = results[0]
+	lines = ['## ' + title, '',
+			'| processes | agents | setup [s] | step mean [ms] | step max [ms] | speedup | efficiency | agent-steps/s | peak RSS [MB] | total RSS [MB] |',
+			'|---|---|---|---|---|---|---|---|---|---|']
+	for res in results:
+		lines.append('| %d | %d | %.2f | %.2f | %.2f | %.2f | %.2f | %.3g | %.0f | %.0f |'
+			% (res['processes'], res['agents'], res['setup_s'], res['step_mean_ms'], res['step_max_ms'],
+				res['agent_steps_per_s']/base['agent_steps_per_s'], efficiency(base, res), res['agent_steps_per_s'],
+				res['peak_rss_mb'], res['total_peak_rss_mb']))
+	return lines + ['']
+
+# Build the generator and the benchmark
+ut.msg('Compiling', CYAN)
+subprocess.call(['cd ../tools/town_generator && ' + py_version + ' compilation.py'], shell=True)
+subprocess.call([py_version + ' compilation.py'], shell=True)
+os.makedirs(town_dir, exist_ok=True)
+
+# Strong - same town, time per step should drop as 1/processes
+strong = [run_case('strong', strong_size, n_proc) for n_proc in processes]
+# Weak - same agents per process, time per step should stay constant
+weak = [run_case('weak', weak_size*n_proc, n_proc) for n_proc in processes]
+
+report = ['# Scaling of ABM::transmit_infection', '',
+			str(n_steps) + ' steps, seed ' + str(seed) + ', distributed with ABM::distribute', '']
+report += table('Strong scaling, ' + str(strong_size) + ' agents', strong,
+			lambda base, res: base['step_mean_ms']/(res['step_mean_ms']*res['processes']/base['processes']))
+report += table('Weak scaling, ' + str(weak_size) + ' agents per process', weak,
+			lambda base, res: base['step_mean_ms']/res['step_mean_ms'])
+
+with open(report_file, 'w') as fout:
+	fout.write('\n'.join(report))
+print('\n'.join(report))
+ut.msg('Report saved to ' + report_file, CYAN)
@@ -0,0 +1,198 @@
+#include "../include/abm.h"
+#include <chrono>
+#include <sys/resource.h>
+#ifdef ABM_MPI
+#include "../include/distributed/mpi_communicator.h"
+#endif
+
+/***************************************************************
+ * End-to-end run of ABM::transmit_infection for scaling
+ * studies
+ *
+ * Same structure as simulations/.../templates/covid_model.cpp,
+ * with the settings from the command line:
+ *
+ * ./scaling_benchmark --input input_files_all.txt --inf0 0,50,0
+ *		[--steps 100] [--dt 0.25] [--seed 2022] [--threads 1] 
+ *		[--label name] [--output results.jsonl]
+ *
+ * Built with -DABM_MPI (mpicxx) and started with mpirun on more
+ * than one process, the run is distributed (ABM::distribute).
+ * Prints and appends to the output one JSON line with setup
+ * time, per-step times, peak RSS, and agent-steps per second;
+ * run_scaling.py collects the lines into scaling tables.
+ **************************************************************/
+
+/// Settings from the command line
+struct ScalingSettings {
+	std::string input = {};
+	std::vector<int> inf0 = {};
+	int steps = 100;
+	double dt = 0.25;
+	unsigned int seed = 2022;
+	/// Threads within a step of each process
+	int threads = 1;
+	std::string label = "run";
+	std::string output = "scaling_results.jsonl";
+};
+
+ScalingSettings parse_arguments(int argc, char** argv);
+void run(const ScalingSettings&, std::shared_ptr<Communicator>);
+long peak_rss_kb();
+
+int main(int argc, char** argv)
+{
+#ifdef ABM_MPI
+	MPI_Init(&argc, &argv);
+	std::shared_ptr<Communicator> comm = std::make_shared<MPICommunicator>();
+#else
+	std::shared_ptr<Communicator> comm = std::make_shared<SerialCommunicator>();
+#endif
+	int status = 0;
+	try {
+		run(parse_arguments(argc, argv), comm);
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		status = 1;
+#ifdef ABM_MPI
+		// Other processes would wait in a collective operation
+		MPI_Abort(MPI_COMM_WORLD, 1);
+#endif
+	}
+#ifdef ABM_MPI
+	MPI_Finalize();
+#endif
+	return status;
+}
+
+/// Setup, steps, and a report from process 0
+void run(const ScalingSettings& settings, std::shared_ptr<Communicator> comm)
+{
+	using clock = std::chrono::steady_clock;
+	auto seconds = [](const clock::time_point& t0, const clock::time_point& t1)
+		{ return std::chrono::duration<double>(t1 - t0).count(); };
+
+	// This initializes the core of the model
+	const clock::time_point setup_start = clock::now();
+	ABM abm(settings.dt);
+	abm.simulation_setup(settings.input, settings.inf0);
+	abm.set_seed(settings.seed);
+	abm.set_number_of_threads(settings.threads);
+	const clock::time_point setup_end = clock::now();
+	if (comm->size() > 1) {
+		abm.distribute(comm, settings.seed);
+	}
+	const clock::time_point distribute_end = clock::now();
+
+	// Simulation, the slowest process sets the time of a step
+	std::vector<int> step_us(settings.steps, 0);
+	for (int ti = 0; ti < settings.steps; ++ti) {
+		const clock::time_point step_start = clock::now();
+		abm.transmit_infection();
+		step_us.at(ti) = static_cast<int>(1e6*seconds(step_start, clock::now()));
+	}
+	const double loop_s = seconds(distribute_end, clock::now());
+	const std::vector<std::vector<int>> all_steps = comm->all_gather(step_us);
+	std::vector<double> step_ms(settings.steps, 0.0);
+	for (const auto& process_steps : all_steps) {
+		for (int ti = 0; ti < settings.steps; ++ti) {
+			step_ms.at(ti) = std::max(step_ms.at(ti), 1e-3*process_steps.at(ti));
+		}
+	}
+
+	// Peak memory of each process and of all together
+	const std::vector<std::vector<int>> all_rss = comm->all_gather({static_cast<int>(peak_rss_kb())});
+	std::vector<double> totals = {static_cast<double>(peak_rss_kb())};
+	comm->all_reduce_sum(totals);
+	int max_rss_kb = 0;
+	for (const auto& rss : all_rss) {
+		max_rss_kb = std::max(max_rss_kb, rss.front());
+	}
+	// Whole town, collective if distributed
+	std::vector<double> values;
+	abm.get_time_series_values(values);
+	const std::vector<std::string> names = abm.get_time_series_names();
+	const double total_infected = values.at(std::find(names.begin(), names.end(), "total infected") - names.begin());
+
+	if (comm->rank() != 0) {
+		return;
+	}
+	const size_t n_agents = abm.get_vector_of_agents().size();
+	std::vector<double> sorted(step_ms);
+	std::sort(sorted.begin(), sorted.end());
+	const double mean_ms = std::accumulate(step_ms.begin(), step_ms.end(), 0.0)/std::max(1, settings.steps);
+	std::ostringstream line;
+	line << std::setprecision(8)
+		 << "{\"label\": \"" << settings.label << "\", \"agents\": " << n_agents
+		 << ", \"processes\": " << comm->size() << ", \"threads\": " << abm.get_number_of_threads()
+		 << ", \"steps\": " << settings.steps
+		 << ", \"dt\": " << settings.dt
+		 << ", \"setup_s\": " << seconds(setup_start, setup_end)
+		 << ", \"distribute_s\": " << seconds(setup_end, distribute_end)
+		 << ", \"loop_s\": " << loop_s
+		 << ", \"step_mean_ms\": " << mean_ms
+		 << ", \"step_median_ms\": " << (sorted.empty() ? 0.0 : sorted.at(sorted.size()/2))
+		 << ", \"step_max_ms\": " << (sorted.empty() ? 0.0 : sorted.back())
+		 << ", \"agent_steps_per_s\": " << n_agents*settings.steps/std::max(loop_s, 1e-9)
+		 << ", \"peak_rss_mb\": " << max_rss_kb/1024.0
+		 << ", \"total_peak_rss_mb\": " << totals.front()/1024.0
+		 << ", \"total_infected\": " << total_infected << "}";
+	std::cout << line.str() << std::endl;
+
+	std::ofstream out(settings.output, std::ios::app);
+	if (!out.is_open()) {
+		std::cerr << "Error opening file " << settings.output << std::endl;
+		throw std::runtime_error("Cannot open scaling output file");
+	}
+	out << line.str() << "\n";
+}
+
+// Pairs of --name value
+ScalingSettings parse_arguments(int argc, char** argv)
+{
+	ScalingSettings settings;
+	for (int i = 1; i < argc; i += 2) {
+		const std::string name(argv[i]);
+		if (i + 1 >= argc) {
+			throw std::invalid_argument("Missing value of " + name);
+		}
+		const std::string value(argv[i+1]);
+		if (name == "--input") {
+			settings.input = value;
+		} else if (name == "--inf0") {
+			std::istringstream values(value);
+			std::string count;
+			while (std::getline(values, count, ',')) {
+				settings.inf0.push_back(std::stoi(count));
+			}
+		} else if (name == "--steps") {
+			settings.steps = std::stoi(value);
+		} else if (name == "--dt") {
+			settings.dt = std::stod(value);
+		} else if (name == "--seed") {
+			settings.seed = static_cast<unsigned int>(std::stoul(value));
+		} else if (name == "--threads") {
+			settings.threads = std::stoi(value);
+		} else if (name == "--label") {
+			settings.label = value;
+		} else if (name == "--output") {
+			settings.output = value;
+		} else {
+			throw std::invalid_argument("Unknown option " + name);
+		}
+	}
+	if (settings.input.empty() || settings.inf0.empty() || settings.steps < 1) {
+		throw std::invalid_argument("Usage: scaling_benchmark --input <input files> --inf0 <n1,n2,...>"
+			" [--steps n] [--dt dt] [--seed s] [--threads n] [--label name] [--output results.jsonl]");
+	}
+	return settings;
+}
+
+/// Peak resident set size of this process
+long peak_rss_kb()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	// Linux reports kB
+	return usage.ru_maxrss;
+}
@@ -61,7 +61,9 @@ public:
 	 * See examples of usage in testing and simulation directories. 
 	 * This sets up the simulation core, custom extensions - like
 	 * vaccinating and intializing active cases need to be done 
-	 * separately, by the user.
+	 * separately, by the user. If the input information has a 
+	 * "Town image" entry, places and agents are loaded from that
+	 * image instead of the individual place and agent files.
 	 *	
 	 * @param filename - path of the file with input information
 	 * @param ninf0 - number of initially infected for each strain 
@@ -71,6 +73,23 @@ public:
 	void simulation_setup(const std::string filename, const std::vector<int>& ninf0,
 		 const bool custom_vac_offsets = false, const bool custom_boost_offsets = false);
 
+	/**
+	 * \brief Set up the model on a town that was already created
+	 * \details Same as simulation_setup from the input files, but places 
+	 * and mobility probabilities are taken from the town instead of 
+	 * created; only agents are loaded. The input files need to be the 
+	 * ones the town was created with - places keep the agents and 
+	 * setup parameters (is_setup_parameter) they were created with.
+	 *	
+	 * @param town - town from get_town() of another model
+	 * @param filename - path of the file with input information
+	 * @param ninf0 - number of initially infected for each strain 
+	 * @param custom_vac_offsets - read the vac time offsets from file if true
+	 */	
+	void simulation_setup(std::shared_ptr<const Town> town, const std::string filename,
+		 const std::vector<int>& ninf0, const bool custom_vac_offsets = false, 
+		 const bool custom_boost_offsets = false);
+
 	/**
 	 * \brief Create households based on information in a file
 	 * \details Constructs households based on the ID and
@@ -161,6 +180,16 @@ public:
 	 */	
 	void create_leisure_locations(const std::string filename);
 
+	/**
+	 * \brief Create all places stored in a town image
+	 * \details Equivalent to calling all the create_* functions for
+	 *		places on the text files the image was made from
+	 *	
+	 * @param image - precompiled town 
+	 * 
+	 */	
+	void create_places(const TownImage& image);
+
 	/**
 	 * \brief Initialize Mobility and assignment of leisure locations
 	 */
@@ -181,6 +210,18 @@ public:
 	 */	
 	void create_agents(const std::string filename, const std::vector<int>& ninf0);
 
+	/**
+	 * \brief Create agents stored in a town image
+	 * \details Same as create_agents from a file, but with agent 
+	 *		properties taken from the image; needs to be called
+	 *		AFTER creating places
+	 *	
+	 * @param image - precompiled town
+	 * @param ninf0 - number of initially infected for each strain 
+	 * 
+	 */	
+	void create_agents(const TownImage& image, const std::vector<int>& ninf0);
+
 	/// Start with N_inf agents that have COVID-19 in various stages
 	/// @details Currently working for 1 strain only
 	/// @param vaccinate - false means this will not initialize various vaccinated stages
@@ -241,20 +282,209 @@ public:
 
 	/// \brief Set the lambda factors to 0.0
 	void reset_contributions()
-		{ contributions.reset_sums(households, schools, workplaces, hospitals, 
-						retirement_homes, carpools, public_transit, leisure_locations); }
+	{ 
+		ABM_PROFILE_PHASE(step_stats, reset_contributions);
+		Tracer::Scope trace_phase(tracer.get(), "reset_contributions", "phase");
+		contributions.reset_sums(households, schools, workplaces, hospitals, 
+						retirement_homes, carpools, public_transit, leisure_locations); 
+		ABM_PROFILE_COUNT(step_stats, reset_contributions, place_updates, number_of_places());
+	}
 	
-	/// Process all traced agents 
-	void setup_traced_isolation(const std::unordered_set<int>&);
+	/// \brief Process all traced agents 
+	/// \details Sorts and removes repeated IDs, removals from
+	///		places are applied together after all agents
+	void setup_traced_isolation(std::vector<int>& traced_IDs);
 
 	// Increasing time
 	void advance_in_time() { time += dt; }
 
-	/// Verify if anything happens at this step
+	//
+	// Recording of time series
+	//
+
+	/**
+	 * \brief Stream per-step metrics to a file during the simulation
+	 * \details One row is written at the beginning of each step 
+	 *		(transmit_infection or transmit_with_vac); columns are currently 
+	 *		infected (all, each strain) and exposed, and total infected 
+	 *		(all, each strain), dead, recovered, tested positive, and vaccinated.
+	 *		Counts come from the state transitions pass, not additional
+	 *		loops over agents. Needs to be called after simulation_setup.
+	 * @param fname - path of the output file
+	 * @param format - Recorder::csv or Recorder::binary
+	 */
+	void record_output(const std::string& fname, 
+						const Recorder::Format format = Recorder::csv);
+
+	/// Write the remaining recorded rows and close the output
+	void stop_recording();
+
+	//
+	// Parameter changes
+	//
+
+	/**
+	 * \brief Parameter values to use instead of the ones in the input files
+	 * \details Needs to be called before simulation_setup; 
+	 *		simulation_setup throws std::invalid_argument 
+	 *		if any of the names is not a parameter
+	 * @param infection_values - infection parameters, name and value 
+	 * @param vaccination_values - vaccination parameters, name and value 
+	 */
+	void set_parameter_overrides(const std::map<std::string, double>& infection_values,
+								const std::map<std::string, double>& vaccination_values = {});
+
+	/**
+	 * \brief Change an infection parameter of a model that is already set up
+	 * \details Throws std::invalid_argument if the parameter does not
+	 *		exist or if it is used only during setup (is_setup_parameter)
+	 * @param name - name of the parameter as in the input file
+	 * @param value - new value
+	 */
+	void set_infection_parameter(const std::string& name, const double value);
+
+	/// Change a vaccination parameter of a model that is already set up
+	void set_vaccination_parameter(const std::string& name, const double value)
+		{ vaccinations.set_parameter(name, value); }
+
+	/**
+	 * \brief True if an infection parameter is copied into places 
+	 *		or agents during setup
+	 * \details Such parameters can only be changed with set_parameter_overrides
+	 */
+	static bool is_setup_parameter(const std::string& name);
+
+	/// Names of the per-step metrics, in the order of get_time_series_values
+	std::vector<std::string> get_time_series_names() const;
+
+	/**
+	 * \brief Current values of the per-step metrics 
+	 * \details Same metrics as written by record_output, without time
+	 * @param values - vector to store the values in, resized if needed
+	 */
+	void get_time_series_values(std::vector<double>& values);
+
+	//
+	// Replicates
+	//
+
+	/**
+	 * \brief Restart all random number generators from a seed
+	 * \details Used to give copies of an ABM object independent,
+	 *		reproducible random streams
+	 * @param seed - seed of this instance
+	 */
+	void set_seed(const unsigned int seed);
+
+	/**
+	 * \brief Randomly infect agents that are not infected yet
+	 * \details Same as initially infected in simulation_setup,
+	 *		for copies of a model set up without any infected; 
+	 *		needs to be called before the first step
+	 * @param ninf0 - number of agents to infect with each strain
+	 */
+	void seed_initially_infected(const std::vector<int>& ninf0);
+
+	//
+	// Threads
+	//
+
+	/**
+	 * \brief Number of threads used within a step
+	 * \details Currently used to distribute leisure locations; results
+	 *		do not depend on the number of threads. Keep 1 if replicates 
+	 *		already run on separate threads, like in Ensemble. 
+	 *		Throws std::invalid_argument for negative values.
+	 * @param n - number of threads, 0 to use all available
+	 */
+	void set_number_of_threads(const int n);
+
+	/// Number of threads used within a step
+	int get_number_of_threads() const { return n_threads; }
+
+	//
+	// Distributed runs
+	//
+
+	/**
+	 * \brief Split the simulation between processes
+	 * \details Every process sets up and initializes the same model -
+	 *		same input and seeding, with random numbers from set_seed
+	 *		(e.g. setup without infected and seed_initially_infected) -
+	 *		and then calls this function.
+	 *		Households and retirement homes are split by location 
+	 *		(HouseholdPartition), and each process from then on simulates
+	 *		only the agents living in its part of the town. Agents of other
+	 *		processes are still stored, but not updated. Place contributions
+	 *		are summed over processes at every step and households isolated
+	 *		due to visits from agents of other processes are exchanged 
+	 *		once per step. Only transmit_infection is supported. Counts 
+	 *		from DataManagementInterface are for this process only, 
+	 *		get_time_series_values and record_output report the whole town
+	 *		and need to be used in all processes. 
+	 * @param comm - communicator of the processes
+	 * @param seed - seed of the random number generators, each process
+	 *		uses a different stream derived from it
+	 */
+	void distribute(std::shared_ptr<Communicator> comm, const unsigned int seed);
+
+	/// True if the simulation is split between processes
+	bool is_distributed() const { return comm != nullptr; }
+	/// Partition of the town, null if not distributed
+	std::shared_ptr<const HouseholdPartition> get_partition() const { return partition; }
+	/// IDs of agents simulated by this process, only if distributed
+	const std::vector<int>& get_owned_agents() const { return owned_agents; }
+	/// Process that simulates agent with ID, 0 if not distributed
+	int get_agent_owner(const int ID) const 
+		{ return comm ? agent_owners.at(ID-1) : 0; }
+
+	//
+	// Step statistics
+	//
+
+	/**
+	 * \brief Time and work of each phase of the steps so far
+	 * \details Collected only if compiled with -DABM_PROFILING,
+	 *		otherwise all values are 0; print with StepStats::print_summary
+	 */
+	const StepStats& get_step_stats() const { return step_stats; }
+	/// Start collecting step statistics from 0
+	void reset_step_stats() { step_stats.reset(); }
+
+	/**
+	 * \brief Record a timeline of steps, their phases, and other events
+	 * \details Steps, phases, contact tracing, vaccinations, mobility setup,
+	 *		and output writes are added as Tracer events; copies of the
+	 *		model (e.g. ensemble replicates) record to the same tracer
+	 * @param trc - timeline to record to, null to stop recording
+	 */
+	void set_tracer(std::shared_ptr<Tracer> trc);
+	/// Timeline of events, null if not recording
+	std::shared_ptr<Tracer> get_tracer() const { return tracer; }
+
+	//
+	// Scheduled events
+	//
+
+	/// Apply the events of the timeline due at this step
 	void check_events();
-	/// Verify if anything that requires parameter changes happens at this step 
+	/// Apply the events due at this step, changes of places to the given ones
 	void check_events(std::vector<School>&, std::vector<Workplace>&);
 
+	/**
+	 * \brief Schedule an event at a simulation time
+	 * \details The event is kept when the timeline is rebuilt after 
+	 *		a parameter change; events before time 0 never happen
+	 * @param event_time - time of the event, days
+	 * @param type - type of the event
+	 * @param value - first value of the event (see EventTimeline::Type)
+	 * @param second_value - second value of the event
+	 */
+	void schedule_event(const double event_time, const EventTimeline::Type type, 
+						const double value = 0.0, const double second_value = 0.0);
+	/// Events that were not applied yet
+	const EventTimeline& get_event_timeline() const { return timeline; }
+
 	//
 	// Getters
 	//
@@ -304,6 +534,10 @@ public:
 	Testing& get_testing_object() { return testing; }
 	/// Return a Transitions object
 	Transitions& get_transitions_object() { return transitions; }
+	/// Return a const reference to the Vaccinations object
+	const Vaccinations& get_vaccinations_object() const { return vaccinations; }
+	/// Return the read-only town this model was set up on
+	std::shared_ptr<const Town> get_town() const { return town; }
 private:
 
 	// General model attributes
@@ -317,8 +551,95 @@ private:
 	std::vector<double> strain_correction;
 	void compute_outside_locations();
 
+	// Places and mobility as set up, shared by copies of the model
+	std::shared_ptr<const Town> town = nullptr;
+	// Common part of both simulation_setup versions, creates the town if null
+	void setup_model(const std::string& filename, const std::vector<int>& inf0,
+			const bool custom_vac_offsets, const bool custom_boost_offsets,
+			std::shared_ptr<const Town> shared_town);
+
+	// Recording
+	// Output of per-step metrics, not present if not recording
+	std::shared_ptr<Recorder> recorder = nullptr;
+	// Values of the recorded metrics, reused every step
+	std::vector<double> recorder_values = {};
+	// Currently infected with each strain and exposed, 
+	// tallied during compute_state_transitions
+	std::vector<int> n_infected_now_strain = {};
+	int n_exposed_now = 0;
+	// False if agent states could have changed 
+	// since the counts were computed
+	bool current_counts_valid = false;
+	// Write a row with current values
+	void record_step();
+	// Compute current counts directly from agents 
+	void count_current_states();
+
+	// Time and work of each phase, only with -DABM_PROFILING
+	StepStats step_stats;
+	// Timeline of events, not recorded if null
+	std::shared_ptr<Tracer> tracer = nullptr;
+	// Total number of places of all types
+	size_t number_of_places() const
+		{ return households.size() + schools.size() + workplaces.size() + hospitals.size()
+				+ retirement_homes.size() + carpools.size() + public_transit.size() 
+				+ leisure_locations.size(); }
+
+	// Distributed runs
+	// Processes of the run, null if not distributed
+	std::shared_ptr<Communicator> comm = nullptr;
+	std::shared_ptr<const HouseholdPartition> partition = nullptr;
+	// Agents simulated by this process and the process of each agent
+	std::vector<int> owned_agents = {};
+	std::vector<int> agent_owners = {};
+	// Time series values at the time of distributing, same in 
+	// all processes; counters after that only add local changes
+	std::vector<double> distributed_offsets = {};
+	// True if the agent is not simulated by another process
+	bool simulated_here(const Agent& agent) const
+		{ return !comm || agent_owners.at(agent.get_ID()-1) == comm->rank(); }
+	// Remove agents of other processes from places
+	template <typename T>
+	void retain_owned_agents(std::vector<T>& places);
+	// Sum place contributions and numbers of present agents over processes
+	void reduce_place_contributions();
+	// Lambda sums and number present of all places, reused every step
+	std::vector<double> place_values = {};
+	template <typename T>
+	void pack_contributions(const std::vector<T>& places);
+	template <typename T>
+	void unpack_contributions(std::vector<T>& places, size_t& pos);
+	// Apply household isolation of other processes, trace the members
+	void exchange_isolated_households();
+	// Currently infected with each strain, all processes
+	void count_infected_strains(std::vector<int>& all_infected);
+	// Infected with each strain at this step, reused every step
+	std::vector<int> all_infected = {};
+	// Random susceptible agent, null if in another process
+	Agent* select_susceptible_agent();
+
 	// Infection parameters
 	std::map<std::string, double> infection_parameters = {};
+	// Parameters replacing the ones from input files
+	std::map<std::string, double> infection_overrides = {};
+	std::map<std::string, double> vaccination_overrides = {};
+	// Set distributions and probabilities of the Infection object
+	void apply_infection_parameters();
+
+	// Scheduled events, rebuilt by schedule_events 
+	EventTimeline timeline;
+	// Events from the input files and schedule_event
+	std::vector<EventTimeline::Event> loaded_events = {};
+	// Values changed by events, NaN if not in the parameters
+	double vaccination_rate = 0.0;
+	double leisure_fraction = 0.0;
+	// Timeline from the parameters and loaded events, without
+	// the events before the current step
+	void schedule_events();
+	// Step of the current time
+	int current_step() const { return EventTimeline::step_of(time, dt); }
+	// Infect a random susceptible agent with a new strain
+	void introduce_strain(const int strain_id);
 	// Age-dependent distributions
 	std::map<std::string, std::map<std::string, double>> age_dependent_distributions = {};
 
@@ -359,6 +680,31 @@ private:
 	double ini_frac_les = 0.0;
 	// Difference between initial and final fraction
 	double del_frac_les = 0.0;
+	// Agents with a leisure location at this step, and households and 
+	// leisure locations in the town with visitors, cleared at the next step
+	std::vector<int> leisure_agents = {};
+	std::vector<int> visited_households = {};
+	std::vector<int> visited_leisure = {};
+	// Visit of one agent to a household or a leisure location
+	struct LeisureVisit {
+		int agent_ID;
+		int location_ID;
+		bool in_household;
+	};
+	// Visits selected by each thread, numbers of random draws and exceptions,
+	// merged in the order of households
+	std::vector<std::vector<LeisureVisit>> leisure_visits = {};
+	std::vector<unsigned long long> leisure_draws = {};
+	std::vector<std::exception_ptr> leisure_errors = {};
+	// Threads used within a step
+	int n_threads = 1;
+
+	// Contact tracing
+	// Agents confirmed positive at this step, traced after the transitions
+	std::vector<int> confirmed_cases = {};
+	// Contacts of all the cases and their removals from places
+	std::vector<int> all_traced = {};
+	PlaceRemovals quarantine_removals = {};
 
 	// Private methods
 
@@ -373,6 +719,9 @@ private:
 
 	/// Initialize testing and its time dependence
 	void load_testing(const std::string);
+
+	/// Load events from a file, rows of time | type | value | second value (optional)
+	void load_events(const std::string&);
 	
 	/// Initialize Vaccinations class 
 	void load_vaccinations(const std::string&, const std::string&, 
@@ -402,17 +751,21 @@ private:
 	void vaccinate_random_time_offset();
 	///	Randomly vaccinate agents based on the daily rate
 	void vaccinate();  
-	/// Increase transmission rate and visiting frequency of leisure locations 
-	void reopen_leisure_locations();
 
 	/// Checks if agent is in a condition that allows going to leisure locations
 	bool check_leisure_eligible(const Agent& agent, const int);
 
-	/// Finds the actual leisure location and registers eligible agent(s)
-	void check_select_and_register_leisure_location(const std::vector<int>& agent_IDs, const int house_ID);
-
-	/// Initiate contact tracing of an agent
-	void contact_trace_agent(Agent& agent);
+	/// Select leisure locations of households with indices [first, last), 
+	/// each household draws from its own stream defined by key 
+	void select_leisure_visits(const size_t first, const size_t last, const unsigned long long key, 
+								std::vector<LeisureVisit>& visits, unsigned long long& draws);
+	/// Register an agent at its leisure location
+	void register_leisure_visit(const LeisureVisit& visit);
+
+	/// Trace all cases confirmed at this step together
+	void contact_trace_confirmed();
+	/// Add contacts of a confirmed case, may repeat earlier ones
+	void collect_contacts(Agent& agent, std::vector<int>& contacts);
 	/**
 	 * \brief Retrieve information about agents from a file and store all in a vector
 	 * \details Optional parameter overwrites the loaded initially infected with custom
@@ -421,27 +774,57 @@ private:
 
 	/// Setup flu properties
 	void setup_flu();
-	/// Select IDs of agents initially infected with each strain
-	std::vector<std::vector<int>> select_initially_infected(const int, const std::vector<int>&);
+	/**
+	 * \brief Select agents initially infected with each strain
+	 * \details Each agent is infected with at most one strain 
+	 * @param n_agents - total number of agents
+	 * @param ninf0 - number of initially infected for each strain
+	 * @returns Strain of each agent (index is ID-1), 0 if not initially infected 
+	 */
+	std::vector<int> select_initially_infected(const int n_agents, const std::vector<int>& ninf0);
 	/// Initialize all transmission rates, assign nominal (common) values
 	std::vector<std::map<std::string, double>> generate_initial_tr_rates(const int&);
 
-	/// Properties of agents: housing, work and school status
-	void assign_roles(const std::vector<std::string>& agent, int& house_ID,
-						bool& patient, bool& hospital_staff, bool& student, 
-						bool& works, bool& livesRH, bool& worksRH, bool& worksSch, 
-						int& workID);
-	
+	// Transmission rates common to all agents, computed 
+	// once for all the agents that are being created 
+	struct RateTemplates {
+		// Nominal rates of each strain
+		std::vector<std::map<std::string, double>> nominal;
+		// Public transit rate at current capacity for each strain
+		std::vector<double> public_transit;
+		// Workplace rates of each occupation (A-E) for each strain
+		std::vector<std::vector<double>> occupation;
+	};
+	/// Compute transmission rates common to all agents
+	RateTemplates generate_rate_templates();
+
+	/// Retrieve information about agents from a town image and store all in a vector
+	void load_agents(const TownImage& image, const std::vector<int>& ninf0);
+
+	/// Construct an agent with ID agent_ID, initially infected with strain_id (0 if not) and store it
+	void add_agent(const AgentRecord& agent, const int agent_ID, 
+						const int strain_id, const RateTemplates& rates);
+
 	/// Assign proper transmission rate for an out-of-town or a generic workplace
-	void assign_workplace_transmission_rate(const std::vector<std::string>&,
+	void assign_workplace_transmission_rate(const AgentRecord&, const RateTemplates&,
 					std::vector<std::map<std::string, double>>&);
 
-	/// Select transit and calculate transmission rates if necessary
-	void assign_transit(const std::vector<std::string>&,
-					std::vector<std::map<std::string, double>>&, 
-					bool& works_from_home, double& work_travel_time, 
-					std::string& work_travel_mode, int& cpID, int& ptID,
-					const bool works, const bool hospital_staff);
+	/// Calculate transit transmission rates if necessary
+	void assign_transit(const AgentRecord&, const RateTemplates&,
+					std::vector<std::map<std::string, double>>&);
+
+	//
+	// Construction of single places
+	//
+
+	void add_household(const PlaceRecord&);
+	void add_retirement_home(const PlaceRecord&);
+	void add_school(const PlaceRecord&);
+	void add_workplace(const PlaceRecord&);
+	void add_hospital(const PlaceRecord&);
+	void add_carpool(const PlaceRecord&);
+	void add_public_transit(const PlaceRecord&);
+	void add_leisure_location(const PlaceRecord&);
 
 	/**
 	 * \brief Assign agents to households, schools, and worplaces
@@ -453,4 +836,37 @@ private:
 	void start_testing_flu_and_vaccination(const bool dont_vac = false);
 };
 
+// Append lambda sums and number present of each place
+template <typename T>
+void ABM::pack_contributions(const std::vector<T>& places)
+{
+	for (const auto& place : places) {
+		const std::vector<double>& sums = place.get_contribution_sum();
+		place_values.insert(place_values.end(), sums.begin(), sums.end());
+		place_values.push_back(place.get_number_present());
+	}
+}
+
+// Set the reduced values, starting at pos
+template <typename T>
+void ABM::unpack_contributions(std::vector<T>& places, size_t& pos)
+{
+	std::vector<double> sums(n_strains, 0.0);
+	for (auto& place : places) {
+		std::copy(place_values.begin() + pos, place_values.begin() + pos + n_strains, sums.begin());
+		pos += n_strains;
+		place.set_global_contributions(sums, static_cast<int>(place_values.at(pos++)));
+	}
+}
+
+// Keep agents simulated by this process
+template <typename T>
+void ABM::retain_owned_agents(std::vector<T>& places)
+{
+	const int rank = comm->rank();
+	for (auto& place : places) {
+		place.retain_agents([this, rank](const int aID){ return agent_owners.at(aID-1) == rank; });
+	}
+}
+
 #endif
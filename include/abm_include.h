@@ -37,9 +37,17 @@
 //
 
 #include <unordered_set>
+#include <numeric>
+#include <thread>
+#include <exception>
+#include <limits>
+#include <memory>
 #include "common.h"
 #include "./io_operations/abm_io.h"
 #include "./io_operations/load_parameters.h"
+#include "./io_operations/mapped_reader.h"
+#include "./io_operations/town_image.h"
+#include "./io_operations/recorder.h"
 #include "agent.h"
 #include "infection.h"
 #include "testing.h"
@@ -48,6 +56,11 @@
 #include "flu.h"
 #include "utils.h"
 #include "mobility.h"
+#include "town.h"
+#include "step_stats.h"
+#include "event_timeline.h"
+#include "distributed/communicator.h"
+#include "distributed/household_partition.h"
 #include "three_part_function.h"
 #include "four_part_function.h"
 #include "vaccinations.h"
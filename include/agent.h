@@ -58,14 +58,14 @@ public:
 			const bool lvRH, const bool wrkRH, const bool wrkSch, const int workID, 
 			const bool worksHospital, const int hospitalID, const bool infected, 
 			const std::string& wt_mode, const double wt_time, const int cp_ID, 
-			const int pt_ID, const bool wfh, const std::vector<std::map<std::string, double>>& tr_rates,
+			const int pt_ID, const bool wfh, std::vector<std::map<std::string, double>> tr_rates,
 			const int tot_strains) 
 			: is_student(student), is_working(works), age(yrs),
 		   		x(xi), y(yi), house_ID(houseID), is_non_covid_patient(isPatient), school_ID(schoolID), 
 				livesRH(lvRH), worksRH(wrkRH), worksSch(wrkSch), work_ID(workID),  
 				works_at_hospital(worksHospital), hospital_ID(hospitalID), is_infected(infected), 
 				work_travel_mode(wt_mode), work_travel_time(wt_time), carpool_ID(cp_ID), 
-				public_transit_ID(pt_ID), works_remotely(wfh), transmission_rates(tr_rates), 
+				public_transit_ID(pt_ID), works_remotely(wfh), transmission_rates(std::move(tr_rates)), 
 				n_strains(tot_strains) { initialize_benefits(); }  
 
 	//
@@ -87,7 +87,7 @@ public:
 	/// Travel time to work
 	double get_work_travel_time() const { return work_travel_time; }
 	/// Travel mode to work
-	std::string get_work_travel_mode() const { return work_travel_mode; }
+	const std::string& get_work_travel_mode() const { return work_travel_mode; }
 	/// Carpool ID
 	int get_carpool_ID() const { return carpool_ID; }
 	/// Public ID
@@ -95,7 +95,7 @@ public:
 	/// Leisure ID 
 	int get_leisure_ID() const { return leisure_location_ID; }
 	/// Leisure type ("household" or "public")
-	std::string get_leisure_type() const { return leisure_type; }
+	const std::string& get_leisure_type() const { return leisure_type; }
 	// Occupation type ('A', 'B', 'C', 'D', or 'E')
 	std::string get_occupation() const { return occupation; }
 	// Each element is a transmission rate for one strain
@@ -210,8 +210,8 @@ public:
 	bool is_up_to_date() const { return vax_up_to_date; }
 	bool got_booster() const { return is_boosted; }
 	bool more_active() const { return is_more_active; }
-	std::string get_vaccine_type(const int val) const { return vaccine_type.at(val-1); }
-	std::string get_vaccine_subtype(const int val) const { return vaccine_subtype.at(val-1); }
+	const std::string& get_vaccine_type(const int val) const { return vaccine_type.at(val-1); }
+	const std::string& get_vaccine_subtype(const int val) const { return vaccine_subtype.at(val-1); }
 	double get_vac_time_offset() const { return vac_offset; }
 	/// Time when the peak benefits of vaccine start dropping 
 	double get_time_vaccine_effects_reduction() const { return time_vac_drop; }
@@ -367,8 +367,8 @@ public:
 	void set_removed_can_vaccinate(const bool val) { was_removed_can_vaccinate = val; }	
 	void set_suspected_can_vaccinate(const bool val) { was_suspected_can_vaccinate = val; }
 	void set_more_active(const bool val) { is_more_active = val; }
-	void set_vaccine_type(const std::string type, const int val) { vaccine_type.at(val-1) = type; }
-	void set_vaccine_subtype(const std::string type, const int val) { vaccine_subtype.at(val-1) = type; }
+	void set_vaccine_type(const std::string& type, const int val) { vaccine_type.at(val-1) = type; }
+	void set_vaccine_subtype(const std::string& type, const int val) { vaccine_subtype.at(val-1) = type; }
 	void set_vac_time_offset(const double val) { vac_offset = val; }
 	/// Time when the peak benefits of vaccine start dropping 
 	void set_time_vaccine_effects_reduction(const double val) { time_vac_drop = val; }
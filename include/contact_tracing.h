@@ -39,21 +39,39 @@ public:
 	 * @param mn - maximum number of visited household IDs stored per agent
 	 */
 	Contact_tracing(const int na, const int nhs, const int mn) : 
-		num_agents(na), num_hs(nhs), max_num_hID(mn) 
-			{ private_leisure.resize(na); is_isolated.resize(num_hs, false); }
+		num_agents(na), num_hs(nhs), max_num_hID(std::max(0, mn)),
+		visits(static_cast<size_t>(na)*max_num_hID), visit_start(na, 0), 
+		visit_count(na, 0), is_isolated(nhs, false) { }
 	
 	//
 	// Main functionality 
 	//
 		
-	/// Add guest household ID to agent aID
+	/// Add guest household ID to agent aID, replaces the oldest if full
 	void add_household(const int aID, const int hID, const int);
 
 	/// Return true if a household is fully quarantined
 	bool house_is_isolated(const int hID) const { return is_isolated.at(hID-1); }
 
 	/// Lift household quarantine
-	void reset_house_isolation(const int hID) { is_isolated.at(hID-1) = false; }
+	void reset_house_isolation(const int hID);
+
+	/// Set the household quarantine flag without tracing or recording the change
+	void set_house_isolation(const int hID, const bool isolated) 
+		{ is_isolated.at(hID-1) = isolated; }
+
+	/**
+	 * \brief Record changes of household isolation flags
+	 * \details Used in distributed runs, where the flags are
+	 *		exchanged between processes once per step
+	 */
+	void track_isolation_changes(const bool track) { track_changes = track; }
+
+	/**
+	 * \brief Changes since the last call, in order
+	 * \details Positive household ID if isolated, negative if lifted
+	 */
+	std::vector<int> take_isolation_changes();
 
 	/// Apply isolation to the household of agent aID
 	std::vector<int> isolate_household(const int aID, const Household& household);
@@ -88,8 +106,9 @@ public:
 	// Getters
 	//
 
-	// Records of visited households
-	std::vector<std::deque<std::vector<int>>> get_private_leisure() const { return private_leisure; }
+	/// Records of visited households of each agent, oldest first, 
+	/// as {household ID, time} - a copy built from the stored visits
+	std::vector<std::deque<std::vector<int>>> get_private_leisure() const;
 
 private:
 	// Number of agents
@@ -99,12 +118,23 @@ private:
 	// Max number of private contacts to store
 	int max_num_hID = 0;
 
-	// Deque of vectors with the following elements:
-	// 0) House IDs from private visits of each agent
-	// 1) Times of visit floored to an integer day
-	std::vector<std::deque<std::vector<int>>> private_leisure;
+	// House ID from a private visit and time of the 
+	// visit floored to an integer day
+	struct Visit {
+		int house_ID;
+		int time;
+	};
+	// Visits of each agent in a ring buffer of max_num_hID entries,
+	// agent aID uses visits starting at (aID-1)*max_num_hID; 
+	// visit_start is the oldest stored and visit_count the number stored
+	std::vector<Visit> visits = {};
+	std::vector<int> visit_start = {};
+	std::vector<int> visit_count = {};
 	// Households isolation flags
 	std::vector<bool> is_isolated;
+	// Record changes of the flags in isolation_changes
+	bool track_changes = false;
+	std::vector<int> isolation_changes = {};
 };
 
 #endif
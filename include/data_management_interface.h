@@ -44,7 +44,7 @@ public:
 	/// Retrieve number of total infected
 	int get_total_infected() const { return n_infected_tot; }
 	/// Retrieve number of total infected with each strain
-	std::vector<int> get_total_infected_strain() const { return n_infected_tot_strain; }
+	const std::vector<int>& get_total_infected_strain() const { return n_infected_tot_strain; }
 	/// Retrieve number of total dead 
 	int get_total_dead() const { return n_dead_tot; }
 	/// Retrieve number of dead that were tested 
@@ -73,6 +73,14 @@ public:
 	const std::vector<int> get_tested_false_positive_day() const { return tested_false_pos_day; }
 	const std::vector<int> get_tested_false_negative_day() const { return tested_false_neg_day; }
 
+	/**
+	 * \brief Reserve memory of the daily statistics
+	 * \details They get one entry at each step, reserving
+	 *		for all the steps of a simulation avoids reallocating them
+	 * @param n_steps - number of steps still to simulate
+	 */
+	void reserve_daily_statistics(const int n_steps);
+
 	//
 	// Saving simulation state
 	//
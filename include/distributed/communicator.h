@@ -0,0 +1,62 @@
+#ifndef COMMUNICATOR_H
+#define COMMUNICATOR_H
+
+#include "../common.h"
+
+/*****************************************************
+ * class: Communicator
+ *
+ * Collective operations between the processes of a
+ * distributed run
+ *
+ * All operations are collective - every process has
+ * to call them in the same order. The ABM uses only
+ * this interface, so the model does not depend on MPI;
+ * MPICommunicator implements it for MPI builds.
+ *
+ ******************************************************/
+
+class Communicator {
+public:
+
+	/// Index of this process, 0 to size()-1
+	virtual int rank() const = 0;
+
+	/// Number of processes
+	virtual int size() const = 0;
+
+	/**
+	 * \brief Element-wise sum over all processes
+	 * \details All processes pass vectors of equal length
+	 * @param values - values of this process, replaced with the sums
+	 */
+	virtual void all_reduce_sum(std::vector<double>& values) = 0;
+
+	/**
+	 * \brief Collect values of all processes in all processes
+	 * \details Lengths can differ between processes
+	 * @param values - values of this process
+	 * @returns Values of each process, index is the rank
+	 */
+	virtual std::vector<std::vector<int>> all_gather(const std::vector<int>& values) = 0;
+
+	virtual ~Communicator() = default;
+};
+
+/*****************************************************
+ * class: SerialCommunicator
+ *
+ * Communicator of a run with a single process
+ *
+ ******************************************************/
+
+class SerialCommunicator : public Communicator {
+public:
+	int rank() const override { return 0; }
+	int size() const override { return 1; }
+	void all_reduce_sum(std::vector<double>& values) override { }
+	std::vector<std::vector<int>> all_gather(const std::vector<int>& values) override
+		{ return {values}; }
+};
+
+#endif
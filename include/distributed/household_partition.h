@@ -0,0 +1,77 @@
+#ifndef HOUSEHOLD_PARTITION_H
+#define HOUSEHOLD_PARTITION_H
+
+#include "../common.h"
+#include "../places/household.h"
+#include "../places/retirement_home.h"
+
+/*****************************************************
+ * class: HouseholdPartition
+ *
+ * Split of households and retirement homes into
+ * spatially compact parts of similar population
+ *
+ * Uses recursive coordinate bisection - homes are
+ * split along the longer side of their bounding box,
+ * at the point where the residents on each side are
+ * proportional to the number of parts assigned to it.
+ * Agents belong to the part of their home, so the
+ * parts have similar numbers of agents, and household
+ * members and neighbours stay in the same part. The
+ * partition depends only on the places, it is the
+ * same in every process.
+ *
+ ******************************************************/
+
+class HouseholdPartition {
+public:
+
+	//
+	// Constructors
+	//
+
+	/**
+	 * \brief Partitions homes weighted by their registered residents
+	 * \details Throws std::invalid_argument if n_parts is less than 1
+	 * @param households - households with registered residents
+	 * @param retirement_homes - retirement homes with registered residents and employees
+	 * @param n_parts - number of parts
+	 */
+	HouseholdPartition(const std::vector<Household>& households,
+						const std::vector<RetirementHome>& retirement_homes,
+						const int n_parts);
+
+	//
+	// Getters
+	//
+
+	/// Part of the household with ID
+	int owner_of_household(const int ID) const { return household_owners.at(ID-1); }
+	/// Part of the retirement home with ID
+	int owner_of_retirement_home(const int ID) const { return retirement_home_owners.at(ID-1); }
+	/// Number of parts
+	int number_of_parts() const { return n_parts; }
+	/// Number of agents registered in the homes of each part
+	const std::vector<int>& get_part_weights() const { return part_weights; }
+
+private:
+	int n_parts = 1;
+	// Part of each home, index is ID-1
+	std::vector<int> household_owners = {};
+	std::vector<int> retirement_home_owners = {};
+	std::vector<int> part_weights = {};
+
+	// Home as seen by the bisection
+	struct Home {
+		double x;
+		double y;
+		int weight;
+		// Owner to assign the part to
+		int* owner;
+	};
+	// Assign homes from first to last to parts first_part to first_part + n - 1
+	void bisect(std::vector<Home>::iterator first, std::vector<Home>::iterator last,
+					const int first_part, const int n);
+};
+
+#endif
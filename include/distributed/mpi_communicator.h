@@ -0,0 +1,42 @@
+#ifndef MPI_COMMUNICATOR_H
+#define MPI_COMMUNICATOR_H
+
+#include <mpi.h>
+#include "communicator.h"
+
+/*****************************************************
+ * class: MPICommunicator
+ *
+ * Communicator of processes started with mpirun
+ *
+ * Uses MPI_COMM_WORLD. MPI needs to be initialized
+ * before creating the object and finalized after the
+ * last collective operation, in the main program.
+ * Only MPI builds compile this class (mpicxx), the
+ * rest of the code does not need it.
+ *
+ ******************************************************/
+
+class MPICommunicator : public Communicator {
+public:
+
+	/**
+	 * \brief Communicator of all processes
+	 * \details Throws std::runtime_error if MPI is not initialized
+	 */
+	MPICommunicator();
+
+	int rank() const override { return my_rank; }
+	int size() const override { return n_ranks; }
+	void all_reduce_sum(std::vector<double>& values) override;
+	std::vector<std::vector<int>> all_gather(const std::vector<int>& values) override;
+
+private:
+	int my_rank = 0;
+	int n_ranks = 1;
+
+	// Throws if an MPI call failed
+	void check(const int err, const std::string& operation) const;
+};
+
+#endif
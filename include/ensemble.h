@@ -0,0 +1,162 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "abm.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+/*****************************************************
+ * struct: EnsembleSetup
+ *
+ * Setup and seeding of every replicate in an ensemble
+ *
+ ******************************************************/
+
+struct EnsembleSetup
+{
+	/// File with all the input files names (input_files_all.txt)
+	std::string input_files = {};
+	/// Time step
+	double dt = 0.25;
+	/// Number of steps to simulate
+	int n_steps = 0;
+	/// Number of initially infected with each strain
+	std::vector<int> inf0 = {};
+	/// Read vaccination and booster offsets from file
+	bool custom_vac_offsets = false;
+	bool custom_boost_offsets = false;
+
+	/// Call initialize_simulations before seeding, with dont_vac
+	bool initialize_simulations = false;
+	bool dont_vac = false;
+
+	/// Seeding as in ABM::initialize_active_cases, skipped if N_active is empty
+	std::vector<int> N_active = {};
+	bool vaccinate = false;
+	std::vector<int> N_vac = {};
+	std::vector<int> N_boost = {};
+	int N_recovered = 0;
+
+	/// Propagate with transmit_with_vac instead of transmit_infection
+	bool transmit_with_vac = false;
+
+	/// Timeline of all replicates and their steps, not recorded if null
+	std::shared_ptr<Tracer> tracer = nullptr;
+};
+
+/*****************************************************
+ * class: Ensemble
+ *
+ * Runs independent stochastic replicates of one model
+ * concurrently, in a single process
+ *
+ * The town, agents, and parameters are set up once;
+ * each replicate is a copy of that model with its own
+ * seeded random number streams. Read-only data (mobility
+ * probabilities) is shared by all the copies. Every
+ * replicate stores the ABM time series metrics at
+ * each step, which are then aggregated over replicates.
+ *
+ ******************************************************/
+
+class Ensemble
+{
+public:
+
+	//
+	// Constructors
+	//
+
+	/**
+	 * \brief Sets up the model shared by all replicates
+	 * @param setup - input files, seeding, and number of steps
+	 * @param n_replicates - number of replicates to run
+	 * @param base_seed - seed from which seeds of replicates are derived
+	 * @param n_threads - number of threads, 0 to use all available
+	 */
+	Ensemble(const EnsembleSetup& setup, const int n_replicates,
+				const unsigned int base_seed = std::random_device()(),
+				const int n_threads = 0);
+
+	//
+	// Simulation
+	//
+
+	/// Run all replicates, blocks until they are done
+	void run();
+
+	//
+	// Results
+	//
+
+	/// Names of the recorded metrics (columns)
+	const std::vector<std::string>& get_metric_names() const { return names; }
+	/// Time at each step
+	const std::vector<double>& get_times() const { return times; }
+
+	/// Metrics of one replicate - outer vector is step, inner metric
+	const std::vector<std::vector<double>>& get_trajectory(const int i) const
+		{ return trajectories.at(i); }
+
+	/// Mean over replicates - outer vector is step, inner metric
+	std::vector<std::vector<double>> get_mean() const;
+	/// Minimum over replicates - outer vector is step, inner metric
+	std::vector<std::vector<double>> get_min() const;
+	/// Maximum over replicates - outer vector is step, inner metric
+	std::vector<std::vector<double>> get_max() const;
+
+	/// Seed of replicate i
+	unsigned int get_seed(const int i) const { return replicate_seed(base_seed, i); }
+
+	/// Number of replicates
+	int get_number_of_replicates() const { return n_replicates; }
+
+	//
+	// Single replicates
+	//
+
+	/**
+	 * \brief Seed, initialize, and run one replicate
+	 * \details Used by all the ensemble-like runners
+	 * @param abm - copy of a model set up without initially infected
+	 * @param setup - seeding and number of steps
+	 * @param seed - seed of this replicate
+	 * @param trajectory - metrics at each step (outer vector), overwritten
+	 */
+	static void simulate(ABM& abm, const EnsembleSetup& setup, const unsigned int seed,
+							std::vector<std::vector<double>>& trajectory);
+
+	/// Seed of replicate i derived from a base seed
+	static unsigned int replicate_seed(const unsigned int base_seed, const int i);
+
+private:
+	EnsembleSetup setup;
+	int n_replicates = 0;
+	unsigned int base_seed = 0;
+	int n_threads = 1;
+
+	// Model after setup, copied by each replicate
+	ABM prototype;
+
+	std::vector<std::string> names = {};
+	std::vector<double> times = {};
+	// Replicate, step, metric
+	std::vector<std::vector<std::vector<double>>> trajectories = {};
+
+	// Next replicate to run, shared by the threads
+	std::atomic<int> next_replicate;
+	// First error in any of the threads
+	std::mutex error_mtx;
+	std::exception_ptr error = nullptr;
+
+	// Runs replicates until none are left
+	void worker();
+	// Set up, seed, and run a single replicate
+	void run_replicate(const int i);
+	// Mean, minimum, or maximum over replicates with a reduction
+	template <typename Reduce>
+	std::vector<std::vector<double>> reduce(Reduce op, const bool average) const;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef EVENT_TIMELINE_H
+#define EVENT_TIMELINE_H
+
+#include "common.h"
+
+/*****************************************************
+ * class: EventTimeline
+ *
+ * Interventions and other scheduled events of
+ * a simulation, keyed by the step they happen at
+ *
+ * Events are kept sorted by step; each step takes
+ * only the events that are due, so the cost of
+ * a step does not depend on how many events are
+ * scheduled later. Events of the same step are
+ * returned in the order they were scheduled.
+ *
+ *****************************************************/
+
+class EventTimeline {
+public:
+
+	/// Types of events
+	enum Type {
+		/// Introduction of a strain, value is the strain ID
+		new_strain,
+		/// New testing fractions, value is the fraction of exposed
+		/// and second_value of symptomatic agents to test
+		testing_change,
+		/// Agents vaccinated per day from now on
+		vaccination_rate,
+		/// Probability of a household to visit a leisure location,
+		/// 0 closes leisure locations
+		leisure_fraction,
+		/// Absenteeism correction of all workplaces
+		workplace_absenteeism,
+		n_types
+	};
+
+	/// Single scheduled event
+	struct Event {
+		Event(const int s, const Type t, const double v = 0.0, const double v2 = 0.0) :
+			step(s), type(t), value(v), second_value(v2) { }
+		int step = 0;
+		Type type = new_strain;
+		double value = 0.0;
+		double second_value = 0.0;
+	};
+
+	/// Iterators over the events due at a step
+	typedef std::vector<Event>::const_iterator const_iterator;
+
+	EventTimeline() = default;
+
+	//
+	// Scheduling
+	//
+
+	/**
+	 * \brief Add an event to the timeline
+	 * \details Events at a step that was already dispatched
+	 *		are returned at the next call of due()
+	 * @param event - event with the step when it happens
+	 */
+	void schedule(const Event& event);
+
+	/**
+	 * \brief Add an event at the step closest to a simulation time
+	 * \details Events before time 0 never happen and are not scheduled
+	 * @param time - simulation time of the event, days
+	 * @param dt - time step, days
+	 * @param type - type of the event
+	 * @param value - first value of the event
+	 * @param second_value - second value of the event
+	 */
+	void schedule_at_time(const double time, const double dt, const Type type,
+						const double value = 0.0, const double second_value = 0.0);
+
+	/// Remove all events
+	void clear() { events.clear(); next = 0; }
+
+	/// Discard the events before step without dispatching them
+	void skip_to(const int step);
+
+	//
+	// Dispatching
+	//
+
+	/**
+	 * \brief Events due at this step
+	 * \details Each event is returned only once; events
+	 *		of earlier steps that were not returned yet are included
+	 * @param step - current step
+	 * @returns Pair of iterators over the due events
+	 */
+	std::pair<const_iterator, const_iterator> due(const int step);
+
+	//
+	// Getters
+	//
+
+	/// Number of events that were not dispatched yet
+	size_t pending() const { return events.size() - next; }
+	/// Step of the next event, -1 if none
+	int next_step() const { return next < events.size() ? events.at(next).step : -1; }
+
+	/// Step closest to a simulation time
+	static int step_of(const double time, const double dt)
+		{ return static_cast<int>(std::lround(time/dt)); }
+
+	/**
+	 * \brief Type from its name in an input file
+	 * \details Throws std::invalid_argument if there is no type with that name
+	 */
+	static Type type_from_name(const std::string& name);
+
+private:
+	// All the events sorted by step
+	std::vector<Event> events = {};
+	// First event that was not dispatched yet
+	size_t next = 0;
+};
+
+#endif
@@ -32,6 +32,9 @@ public:
 	/// \brief Specifies the offset in days for the time Flu agents can be tested
 	void set_testing_duration(const double dt) { testing_period = dt; }
 
+	/// \brief Restart the random number generator from a given seed
+	void seed(const unsigned int s) { rng.seed(s); }
+
 	//
 	//	Flu computations and agent management 
 	//
@@ -68,6 +71,15 @@ public:
 	 */
 	int swap_flu_agent(const int index);
 
+	/**
+	 * \brief Keep only agents for which keep(ID) is true
+	 * \details Used when agents are split between processes,
+	 *		so that new flu cases are agents of this process
+	 * @param keep - predicate taking an agent ID
+	 */
+	template <typename Pred>
+	void retain_agents(Pred keep);
+
 	/// \brief True if agent will get tested
 	bool getting_tested(const Testing& testing)
 		{ return rng.get_random(0,1) <= testing.get_prob_flu_tested(); }
@@ -84,6 +96,9 @@ public:
 	const std::vector<int>& get_susceptible_IDs() const { return susceptible_agent_IDs; }
 	/// \brief Const reference to IDs of agents with flu
 	const std::vector<int>& get_flu_IDs() const { return flu_agent_IDs; }
+	/// \brief IDs of agents given flu by swap_flu_agent since the last call
+	std::vector<int> take_new_flu_IDs() 
+		{ std::vector<int> new_IDs; new_IDs.swap(new_flu_agent_IDs); return new_IDs; }
 
 private:
 	// Fraction of the total susceptible population
@@ -102,6 +117,19 @@ private:
 	std::vector<int> susceptible_agent_IDs;
 	// Susceptible with flu
 	std::vector<int> flu_agent_IDs;
+	// New flu cases from swap_flu_agent, not taken yet
+	std::vector<int> new_flu_agent_IDs;
 };
 
+// Remove agents from both groups
+template <typename Pred>
+void Flu::retain_agents(Pred keep)
+{
+	auto drop = [&keep](const int ID){ return !keep(ID); };
+	susceptible_agent_IDs.erase(std::remove_if(susceptible_agent_IDs.begin(), 
+				susceptible_agent_IDs.end(), drop), susceptible_agent_IDs.end());
+	flu_agent_IDs.erase(std::remove_if(flu_agent_IDs.begin(), 
+				flu_agent_IDs.end(), drop), flu_agent_IDs.end());
+}
+
 #endif
@@ -113,6 +113,24 @@ public:
 	void vector_shuffle(std::vector<double>& v) 
 		{ rng.vector_shuffle(v); }
 
+	/// Restart the random number generator from a given seed
+	void seed(const unsigned int s) { rng.seed(s); }
+
+	/// Moves a uniformly random sample of k elements to the front of v, O(k)
+	void partial_shuffle(std::vector<int>& v, const size_t k)
+		{ rng.partial_shuffle(v, k); }
+	/// k distinct random integers from [0, n) 
+	std::vector<int> sample_without_replacement(const int n, const int k)
+		{ return rng.sample_without_replacement(n, k); }
+	/// Up to k randomly selected elements of [first, last) for which pred is true
+	template <typename Iter, typename Pred>
+	std::vector<Iter> reservoir_sample(Iter first, Iter last, const size_t k, Pred pred)
+		{ return rng.reservoir_sample(first, last, k, pred); }
+	/// Call visit(i) for i in [0, n) in random order until it returns false
+	template <typename Visit>
+	void visit_in_random_order(const size_t n, Visit visit)
+		{ rng.visit_in_random_order(n, visit); }
+
 	/// Return a random number between 0 and 1 according to uniform distribution
 	double get_uniform() { return rng.get_random(0.0, 1.0); }		
 	/// Return a random number between d_min and d_max according to uniform distribution
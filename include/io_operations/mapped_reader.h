@@ -0,0 +1,113 @@
+#ifndef MAPPED_READER_H
+#define MAPPED_READER_H
+
+#include "../common.h"
+
+/***************************************************************
+ * class: MappedReader
+ *
+ * Read-only, memory-mapped access to whitespace separated
+ * tabular files (population and place files)
+ *
+ * The file is mapped once and tokenized in place - fields
+ * are exposed as (pointer, length) views into the mapping
+ * and converted to numbers directly, without creating
+ * intermediate strings. Rows are streamed one at a time.
+ **************************************************************/
+
+class MappedReader
+{
+public:
+
+	/**
+	 * \brief Non-owning view of a single line of the file
+	 * \details Field views are valid as long as the parent
+	 *		MappedReader exists; storage for the views is
+	 *		reused between rows
+	 */
+	class Row
+	{
+	public:
+
+		/// Number of fields in the row
+		size_t size() const { return fields.size(); }
+		/// True if the row has no fields
+		bool empty() const { return fields.empty(); }
+
+		/// Field i converted to an int, throws std::invalid_argument if not an integer
+		int get_int(const size_t i) const;
+		/// Field i converted to a double, throws std::invalid_argument if not a number
+		double get_double(const size_t i) const;
+		/// Field i copied into a std::string
+		std::string get_string(const size_t i) const;
+		/// True if field i is exactly equal to str (no copies)
+		bool equals(const size_t i, const char* str) const;
+
+		/// Pointer to the first character of field i
+		const char* field_begin(const size_t i) const { return fields.at(i).first; }
+		/// Length of field i
+		size_t field_length(const size_t i) const { return fields.at(i).second; }
+
+	private:
+		friend class MappedReader;
+		// Beginning and length of each field
+		std::vector<std::pair<const char*, size_t>> fields;
+	};
+
+	//
+	// Constructors
+	//
+
+	MappedReader() = delete;
+
+	/**
+	 * \brief Maps the file for reading
+	 * \details Throws std::runtime_error if the file cannot be opened or mapped
+	 * @param name - name of the file
+	 */
+	explicit MappedReader(const std::string& name);
+
+	MappedReader(const MappedReader&) = delete;
+	MappedReader& operator=(const MappedReader&) = delete;
+
+	//
+	// Reading
+	//
+
+	/**
+	 * \brief Tokenize the next non-empty line into row
+	 * @param row - Row object to store the field views in
+	 * @returns False if the end of the file was reached
+	 */
+	bool next_row(Row& row);
+
+	/// Move back to the beginning of the file
+	void rewind() { pos = data; }
+
+	/// Number of non-empty lines in the file (does not change the current position)
+	size_t count_rows() const;
+
+	/// Size of the mapped file in bytes
+	size_t size() const { return file_size; }
+
+	/// Beginning of the mapping, for files that are not text
+	const char* raw_data() const { return data; }
+
+	//
+	// Destructor
+	//
+
+	~MappedReader();
+
+private:
+	std::string fname;
+	// Start, end, and current position in the mapping
+	const char* data = nullptr;
+	const char* end = nullptr;
+	const char* pos = nullptr;
+	size_t file_size = 0;
+	// True if memory was mapped (empty files are not)
+	bool mapped = false;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include "../common.h"
+#include "tracer.h"
+
+/***************************************************************
+ * class: Recorder
+ *
+ * Streams named per-step metrics (time series) to a file
+ *
+ * Rows are collected in a fixed size buffer; full buffers are
+ * handed to a background thread that writes them while the
+ * simulation continues. Memory use does not depend on the
+ * number of steps and the output is available during the run.
+ *
+ * Formats:
+ *	csv - header line "time,name_1,...,name_n", one row per step
+ *	binary - "ABMREC" magic padded to 8 bytes, uint32 version,
+ * 		uint32 number of columns (including time), null-terminated
+ *		column names padded to 8 bytes, then one row of doubles
+ *		per step
+ **************************************************************/
+
+class Recorder
+{
+public:
+
+	/// Output formats
+	enum Format { csv, binary };
+
+	/// Version of the binary format
+	static const uint32_t version = 1;
+
+	//
+	// Constructors
+	//
+
+	Recorder() = delete;
+
+	/**
+	 * \brief Opens the output file and starts the writer thread
+	 * \details Throws std::runtime_error if the file cannot be opened
+	 * @param fname - path of the output file
+	 * @param fmt - csv or binary
+	 * @param buffer_rows - number of rows collected before they are written
+	 */
+	Recorder(const std::string& fname, const Format fmt = csv,
+				const size_t buffer_rows = 256);
+
+	Recorder(const Recorder&) = delete;
+	Recorder& operator=(const Recorder&) = delete;
+
+	//
+	// Metrics
+	//
+
+	/**
+	 * \brief Register a new metric (column)
+	 * \details Throws std::runtime_error if called after
+	 *		the first row was recorded
+	 * @param name - name of the metric, used in the header
+	 * @returns Index of the metric to use with set()
+	 */
+	int add_metric(const std::string& name);
+
+	/// Number of registered metrics
+	size_t number_of_metrics() const { return names.size(); }
+	/// Names of the registered metrics, in the order of columns
+	const std::vector<std::string>& get_metric_names() const { return names; }
+
+	/// Set value of a metric for the current row
+	void set(const int metric, const double value) { current.at(metric) = value; }
+
+	//
+	// Recording
+	//
+
+	/**
+	 * \brief Store the current row with a time stamp
+	 * \details Values not set since the last record() are repeated;
+	 *		throws std::runtime_error if writing failed
+	 * @param time - simulation time of the row
+	 */
+	void record(const double time);
+
+	/// Write all the rows recorded so far and wait until they are in the file
+	void flush();
+
+	/// Flush, stop the writer thread, and close the file
+	void close();
+
+	/// Number of rows recorded so far
+	size_t number_of_rows() const { return n_rows; }
+
+	/// Add flushes and writes of the rows to a timeline, null to stop
+	void set_tracer(std::shared_ptr<Tracer> trc);
+
+	//
+	// Destructor
+	//
+
+	~Recorder();
+
+private:
+	std::string fname;
+	Format format = csv;
+	std::ofstream out;
+	std::vector<std::string> names = {};
+	// Current row, without time
+	std::vector<double> current = {};
+	size_t n_rows = 0;
+	size_t max_rows = 0;
+	bool header_written = false;
+	bool closed = false;
+
+	// Rows being collected (time + values each)
+	std::vector<double> filling = {};
+	// Rows handed to the writer thread
+	std::vector<double> pending = {};
+	// Number of columns in a row (time + metrics)
+	size_t n_columns = 1;
+
+	// Writer thread and synchronization
+	std::thread writer;
+	std::mutex mtx;
+	std::condition_variable cv;
+	bool stop = false;
+	bool write_failed = false;
+	// Timeline of the writes, shared with the writer thread
+	std::shared_ptr<Tracer> tracer = nullptr;
+
+	// Hand the filled buffer to the writer, waits if it is still busy
+	void submit();
+	// Loop of the writer thread
+	void write_loop();
+	// Write the header, in the main thread before any rows
+	void write_header();
+	// Write rows stored in data
+	void write_rows(const std::vector<double>& data);
+};
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef TOWN_GENERATOR_H
+#define TOWN_GENERATOR_H
+
+#include <cstdint>
+#include "../common.h"
+#include "../rng.h"
+#include "town_image.h"
+
+/***************************************************************
+ * Settings of a synthetic town
+ *
+ * Place sizes are drawn from the given ranges or distributions,
+ * densities are numbers of agents per place; defaults are
+ * roughly those of a mid-sized US town
+ **************************************************************/
+
+struct TownSettings
+{
+	/// Total number of agents, including retirement home residents and patients
+	int n_agents = 100000;
+	/// Seed of the generator, same seed and settings give the same files
+	unsigned int seed = 2022;
+
+	// Geography
+	/// Latitude and longitude of the town center
+	double center_lat = 40.93, center_lon = -73.78;
+	/// Agents per km2, sets the size of the town
+	double agents_per_km2 = 4000.0;
+	/// Households are clustered into neighborhoods of about this many agents
+	int agents_per_neighborhood = 2500;
+
+	// Households
+	/// Probability of household size 1, 2, ..., the last is the largest size
+	std::vector<double> household_size_probs = {0.28, 0.35, 0.15, 0.13, 0.06, 0.02, 0.01};
+
+	/// Probability of age ranges [age_bins[i], age_bins[i+1]), last bin ends at max_age
+	std::vector<int> age_bins = {0, 5, 10, 15, 20, 25, 35, 45, 55, 65, 75, 85};
+	std::vector<double> age_bin_probs = {0.06, 0.06, 0.065, 0.065, 0.065, 0.135, 0.127,
+											0.125, 0.13, 0.095, 0.048, 0.02};
+	int max_age = 100;
+
+	// Institutions
+	/// Fraction of all agents living in retirement homes, aged 65 or more
+	double fraction_rh_residents = 0.01;
+	/// Residents of one retirement home, inclusive range
+	int min_rh_size = 40, max_rh_size = 160;
+	/// Fraction of all agents that are non-COVID hospital patients
+	double fraction_patients = 0.002;
+	/// Agents per hospital, at least one hospital
+	int agents_per_hospital = 50000;
+
+	// Schools - daycare, primary, middle, high, college
+	/// First and last age (inclusive) of each school type
+	std::vector<int> school_min_age = {0, 5, 11, 14, 18};
+	std::vector<int> school_max_age = {4, 10, 13, 17, 22};
+	/// Probability that an agent of that age attends a school of the type
+	std::vector<double> school_attendance = {0.5, 0.95, 0.95, 0.95, 0.4};
+	/// Mean number of students, actual sizes are within +/- 50%
+	std::vector<int> school_mean_size = {60, 450, 600, 1200, 2500};
+	/// Students per school employee
+	double students_per_school_staff = 12.0;
+
+	// Work
+	/// Fraction employed of ages 18-64 and 65-74, and of students aged 18 or more
+	double employment_adults = 0.65, employment_seniors = 0.2, employment_students = 0.25;
+	/// Retirement home residents per employee
+	double rh_residents_per_staff = 1.5;
+	/// Fraction of all agents working in hospitals
+	double fraction_hospital_staff = 0.01;
+	/// Fractions of regular workers working from home and outside of the town
+	double fraction_wfh = 0.1, fraction_work_outside = 0.1;
+	/// Workplace size ranges (inclusive) and probability of each range
+	std::vector<int> workplace_min_size = {1, 5, 10, 20, 50, 100, 250, 500};
+	std::vector<int> workplace_max_size = {4, 9, 19, 49, 99, 249, 499, 1500};
+	std::vector<double> workplace_size_probs = {0.5, 0.2, 0.13, 0.1, 0.04, 0.02, 0.006, 0.004};
+	/// Workplace types and their probabilities
+	std::vector<std::string> workplace_types = {"A", "B", "C", "D", "E"};
+	std::vector<double> workplace_type_probs = {0.3, 0.35, 0.26, 0.06, 0.03};
+
+	// Transit
+	/// Probabilities of car, carpool, public, walk, and other for commuters
+	std::vector<double> travel_mode_probs = {0.6, 0.1, 0.15, 0.1, 0.05};
+	/// Commute time range in minutes
+	double min_travel_time = 5.0, max_travel_time = 60.0;
+	/// Carpool and public transit route sizes, inclusive ranges
+	int min_carpool_size = 2, max_carpool_size = 4;
+	int min_public_size = 100, max_public_size = 400;
+
+	// Leisure
+	/// Agents per leisure location and fraction of locations outside the town
+	int agents_per_leisure = 100;
+	double fraction_leisure_outside = 0.05;
+};
+
+/***************************************************************
+ * class: TownGenerator
+ *
+ * Synthetic town with all its places and agents
+ *
+ * Generates households, schools, workplaces, hospitals,
+ * retirement homes, carpools, public transit, leisure
+ * locations, and agents for a requested population and
+ * writes them in the format of the NR_*.txt input files.
+ *
+ * Households are clustered into neighborhoods; students of
+ * each school type are filled into schools in household
+ * order, so that schools are local, while workers are
+ * spread over workplaces in the whole town. Place sizes
+ * follow the distributions in TownSettings and are exact,
+ * not only on average. All steps are linear in the number
+ * of agents.
+ **************************************************************/
+
+class TownGenerator
+{
+public:
+
+	//
+	// Constructors
+	//
+
+	/**
+	 * \brief Generates the town
+	 * \details Throws std::invalid_argument for inconsistent settings
+	 * @param settings - population size, seed, and distributions
+	 */
+	explicit TownGenerator(const TownSettings& settings);
+
+	//
+	// Output
+	//
+
+	/**
+	 * \brief Write all place files and the agent file
+	 * \details Files are path + NR_households.txt, NR_schools.txt,
+	 *		NR_workplaces.txt, NR_hospitals.txt, NR_retirement_homes.txt,
+	 *		NR_carpool.txt, NR_public.txt, NR_leisure.txt, and NR_agents.txt;
+	 *		the directory needs to exist. Throws std::runtime_error if a
+	 *		file cannot be written.
+	 * @param path - directory with the trailing separator, or a file name prefix
+	 */
+	void write_files(const std::string& path) const;
+
+	/**
+	 * \brief Input file list for the generated town
+	 * \details Copies the template, a file as passed to
+	 *		ABM::simulation_setup, with the place and agent files
+	 *		replaced by the files written by write_files(path) and
+	 *		without a town image entry. Throws std::runtime_error
+	 *		if a file cannot be opened.
+	 * @param template_file - input file list with parameter files to use
+	 * @param path - same as in write_files
+	 * @param fname - name of the new input file list
+	 */
+	static void write_input_files(const std::string& template_file,
+					const std::string& path, const std::string& fname);
+
+	/// Name of the file of a place type, without the path
+	static std::string place_file_name(const TownImage::PlaceType type);
+	/// Name of the agent file, without the path
+	static std::string agent_file_name() { return "NR_agents.txt"; }
+
+	//
+	// Getters
+	//
+
+	/// Number of places of a type
+	size_t number_of_places(const TownImage::PlaceType type) const
+		{ return places.at(type).size(); }
+	/// Number of agents
+	size_t number_of_agents() const { return agents.size(); }
+
+private:
+
+	// Where an agent lives or works in addition to regular places
+	enum Role : uint8_t { regular, rh_resident, patient, school_staff, rh_staff, hospital_staff };
+	// Travel modes, in the order of TownSettings::travel_mode_probs
+	enum Mode : uint8_t { car, carpool, public_transit, walk, other, no_mode };
+
+	/// Generated place, ID is the index + 1
+	struct GenPlace {
+		double lat = 0.0, lon = 0.0;
+		// Index to the type name of the place type, if it has one
+		int type = 0;
+	};
+
+	/// Generated agent, coordinates are those of its residence
+	struct GenAgent {
+		int age = 0;
+		// Household, retirement home, or hospital
+		int residence_ID = 0;
+		int school_ID = 0, work_ID = 0, hospital_ID = 0;
+		int carpool_ID = 0, public_ID = 0;
+		float travel_time = 0.0f;
+		uint8_t role = regular, mode = no_mode;
+		bool student = false, works = false, wfh = false;
+		int8_t occupation = -1;
+	};
+
+	TownSettings settings;
+	RNG rng;
+	std::vector<std::vector<GenPlace>> places =
+		std::vector<std::vector<GenPlace>>(TownImage::n_place_types);
+	std::vector<GenAgent> agents = {};
+
+	// Geography - corner of the town and its size in degrees,
+	// neighborhood centers and their spread
+	double lat0 = 0.0, lon0 = 0.0, lat_size = 0.0, lon_size = 0.0;
+	std::vector<std::pair<double, double>> neighborhoods = {};
+	double nbh_spread = 0.0;
+
+	// Steps of the generation, in this order
+	void check_settings() const;
+	void create_geography();
+	void create_households();
+	void create_institutions();
+	void create_schools();
+	void create_workplaces();
+	void create_transit();
+	void create_leisure_locations();
+
+	// Location near a random or given neighborhood
+	GenPlace random_location(const int nbh = -1);
+	// Age from the age distribution, at least min_age
+	int random_age(const int min_age);
+	// Index of an outcome drawn from probabilities (need not sum to 1)
+	size_t draw(const std::vector<double>& probs);
+	// Uniform integer from an inclusive range
+	int uniform_int(const int imin, const int imax)
+		{ return rng.get_random_int(imin, imax); }
+
+	// Type names of places that have them
+	std::vector<std::string> type_names(const TownImage::PlaceType type) const;
+	// Coordinates of where the agent lives
+	const GenPlace& residence(const GenAgent& agent) const;
+	void write_places(const std::string& path, const TownImage::PlaceType type) const;
+	void write_agents(const std::string& path) const;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef TOWN_IMAGE_H
+#define TOWN_IMAGE_H
+
+#include <cstdint>
+#include "../common.h"
+#include "mapped_reader.h"
+
+/***************************************************************
+ * Records of places and agents
+ *
+ * Town properties as read from the input files, shared by the
+ * text and the binary (town image) input paths
+ **************************************************************/
+
+/// Properties of a place as given in a place input file
+struct PlaceRecord
+{
+	int ID = 0;
+	// Coordinates, 0 for places without a location (transit)
+	double x = 0.0, y = 0.0;
+	// Type (school type, workplace or leisure location type, ...),
+	// empty if the file does not have one
+	std::string type = {};
+};
+
+/**
+ * \brief Properties of an agent with roles and transit already resolved
+ * \details Work ID, household ID, carpool and public transit IDs,
+ *		and travel mode are set the same way they would be in the
+ *		ABM when reading the agent file directly
+ */
+struct AgentRecord
+{
+	bool student = false, works = false, patient = false, hospital_staff = false;
+	bool lives_RH = false, works_RH = false, works_school = false, works_from_home = false;
+	int age = 0, house_ID = -1, school_ID = 0, work_ID = 0, hospital_ID = 0;
+	int carpool_ID = 0, public_ID = 0;
+	double x = 0.0, y = 0.0, travel_time = 0.0;
+	std::string travel_mode = {};
+	std::string occupation = {};
+};
+
+/***************************************************************
+ * class: TownImage
+ *
+ * Precompiled binary form of all the places and agents
+ * of a town
+ *
+ * The image is a single versioned file with columnar arrays
+ * for each place type and for the agents. It is created once
+ * from the text input files and then memory-mapped on every
+ * subsequent run, without any parsing.
+ *
+ * Layout - header (magic, version) followed by the place
+ * tables in the order of PlaceType and then the agent table;
+ * each table is a number of rows, string dictionaries, and
+ * columns; every block is padded to 8 bytes
+ **************************************************************/
+
+class TownImage
+{
+public:
+
+	/// Place tables in the image, in the order they are stored
+	enum PlaceType { households = 0, schools, workplaces, hospitals,
+		retirement_homes, carpools, public_transit, leisure_locations,
+		n_place_types };
+
+	/// Current version of the format
+	static const uint32_t version = 1;
+
+	//
+	// Constructors
+	//
+
+	TownImage() = delete;
+
+	/**
+	 * \brief Maps and validates an existing image
+	 * \details Throws std::runtime_error if the file is not
+	 *		a town image, is a different version, or is truncated
+	 * @param fname - path to the image
+	 */
+	explicit TownImage(const std::string& fname);
+
+	//
+	// Creation
+	//
+
+	/**
+	 * \brief Creates an image from text input files
+	 * \details Place and agent files are taken from the tagged
+	 *		file with all the input files (as in input_files_all.txt)
+	 * @param input_files - file with tagged input file names
+	 * @param fname - path of the image to create
+	 */
+	static void create(const std::string& input_files, const std::string& fname);
+
+	/**
+	 * \brief Fill a PlaceRecord from one row of a place file
+	 * @param row - tokenized line of the file
+	 * @param has_coordinates - true if columns 2 and 3 are coordinates
+	 * @param record - record to fill
+	 */
+	static void read_place(const MappedReader::Row& row, const bool has_coordinates,
+								PlaceRecord& record);
+
+	/**
+	 * \brief Fill an AgentRecord from one row of an agent file
+	 * \details Resolves roles, work IDs, and transit
+	 * @param row - tokenized line of the file
+	 * @param record - record to fill
+	 */
+	static void read_agent(const MappedReader::Row& row, AgentRecord& record);
+
+	//
+	// Getters
+	//
+
+	/// Number of places of a given type
+	size_t number_of_places(const PlaceType ptype) const
+		{ return place_tables.at(ptype).n_rows; }
+	/// Properties of place with index i (ID-1)
+	void get_place(const PlaceType ptype, const size_t i, PlaceRecord& record) const;
+
+	/// Number of agents
+	size_t number_of_agents() const { return agent_table.n_rows; }
+	/// Properties of agent with index i (ID-1)
+	void get_agent(const size_t i, AgentRecord& record) const;
+
+private:
+
+	// Columns of a place table, pointers into the mapping
+	struct PlaceTable {
+		size_t n_rows = 0;
+		const int32_t* ID = nullptr;
+		const double* x = nullptr;
+		const double* y = nullptr;
+		const uint16_t* type = nullptr;
+		std::vector<std::string> type_names = {};
+	};
+
+	// Columns of the agent table, pointers into the mapping
+	struct AgentTable {
+		size_t n_rows = 0;
+		// Flags, one byte per agent each
+		const uint8_t* flags[8] = {nullptr};
+		const int32_t* ints[7] = {nullptr};
+		const double* doubles[3] = {nullptr};
+		const uint16_t* travel_mode = nullptr;
+		const uint16_t* occupation = nullptr;
+		std::vector<std::string> travel_mode_names = {};
+		std::vector<std::string> occupation_names = {};
+	};
+
+	MappedReader file;
+	std::vector<PlaceTable> place_tables;
+	AgentTable agent_table;
+};
+
+#endif
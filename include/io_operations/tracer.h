@@ -0,0 +1,158 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <iomanip>
+#include "../common.h"
+
+/***************************************************************
+ * class: Tracer
+ *
+ * Timeline of scoped events in Chrome trace format
+ *
+ * Events (simulation steps, their phases, contact tracing,
+ * output) are kept in a ring buffer of fixed size - when it
+ * is full, the oldest events are replaced. At the end of a
+ * run the buffer is written as JSON that can be opened
+ * in chrome://tracing or ui.perfetto.dev. Events from
+ * different threads are shown on separate tracks.
+ *
+ * Event names and categories are not copied, they need to
+ * be string literals or otherwise outlive the tracer.
+ **************************************************************/
+
+class Tracer
+{
+public:
+
+	//
+	// Constructors
+	//
+
+	/**
+	 * \brief Empty timeline starting now
+	 * \details Throws std::invalid_argument if capacity is 0
+	 * @param capacity - maximum number of stored events
+	 */
+	explicit Tracer(const size_t capacity = 1 << 20);
+
+	Tracer(const Tracer&) = delete;
+	Tracer& operator=(const Tracer&) = delete;
+
+	//
+	// Recording
+	//
+
+	/**
+	 * \brief Store a complete event of the calling thread
+	 * \details Safe to call from multiple threads
+	 * @param name - name of the event
+	 * @param category - category of the event, used for filtering
+	 * @param start - start time in microseconds, from now()
+	 * @param duration - duration in microseconds
+	 * @param arg_name - name of an optional numerical argument,
+	 *		nullptr if none
+	 * @param arg_value - value of the argument
+	 */
+	void add_event(const char* name, const char* category,
+					const double start, const double duration,
+					const char* arg_name = nullptr, const double arg_value = 0.0);
+
+	/// Microseconds since the tracer was created
+	double now() const
+		{ return std::chrono::duration<double, std::micro>(
+					std::chrono::steady_clock::now() - origin).count(); }
+
+	/// Remove all the events
+	void clear();
+
+	//
+	// Output
+	//
+
+	/**
+	 * \brief Write the stored events as Chrome trace JSON
+	 * \details Throws std::runtime_error if the file cannot be opened
+	 * @param fname - path of the output file
+	 */
+	void write_json(const std::string& fname) const;
+
+	/// Write the stored events as Chrome trace JSON to a stream
+	void write_json(std::ostream& where) const;
+
+	//
+	// Getters
+	//
+
+	/// Number of stored events
+	size_t number_of_events() const;
+	/// Number of events replaced because the buffer was full
+	size_t number_of_dropped_events() const;
+	/// Maximum number of stored events
+	size_t get_capacity() const { return events.size(); }
+	/// Number of threads that recorded events
+	size_t number_of_threads() const;
+
+	/***************************************************************
+	 * class: Tracer::Scope
+	 *
+	 * Event that lasts from construction to destruction,
+	 * does nothing if the tracer is null
+	 **************************************************************/
+
+	class Scope {
+	public:
+		Scope(Tracer* trc, const char* event_name, const char* event_category,
+				const char* event_arg_name = nullptr, const double event_arg_value = 0.0) :
+			tracer(trc), name(event_name), category(event_category),
+			arg_name(event_arg_name), arg_value(event_arg_value)
+			{ if (tracer) { start = tracer->now(); } }
+		~Scope()
+		{
+			if (tracer) {
+				tracer->add_event(name, category, start,
+									tracer->now() - start, arg_name, arg_value);
+			}
+		}
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	private:
+		Tracer* tracer = nullptr;
+		const char* name = nullptr;
+		const char* category = nullptr;
+		const char* arg_name = nullptr;
+		double arg_value = 0.0;
+		double start = 0.0;
+	};
+
+private:
+	// Complete event, times in microseconds
+	struct Event {
+		const char* name;
+		const char* category;
+		double start;
+		double duration;
+		int thread;
+		const char* arg_name;
+		double arg_value;
+	};
+
+	std::chrono::steady_clock::time_point origin;
+	// Ring buffer, next is the position of the next event
+	std::vector<Event> events = {};
+	size_t next = 0;
+	// All events added since the last clear
+	size_t n_added = 0;
+	// Threads in order of their first event, index is the track
+	std::vector<std::thread::id> threads = {};
+	mutable std::mutex mtx;
+
+	// Track of the calling thread, needs the lock
+	int thread_number();
+	// Quotes and backslashes escaped
+	static std::string escape(const char* text);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define MOBILITY_H
 
 #include <cmath>
+#include <memory>
 #include "io_operations/abm_io.h"
 #include "io_operations/load_parameters.h"
 #include "places/place.h"
@@ -50,13 +51,17 @@ public:
 	/**
 	 * \brief Assign a leisure location - public or residential 
 	 *
-	 * @param infection - instance of the Infection class
+	 * \details Only reads the probabilities, safe to call from several 
+	 *		threads with different generators
+	 * @param gen - source of random numbers with get_uniform() and 
+	 *		get_int(imin, imax), e.g. Infection or StreamRNG
 	 * @param house_ID - ID of the household to be assigned to
 	 * @param in_household - in/out - assigned leisure location is a household 
 	 * @param in_public - in/out - assigned leisure location is public 
 	 * @param household_prob - optional parameter, probability agent will visit a private household 
 	 */
-	int assign_leisure_location(Infection& infection, const int& house_ID, bool& in_household, bool& in_public, const double& household_prob = 0.5);
+	template <typename Gen>
+	int assign_leisure_location(Gen& gen, const int& house_ID, bool& in_household, bool& in_public, const double& household_prob = 0.5);
 
 
 
@@ -84,8 +89,16 @@ public:
 	//
 	
 	std::vector<std::vector<double>> get_public_probabilities()
+		{ return *public_probabilities; }
+
+	/// Read-only probabilities, shared with the caller
+	std::shared_ptr<const std::vector<std::vector<double>>> get_shared_public_probabilities() const
 		{ return public_probabilities; }
 
+	/// Use probabilities constructed elsewhere (e.g. by a Town)
+	void set_shared_public_probabilities(std::shared_ptr<const std::vector<std::vector<double>>> probs)
+		{ public_probabilities = probs; }
+
 	//
 	// IO
 	//
@@ -98,7 +111,9 @@ private:
 	// Probabilities of each household viting 
 	// a given public leisure location
 	// Outer vector: households, inner: public leisure location
-	std::vector<std::vector<double>> public_probabilities;
+	// Read-only after construction - copies of the object share it
+	std::shared_ptr<const std::vector<std::vector<double>>> public_probabilities = 
+		std::make_shared<const std::vector<std::vector<double>>>();
 
 	// Parameters for the probability model
 	double dr0 = 0.0, beta = 0.0, kappa = 0.0;
@@ -110,4 +125,41 @@ private:
 	double pi = 3.14159265358979323846;
 };
 
+// Assign a leisure location - public or residential 
+template <typename Gen>
+int Mobility::assign_leisure_location(Gen& gen, const int& house_ID, 
+				bool& in_household, bool& in_public, const double& household_prob)
+{
+	in_household = false;
+	in_public = false;
+	int pub_ID = 0, guest_ID = 0;
+
+	// Determine if the location will be private of public
+	if (household_prob <= gen.get_uniform()) {	
+		// If a household, randomly select the ID that is not one of current agents
+		guest_ID = house_ID;
+		while (guest_ID == house_ID) {
+			guest_ID = gen.get_int(1, static_cast<int>(public_probabilities->size()));
+		}	
+		in_household = true;
+		return guest_ID;
+	} else {
+		// If a public location - assign based on the probabilities
+		int pub_ID = 0;
+		in_public = true;
+		const double prob = gen.get_uniform();
+		const std::vector<double>& a_house = public_probabilities->at(house_ID-1);
+			
+		// Iterator to the first element with probability >= to prob, 
+		// or one past last if no such element
+		const auto& iter = std::find_if(a_house.cbegin(), a_house.cend(), 
+						[&prob](const double x) { return x >= prob; });
+		// Find and return the ID
+		pub_ID = std::distance(a_house.cbegin(), iter) + 1;
+		in_public = true;
+		return pub_ID;
+	}
+	return 0;
+}
+
 #endif
@@ -0,0 +1,135 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include "ensemble.h"
+#include "io_operations/recorder.h"
+
+/*****************************************************
+ * struct: SweepParameter
+ *
+ * One swept parameter and its values
+ *
+ ******************************************************/
+
+struct SweepParameter
+{
+	/// Parameter map the name refers to
+	enum Target {infection, vaccination};
+
+	/// Name as in the infection or vaccination parameter file
+	std::string name;
+	Target target;
+	/// Values on the grid
+	std::vector<double> values;
+};
+
+/*****************************************************
+ * class: ParameterSweep
+ *
+ * Runs replicates of a model on a grid of parameter
+ * values, in a single process
+ *
+ * The grid is a cartesian product of the values of all
+ * the swept parameters, the last one changing fastest.
+ * Parameters are overridden in memory, the input files
+ * are not changed. If none of the parameters is used
+ * during setup, the town and agents are set up once and
+ * copied for every run; otherwise each grid point is
+ * set up separately. Replicate i uses the same seed at
+ * every grid point. All runs are written to a single
+ * output, with columns for grid point, replicate, and
+ * parameter values, followed by the ABM time series.
+ *
+ ******************************************************/
+
+class ParameterSweep
+{
+public:
+
+	//
+	// Constructors
+	//
+
+	/**
+	 * \brief Checks the grid and sets up the shared model if possible
+	 * @param setup - input files, seeding, and number of steps
+	 * @param parameters - swept parameters and their values
+	 * @param n_replicates - number of replicates at each grid point
+	 * @param base_seed - seed from which seeds of replicates are derived
+	 * @param n_threads - number of threads, 0 to use all available
+	 */
+	ParameterSweep(const EnsembleSetup& setup, const std::vector<SweepParameter>& parameters,
+					const int n_replicates, const unsigned int base_seed = std::random_device()(),
+					const int n_threads = 0);
+
+	//
+	// Simulation
+	//
+
+	/**
+	 * \brief Run all grid points and replicates, blocks until they are done
+	 * \details Rows of each run are contiguous, runs are in order of completion
+	 * @param fname - output file
+	 * @param format - CSV or binary, as in Recorder
+	 */
+	void run(const std::string& fname, const Recorder::Format format = Recorder::csv);
+
+	//
+	// Grid
+	//
+
+	/// Number of grid points
+	int number_of_points() const { return n_points; }
+	/// Parameter values at grid point i, in order of parameters
+	std::vector<double> get_point(const int i) const;
+	/// Number of replicates at each point
+	int get_number_of_replicates() const { return n_replicates; }
+	/// True if each grid point is set up separately
+	bool sets_up_each_point() const { return per_point_setup; }
+
+private:
+	EnsembleSetup setup;
+	std::vector<SweepParameter> parameters = {};
+	int n_replicates = 0;
+	unsigned int base_seed = 0;
+	int n_threads = 1;
+	int n_points = 1;
+	bool per_point_setup = false;
+
+	// Model after setup, copied by each run, if shared by all points
+	std::unique_ptr<ABM> prototype;
+
+	// Models set up for one grid point, released after the last replicate
+	struct PointModel
+	{
+		std::once_flag built;
+		std::unique_ptr<ABM> abm;
+		int remaining = 0;
+	};
+	std::vector<std::unique_ptr<PointModel>> point_models = {};
+	std::mutex point_mtx;
+
+	// Next run, point*n_replicates + replicate
+	std::atomic<int> next_task;
+	// Output shared by the threads
+	Recorder* recorder = nullptr;
+	std::mutex output_mtx;
+	// First error in any of the threads
+	std::mutex error_mtx;
+	std::exception_ptr error = nullptr;
+
+	// Runs until none are left
+	void worker();
+	// Set up, seed, run, and write a single run
+	void run_task(const int task);
+	// Model with parameters of grid point i, set up from the input files
+	std::unique_ptr<ABM> setup_point(const int i) const;
+	// Split parameters of grid point i by target
+	void point_values(const int i, std::map<std::string, double>& infection_values,
+						std::map<std::string, double>& vaccination_values) const;
+	// Write rows of one run
+	void write_run(const int point, const int replicate,
+					const std::vector<std::vector<double>>& trajectory);
+};
+
+#endif
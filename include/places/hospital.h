@@ -118,11 +118,14 @@ public:
   	/// \brief Reset select variables of a place after transmission step
     void reset_contributions() override
  		{ std::fill(lambda_sum.begin(), lambda_sum.end(), 0.0); 
-			std::fill(lambda_tot.begin(), lambda_tot.end(), 0.0); n_tested = 0;}
+			std::fill(lambda_tot.begin(), lambda_tot.end(), 0.0); n_tested = 0; n_remote = 0;}
 
 	/// \brief Contribution takes into account agents tested at current step
 	void compute_infected_contribution() override;
 
+	/// \brief Registered agents and agents tested at current step
+	int get_number_present() const override { return agent_IDs->size() + n_tested; }
+
 	/// \brief Returns number of Flu agents being tested in a hospital at that step
 	int get_n_tested() const { return n_tested; }
 
@@ -2,11 +2,16 @@
 #define PLACE_H
 
 #include "../common.h"
+#include <memory>
 
 /***************************************************** 
  * class: Place
  * 
  * Base class that defines a place  
+ *
+ * Copies of a place share the IDs of registered agents
+ * until one of the copies changes them. Leisure visitors
+ * of the current step are stored separately.
  * 
  *****************************************************/
 
@@ -70,7 +75,18 @@ public:
 	 */
 	virtual void reset_contributions() 
 		{ std::fill(lambda_sum.begin(), lambda_sum.end(), 0.0); 
-			std::fill(lambda_tot.begin(), lambda_tot.end(), 0.0); }
+			std::fill(lambda_tot.begin(), lambda_tot.end(), 0.0); n_remote = 0; }
+
+	/**
+	 * \brief Use sums over all processes of a distributed run
+	 * \details Replaces the lambda sum of this process; agents present
+	 *		in other processes are included in the total number of agents
+	 *		by compute_infected_contribution
+	 * @param sums - lambda sum of each strain, summed over processes
+	 * @param n_present - number of agents present, summed over processes
+	 */
+	void set_global_contributions(const std::vector<double>& sums, const int n_present)
+		{ lambda_sum = sums; n_remote = n_present - get_number_present(); }
 
 	//
 	// Getters
@@ -79,14 +95,27 @@ public:
 	/// Return place ID
 	int get_ID() const { return ID; }
 
-	/// Return IDs of agents registered in this place	
-	std::vector<int> get_agent_IDs() const { return agent_IDs; }
+	/// Return IDs of agents registered in this place, without leisure visitors
+	const std::vector<int>& get_agent_IDs() const { return *agent_IDs; }
+
+	/// Return IDs of agents visiting this place for leisure at this step
+	const std::vector<int>& get_visitor_IDs() const { return visitor_IDs; }
+
+	/// Return total number of agents, including visitors
+	int get_number_of_agents() const { return agent_IDs->size() + visitor_IDs.size(); }
 
-	/// Return total number of agents
-	int get_number_of_agents() const { return agent_IDs.size(); }
+	/// Number of agents that count in compute_infected_contribution, without other processes
+	virtual int get_number_present() const { return agent_IDs->size() + visitor_IDs.size(); }
+
+	/// Sum of contributions added at this step, for each strain
+	const std::vector<double>& get_contribution_sum() const { return lambda_sum; }
+
+	/// True if this place and the other one use the same stored agent IDs
+	bool shares_agent_IDs_with(const Place& other) const 
+		{ return agent_IDs == other.agent_IDs; }
 
 	/// Return probability contribution of infected agents
-	std::vector<double> get_infected_contribution() const { return lambda_tot; }
+	const std::vector<double>& get_infected_contribution() const { return lambda_tot; }
 
 	/// Coordinates
 	double get_x() const { return x; }
@@ -127,13 +156,37 @@ public:
 	 * \brief Add a new agent to this place
 	 * @param index - agent ID (starts with 1)
 	 */
-	void add_agent(const int index) { agent_IDs.push_back(index); }
+	virtual void add_agent(const int index) { own_agent_IDs().push_back(index); }
 
 	/**
 	 * \brief Remove an agent from this place
+	 * \details Does not remove leisure visitors
+	 * @param index - agent ID (starts with 1)
+	 */
+	virtual void remove_agent(const int index);
+
+	/**
+	 * \brief Remove several agents from this place in one pass
+	 * \details Does not remove leisure visitors
+	 * @param IDs - sorted agent IDs (start with 1)
+	 */
+	virtual void remove_agents(const std::vector<int>& IDs);
+
+	/**
+	 * \brief Add a leisure visitor for this step
 	 * @param index - agent ID (starts with 1)
 	 */
-	void remove_agent(const int index);
+	void add_visitor(const int index) { visitor_IDs.push_back(index); }
+
+	/// Remove all leisure visitors, keeps the storage
+	void clear_visitors() { visitor_IDs.clear(); }
+
+	/**
+	 * \brief Keep only the agents and visitors for which keep(ID) is true
+	 * @param keep - predicate taking an agent ID
+	 */
+	template <typename Pred>
+	void retain_agents(Pred keep);
 
 	// Virtual destructor
 	virtual ~Place() = default;
@@ -145,10 +198,15 @@ protected:
 	double x = 0.0, y = 0.0;
 	// Number of strains
 	int n_strains = 0;
-	// IDs of agents in this place
-	std::vector<int> agent_IDs;
+	// IDs of agents in this place - copies of the place share
+	// them until the first change (copy on write)
+	std::shared_ptr<std::vector<int>> agent_IDs = std::make_shared<std::vector<int>>();
+	// IDs of leisure visitors at this step
+	std::vector<int> visitor_IDs = {};
 	// Total number of agents
 	int num_tot = 0;
+	// Agents present in other processes of a distributed run
+	int n_remote = 0;
 
 	// Sum of agents contributions
 	std::vector<double> lambda_sum;	
@@ -158,8 +216,22 @@ protected:
 
 	// Severity correction for symptomatic
 	double ck = 0.0;
+
+	// Agent IDs that only this place uses, copied if shared
+	std::vector<int>& own_agent_IDs();
 };
 
+// New storage with the kept agents
+template <typename Pred>
+void Place::retain_agents(Pred keep)
+{
+	std::vector<int> kept = {};
+	std::copy_if(agent_IDs->begin(), agent_IDs->end(), std::back_inserter(kept), keep);
+	agent_IDs = std::make_shared<std::vector<int>>(std::move(kept));
+	visitor_IDs.erase(std::remove_if(visitor_IDs.begin(), visitor_IDs.end(),
+				[&keep](const int aID){ return !keep(aID); }), visitor_IDs.end());
+}
+
 /// Overloaded ostream operator for I/O
 std::ostream& operator<< (std::ostream& out, const Place& place);
 
@@ -1,6 +1,8 @@
 #ifndef SCHOOL_H
 #define SCHOOL_H
 
+#include <unordered_map>
+#include <unordered_set>
 #include "place.h"
 
 class Place;
@@ -81,6 +83,57 @@ public:
 	
 	double get_absenteeism_correction() const { return psi_emp; }
 
+	/// Students present in the school, grouped by age
+	const std::map<int, std::vector<int>>& get_students_by_age() const 
+		{ return students_by_age; }
+
+	/// Employees present in the school
+	const std::vector<int>& get_employee_IDs() const { return employee_IDs; }
+
+	//
+	// Initialization and update
+	//
+
+	/**
+	 * \brief Register a student of this school
+	 * \details Also adds the student to the class of their age 
+	 * @param agent_ID - global ID of the agent
+	 * @param age - age of the agent
+	 */
+	void register_student(const int agent_ID, const int age);
+
+	/**
+	 * \brief Register an employee of this school
+	 * @param agent_ID - global ID of the agent
+	 */
+	void register_employee(const int agent_ID);
+
+	/**
+	 * \brief Add a registered agent back to this school
+	 * \details Returns students to their class and employees to the staff
+	 * @param index - agent ID (starts with 1)
+	 */
+	void add_agent(const int index) override;
+
+	/**
+	 * \brief Remove an agent from this school, its class, or the staff
+	 * @param index - agent ID (starts with 1)
+	 */
+	void remove_agent(const int index) override;
+
+	/**
+	 * \brief Remove several agents from this school, their classes, or the staff
+	 * @param IDs - sorted agent IDs (start with 1)
+	 */
+	void remove_agents(const std::vector<int>& IDs) override;
+
+	/**
+	 * \brief Keep only the agents for which keep(ID) is true
+	 * @param keep - predicate taking an agent ID
+	 */
+	template <typename Pred>
+	void retain_agents(Pred keep);
+
 	//
  	// I/O
 	//
@@ -99,6 +152,38 @@ private:
 	// Absenteeism correction - student and employee
 	double psi_j = 0.0;
 	double psi_emp = 0.0;
+
+	// Ages of all registered students
+	std::unordered_map<int, int> student_ages = {};
+	// All registered employees
+	std::unordered_set<int> employees = {};
+	// Students present, by age, and employees present
+	std::map<int, std::vector<int>> students_by_age = {};
+	std::vector<int> employee_IDs = {};
+
+	// Keep students and employees present for which keep(ID) is true 
+	template <typename Pred>
+	void retain_classes_and_staff(Pred keep);
 };
 
+// Filter the classes and staff as well
+template <typename Pred>
+void School::retain_agents(Pred keep)
+{
+	Place::retain_agents(keep);
+	retain_classes_and_staff(keep);
+}
+
+template <typename Pred>
+void School::retain_classes_and_staff(Pred keep)
+{
+	auto drop = [&keep](std::vector<int>& IDs) 
+		{ IDs.erase(std::remove_if(IDs.begin(), IDs.end(), 
+				[&keep](const int aID){ return !keep(aID); }), IDs.end()); };
+	for (auto& age_class : students_by_age) {
+		drop(age_class.second);
+	}
+	drop(employee_IDs);
+}
+
 #endif
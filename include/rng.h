@@ -2,6 +2,10 @@
 #define RNG_H
 
 #include <random>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
 
 /***************************************************** 
  * class: RNG
@@ -14,6 +18,22 @@ class RNG
 {
 public:
     RNG() : gen(std::random_device()()) { } 
+	/// Generator with a fixed seed, for reproducible or independent streams
+	explicit RNG(const unsigned int seed) : gen(seed) { } 
+
+	/// Restart the generator from a given seed
+	void seed(const unsigned int s) { gen.seed(s); }
+
+	/// Numbers generated by all generators in this thread, 
+	/// always 0 unless compiled with -DABM_PROFILING
+	static unsigned long long draws_in_this_thread()
+	{
+#ifdef ABM_PROFILING
+		return draw_counter();
+#else
+		return 0;
+#endif
+	}
 
 	/**
 	 *	\brief Random number sampled from uniform distribution
@@ -83,8 +103,195 @@ public:
 		std::shuffle(v.begin(), v.end(), gen);
 	}
 
+	//
+	// Sampling without replacement
+	//
+
+	/**
+	 *	\brief Partial Fisher-Yates shuffle 
+	 *	\details After the call the first k elements of v are a uniformly
+	 *		random sample (in random order) of the original elements; 
+	 *		the rest is left in unspecified order. Cost is O(k). 
+	 *	@param v - vector to sample from, modified in place
+	 *	@param k - number of elements to select, clipped to v.size()
+	 */
+	template <typename T>
+	void partial_shuffle(std::vector<T>& v, size_t k)
+	{
+		const size_t n = v.size();
+		k = std::min(k, n);
+		for (size_t i = 0; i < k; ++i) {
+			std::uniform_int_distribution<size_t> dist(i, n - 1);
+			std::swap(v[i], v[dist(gen)]);
+		}
+	}
+
+	/**
+	 *	\brief k distinct integers from [0, n) with Floyd's algorithm
+	 *	\details Cost is O(k) and independent of n; the order of 
+	 *		the returned values is not random
+	 *	@param n - size of the range, exclusive upper bound
+	 *	@param k - number of integers to select, clipped to n
+	 */
+	std::vector<int> sample_without_replacement(const int n, int k)
+	{
+		k = std::max(0, std::min(k, n));
+		std::vector<int> sample;
+		if (k == 0) {
+			return sample;
+		}
+		sample.reserve(k);
+		std::unordered_set<int> selected;
+		selected.reserve(2*k);
+		for (int j = n - k; j < n; ++j) {
+			std::uniform_int_distribution<int> dist(0, j);
+			int t = dist(gen);
+			if (!selected.insert(t).second) {
+				// Already in the sample - j itself was never drawn
+				t = j;
+				selected.insert(t);
+			}
+			sample.push_back(t);
+		}
+		return sample;
+	}
+
+	/**
+	 *	\brief Reservoir sampling of up to k elements that satisfy a condition
+	 *	\details Single pass over [first, last) without storing the 
+	 *		candidates; useful when their number is not known in advance
+	 *	@param first, last - range to sample from
+	 *	@param k - number of elements to select
+	 *	@param pred - unary predicate, only elements for which it
+	 *		returns true are sampled
+	 *	@returns Iterators to the selected elements, fewer than k
+	 *		if there is not enough qualifying elements
+	 */
+	template <typename Iter, typename Pred>
+	std::vector<Iter> reservoir_sample(Iter first, Iter last, const size_t k, Pred pred)
+	{
+		std::vector<Iter> reservoir;
+		if (k == 0) {
+			return reservoir;
+		}
+		reservoir.reserve(k);
+		// Number of qualifying elements seen so far
+		size_t n_seen = 0;
+		for (; first != last; ++first) {
+			if (!pred(*first)) {
+				continue;
+			}
+			++n_seen;
+			if (reservoir.size() < k) {
+				reservoir.push_back(first);
+			} else {
+				std::uniform_int_distribution<size_t> dist(0, n_seen - 1);
+				const size_t j = dist(gen);
+				if (j < k) {
+					reservoir[j] = first;
+				}
+			}
+		}
+		return reservoir;
+	}
+
+	/**
+	 *	\brief Visit indices [0, n) in random order until told to stop
+	 *	\details Same as shuffling the indices and iterating, but only
+	 *		the visited part of the permutation is drawn, so the cost 
+	 *		is proportional to the number of visited indices, not to n
+	 *	@param n - number of indices
+	 *	@param visit - called with each index, returns false to stop
+	 */
+	template <typename Visit>
+	void visit_in_random_order(const size_t n, Visit visit)
+	{
+		// Positions of a Fisher-Yates shuffle that hold other values
+		std::unordered_map<size_t, size_t> moved;
+		auto value_at = [&moved](const size_t k) 
+			{ const auto it = moved.find(k); return (it == moved.end()) ? k : it->second; };
+		for (size_t i = 0; i < n; ++i) {
+			std::uniform_int_distribution<size_t> dist(i, n - 1);
+			const size_t j = dist(gen);
+			const size_t pick = value_at(j);
+			moved[j] = value_at(i);
+			if (!visit(pick)) {
+				return;
+			}
+		}
+	}
+
 private:
+#ifdef ABM_PROFILING
+	// Mersenne twister that counts its outputs
+	struct CountingEngine : public std::mt19937 {
+		using std::mt19937::mt19937;
+		result_type operator()() { ++draw_counter(); return std::mt19937::operator()(); }
+	};
+	static unsigned long long& draw_counter()
+		{ static thread_local unsigned long long n_draws = 0; return n_draws; }
+	CountingEngine gen;
+#else
     std::mt19937 gen;
+#endif
+};
+
+/***************************************************** 
+ * class: StreamRNG
+ * 
+ * Counter-based random number generator
+ *
+ * Cheap to create for every stream, e.g. for each
+ * household at a given step, so that work split 
+ * between threads draws the same numbers no matter 
+ * which thread does it. Numbers are a SplitMix64 
+ * sequence starting at a mix of the key and stream. 
+ *
+ *****************************************************/
+
+class StreamRNG
+{
+public:
+	/**
+	 *	\brief Generator of one stream
+	 *	@param key - same for all streams of a set, e.g. drawn once per step
+	 *	@param stream - number of the stream in the set, e.g. household ID
+	 */
+	StreamRNG(const unsigned long long key, const unsigned long long stream) :
+		state(mix(key + golden*(stream + 1))) { }
+
+	/// Random number from uniform distribution on [0, 1)
+	double get_uniform() 
+		{ return static_cast<double>(next() >> 11)*(1.0/9007199254740992.0); }
+
+	/**
+	 *	\brief Random integer from uniform distribution 
+	 *	\details Modulo bias is negligible for ranges much smaller than 2^64
+	 *	@param imin - minimum, inclusive
+	 *	@param imax - maximum, inclusive
+	 */
+	int get_int(const int imin, const int imax)
+	{
+		const unsigned long long range = static_cast<unsigned long long>(
+						static_cast<long long>(imax) - imin) + 1;
+		return static_cast<int>(imin + static_cast<long long>(next() % range));
+	}
+
+	/// Numbers drawn so far
+	unsigned long long get_draws() const { return n_draws; }
+
+private:
+	static constexpr unsigned long long golden = 0x9E3779B97F4A7C15ULL;
+	unsigned long long state = 0;
+	unsigned long long n_draws = 0;
+
+	static unsigned long long mix(unsigned long long z)
+	{
+		z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+	unsigned long long next() { ++n_draws; state += golden; return mix(state); }
 };
 
 #endif
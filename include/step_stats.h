@@ -0,0 +1,145 @@
+#ifndef STEP_STATS_H
+#define STEP_STATS_H
+
+#include <chrono>
+#include <iomanip>
+#include "common.h"
+#include "rng.h"
+
+/*****************************************************
+ * class: StepStats
+ *
+ * Time and amount of work in each phase of
+ * a simulation step
+ *
+ * Collected only when the code is compiled with
+ * -DABM_PROFILING. Otherwise the profiling macros
+ * below expand to nothing, there is no cost, and
+ * all the values stay 0. Phases can be nested -
+ * contact tracing is a part of the state transitions,
+ * and its time and RNG draws are included there too.
+ *
+ ******************************************************/
+
+class StepStats {
+public:
+
+	/// Measured phases of a step
+	enum Phase { check_events, vaccinate, distribute_leisure, compute_outside_locations,
+					compute_place_contributions, compute_state_transitions,
+					reset_contributions, contact_tracing, n_phases };
+
+	/// Work counted in each phase
+	enum Counter { agents, place_updates, rng_draws, n_counters };
+
+	StepStats() { reset(); }
+
+	/// True if compiled with -DABM_PROFILING
+	static bool enabled()
+	{
+#ifdef ABM_PROFILING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/// Name of a phase, same as the ABM function
+	static std::string phase_name(const Phase phase);
+	/// Name of a counter
+	static std::string counter_name(const Counter counter);
+
+	//
+	// Collection
+	//
+
+	/// Add one call of a phase that took seconds
+	void add_time(const Phase phase, const double seconds);
+	/// Increase a counter of a phase by n
+	void add_count(const Phase phase, const Counter counter, const unsigned long long n)
+		{ counts.at(phase).at(counter) += n; }
+	/// Count one simulation step
+	void add_step() { ++n_steps; }
+	/// Set everything to 0
+	void reset();
+
+	//
+	// Getters
+	//
+
+	/// Number of simulation steps
+	unsigned long long get_number_of_steps() const { return n_steps; }
+	/// Number of calls of a phase
+	unsigned long long get_number_of_calls(const Phase phase) const { return calls.at(phase); }
+	/// Total time of a phase in seconds
+	double get_total_time(const Phase phase) const { return total_time.at(phase); }
+	/// Longest call of a phase in seconds
+	double get_max_time(const Phase phase) const { return max_time.at(phase); }
+	/// Value of a counter in a phase
+	unsigned long long get_count(const Phase phase, const Counter counter) const
+		{ return counts.at(phase).at(counter); }
+
+	/**
+	 * \brief Print a table with time and counts of each phase
+	 * \details Times are totals and averages per step;
+	 * 	only a note is printed when profiling is disabled
+	 * @param where - output stream
+	 */
+	void print_summary(std::ostream& where) const;
+
+	/*****************************************************
+	 * class: StepStats::Timer
+	 *
+	 * Measures one call of a phase from construction
+	 * to destruction, including the RNG draws made
+	 * by this thread in the meantime
+	 *
+	 ******************************************************/
+
+	class Timer {
+	public:
+		Timer(StepStats& step_stats, const Phase measured) : stats(step_stats), phase(measured),
+				start(std::chrono::steady_clock::now()), draws_at_start(RNG::draws_in_this_thread()) { }
+		~Timer()
+		{
+			const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			stats.add_time(phase, elapsed.count());
+			stats.add_count(phase, rng_draws, RNG::draws_in_this_thread() - draws_at_start);
+		}
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+	private:
+		StepStats& stats;
+		const Phase phase;
+		const std::chrono::steady_clock::time_point start;
+		const unsigned long long draws_at_start;
+	};
+
+private:
+	unsigned long long n_steps = 0;
+	// Per phase
+	std::vector<unsigned long long> calls = {};
+	std::vector<double> total_time = {};
+	std::vector<double> max_time = {};
+	std::vector<std::vector<unsigned long long>> counts = {};
+};
+
+//
+// Instrumentation, no code unless profiling
+//
+
+#ifdef ABM_PROFILING
+/// Time the rest of the enclosing scope as a call of phase
+#define ABM_PROFILE_PHASE(stats, phase) StepStats::Timer abm_profile_timer_((stats), StepStats::phase)
+/// Add n to a counter of phase
+#define ABM_PROFILE_COUNT(stats, phase, counter, n) \
+	(stats).add_count(StepStats::phase, StepStats::counter, (n))
+/// Count a simulation step
+#define ABM_PROFILE_STEP(stats) (stats).add_step()
+#else
+#define ABM_PROFILE_PHASE(stats, phase)
+#define ABM_PROFILE_COUNT(stats, phase, counter, n)
+#define ABM_PROFILE_STEP(stats)
+#endif
+
+#endif
@@ -60,6 +60,13 @@ public:
 	 */
 	bool check_switch_time(const double time);
 
+	/**
+	 * \brief Change the testing fractions from now on
+	 *  @param exp_frac - fraction of exposed agents to test 
+	 *  @param sy_frac - fraction of symptomatic agents to test 
+	 */
+	void change_fractions(const double exp_frac, const double sy_frac);
+
 	//
 	// Getters
 	//
@@ -87,7 +94,8 @@ private:
 	double exposed_fraction_to_get_tested = 0.0;
 	double flu_fraction_to_test = 0.0;
 
-	double time_of_next_change = 0.0;
+	// Negative if no change is scheduled
+	double time_of_next_change = -1.0;
 	std::vector<double> next_testing_fractions = {};
 
 	// Calculates fraction of flu agents to get tested
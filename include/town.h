@@ -0,0 +1,107 @@
+#ifndef TOWN_H
+#define TOWN_H
+
+#include "data_management_interface.h"
+#include "mobility.h"
+#include <memory>
+
+/*****************************************************
+ * class: Town
+ *
+ * Read-only snapshot of the town after setup
+ *
+ * Stores places with their static attributes and the
+ * agents registered in them during setup, and the
+ * leisure location probabilities. Models reference
+ * the town through a shared pointer and keep only
+ * the state that changes during the simulation -
+ * copies of places share the agent IDs with the town
+ * until the simulation changes them. Nothing in a
+ * Town changes after construction, so it can be used
+ * from any number of threads.
+ *
+ ******************************************************/
+
+class Town {
+public:
+
+	//
+	// Constructors
+	//
+
+	/**
+	 * \brief Creates an empty Town
+	 */
+	Town() = default;
+
+	/**
+	 * \brief Creates a Town from a model that was set up
+	 * \details Places are copied, agent IDs and
+	 *		mobility probabilities are shared with the model
+	 * @param model - model after creation of places and agents
+	 * @param mobility - leisure mobility of that model
+	 */
+	Town(const DataManagementInterface& model, const Mobility& mobility);
+
+	//
+	// Getters
+	//
+
+	/// Places as registered during setup
+	const std::vector<Household>& get_households() const { return households; }
+	const std::vector<RetirementHome>& get_retirement_homes() const { return retirement_homes; }
+	const std::vector<School>& get_schools() const { return schools; }
+	const std::vector<Workplace>& get_workplaces() const { return workplaces; }
+	const std::vector<Hospital>& get_hospitals() const { return hospitals; }
+	const std::vector<Transit>& get_carpools() const { return carpools; }
+	const std::vector<Transit>& get_public_transit() const { return public_transit; }
+	const std::vector<Leisure>& get_leisure_locations() const { return leisure_locations; }
+
+	/// Probabilities of each household (outer) visiting a public leisure location (inner)
+	const std::vector<std::vector<double>>& get_public_probabilities() const
+		{ return *public_probabilities; }
+	/// Same probabilities, shared with the caller
+	std::shared_ptr<const std::vector<std::vector<double>>> get_shared_public_probabilities() const
+		{ return public_probabilities; }
+
+	/// Number of places of all types
+	size_t number_of_places() const;
+
+	/**
+	 * \brief Number of places of a model that still use the agent IDs stored here
+	 * @param model - model set up with this town or a copy of one
+	 */
+	size_t number_of_shared_places(const DataManagementInterface& model) const;
+
+private:
+	std::vector<Household> households = {};
+	std::vector<RetirementHome> retirement_homes = {};
+	std::vector<School> schools = {};
+	std::vector<Workplace> workplaces = {};
+	std::vector<Hospital> hospitals = {};
+	std::vector<Transit> carpools = {};
+	std::vector<Transit> public_transit = {};
+	std::vector<Leisure> leisure_locations = {};
+
+	std::shared_ptr<const std::vector<std::vector<double>>> public_probabilities =
+		std::make_shared<const std::vector<std::vector<double>>>();
+
+	// Number of places in two vectors that share the agent IDs
+	template <typename T>
+	size_t count_shared(const std::vector<T>& mine, const std::vector<T>& theirs) const;
+};
+
+// Places that share agent IDs, pairwise
+template <typename T>
+size_t Town::count_shared(const std::vector<T>& mine, const std::vector<T>& theirs) const
+{
+	size_t n_shared = 0;
+	for (size_t i = 0; i < std::min(mine.size(), theirs.size()); ++i) {
+		if (mine[i].shares_agent_IDs_with(theirs[i])) {
+			++n_shared;
+		}
+	}
+	return n_shared;
+}
+
+#endif
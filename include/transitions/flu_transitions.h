@@ -24,6 +24,7 @@
 #include "../states_manager/regular_states_manager.h"
 #include "../flu.h"
 #include "../testing.h"
+#include "state_changes.h"
 
 /***************************************************** 
  * class: FluTransitions 
@@ -46,7 +47,7 @@ public:
 
 	/// \brief Implement transitions relevant to susceptible
 	/// \details Returns 1 if the agent got infected 
-	std::vector<int> susceptible_transitions(Agent& agent, const double time, Infection& infection,	
+	SusceptibleChanges susceptible_transitions(Agent& agent, const double time, Infection& infection,	
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 			    std::vector<RetirementHome>& retirement_homes,
@@ -85,16 +86,20 @@ public:
 					Flu& flu, const Testing& testing);
 private:
 
+	// Total lambda of the current susceptible agent, reused for all agents
+	std::vector<double> lambda_buffer = {};
 	// For changing agent states
 	RegularStatesManager states_manager;
 
-	/// \brief Return total lambda of susceptible agent
-	std::vector<double> compute_susceptible_lambda(const Agent& agent, const double time, 
+	/// \brief Compute total lambda of susceptible agent
+	/// \details Stored in lambda_tot, which keeps its memory between calls
+	void compute_susceptible_lambda(const Agent& agent, const double time, 
 					const std::vector<Household>& households, const std::vector<School>& schools,
 					const std::vector<Workplace>& workplaces, const std::vector<Hospital>& hospitals,
 					const std::vector<RetirementHome>& retirement_homes,
 					const std::vector<Transit>& carpools, const std::vector<Transit>& public_transit,
-					const std::vector<Leisure>& leisure_locations, const int);
+					const std::vector<Leisure>& leisure_locations, const int n_strains,
+					std::vector<double>& lambda_tot);
 
 	/// \brief Compte and set agent properties related to recovery without symptoms and incubation
 	void recovery_and_incubation(Agent& agent, Infection& infection, const double time,
@@ -20,6 +20,7 @@
 #include "../infection.h"
 #include "../states_manager/hsp_employee_states_manager.h"
 #include "../flu.h"
+#include "state_changes.h"
 
 /***************************************************** 
  * class: HspPatientTransitions 
@@ -49,7 +50,7 @@ public:
 
 	/// \brief Implement transitions relevant to exposed
 	/// \details Return 1 if recovered without symptoms 
-	std::vector<int> exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, std::vector<Household>& households,
+	InfectedChanges exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, std::vector<Household>& households,
 				std::vector<Hospital>& hospitals, const std::map<std::string, double>& infection_parameters, const Testing& testing);
 
 	/// \brief Determine any testing related properties
@@ -59,7 +60,7 @@ public:
 
 	/// \brief Transitions of a symptomatic agent 
 	/// @return Vector where first entry is one if agent recovered, second if agent died
-	std::vector<int> symptomatic_transitions(Agent& agent, const double time, 
+	InfectedChanges symptomatic_transitions(Agent& agent, const double time, 
 				const double dt, Infection& infection, std::vector<Household>& households,
 				std::vector<Hospital>& hospitals, const std::map<std::string, double>& infection_parameters);
 
@@ -87,12 +88,16 @@ public:
 
 private:
 
+	// Total lambda of the current susceptible agent, reused for all agents
+	std::vector<double> lambda_buffer = {};
 	// For changing agent states
 	HspEmployeeStatesManager states_manager;
 
-	/// \brief Return total lambda of susceptible agent
-	std::vector<double> compute_susceptible_lambda(const Agent& agent, const double time, 
-					const std::vector<Hospital>& hospitals, const int);
+	/// \brief Compute total lambda of susceptible agent
+	/// \details Stored in lambda_tot, which keeps its memory between calls
+	void compute_susceptible_lambda(const Agent& agent, const double time, 
+					const std::vector<Hospital>& hospitals, const int n_strains,
+					std::vector<double>& lambda_tot);
 
 	/// \brief Compte and set agent properties related to recovery without symptoms and incubation
 	void recovery_and_incubation(Agent& agent, Infection& infection, const double time,
@@ -100,7 +105,7 @@ private:
 	
 	/// \brief Verifies and manages removal of an agent from the model
 	/// @return Vector where first entry is one if agent recovered, second if agent died
-	std::vector<int> check_agent_removal(Agent& agent, const double time,
+	RemovalChanges check_agent_removal(Agent& agent, const double time,
 					std::vector<Household>& households, std::vector<Hospital>& hospitals,
  					const std::map<std::string, double>& infection_parameters);
 
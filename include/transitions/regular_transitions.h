@@ -24,6 +24,7 @@
 #include "../states_manager/regular_states_manager.h"
 #include "../flu.h"
 #include "../testing.h"
+#include "state_changes.h"
 
 /***************************************************** 
  * class: RegularTransitions 
@@ -57,7 +58,7 @@ public:
 
 	/// \brief Implement transitions relevant to exposed
 	/// \details Return 1 if recovered without symptoms 
-	std::vector<int> exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
+	InfectedChanges exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 				std::vector<RetirementHome>& retirement_homes,
@@ -74,7 +75,7 @@ public:
 
 	/// \brief Transitions of a symptomatic agent 
 	/// @return Vector where first entry is one if agent recovered, second if agent died
-	std::vector<int> symptomatic_transitions(Agent& agent, const double time, 
+	InfectedChanges symptomatic_transitions(Agent& agent, const double time, 
 				const double dt, Infection& infection,
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
@@ -131,18 +132,22 @@ public:
 	void recovery_status_ICU(Agent& agent, Infection& infection, const double time,
 										const std::map<std::string, double>& infection_parameters);
 
+	/// \brief Compute total lambda of susceptible agent
+	/// \details Stored in lambda_tot, which keeps its memory between calls
+	void compute_susceptible_lambda(const Agent& agent, const double time, 
+					const std::vector<Household>& households, const std::vector<School>& schools,
+					const std::vector<Workplace>& workplaces, const std::vector<RetirementHome>& retirement_homes,
+					const std::vector<Transit>& carpools, const std::vector<Transit>& public_transit,
+					const std::vector<Leisure>& leisure_locations, const int n_strains,
+					std::vector<double>& lambda_tot);
+
 private:
 
+	// Total lambda of the current susceptible agent, reused for all agents
+	std::vector<double> lambda_buffer = {};
 	// For changing agent states
 	RegularStatesManager states_manager;
 
-	/// \brief Return total lambda of susceptible agent
-	std::vector<double> compute_susceptible_lambda(const Agent& agent, const double time, 
-					const std::vector<Household>& households, const std::vector<School>& schools,
-					const std::vector<Workplace>& workplaces, const std::vector<RetirementHome>& retirement_homes,
-					const std::vector<Transit>& carpools, const std::vector<Transit>& public_transit,
-					const std::vector<Leisure>& leisure_locations, const int n_strains);
-
 	/// \brief Compte and set agent properties related to recovery without symptoms and incubation
 	void recovery_and_incubation(Agent& agent, Infection& infection, const double time,
 				                const std::map<std::string, double>& infection_parameters, const int);
@@ -158,7 +163,7 @@ private:
 
 	/// \brief Verifies and manages removal of an agent from the model
 	/// @return Vector where first entry is one if agent recovered, second if agent died
-	std::vector<int> check_agent_removal(Agent& agent, const double time,
+	RemovalChanges check_agent_removal(Agent& agent, const double time,
 					std::vector<Household>& households, std::vector<School>& schools,
 					std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 				 	std::vector<RetirementHome>& retirement_homes,
@@ -0,0 +1,26 @@
+#ifndef STATE_CHANGES_H
+#define STATE_CHANGES_H
+
+#include <array>
+
+/*****************************************************
+ *
+ * State changes of a single agent at a single step 
+ *
+ * Fixed-size so that transitions of an agent
+ * don't allocate; a value of 1 means the change
+ * happened, 0 that it did not
+ *
+ *****************************************************/
+
+/// Susceptible agent: infected, tested, tested negative, tested false positive
+typedef std::array<int, 4> SusceptibleChanges;
+
+/// \brief Exposed or symptomatic agent: recovered, dead, tested, tested positive, tested false negative
+/// \details Dead is 1 if the agent died after testing, 2 if without testing
+typedef std::array<int, 5> InfectedChanges;
+
+/// Agent removed from the model: recovered, dead
+typedef std::array<int, 2> RemovalChanges;
+
+#endif
@@ -34,6 +34,9 @@
 #include "../testing.h"
 #include "../contact_tracing.h"
 
+/// Agents to remove from places, as place and agent ID pairs
+typedef std::vector<std::pair<Place*, int>> PlaceRemovals;
+
 /***************************************************** 
  * class: Transitions 
  *
@@ -63,21 +66,26 @@ public:
 										std::vector<RetirementHome>& retirement_homes,
 										std::vector<Transit>& carpools, 
 										std::vector<Transit>& public_transit, 
-										Contact_tracing& contact_tracing,
-				const std::map<std::string, double>& infection_parameters);
+										Contact_tracing& contact_tracing, const int n_strains);
 
-	/// Transitions related to quarantining an agent as part of contact tracing
+	/// \brief Transitions related to quarantining an agent as part of contact tracing
+	/// \details If removals are given, removals from public places are stored
+	///		there for remove_from_places instead of being applied now
 	void new_quarantined(Agent& agent, const double time, 
 				const double dt, Infection& infection, 
 				std::vector<Household>& households,	std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 				std::vector<RetirementHome>& retirement_homes,
 				std::vector<Transit>& carpools, std::vector<Transit>& public_transit,
-				const std::map<std::string, double>& infection_parameters);
+				const std::map<std::string, double>& infection_parameters,
+				PlaceRemovals* removals = nullptr);
+
+	/// Apply and clear stored removals, each place changes once 
+	static void remove_from_places(PlaceRemovals& removals);
 
 	/// \brief Implement transitions relevant to susceptible
 	/// \details Returns 1 if the agent got infected 
-	std::vector<int> susceptible_transitions(Agent& agent, const double time, 
+	SusceptibleChanges susceptible_transitions(Agent& agent, const double time, 
 				const double dt, Infection& infection,	
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
@@ -89,7 +97,7 @@ public:
 
 	/// \brief Implement transitions relevant to exposed
 	/// \details Return 1 if recovered without symptoms 
-	std::vector<int> exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
+	InfectedChanges exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 				std::vector<RetirementHome>& retirement_homes,
@@ -98,7 +106,7 @@ public:
 
 	/// \brief Transitions of a symptomatic agent 
 	/// @return Vector where first entry is one if agent recovered, second if agent died
-	std::vector<int> symptomatic_transitions(Agent& agent, const double time, 
+	InfectedChanges symptomatic_transitions(Agent& agent, const double time, 
 				const double dt, Infection& infection,
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
@@ -11,11 +11,17 @@
  */
 std::string str_to_lower(std::string s); 
 	
-/// Combine contributions from different lambdas
-/// @lambdas - vector of lambda vectors for each location to add
-/// @mult - <i, multiplication factors> - lambda vector i will be multiplied by the multiplication factor 
-std::vector<double> add_lambdas(std::vector<std::vector<double>>&& lambdas, 
-					std::map<int, const std::vector<double>&>&& mult);
+/// Add contributions of a location to the total lambda, in place
+/// @lambda_tot - total lambda for each strain, same size as lambda 
+/// @lambda - lambda of the location for each strain 
+void add_lambda(std::vector<double>& lambda_tot, const std::vector<double>& lambda);
+
+/// Add contributions of a location multiplied by a factor of each strain, in place
+/// @lambda_tot - total lambda for each strain, same size as lambda 
+/// @lambda - lambda of the location for each strain 
+/// @factor - multiplication factors for each strain 
+void add_lambda(std::vector<double>& lambda_tot, const std::vector<double>& lambda,
+					const std::vector<double>& factor);
 
 /**
  * \brief Compare num1 and num2 as inexact values
@@ -1,7 +1,9 @@
 #ifndef VACCINATIONS_H
 #define VACCINATIONS_H
 
+#include <array>
 #include <forward_list>
+#include <limits>
 #include "common.h"
 #include "utils.h"
 #include "./io_operations/abm_io.h"
@@ -73,9 +75,9 @@ public:
 	 * @param infection_parameters - map of property-value pairs
 	 * @param time - current time
 	 *
-	 * @returns the number of vaccinated agents 
+	 * @returns the number of vaccinated and boosted agents 
 	 */
-	std::vector<int> vaccinate_random(std::vector<Agent>& agents, int n_vac, 
+	std::array<int, 2> vaccinate_random(std::vector<Agent>& agents, int n_vac, 
 							int n_boost, Infection& infection, const double time);
 	/**
 	 * \brief Randomly vaccinates requested number of agents with a negative time offset
@@ -120,6 +122,17 @@ public:
 	/// Get const reference to vaccination properties (for testing)
 	const std::map<std::string, std::map<std::string, std::vector<std::vector<double>>>>& get_vaccination_data() const { return vac_types_properties; }
 
+	/**
+	 * \brief Change a single vaccination parameter
+	 * \details Properties with respect to other strains and type 
+	 *		probabilities are recomputed; throws std::invalid_argument 
+	 *		if there is no such parameter or if it determines the files 
+	 *		that are loaded (strain ID and number of strains or types) 
+	 * @param name - name of the parameter as in the input file
+	 * @param value - new value
+	 */
+	void set_parameter(const std::string& name, const double value);
+
 	/// Const reference to vaccination parameter map
 	const std::map<std::string, double>& get_vaccination_parameters() const 
 		{ return vaccination_parameters; }
@@ -132,26 +145,90 @@ public:
 
 	/// Minimum age to get vaccinated
 	int get_min_vac_age() const { return vaccination_parameters.at("Minimum vaccination age"); }
+
+	//
+	// Eligibility index
+	//
+
+	/**
+	 * \brief Keep the eligible agents and members of each group in an index 
+	 * \details Builds the index from all the agents; from then on random and 
+	 *		group vaccinations and eligibility counts use the index, so every
+	 *		change of an agent that can affect check_general needs to be
+	 *		followed by update_eligibility. Agents vaccinated here are updated
+	 *		automatically. Changing a parameter stops the tracking.
+	 * @param agents - all the agents in the simulation
+	 */
+	void track_eligibility(const std::vector<Agent>& agents);
+
+	/// Update the index after changes of the agent, nothing if not tracking
+	void update_eligibility(const Agent& agent);
+
+	/// True if the eligibility index is in use
+	bool tracks_eligibility() const { return tracking; }
+
 	/// Vaccinates agents with provided IDs and sets all the agent properties
 	void vaccinate_and_setup(std::vector<Agent>& agents, std::vector<int>& agent_IDs,
 								Infection& infection, const double time);
 	/// Vaccinates agents with provided IDs and sets all the agent properties while applying a negative time offset
 	void vaccinate_and_setup_time_offset(std::vector<Agent>& agents, std::vector<int>& agent_IDs, 
 										Infection& infection, const double time, const int n_boosted);
+
+	/**
+	 * \brief Select agents eligible for vaccination based on criteria valid for all agents
+	 *
+	 * @param agents - all the agents in the simulation
+	 * @param max_boost - number of agents that are eligible for booster shots 
+	 *
+     * @returns - vector of IDs of eligible agents (index in the vector is ID-1)
+	 */
+	std::vector<int> filter_general(const std::vector<Agent>& agents, int& max_boost);
+
 private:
 
 	// Path to the file with vaccination parameters
 	std::string input_file;
 	// Map of property tag - property value pairs
 	std::map<std::string, double> vaccination_parameters;
-	// Map of vaccination types and probabilities of receiving them
-	// The probabilities for subtypes of each general type are assumed to be a CDF
-	// General types are "one dose" and "two doses", and subtypes are the specific
-	// vaccination variants (e.g. two doses type 1 can be Moderna, and type 2 Pheizer) 
-	std::map<std::string, std::vector<double>> vac_types_probs;
 	// Outer maps are vaccination types, inner are properties altered by
 	// vaccinating in an extent that correspond to each type
 	std::map<std::string, std::map<std::string, std::vector<std::vector<double>>>> vac_types_properties;
+
+	// (t,y) points of a benefit
+	typedef std::vector<std::vector<double>> BenefitPoints;
+	// Benefits in the order of the compiled tables and their names 
+	// in vac_types_properties
+	enum Benefit { effectiveness, asymptomatic, transmission, severe, death, n_benefits };
+	std::vector<std::string> benefit_names = {"effectiveness", "asymptomatic", 
+				"transmission", "severe", "death"};
+	// Vaccine subtype compiled from vac_types_properties so that 
+	// vaccinating an agent does not look up or build any tags
+	struct VaccineType {
+		// Subtype tag and its tag after a booster
+		std::string tag = {};
+		std::string booster_tag = {};
+		// Points of each benefit with respect to each strain, 
+		// index is strain ID - 1 and then Benefit
+		std::vector<std::vector<BenefitPoints>> benefits = {};
+	};
+	// General types are "one dose" and "two doses", and subtypes are the specific
+	// vaccination variants (e.g. two doses type 1 can be Moderna, and type 2 Pheizer);
+	// index is subtype number - 1 
+	std::vector<VaccineType> one_dose_types = {};
+	std::vector<VaccineType> two_dose_types = {};
+	// Probabilities of receiving each subtype of a general type, a CDF
+	std::vector<double> one_dose_CDF = {};
+	std::vector<double> two_dose_CDF = {};
+	// Parameters used for each vaccinated agent, NaN if not in the input
+	double frac_one_dose = 0.0;
+	double frac_boosters = 0.0;
+	double third_dose_max_time = 0.0;
+	double third_dose_max_end = 0.0;
+	double third_dose_end = 0.0;
+	double offset_start = 0.0;
+	double offset_end = 0.0;
+	// Reused points of benefits after a booster
+	BenefitPoints booster_points = {{0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}};
 	// Vector with time offsets
 	std::vector<double> time_offsets;
 	// Vector with time offsets (boosters)
@@ -164,13 +241,67 @@ private:
 	int num_strains = 0;
 	// Reduction factors for benefits with respect to each other strain
 	std::vector<std::map<std::string, double>> other_strains;
+	// Minimum vaccination age, from the parameters
+	double min_vac_age = 0.0;
+
+	// Agents in a set with their positions for constant time updates 
+	struct EligibleIndex {
+		std::vector<int> IDs = {};
+		// Position of each agent in IDs, -1 if not in the set
+		std::vector<int> positions = {};
+		void set(const int agent_ID, const bool eligible);
+	};
+	// True if the index is used instead of checking all agents
+	bool tracking = false;
+	// Agents eligible for vaccination
+	EligibleIndex eligible;
+	// Agents vaccinated for this strain that need the next vaccination,
+	// the max_boost of filter_general, flag of each agent and total
+	std::vector<char> boost_due = {};
+	int n_boost_due = 0;
+	// Names of the groups of check_group, eligible members of each, 
+	// and bits of the groups of each agent (bit i for group i)
+	std::vector<std::string> group_names = {"hospital employees", "school employees",
+				"retirement home employees", "retirement home residents"};
+	std::vector<EligibleIndex> eligible_groups = {};
+	std::vector<unsigned char> agent_groups = {};
+	// Eligible agents found by checking all the agents when not tracking
+	std::vector<int> checked_eligible = {};
+
+	/// Eligible agents and number of boosts, from the index or all the agents
+	const std::vector<int>& eligible_agents(const std::vector<Agent>& agents, int& max_boost);
+	/// Eligible agents of a group, from the index or all the agents
+	const std::vector<int>& eligible_group_agents(const std::vector<Agent>& agents, 
+						const std::string& group_name);
+	/// Randomly selected n_vac from the eligible, all if as many
+	std::vector<int> select_eligible(const std::vector<int>& can_be_vaccinated, 
+						const int n_vac, Infection& infection);
+	/// Update the index for agents that were just vaccinated
+	void update_eligibility(const std::vector<Agent>& agents, const std::vector<int>& agent_IDs);
 
 	/// Load parameters related to vaccinations store in a map
 	void load_vaccination_parameters(const std::string&, const std::string&);
 
+	/// Compute type probabilities and other strain properties from the parameters
+	void derive_from_parameters();
+
 	/// Create a parameter entry in vac_types_properties for another strain
 	void add_other_strain(const std::string&, const std::string&, const std::map<std::string, double>&);
 
+	/// Compile the types, their CDFs and benefits for all strains into tables 
+	void compile_vaccine_types(const std::string& dose, const std::string& number_tag,
+				std::vector<VaccineType>& types, std::vector<double>& cdf);
+
+	/// Subtype with the probability cur_prob in the CDF
+	const VaccineType& select_type(const std::vector<VaccineType>& types, 
+				const std::vector<double>& cdf, const double cur_prob) const;
+
+	/// Compiled subtype with this tag 
+	const VaccineType& find_type(const std::string& tag) const;
+
+	/// Value of a parameter used for each agent, throws if it was not in the input
+	double required(const double value, const char* name) const;
+
 	/// Load and shuffle time custom offsets 
 	void load_and_shuffle_time_offsets(const std::string&, Infection&);
 
@@ -181,16 +312,6 @@ private:
 	void copy_vaccination_dependencies(std::forward_list<double>&& lst,
 			std::vector<std::vector<double>>& vec);
 
-	/**
-	 * \brief Select agents eligible for vaccination based on criteria valid for all agents
-	 *
-	 * @param agents - all the agents in the simulation
-	 * @param max_boost - number of agents that are eligible for booster shots 
-	 *
-     * @returns - vector of IDs of eligible agents (index in the vector is ID-1)
-	 */
-	std::vector<int> filter_general(const std::vector<Agent>& agents, int& max_boost);
-	
 	/**
 	 * \brief Select agents in a given group eligible for vaccination based on criteria valid for all agents
 	 *
@@ -210,14 +331,19 @@ private:
 	bool check_group(const Agent& agent, const std::string& group_name);
 
 	/// Assign benefits for this strain and other relevant strains for one dose vaccine
-	void set_regular_one_dose(Agent& agent, const std::string& tag, const double time);
+	void set_regular_one_dose(Agent& agent, const VaccineType& vac_type, const double time);
 	
 	/// Assign benefits for this strain and other relevant strains for two dose vaccine
-	void set_regular_two_dose(Agent& agent, const std::string& tag, const double time);
+	void set_regular_two_dose(Agent& agent, const VaccineType& vac_type, const double time);
 
 	/// Assign benefits for a booster that consider other relevant strains 
-	void set_booster(Agent& agent, const std::string& tag, const double time, 
+	void set_booster(Agent& agent, const VaccineType& vac_type, const double time, 
 								const double next_step, const double max_end, const double tot_end);
+
+	/// Benefit from its current value to the maximum of the type after a booster, then as usual
+	ThreePartFunction booster_benefit(const BenefitPoints& type_points, const double current, 
+								const double end_value, const double time, const double next_step, 
+								const double max_end, const double tot_end);
 };
 
 #endif
@@ -80,6 +80,10 @@ int main()
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
     std::cout << "Time difference = " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "[ms]" << std::endl;
     std::cout << "Time difference = " << std::chrono::duration_cast<std::chrono::seconds> (end - begin).count() << "[s]" << std::endl;
+	// Time of each phase, if compiled with -DABM_PROFILING
+	if (StepStats::enabled()) {
+		abm.get_step_stats().print_summary(std::cout);
+	}
 
 	// Should be no vaccines and no boosters after initial
 	const std::vector<Agent>& agents = abm.vector_of_agents();
@@ -17,6 +17,16 @@
  * 
 ******************************************************/
 
+namespace {
+	// Names of the parameters read at every step, 
+	// created once so that the lookups don't allocate
+	const std::string frac_estimated_infected("fraction estimated infected");
+	const std::string data_collection_start("time to start data collection");
+	const std::string frac_boosters("fraction boosters");
+	const std::string max_vaccinated("Maximum number to vaccinate");
+	const std::string max_boosted("Maximum number to boost");
+}
+
 //
 // Initialization and object construction
 //
@@ -51,6 +61,24 @@ void ABM::initialize_data_collection()
 // Create the town, agents, infection properties, and introduce initially infected 
 void ABM::simulation_setup(const std::string filename, const std::vector<int>& inf0, 
 		const bool custom_vac_offsets, const bool custom_boost_offsets)
+{
+	setup_model(filename, inf0, custom_vac_offsets, custom_boost_offsets, nullptr);
+}
+
+// Same, but on a town that already exists
+void ABM::simulation_setup(std::shared_ptr<const Town> shared_town, const std::string filename, 
+		const std::vector<int>& inf0, const bool custom_vac_offsets, const bool custom_boost_offsets)
+{
+	if (!shared_town) {
+		throw std::invalid_argument("Setting up a model on a town that does not exist");
+	}
+	setup_model(filename, inf0, custom_vac_offsets, custom_boost_offsets, shared_town);
+}
+
+// Parameters, places, and agents
+void ABM::setup_model(const std::string& filename, const std::vector<int>& inf0, 
+		const bool custom_vac_offsets, const bool custom_boost_offsets,
+		std::shared_ptr<const Town> shared_town)
 {
 	// Load filenames - key is the tag, value is the actual file name
 	LoadParameters ldparam;
@@ -67,6 +95,10 @@ void ABM::simulation_setup(const std::string filename, const std::vector<int>& i
 	load_infection_parameters(setup_files.at("Simulation parameters"));
 	load_age_dependent_distributions(dfiles);
 	load_testing(setup_files.at("Testing manager"));
+	if (setup_files.find("Intervention events") != setup_files.end()) {
+		load_events(setup_files.at("Intervention events"));
+	}
+	schedule_events();
 
 	// So not to require extra parameters (and be backwards compatible)
 	if (custom_vac_offsets && !custom_boost_offsets) {
@@ -81,25 +113,60 @@ void ABM::simulation_setup(const std::string filename, const std::vector<int>& i
 	} else {
 		load_vaccinations(setup_files.at("Vaccination parameters"), setup_files.at("Vaccination tables directory"));
 	}
-	// Setup the town and mobility components
-	create_households(setup_files.at("Household data"));
-	create_schools(setup_files.at("School data"));
-	create_workplaces(setup_files.at("Workplace data"));
-	create_hospitals(setup_files.at("Hospital data"));
-	create_retirement_homes(setup_files.at("Retirement home data"));
-	create_carpools(setup_files.at("Carpool data"));
-	create_public_transit(setup_files.at("Public transit data"));
-	create_leisure_locations(setup_files.at("Leisure location data"));
-	initialize_mobility();
-
 	// Initialize strain number and strain tracking
 	n_strains = static_cast<int>(infection_parameters.at("number of strains"));
 	n_infected_tot_strain.resize(n_strains);
 	// Initialize strain corrections
 	strain_correction.resize(n_strains, 1.0);
 
-	// Create the agents, including initially infected
-	create_agents(setup_files.at("Agent data"), inf0);
+	if (shared_town) {
+		// Places with their agents and mobility from the town,
+		// the copies share agent IDs with it
+		town = shared_town;
+		households = town->get_households();
+		retirement_homes = town->get_retirement_homes();
+		schools = town->get_schools();
+		workplaces = town->get_workplaces();
+		hospitals = town->get_hospitals();
+		carpools = town->get_carpools();
+		public_transit = town->get_public_transit();
+		leisure_locations = town->get_leisure_locations();
+		mobility.set_probability_parameters(infection_parameters.at("leisure - dr0"), 
+			infection_parameters.at("leisure - beta"), infection_parameters.at("leisure - kappa"));
+		mobility.set_shared_public_probabilities(town->get_shared_public_probabilities());
+		// Agents are already registered in the places
+		if (setup_files.find("Town image") != setup_files.end()) {
+			load_agents(TownImage(setup_files.at("Town image")), inf0);
+		} else {
+			load_agents(setup_files.at("Agent data"), inf0);
+		}
+		initialize_contact_tracing();
+		return;
+	}
+
+	if (setup_files.find("Town image") != setup_files.end()) {
+		// Places and agents from a precompiled binary town
+		TownImage image(setup_files.at("Town image"));
+		create_places(image);
+		initialize_mobility();
+		create_agents(image, inf0);
+	} else {
+		// Setup the town and mobility components
+		create_households(setup_files.at("Household data"));
+		create_schools(setup_files.at("School data"));
+		create_workplaces(setup_files.at("Workplace data"));
+		create_hospitals(setup_files.at("Hospital data"));
+		create_retirement_homes(setup_files.at("Retirement home data"));
+		create_carpools(setup_files.at("Carpool data"));
+		create_public_transit(setup_files.at("Public transit data"));
+		create_leisure_locations(setup_files.at("Leisure location data"));
+		initialize_mobility();
+
+		// Create the agents, including initially infected
+		create_agents(setup_files.at("Agent data"), inf0);
+	}
+	// Everything that does not change during the simulation
+	town = std::make_shared<const Town>(*this, mobility);
 }
 
 // Load infection parameters, store in a map
@@ -108,7 +175,19 @@ void ABM::load_infection_parameters(const std::string infile)
 	// Load parameters
 	LoadParameters ldparam;
 	infection_parameters = ldparam.load_parameter_map<double>(infile);
+	// Values that replace the ones from the file
+	for (const auto& entry : infection_overrides) {
+		if (infection_parameters.find(entry.first) == infection_parameters.end()) {
+			throw std::invalid_argument("No infection parameter named " + entry.first);
+		}
+		infection_parameters.at(entry.first) = entry.second;
+	}
+	apply_infection_parameters();
+}
 
+// Set distributions and probabilities of the Infection object
+void ABM::apply_infection_parameters()
+{
 	// Set infection distributions
 	infection.set_latency_distribution(infection_parameters.at("latency log-normal mean"),
 					infection_parameters.at("latency log-normal standard deviation"));	
@@ -123,6 +202,14 @@ void ABM::load_infection_parameters(const std::string infile)
 	infection.set_other_probabilities(infection_parameters.at("average fraction to get tested"),
 									  infection_parameters.at("probability of death in ICU"), 
 								  infection_parameters.at("probability dying if needing but not admitted to icu"));
+
+	// Values that events can change later
+	auto optional = [this](const std::string& name) {
+			const auto& iter = infection_parameters.find(name); 
+			return iter == infection_parameters.end() ? 
+					std::numeric_limits<double>::quiet_NaN() : iter->second; };
+	vaccination_rate = optional("vaccination rate");
+	leisure_fraction = optional("leisure - fraction");
 }
 
 // Load age-dependent distributions, store in a map of maps
@@ -158,17 +245,59 @@ void ABM::load_testing(const std::string fname)
 					infection_parameters.at("fraction false positive"),
 					infection_parameters.at("fraction to get tested"),
 					infection_parameters.at("exposed fraction to get tested"));	
-	// Time-dependent test fractions
+	// Time-dependent test fractions, time | exposed | symptomatic
 	std::vector<std::vector<std::string>> file = read_object(fname);
-	std::vector<std::vector<double>> fractions_times = {};
-	std::vector<double> temp(3,0.0);
 	for (auto& entry : file){
-		for (int i=0; i<3; ++i){
-			temp.at(i) = std::stod(entry.at(i));
+		const double change_time = std::stod(entry.at(0));
+		if (change_time >= 0.0) {
+			loaded_events.emplace_back(EventTimeline::step_of(change_time, dt), 
+				EventTimeline::testing_change, std::stod(entry.at(1)), std::stod(entry.at(2)));
 		}
-		fractions_times.push_back(temp);
 	}
-	testing.set_time_varying(fractions_times);
+}
+
+// Load events from a file
+void ABM::load_events(const std::string& fname)
+{
+	std::vector<std::vector<std::string>> file = read_object(fname);
+	for (auto& entry : file){
+		if (entry.size() < 3) {
+			throw std::invalid_argument("Event in " + fname + " needs time, type, and value");
+		}
+		const double event_time = std::stod(entry.at(0));
+		if (event_time >= 0.0) {
+			loaded_events.emplace_back(EventTimeline::step_of(event_time, dt), 
+				EventTimeline::type_from_name(entry.at(1)), std::stod(entry.at(2)), 
+				entry.size() > 3 ? std::stod(entry.at(3)) : 0.0);
+		}
+	}
+	schedule_events();
+}
+
+// Schedule an event at a simulation time
+void ABM::schedule_event(const double event_time, const EventTimeline::Type type, 
+							const double value, const double second_value)
+{
+	if (event_time < 0.0) {
+		return;
+	}
+	loaded_events.emplace_back(EventTimeline::step_of(event_time, dt), type, value, second_value);
+	timeline.schedule(loaded_events.back());
+}
+
+// Timeline from the parameters and loaded events
+void ABM::schedule_events()
+{
+	timeline.clear();
+	// New strain - assumes that strain 2 didn't exist before
+	const auto& new_strain = infection_parameters.find("introduction of a new strain");
+	if (new_strain != infection_parameters.end()) {
+		timeline.schedule_at_time(new_strain->second, dt, EventTimeline::new_strain, 2);
+	}
+	for (const auto& event : loaded_events) {
+		timeline.schedule(event);
+	}
+	timeline.skip_to(current_step());
 }
 
 // Initialize Vaccinations class 
@@ -183,90 +312,108 @@ void ABM::load_vaccinations(const std::string& fname, const std::string& data_pa
 	} else {
 		vaccinations = Vaccinations(fname, data_path);
 	}
+	// Values that replace the ones from the file
+	for (const auto& entry : vaccination_overrides) {
+		vaccinations.set_parameter(entry.first, entry.second);
+	}
+}
+
+// Values to use instead of the ones in the input files
+void ABM::set_parameter_overrides(const std::map<std::string, double>& infection_values,
+									const std::map<std::string, double>& vaccination_values)
+{
+	infection_overrides = infection_values;
+	vaccination_overrides = vaccination_values;
+}
+
+// Change an infection parameter of a set up model
+void ABM::set_infection_parameter(const std::string& name, const double value)
+{
+	if (infection_parameters.find(name) == infection_parameters.end()) {
+		throw std::invalid_argument("No infection parameter named " + name);
+	}
+	if (is_setup_parameter(name)) {
+		throw std::invalid_argument("Infection parameter " + name 
+					+ " is used during setup and needs to be set with set_parameter_overrides");
+	}
+	infection_parameters.at(name) = value;
+	// Parameters copied into other objects
+	apply_infection_parameters();
+	setup_flu();
+	schedule_events();
+}
+
+// True for parameters that are copied into places and agents during setup
+bool ABM::is_setup_parameter(const std::string& name)
+{
+	const std::vector<std::string> setup_names = {"household scaling parameter",
+		"severity correction", "number of strains", "public transit current capacity",
+		"maximum number of visits to track"};
+	if (std::find(setup_names.begin(), setup_names.end(), name) != setup_names.end()) {
+		return true;
+	}
+	// Transmission rates, absenteeism corrections, and mobility constants
+	return (name.find("transmission rate") != std::string::npos)
+			|| (name.find("absenteeism") != std::string::npos)
+			|| (name.find("public transit beta") == 0)
+			|| (name.find("leisure - ") == 0);
 }
 
 // Generate and store household objects
 void ABM::create_households(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord house;
+	households.reserve(households.size() + reader.count_rows());
 	// One household per line
-	for (auto& house : file){
-		// Extract properties, add infection parameters
-		Household temp_house(std::stoi(house.at(0)), 
-			std::stod(house.at(1)), std::stod(house.at(2)),
-			infection_parameters.at("household scaling parameter"),
-			infection_parameters.at("severity correction"),
-			static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		households.push_back(temp_house);
+	while (reader.next_row(row)){
+		TownImage::read_place(row, true, house);
+		add_household(house);
 	}
 }
 
 // Generate and store retirement homes objects
 void ABM::create_retirement_homes(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord rh;
 	// One household per line
-	for (auto& rh : file){
-		// Extract properties, add infection parameters
-		RetirementHome temp_RH(std::stoi(rh.at(0)), 
-			std::stod(rh.at(1)), std::stod(rh.at(2)),
-			infection_parameters.at("severity correction"),
-			infection_parameters.at("RH employee absenteeism factor"),
-			static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		retirement_homes.push_back(temp_RH);
+	while (reader.next_row(row)){
+		TownImage::read_place(row, true, rh);
+		add_retirement_home(rh);
 	}
 }
 
 // Generate and store school objects
 void ABM::create_schools(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord school;
 	// One workplace per line
-	for (auto& school : file){
-		// Extract properties, add infection parameters
-		// School-type dependent absenteeism
-		double psi = 0.0;
-		std::string school_type = school.at(3);
-		if (school_type == "daycare")
- 			psi = infection_parameters.at("daycare absenteeism correction");
-		else if (school_type == "primary" || school_type == "middle")
- 			psi = infection_parameters.at("primary and middle school absenteeism correction");
-		else if (school_type == "high")
- 			psi = infection_parameters.at("high school absenteeism correction");
-		else if (school_type == "college")
- 			psi = infection_parameters.at("college absenteeism correction");
-		else
-			throw std::invalid_argument("Wrong school type: " + school_type);
-		School temp_school(std::stoi(school.at(0)), 
-			std::stod(school.at(1)), std::stod(school.at(2)),
-			infection_parameters.at("severity correction"),	
-			infection_parameters.at("school employee absenteeism correction"),
-			psi, static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		schools.push_back(temp_school);
+	while (reader.next_row(row)){
+		TownImage::read_place(row, true, school);
+		add_school(school);
 	}
 }
 
 // Generate and store workplace objects
 void ABM::create_workplaces(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord work;
+	workplaces.reserve(workplaces.size() + reader.count_rows());
 	// One workplace per line
-	for (auto& work : file){
-		// Extract properties, add infection parameters
-		Workplace temp_work(std::stoi(work.at(0)), 
-			std::stod(work.at(1)), std::stod(work.at(2)),
-			infection_parameters.at("severity correction"),
-			infection_parameters.at("work absenteeism correction"),
-			work.at(3), static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		workplaces.push_back(temp_work);
+	while (reader.next_row(row)){
+		TownImage::read_place(row, true, work);
+		add_workplace(work);
 	}
 	set_outside_workplace_transmission();
 }
@@ -274,74 +421,190 @@ void ABM::create_workplaces(const std::string fname)
 // Create hospitals based on information in a file
 void ABM::create_hospitals(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord hospital;
 	// One hospital per line
-	for (auto& hospital : file){
-		Hospital temp_hospital(std::stoi(hospital.at(0)), 
-			std::stod(hospital.at(1)), std::stod(hospital.at(2)),
-			infection_parameters.at("severity correction"), static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		hospitals.push_back(temp_hospital);
+	while (reader.next_row(row)){
+		TownImage::read_place(row, true, hospital);
+		add_hospital(hospital);
 	}
 }
 
 // Generate and store carpool objects
 void ABM::create_carpools(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord cpl;
+	carpools.reserve(carpools.size() + reader.count_rows());
 	// One carpool per line
-	for (auto& cpl : file) {
-		// Extract properties, add infection parameters
-		Transit temp_transit(std::stoi(cpl.at(0)), 
-			infection_parameters.at("severity correction"),  
-			infection_parameters.at("work absenteeism correction"),
-			cpl.at(1), static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		carpools.push_back(temp_transit);
+	while (reader.next_row(row)) {
+		TownImage::read_place(row, false, cpl);
+		add_carpool(cpl);
 	}
 }
 
 // Generate and store public transit objects
 void ABM::create_public_transit(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
-	
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord pbt;
 	// One public transit per line
-	for (auto& pbt : file) {
-		// Extract properties, add infection parameters
-		Transit temp_transit(std::stoi(pbt.at(0)),
-			infection_parameters.at("severity correction"),  
-			infection_parameters.at("work absenteeism correction"),  
-			pbt.at(1), static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		public_transit.push_back(temp_transit);
+	while (reader.next_row(row)) {
+		TownImage::read_place(row, false, pbt);
+		add_public_transit(pbt);
 	}
 }
 
 // Generate and store leisure locations/weekend objects
 void ABM::create_leisure_locations(const std::string fname)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	PlaceRecord lsr;
+	leisure_locations.reserve(leisure_locations.size() + reader.count_rows());
 	// One leisure location per line
-	for (auto& lsr : file) {
-		// Extract properties, add infection parameters
-		Leisure temp_lsr(std::stoi(lsr.at(0)), 
-			std::stod(lsr.at(1)), std::stod(lsr.at(2)),
-			infection_parameters.at("severity correction"), 
-			lsr.at(3), static_cast<int>(infection_parameters.at("number of strains")));
-		// Store 
-		leisure_locations.push_back(temp_lsr);
+	while (reader.next_row(row)) {
+		TownImage::read_place(row, true, lsr);
+		add_leisure_location(lsr);
 	}
 	set_outside_leisure_transmission();
 }
 
+// Create all places stored in a town image
+void ABM::create_places(const TownImage& image)
+{
+	PlaceRecord place;
+	households.reserve(households.size() + image.number_of_places(TownImage::households));
+	for (size_t i = 0; i < image.number_of_places(TownImage::households); ++i) {
+		image.get_place(TownImage::households, i, place);
+		add_household(place);
+	}
+	for (size_t i = 0; i < image.number_of_places(TownImage::schools); ++i) {
+		image.get_place(TownImage::schools, i, place);
+		add_school(place);
+	}
+	workplaces.reserve(workplaces.size() + image.number_of_places(TownImage::workplaces));
+	for (size_t i = 0; i < image.number_of_places(TownImage::workplaces); ++i) {
+		image.get_place(TownImage::workplaces, i, place);
+		add_workplace(place);
+	}
+	set_outside_workplace_transmission();
+	for (size_t i = 0; i < image.number_of_places(TownImage::hospitals); ++i) {
+		image.get_place(TownImage::hospitals, i, place);
+		add_hospital(place);
+	}
+	for (size_t i = 0; i < image.number_of_places(TownImage::retirement_homes); ++i) {
+		image.get_place(TownImage::retirement_homes, i, place);
+		add_retirement_home(place);
+	}
+	carpools.reserve(carpools.size() + image.number_of_places(TownImage::carpools));
+	for (size_t i = 0; i < image.number_of_places(TownImage::carpools); ++i) {
+		image.get_place(TownImage::carpools, i, place);
+		add_carpool(place);
+	}
+	for (size_t i = 0; i < image.number_of_places(TownImage::public_transit); ++i) {
+		image.get_place(TownImage::public_transit, i, place);
+		add_public_transit(place);
+	}
+	leisure_locations.reserve(leisure_locations.size() + image.number_of_places(TownImage::leisure_locations));
+	for (size_t i = 0; i < image.number_of_places(TownImage::leisure_locations); ++i) {
+		image.get_place(TownImage::leisure_locations, i, place);
+		add_leisure_location(place);
+	}
+	set_outside_leisure_transmission();
+}
+
+// Construct and store a household
+void ABM::add_household(const PlaceRecord& house)
+{
+	households.emplace_back(house.ID, house.x, house.y,
+		infection_parameters.at("household scaling parameter"),
+		infection_parameters.at("severity correction"),
+		static_cast<int>(infection_parameters.at("number of strains")));
+}
+
+// Construct and store a retirement home
+void ABM::add_retirement_home(const PlaceRecord& rh)
+{
+	retirement_homes.emplace_back(rh.ID, rh.x, rh.y,
+		infection_parameters.at("severity correction"),
+		infection_parameters.at("RH employee absenteeism factor"),
+		static_cast<int>(infection_parameters.at("number of strains")));
+}
+
+// Construct and store a school
+void ABM::add_school(const PlaceRecord& school)
+{
+	// School-type dependent absenteeism
+	double psi = 0.0;
+	if (school.type == "daycare")
+		psi = infection_parameters.at("daycare absenteeism correction");
+	else if (school.type == "primary" || school.type == "middle")
+		psi = infection_parameters.at("primary and middle school absenteeism correction");
+	else if (school.type == "high")
+		psi = infection_parameters.at("high school absenteeism correction");
+	else if (school.type == "college")
+		psi = infection_parameters.at("college absenteeism correction");
+	else
+		throw std::invalid_argument("Wrong school type: " + school.type);
+	schools.emplace_back(school.ID, school.x, school.y,
+		infection_parameters.at("severity correction"),	
+		infection_parameters.at("school employee absenteeism correction"),
+		psi, static_cast<int>(infection_parameters.at("number of strains")));
+}
+
+// Construct and store a workplace
+void ABM::add_workplace(const PlaceRecord& work)
+{
+	workplaces.emplace_back(work.ID, work.x, work.y,
+		infection_parameters.at("severity correction"),
+		infection_parameters.at("work absenteeism correction"),
+		work.type, static_cast<int>(infection_parameters.at("number of strains")));
+}
+
+// Construct and store a hospital
+void ABM::add_hospital(const PlaceRecord& hospital)
+{
+	hospitals.emplace_back(hospital.ID, hospital.x, hospital.y,
+		infection_parameters.at("severity correction"), 
+		static_cast<int>(infection_parameters.at("number of strains")));
+}
+
+// Construct and store a carpool
+void ABM::add_carpool(const PlaceRecord& cpl)
+{
+	carpools.emplace_back(cpl.ID, infection_parameters.at("severity correction"),  
+		infection_parameters.at("work absenteeism correction"),
+		cpl.type, static_cast<int>(infection_parameters.at("number of strains")));
+}
+
+// Construct and store a public transit object
+void ABM::add_public_transit(const PlaceRecord& pbt)
+{
+	public_transit.emplace_back(pbt.ID, infection_parameters.at("severity correction"),  
+		infection_parameters.at("work absenteeism correction"),  
+		pbt.type, static_cast<int>(infection_parameters.at("number of strains")));
+}
+
+// Construct and store a leisure location
+void ABM::add_leisure_location(const PlaceRecord& lsr)
+{
+	leisure_locations.emplace_back(lsr.ID, lsr.x, lsr.y,
+		infection_parameters.at("severity correction"), 
+		lsr.type, static_cast<int>(infection_parameters.at("number of strains")));
+}
+
 // Initialize Mobility and assignment of leisure locations
 void ABM::initialize_mobility()
 {
+	Tracer::Scope trace_mobility(tracer.get(), "initialize_mobility", "setup");
 	mobility.set_probability_parameters(infection_parameters.at("leisure - dr0"), infection_parameters.at("leisure - beta"), infection_parameters.at("leisure - kappa"));
 	mobility.construct_public_probabilities(households, leisure_locations);
 }
@@ -354,84 +617,103 @@ void ABM::create_agents(const std::string fname, const std::vector<int>& ninf0)
 	initialize_contact_tracing();
 }
 
+// Create agents stored in a town image and assign them to places
+void ABM::create_agents(const TownImage& image, const std::vector<int>& ninf0)
+{
+	load_agents(image, ninf0);
+	register_agents();
+	initialize_contact_tracing();
+}
+
 // Retrieve agent information from a file
 void ABM::load_agents(const std::string fname, const std::vector<int>& ninf0)
 {
-	// Read the whole file
-	std::vector<std::vector<std::string>> file = read_object(fname);
+	// Stream the file directly from the mapping
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	AgentRecord agent;
 
 	// One of the many flu setups	
 	setup_flu();
 
-	// IDs of initially infected agents for each strain
-	// Outer vector - strains, inner vectors - IDs for that strain
-	int n_agents = file.size();
-	std::vector<std::vector<int>> infected_IDs = select_initially_infected(n_agents, ninf0);
-	int strain_id = 0;
+	// Strain of each initially infected agent (index is ID-1), 0 if not infected 
+	int n_agents = reader.count_rows();
+	std::vector<int> initial_strains = select_initially_infected(n_agents, ninf0);
+	// Rates common for all agents
+	RateTemplates rates = generate_rate_templates();
 
-	// Counter for agent IDs
-	int agent_ID = 1;
 	// One agent per line, with properties as defined in the line
-	for (auto agent : file){
-		// Agent status
-		bool student = false, works = false, livesRH = false, worksRH = false,  
-			 worksSch = false, patient = false, hospital_staff = false,
-			 works_from_home = false;
-		int house_ID = -1, workID = 0, cpID = 0, ptID = 0;
-		double work_travel_time = 0.0;
-		std::string work_travel_mode;
-		// Entries will be common for all agents, values may change
-		std::vector<std::map<std::string, double>> transmission_rates = generate_initial_tr_rates(n_strains);
-
-		// Infection status 
-		bool infected = false;
-		for (int i = 0; i < infected_IDs.size(); ++i) {
-			std::vector<int>& one_strain_IDs = infected_IDs.at(i);
-			if (one_strain_IDs.empty() || one_strain_IDs.at(0) == -1) {
-				continue;
-			}
-			auto iter = std::find(one_strain_IDs.begin(), one_strain_IDs.end(), agent_ID); 
-			if (iter != one_strain_IDs.end()) {
-				one_strain_IDs.erase(iter);
-				infected = true;
-				strain_id = i + 1;
-				++n_infected_tot;
-				++n_infected_tot_strain.at(strain_id - 1);
-				break;
-			}
-		}
-		
-		// Properties
-		assign_roles(agent, house_ID, patient, hospital_staff, student, 
-						works, livesRH, worksRH, worksSch, workID);
-		assign_transit(agent, transmission_rates, works_from_home, work_travel_time, 
-					work_travel_mode, cpID, ptID, works, hospital_staff);
-		assign_workplace_transmission_rate(agent, transmission_rates);
-		
-		// Construction
-		Agent temp_agent(student, works, std::stoi(agent.at(2)), 
-			std::stod(agent.at(3)), std::stod(agent.at(4)), house_ID,
-			patient, std::stoi(agent.at(7)), livesRH, worksRH,
-		    worksSch, workID, hospital_staff, std::stoi(agent.at(13)), 
-			infected, work_travel_mode, work_travel_time, cpID, ptID, 
-			works_from_home, transmission_rates, n_strains);
-
-		// Post-processing
-		temp_agent.set_ID(agent_ID++);
-		temp_agent.set_occupation(agent.at(21));
-		temp_agent.set_occupation_transmission();
-
-		// Set properties for exposed if initially infected
-		if (temp_agent.infected() == true) {
-			temp_agent.set_strain(strain_id);
-			initial_exposed(temp_agent);
-		}	
+	agents.reserve(agents.size() + n_agents);
+	int agent_ID = 1;
+	while (reader.next_row(row)){
+		TownImage::read_agent(row, agent);
+		add_agent(agent, agent_ID, initial_strains.at(agent_ID-1), rates);
+		++agent_ID;
+	}
+}
+
+// Retrieve agent information from a town image
+void ABM::load_agents(const TownImage& image, const std::vector<int>& ninf0)
+{
+	AgentRecord agent;
+
+	// One of the many flu setups	
+	setup_flu();
 
-		// Store
-		agents.push_back(temp_agent);
+	// Strain of each initially infected agent (index is ID-1), 0 if not infected 
+	int n_agents = image.number_of_agents();
+	std::vector<int> initial_strains = select_initially_infected(n_agents, ninf0);
+	// Rates common for all agents
+	RateTemplates rates = generate_rate_templates();
+
+	agents.reserve(agents.size() + n_agents);
+	for (int i = 0; i < n_agents; ++i) {
+		image.get_agent(i, agent);
+		add_agent(agent, i + 1, initial_strains.at(i), rates);
 	}
 }
 
+// Construct an agent and store it 
+void ABM::add_agent(const AgentRecord& agent, const int agent_ID, 
+						const int strain_id, const RateTemplates& rates)
+{
+	// Entries will be common for all agents, values may change
+	std::vector<std::map<std::string, double>> transmission_rates(rates.nominal);
+
+	// Infection status 
+	const bool infected = (strain_id > 0);
+	if (infected) {
+		++n_infected_tot;
+		++n_infected_tot_strain.at(strain_id - 1);
+	}
+	
+	// Properties
+	assign_transit(agent, rates, transmission_rates);
+	assign_workplace_transmission_rate(agent, rates, transmission_rates);
+	
+	// Construction
+	Agent temp_agent(agent.student, agent.works, agent.age, 
+		agent.x, agent.y, agent.house_ID,
+		agent.patient, agent.school_ID, agent.lives_RH, agent.works_RH,
+	    agent.works_school, agent.work_ID, agent.hospital_staff, agent.hospital_ID, 
+		infected, agent.travel_mode, agent.travel_time, agent.carpool_ID, agent.public_ID, 
+		agent.works_from_home, std::move(transmission_rates), n_strains);
+
+	// Post-processing
+	temp_agent.set_ID(agent_ID);
+	temp_agent.set_occupation(agent.occupation);
+	temp_agent.set_occupation_transmission();
+
+	// Set properties for exposed if initially infected
+	if (temp_agent.infected() == true) {
+		temp_agent.set_strain(strain_id);
+		initial_exposed(temp_agent);
+	}	
+
+	// Store
+	agents.push_back(std::move(temp_agent));
+}
+
 // Setup flu properties
 void ABM::setup_flu()
 {
@@ -443,38 +725,27 @@ void ABM::setup_flu()
 	flu.set_testing_duration(infection_parameters.at("flu testing duration"));
 }
 
-// Select IDs of agents initially infected with each strain
-std::vector<std::vector<int>> ABM::select_initially_infected(const int n_agents, const std::vector<int>& ninf0)
+// Select agents initially infected with each strain
+std::vector<int> ABM::select_initially_infected(const int n_agents, const std::vector<int>& ninf0)
 {
-	// For custom generation of initially infected
-	std::vector<std::vector<int>> infected_IDs;
-	// All possible IDs
-	std::vector<int> agent_ids(n_agents);
-	std::iota(agent_ids.begin(), agent_ids.end(), 1);
-	// One agent can be infected with only one strain - this ensures it
-	for (const auto& strain_i0 : ninf0) {
-		// Safety and redundancy check
-		if (strain_i0 == 0) {
-			infected_IDs.push_back({-1});
-			continue;
-		}
-		if (strain_i0 > agent_ids.size()) {
-			throw std::runtime_error("Requesting more initially infected than available agents");
-		}
-		// Randomly rearrange the remaining IDs
-		std::vector<int> temp_ids(strain_i0);
-		infection.vector_shuffle(agent_ids);
-		// Copy strain_i0 of them into the ID vector for that strain, save it
-		auto it_end = std::next(agent_ids.begin(), strain_i0); 
-		std::copy(agent_ids.begin(), it_end, temp_ids.begin());		
-		infected_IDs.push_back(temp_ids);
-		// Remove the selected IDs
-		for (const auto& id : temp_ids) {
-			auto iter = std::find(agent_ids.begin(), agent_ids.end(), id);
-			agent_ids.erase(iter);
+	// Strain of each agent, 0 if not infected
+	std::vector<int> initial_strains(n_agents, 0);
+	const int n_total = std::accumulate(ninf0.begin(), ninf0.end(), 0);
+	if (n_total > n_agents) {
+		throw std::runtime_error("Requesting more initially infected than available agents");
+	}
+	// Distinct indices, so one agent can be infected with only one strain
+	std::vector<int> selected = infection.sample_without_replacement(n_agents, n_total);
+	// Floyd's sample is not in random order 
+	infection.vector_shuffle(selected);
+	int n_selected = 0;
+	for (int is = 0; is < ninf0.size(); ++is) {
+		for (int i = 0; i < ninf0.at(is); ++i) {
+			initial_strains.at(selected.at(n_selected)) = is + 1;
+			++n_selected;
 		}
 	}
-	return infected_IDs;
+	return initial_strains;
 }
 
 // Initialize all transmission rates, assign nominal (common) values
@@ -506,115 +777,59 @@ std::vector<std::map<std::string, double>> ABM::generate_initial_tr_rates(const
 	return nominal_rates;
 }
 
-// Assign proper transmission rate for an out-of-town or a generic workplace
-void ABM::assign_workplace_transmission_rate(const std::vector<std::string>& agent,
-					std::vector<std::map<std::string, double>>& transmission_rates)
+// Transmission rates common for all agents
+ABM::RateTemplates ABM::generate_rate_templates()
 {
-	// Set agent occupation
-	std::string work_type = agent.at(21);
-	std::string rate_by_type;
-	// And the corresponding transmission rate
-	double work_rate = 0.0;	 
-	if (work_type != "none") {
-		if (work_type == "A") { 
-			rate_by_type = "management science art transmission rate";
-		} else if (work_type == "B") { 
-			rate_by_type = "service occupation transmission rate";
-		} else if (work_type == "C") { 
-			rate_by_type = "sales office transmission rate"; 
-		} else if (work_type == "D") { 
-			rate_by_type = "construction maintenance transmission rate"; 
-		} else if (work_type == "E") { 
-			rate_by_type = "production transportation transmission rate"; 
-		}
+	RateTemplates rates;
+	rates.nominal = generate_initial_tr_rates(n_strains);
+	// Public transit - transmission rate based on current capacity
+	for (int ip = 1; ip <= n_strains; ++ip) {
+		rates.public_transit.push_back(
+			infection_parameters.at(std::string("public transit beta0") + std::string(" strain ") + std::to_string(ip)) 
+			+ infection_parameters.at(std::string("public transit beta full") + std::string(" strain ") + std::to_string(ip))
+			*infection_parameters.at("public transit current capacity"));
+	}
+	// Occupations A - E
+	const std::vector<std::string> rate_by_type = {"management science art transmission rate",
+		"service occupation transmission rate", "sales office transmission rate",
+		"construction maintenance transmission rate", "production transportation transmission rate"};
+	for (const auto& rate_name : rate_by_type) {
+		std::vector<double> temp;
  		for (int ip = 1; ip <= n_strains; ++ip) {
-			transmission_rates.at(ip-1).at("workplace transmission rate") 
-					= infection_parameters.at(std::string(rate_by_type) + std::string(" strain ") + std::to_string(ip));
+			temp.push_back(infection_parameters.at(rate_name + std::string(" strain ") + std::to_string(ip)));
 		}
+		rates.occupation.push_back(temp);
 	}
+	return rates;
 }
 
-// Select transit and calculate transmission rates if necessary
-void ABM::assign_transit(const std::vector<std::string>& agent,
-					std::vector<std::map<std::string, double>>& transmission_rates,
-					bool& works_from_home, double& work_travel_time, 
-					std::string& work_travel_mode, int& cpID, int& ptID,
-					const bool works, const bool hospital_staff)
+// Assign proper transmission rate for an out-of-town or a generic workplace
+void ABM::assign_workplace_transmission_rate(const AgentRecord& agent, const RateTemplates& rates,
+					std::vector<std::map<std::string, double>>& transmission_rates)
 {
-	// Transit information
-	if (std::stoi(agent.at(15)) == 1) {
-		works_from_home = true;
-		work_travel_mode = agent.at(17);
-	} else {
-		if (!(works || hospital_staff)) {
-			work_travel_mode = "None";
-		} else {
-			work_travel_mode = agent.at(17);
-			if (work_travel_mode == "carpool") {
-				cpID = std::stoi(agent.at(19));
-			}
-			if (work_travel_mode == "public") {
-				ptID = std::stoi(agent.at(20));
-				// Transmission rate based on current capacity
-				for (int ip = 1; ip <= n_strains; ++ip) {
-					double beta_T = infection_parameters.at(std::string("public transit beta0") + std::string(" strain ") + std::to_string(ip)) 
-						+ infection_parameters.at(std::string("public transit beta full") + std::string(" strain ") + std::to_string(ip))
-						*infection_parameters.at("public transit current capacity");
-					transmission_rates.at(ip-1).at("public transit transmission rate") = beta_T;
-				}
-			}
-			work_travel_time = std::stod(agent.at(16));
+	// Agent occupation and the corresponding transmission rate
+	const std::string& work_type = agent.occupation;
+	if (work_type != "none") {
+		const int occ = work_type.size() == 1 ? work_type.at(0) - 'A' : -1;
+		if (occ < 0 || occ >= static_cast<int>(rates.occupation.size())) {
+			throw std::invalid_argument("Wrong occupation type: " + work_type);
+		}
+ 		for (int ip = 1; ip <= n_strains; ++ip) {
+			transmission_rates.at(ip-1).at("workplace transmission rate") = rates.occupation.at(occ).at(ip-1);
 		}
 	}
 }
 
-// Properties of agents: housing, work and school status
-void ABM::assign_roles(const std::vector<std::string>& agent, int& house_ID,
-						bool& patient, bool& hospital_staff, bool& student, 
-						bool& works, bool& livesRH, bool& worksRH, bool& worksSch, 
-						int& workID)
+// Calculate transit transmission rates if necessary
+void ABM::assign_transit(const AgentRecord& agent, const RateTemplates& rates,
+					std::vector<std::map<std::string, double>>& transmission_rates)
 {
-		// Household ID only if not hospitalized with condition
-		// different than COVID-19
-		if (std::stoi(agent.at(6)) == 1){
-			patient = true;
-			house_ID = 0;
-		}else{
-			house_ID = std::stoi(agent.at(5));
-		}
-
-		// No school or work if patient with condition other than COVID
-		if (std::stoi(agent.at(12)) == 1 && !patient){
-			hospital_staff = true;
-		}
-		if (std::stoi(agent.at(0)) == 1 && !patient){
-			student = true;
+	// Public transit - transmission rate based on current capacity
+	if (!agent.works_from_home && agent.travel_mode == "public") {
+		for (int ip = 1; ip <= n_strains; ++ip) {
+			transmission_rates.at(ip-1).at("public transit transmission rate") = rates.public_transit.at(ip-1);
 		}
-	   	// No work flag if a hospital employee	
-		if (std::stoi(agent.at(1)) == 1 && !(patient || hospital_staff)){
-			works = true; 
-		}
-			// Retirement home resident
-		if (std::stoi(agent.at(8)) == 1){
-			 livesRH = true;
-		}
-		// Retirement home or school employee
-		if (std::stoi(agent.at(9)) == 1){
-			 worksRH = true;
-		}
-		if (std::stoi(agent.at(10)) == 1){
-			 worksSch = true;
-		}
-
-		// Select correct work ID for special employment types
-		// Hospital ID is set separately, but for consistency
-		if (worksRH || worksSch || hospital_staff) {
-			workID = std::stoi(agent.at(18));
-		} else if (works) {
-			workID = std::stoi(agent.at(11));
-		}
-
-
+	}
 }
 
 // Assign agents to households, schools, and worplaces
@@ -648,7 +863,7 @@ void ABM::register_agents()
 		if (agent.student()){
 			school_ID = agent.get_school_ID();
 			School& school = schools.at(school_ID - 1); 
-			school.register_agent(agent_ID);		
+			school.register_student(agent_ID, agent.get_age());		
 		}
 
 		if (agent.works() && !agent.works_from_home()
@@ -659,7 +874,7 @@ void ABM::register_agents()
 				rh.register_agent(agent_ID);
 			} else if (agent.school_employee()){
 				School& school = schools.at(work_ID - 1); 
-				school.register_agent(agent_ID);
+				school.register_employee(agent_ID);
 			} else {
 				Workplace& work = workplaces.at(work_ID - 1);
 				work.register_agent(agent_ID);
@@ -754,12 +969,13 @@ void ABM::initialize_active_cases(const std::vector<int> N_inf, const bool vacci
 			can_be_removed.push_back(agent.get_ID());
 		}
 	}
-	infection.vector_shuffle(can_be_removed);
 	if (N_R > can_be_removed.size()) {
 		std::cerr << "Requested number of agents to initially be recovered from strain 1 "
 				  << "larger than number of available agents" << std::endl;
 		throw std::invalid_argument("Too many agents to be initially recovered: " + N_R);
 	}
+	// Randomly select only the first N_R
+	infection.partial_shuffle(can_be_removed, N_R);
 	for (int ir = 0; ir < N_R; ++ir) {
 		int aID = can_be_removed.at(ir);
 		Agent& agent = agents.at(aID-1);
@@ -787,13 +1003,14 @@ void ABM::initialize_active_cases(const std::vector<int> N_inf, const bool vacci
 		}
 	}
 
-	// Randomly rearrange, then select first N_inf if available 
-	infection.vector_shuffle(can_have_covid);
+	// Randomly select the first N_inf (all strains) if available 
 	if (tot_requested > can_have_covid.size()) {
 		std::cerr << "Requested number of agents to initially have covid "
 				  << "larger than number of available agents" << std::endl;
 		throw std::invalid_argument("Too many agents to have covid: " + tot_requested);
 	}
+	infection.partial_shuffle(can_have_covid, 
+		std::accumulate(N_inf.begin(), N_inf.begin() + n_strains, 0));
 	int i_tot = 0;
 	int N0_i = 0;
 	for (int j = 0; j < n_strains; ++j) {
@@ -1005,24 +1222,25 @@ void ABM::process_initial_symptomatic(Agent& agent)
 // Vaccinate random members of the population that are not Flu or infected agents
 void ABM::vaccinate_random()
 {
+	Tracer::Scope trace_vac(tracer.get(), "vaccinate_random", "vaccination");
 	int cur_vaccinated = 0;
 	// Check against allowable maximum (hesitancy, inability to vaccinate)
-	if (total_vaccinated >= infection_parameters.at("Maximum number to vaccinate")) {
+	if (total_vaccinated >= infection_parameters.at(max_vaccinated)) {
 		return; 
 	} else if (total_vaccinated + n_vaccinated >= 
-					infection_parameters.at("Maximum number to vaccinate")) {
-		n_vaccinated = infection_parameters.at("Maximum number to vaccinate") - total_vaccinated;
+					infection_parameters.at(max_vaccinated)) {
+		n_vaccinated = infection_parameters.at(max_vaccinated) - total_vaccinated;
 //		std::cout << "Requested number of agents to vaccinate exceeds" 
 //				  << " the maximum allowable count - reducing to " << n_vaccinated << std::endl; 
 	}
 	if (total_boosted + n_boosted >= 
-					infection_parameters.at("Maximum number to boost")) {
-		n_boosted = infection_parameters.at("Maximum number to boost") - total_boosted;
+					infection_parameters.at(max_boosted)) {
+		n_boosted = infection_parameters.at(max_boosted) - total_boosted;
 //		std::cout << "Requested number of agents to boost exceeds" 
 //				  << " the maximum allowable count - reducing to " << n_boosted << std::endl; 
 	}
 	// Vaccinate if possible, update the counter
-	std::vector<int> cur = vaccinations.vaccinate_random(agents, n_vaccinated, n_boosted, infection, time);	
+	const std::array<int, 2> cur = vaccinations.vaccinate_random(agents, n_vaccinated, n_boosted, infection, time);	
 	total_vaccinated += cur.at(0);
 	total_boosted += cur.at(1);
 }
@@ -1068,6 +1286,9 @@ void ABM::vaccinate_group()
 // Transmit infection - original way 
 void ABM::transmit_infection() 
 {
+	ABM_PROFILE_STEP(step_stats);
+	Tracer::Scope trace_step(tracer.get(), "step", "step", "time", time);
+	record_step();
 	check_events();
 	distribute_leisure();
 	compute_outside_locations();
@@ -1080,6 +1301,12 @@ void ABM::transmit_infection()
 // Constant rate testing and vaccination 
 void ABM::transmit_with_vac() 
 {
+	if (comm) {
+		throw std::runtime_error("Vaccination during a distributed run is not supported");
+	}
+	ABM_PROFILE_STEP(step_stats);
+	Tracer::Scope trace_step(tracer.get(), "step", "step", "time", time);
+	record_step();
 	check_events();
 	vaccinate();
 	distribute_leisure();
@@ -1092,62 +1319,92 @@ void ABM::transmit_with_vac()
 // Randomly vaccinate agents based on the daily rate
 void ABM::vaccinate()
 {
+	ABM_PROFILE_PHASE(step_stats, vaccinate);
+	Tracer::Scope trace_phase(tracer.get(), "vaccinate", "phase");
+	// Eligible agents are kept up to date from the first call
+	if (!vaccinations.tracks_eligibility()) {
+		vaccinations.track_eligibility(agents);
+	}
 	// Adjust n_vaccinated 
-	n_vaccinated = static_cast<int>(infection_parameters.at("vaccination rate")*dt);
-	n_boosted = static_cast<int>(infection_parameters.at("fraction boosters")*n_vaccinated);
+	if (std::isnan(vaccination_rate)) {
+		throw std::out_of_range("No infection parameter named vaccination rate");
+	}
+	n_vaccinated = static_cast<int>(vaccination_rate*dt);
+	n_boosted = static_cast<int>(infection_parameters.at(frac_boosters)*n_vaccinated);
 	// Apply at random to eligible agents 
 	vaccinate_random();				
-}
-
-// Increase transmission rate and visiting frequency of leisure locations 
-void ABM::reopen_leisure_locations()
-{
-	;
+	ABM_PROFILE_COUNT(step_stats, vaccinate, agents, agents.size());
 }
 
 // Assign leisure locations for this step
 void ABM::distribute_leisure()
 {
-	// Remove previous leisure assignments
-	// Reset the ID for all that had a location 
-	// This includes all agents, passed as well
-	int old_loc_ID = 0;
-	for (auto& agent : agents) {
-		old_loc_ID = agent.get_leisure_ID();
-		if (old_loc_ID > 0) {
-			if (agent.get_leisure_type() == "household") {
-				households.at(old_loc_ID - 1).remove_agent(agent.get_ID());
-			} else if (agent.get_leisure_type() == "public") {
-				// Only remove in-town leisure locations
-				if(!leisure_locations.at(old_loc_ID -1).outside_town()){
-					leisure_locations.at(old_loc_ID - 1).remove_agent(agent.get_ID());
-				}
-			} else {
-				throw std::invalid_argument("Wrong leisure type: " + agent.get_leisure_type());
+	ABM_PROFILE_PHASE(step_stats, distribute_leisure);
+	Tracer::Scope trace_phase(tracer.get(), "distribute_leisure", "phase");
+	if (std::isnan(leisure_fraction)) {
+		throw std::out_of_range("No infection parameter named leisure - fraction");
+	}
+	// Remove previous leisure assignments - visitors are stored 
+	// separately, only places and agents of the last step change
+	for (const int hID : visited_households) {
+		households.at(hID-1).clear_visitors();
+		ABM_PROFILE_COUNT(step_stats, distribute_leisure, place_updates, 1);
+	}
+	for (const int lID : visited_leisure) {
+		leisure_locations.at(lID-1).clear_visitors();
+		ABM_PROFILE_COUNT(step_stats, distribute_leisure, place_updates, 1);
+	}
+	for (const int aID : leisure_agents) {
+		agents.at(aID-1).set_leisure_ID(0);
+	}
+	visited_households.clear();
+	visited_leisure.clear();
+	leisure_agents.clear();
+	// Room for all the places and agents, so that later steps don't reallocate
+	visited_households.reserve(households.size());
+	visited_leisure.reserve(leisure_locations.size());
+	leisure_agents.reserve(agents.size());
+
+	// One leisure location per household, or one per each more mobile agent,
+	// households split into contiguous ranges, one per thread; each household
+	// draws from its own stream so the result is the same for any number of threads
+	const unsigned long long key = static_cast<unsigned int>(infection.get_int(0, std::numeric_limits<int>::max()));
+	const size_t n_chunks = std::max<size_t>(1, std::min<size_t>(n_threads, households.size()));
+	const size_t chunk_size = (households.size() + n_chunks - 1)/n_chunks;
+	leisure_visits.resize(n_chunks);
+	leisure_draws.assign(n_chunks, 0);
+	leisure_errors.assign(n_chunks, nullptr);
+	auto select_chunk = [&](const size_t ic) {
+			try {
+				select_leisure_visits(ic*chunk_size, std::min(households.size(), (ic + 1)*chunk_size), 
+										key, leisure_visits.at(ic), leisure_draws.at(ic));
+			} catch (...) {
+				leisure_errors.at(ic) = std::current_exception();
 			}
+		};
+	std::vector<std::thread> threads;
+	for (size_t ic = 1; ic < n_chunks; ++ic) {
+		threads.emplace_back(select_chunk, ic);
+	}
+	// This thread works too
+	select_chunk(0);
+	for (auto& thr : threads) {
+		thr.join();
+	}
+	for (const auto& error : leisure_errors) {
+		if (error) {
+			std::rethrow_exception(error);
 		}
-		agent.set_leisure_ID(0);
 	}
 
-	// One leisure location per household, or one per each more mobile agent
-	// Automatically excludes hospital patients (including non-COVID ones)
-	// and retirement home residents; also passed agents, alive and removed participate
-	int house_ID = 0;
-	for (auto& house : households) {
-		house_ID = house.get_ID();
-		// Exclude fully isolated
-		if (contact_tracing.house_is_isolated(house_ID)) {
-			continue;
+	// Merge in the order of households
+	for (size_t ic = 0; ic < n_chunks; ++ic) {
+		for (const auto& visit : leisure_visits.at(ic)) {
+			register_leisure_visit(visit);
 		}
-		// Looping through households automatically excludes 
-		// agents that died and that are hospitalized
-		std::vector<int> agent_IDs = house.get_agent_IDs();
-		// First check for the whole household
-		if (infection.get_uniform() <= infection_parameters.at("leisure - fraction")) {
-			// Household is going as a whole
-			check_select_and_register_leisure_location(agent_IDs, house_ID);
-		}
-	}	
+		ABM_PROFILE_COUNT(step_stats, distribute_leisure, agents, leisure_visits.at(ic).size());
+		ABM_PROFILE_COUNT(step_stats, distribute_leisure, rng_draws, leisure_draws.at(ic));
+	}
 }
 
 // Checks if agent is in a condition that allows going to leisure locations
@@ -1172,92 +1429,528 @@ bool ABM::check_leisure_eligible(const Agent& agent, const int house_ID)
 	return true;
 }
 
-// Finds the actual leisure location and registers eligible agent(s)
-void ABM::check_select_and_register_leisure_location(const std::vector<int>& agent_IDs, const int house_ID)
+// Leisure locations of a range of households, stored as visits
+void ABM::select_leisure_visits(const size_t first, const size_t last, const unsigned long long key,
+									std::vector<LeisureVisit>& visits, unsigned long long& draws)
 {
+	visits.clear();
+	visits.reserve(agents.size());
+	draws = 0;
 	bool is_public = false;
 	bool is_house = false;
 	int loc_ID = 0; 
-	
-	// Assign location - single agent (one element ID vector) or the entire household
-	loc_ID = mobility.assign_leisure_location(infection, house_ID, is_house, is_public);
-	assert(loc_ID > 0);
-	assert((is_house == true) || (is_public == true));
-
-	// Skip households that are fully isolated
-	if (is_house) {
-		if (contact_tracing.house_is_isolated(loc_ID)) {
-			// Continue drawing until either public or not isolated
-			while (is_house && contact_tracing.house_is_isolated(loc_ID)) {
-				loc_ID = mobility.assign_leisure_location(infection, house_ID, is_house, is_public);
-				assert(loc_ID > 0);
-				assert((is_house == true) || (is_public == true));
+	for (size_t ih = first; ih < last; ++ih) {
+		const Household& house = households.at(ih);
+		const int house_ID = house.get_ID();
+		// Residents are simulated by another process
+		if (comm && partition->owner_of_household(house_ID) != comm->rank()) {
+			continue;
+		}
+		// Exclude fully isolated
+		if (contact_tracing.house_is_isolated(house_ID)) {
+			continue;
+		}
+		StreamRNG rng(key, house_ID);
+		// First check for the whole household
+		if (rng.get_uniform() > leisure_fraction) {
+			draws += rng.get_draws();
+			continue;
+		}
+		// Household is going as a whole
+		loc_ID = mobility.assign_leisure_location(rng, house_ID, is_house, is_public);
+		assert(loc_ID > 0);
+		assert((is_house == true) || (is_public == true));
+
+		// Skip households that are fully isolated
+		// Continue drawing until either public or not isolated
+		while (is_house && contact_tracing.house_is_isolated(loc_ID)) {
+			loc_ID = mobility.assign_leisure_location(rng, house_ID, is_house, is_public);
+			assert(loc_ID > 0);
+			assert((is_house == true) || (is_public == true));
+		}
+		draws += rng.get_draws();
+
+		// Looping through households automatically excludes 
+		// agents that died and that are hospitalized
+		for (const int aID : house.get_agent_IDs()) {
+			// Conditions under which the agent won't visit a leisure location
+			if (check_leisure_eligible(agents.at(aID-1), house_ID) == false) {
+				continue;
+			}
+			visits.push_back({aID, loc_ID, is_house});
+		}
+	}
+}
+
+// Registers an agent at the selected leisure location
+void ABM::register_leisure_visit(const LeisureVisit& visit)
+{
+	const int aID = visit.agent_ID;
+	const int loc_ID = visit.location_ID;
+	if (visit.in_household) {
+		Household& house = households.at(loc_ID-1);
+		if (house.get_visitor_IDs().empty()) {
+			visited_households.push_back(loc_ID);
+		}
+		house.add_visitor(aID);
+		ABM_PROFILE_COUNT(step_stats, distribute_leisure, place_updates, 1);
+		agents.at(aID-1).set_leisure_type("household");
+		agents.at(aID-1).set_leisure_ID(loc_ID);
+		// Record this visit
+		contact_tracing.add_household(aID, loc_ID, static_cast<int>(time));
+	} else {
+		// Only add if leisure location is within town
+		Leisure& leisure = leisure_locations.at(loc_ID-1);
+		if(!leisure.outside_town()){
+			if (leisure.get_visitor_IDs().empty()) {
+				visited_leisure.push_back(loc_ID);
+			}
+			leisure.add_visitor(aID);
+			ABM_PROFILE_COUNT(step_stats, distribute_leisure, place_updates, 1);
+		}
+		agents.at(aID-1).set_leisure_type("public");
+		agents.at(aID-1).set_leisure_ID(loc_ID);
+	}
+	leisure_agents.push_back(aID);
+}
+
+//
+// Recording of time series
+//
+
+// Stream per-step metrics to a file
+void ABM::record_output(const std::string& fname, const Recorder::Format format)
+{
+	recorder = std::make_shared<Recorder>(fname, format);
+	for (const auto& name : get_time_series_names()) {
+		recorder->add_metric(name);
+	}
+	recorder->set_tracer(tracer);
+	current_counts_valid = false;
+}
+
+// Record events, including output writes
+void ABM::set_tracer(std::shared_ptr<Tracer> trc)
+{
+	tracer = trc;
+	if (recorder) {
+		recorder->set_tracer(tracer);
+	}
+}
+
+// Write the remaining rows and close the output
+void ABM::stop_recording()
+{
+	if (recorder) {
+		recorder->close();
+		recorder = nullptr;
+	}
+}
+
+// Write a row with current values
+void ABM::record_step()
+{
+	// Values of a distributed run are collected from all processes,
+	// also by the processes that don't record
+	if (!recorder && !comm) {
+		return;
+	}
+	get_time_series_values(recorder_values);
+	if (!recorder) {
+		return;
+	}
+	for (int im = 0; im < recorder_values.size(); ++im) {
+		recorder->set(im, recorder_values.at(im));
+	}
+	recorder->record(time);
+}
+
+// Names of the per-step metrics
+std::vector<std::string> ABM::get_time_series_names() const
+{
+	std::vector<std::string> names = {"infected"};
+	for (int i = 1; i <= n_strains; ++i) {
+		names.push_back("infected strain " + std::to_string(i));
+	}
+	names.push_back("exposed");
+	names.push_back("total infected");
+	for (int i = 1; i <= n_strains; ++i) {
+		names.push_back("total infected strain " + std::to_string(i));
+	}
+	names.push_back("total dead");
+	names.push_back("total recovered");
+	names.push_back("total tested positive");
+	names.push_back("total vaccinated");
+	return names;
+}
+
+// Current values of the per-step metrics
+void ABM::get_time_series_values(std::vector<double>& values)
+{
+	// Setup and seeding change states outside of the 
+	// transitions - first step needs a direct count
+	if (!current_counts_valid) {
+		count_current_states();
+	}
+	values.clear();
+	values.push_back(std::accumulate(n_infected_now_strain.begin(), 
+							n_infected_now_strain.end(), 0));
+	values.insert(values.end(), n_infected_now_strain.begin(), n_infected_now_strain.end());
+	values.push_back(n_exposed_now);
+	values.push_back(n_infected_tot);
+	values.insert(values.end(), n_infected_tot_strain.begin(), n_infected_tot_strain.end());
+	values.push_back(n_dead_tot);
+	values.push_back(n_recovered_tot);
+	values.push_back(tot_tested_pos);
+	values.push_back(total_vaccinated);
+	// Events at the next step can change the states before the transitions
+	current_counts_valid = false;
+
+	if (comm) {
+		// Changes since distributing, summed over processes
+		for (int im = 0; im < values.size(); ++im) {
+			values.at(im) -= distributed_offsets.at(im);
+		}
+		comm->all_reduce_sum(values);
+		for (int im = 0; im < values.size(); ++im) {
+			values.at(im) += distributed_offsets.at(im);
+		}
+	}
+}
+
+// Compute current counts directly from agents 
+void ABM::count_current_states()
+{
+	if (!comm) {
+		n_infected_now_strain = get_num_infected_strains(n_strains);
+		n_exposed_now = get_num_exposed();
+	} else {
+		n_infected_now_strain.assign(n_strains, 0);
+		n_exposed_now = 0;
+		for (const int aID : owned_agents) {
+			const Agent& agent = agents.at(aID-1);
+			if (agent.infected()) {
+				++n_infected_now_strain.at(agent.get_strain()-1);
+			}
+			if (agent.exposed()) {
+				++n_exposed_now;
 			}
 		}
 	}
+	current_counts_valid = true;
+}
 
-	for (auto& aID : agent_IDs) {
-		// Conditions under which the agent won't visit a leisure location
-		if (check_leisure_eligible(agents.at(aID-1), house_ID) == false) {
+//
+// Replicates
+//
+
+// Restart all random number generators
+void ABM::set_seed(const unsigned int seed)
+{
+	// Separate, but reproducible streams for each generator
+	std::seed_seq seq{seed};
+	std::vector<unsigned int> seeds(2);
+	seq.generate(seeds.begin(), seeds.end());
+	infection.seed(seeds.at(0));
+	flu.seed(seeds.at(1));
+}
+
+// Threads used within a step
+void ABM::set_number_of_threads(const int n)
+{
+	if (n < 0) {
+		throw std::invalid_argument("Number of threads cannot be negative");
+	}
+	n_threads = (n > 0) ? n : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Randomly infect agents that are not infected yet
+void ABM::seed_initially_infected(const std::vector<int>& ninf0)
+{
+	std::vector<int> can_be_infected;
+	for (const auto& agent : agents) {
+		if (!agent.infected()) {
+			can_be_infected.push_back(agent.get_ID());
+		}
+	}
+	const int n_total = std::accumulate(ninf0.begin(), ninf0.end(), 0);
+	if (n_total > can_be_infected.size()) {
+		throw std::runtime_error("Requesting more initially infected than available agents");
+	}
+	infection.partial_shuffle(can_be_infected, n_total);
+	int n_selected = 0;
+	for (int is = 0; is < ninf0.size(); ++is) {
+		for (int i = 0; i < ninf0.at(is); ++i) {
+			Agent& agent = agents.at(can_be_infected.at(n_selected) - 1);
+			agent.set_infected(true);
+			agent.set_strain(is + 1);
+			initial_exposed(agent);
+			++n_infected_tot;
+			++n_infected_tot_strain.at(is);
+			++n_selected;
+		}
+	}
+	current_counts_valid = false;
+}
+
+//
+// Distributed runs
+//
+
+// Partition the town and keep only agents of this process
+void ABM::distribute(std::shared_ptr<Communicator> communicator, const unsigned int seed)
+{
+	if (!communicator) {
+		throw std::invalid_argument("Distributing a model without a communicator");
+	}
+	if (comm) {
+		throw std::runtime_error("Model is already distributed");
+	}
+	if (!town) {
+		throw std::runtime_error("Model needs to be set up before it is distributed");
+	}
+	// Totals so far - identical in all processes; current 
+	// counts are summed over processes as they are
+	get_time_series_values(distributed_offsets);
+	std::fill(distributed_offsets.begin(), distributed_offsets.begin() + n_strains + 2, 0.0);
+
+	const int rank = communicator->rank();
+	const int n_ranks = communicator->size();
+	// Residents as registered during setup
+	partition = std::make_shared<const HouseholdPartition>(town->get_households(),
+						town->get_retirement_homes(), n_ranks);
+	agent_owners.assign(agents.size(), 0);
+	owned_agents.clear();
+	int owner = 0;
+	for (const auto& agent : agents) {
+		const int aID = agent.get_ID();
+		if (agent.hospital_non_covid_patient()) {
+			// No home, spread evenly
+			owner = (aID - 1) % n_ranks;
+		} else if (agent.retirement_home_resident()) {
+			owner = partition->owner_of_retirement_home(agent.get_household_ID());
+		} else {
+			owner = partition->owner_of_household(agent.get_household_ID());
+		}
+		agent_owners.at(aID-1) = owner;
+		if (owner == rank) {
+			owned_agents.push_back(aID);
+		}
+	}
+	comm = communicator;
+
+	// Places only count agents of this process,
+	// the rest comes from the other processes
+	retain_owned_agents(households);
+	retain_owned_agents(retirement_homes);
+	retain_owned_agents(schools);
+	retain_owned_agents(workplaces);
+	retain_owned_agents(hospitals);
+	retain_owned_agents(carpools);
+	retain_owned_agents(public_transit);
+	retain_owned_agents(leisure_locations);
+	flu.retain_agents([this, rank](const int aID){ return agent_owners.at(aID-1) == rank; });
+	contact_tracing.track_isolation_changes(true);
+
+	// Different, reproducible streams in each process
+	std::seed_seq seq{seed, static_cast<unsigned int>(rank)};
+	std::vector<unsigned int> seeds(2);
+	seq.generate(seeds.begin(), seeds.end());
+	infection.seed(seeds.at(0));
+	flu.seed(seeds.at(1));
+	current_counts_valid = false;
+}
+
+// Sum contributions of places over processes
+void ABM::reduce_place_contributions()
+{
+	// Same order in all processes
+	place_values.clear();
+	pack_contributions(households);
+	pack_contributions(retirement_homes);
+	pack_contributions(schools);
+	pack_contributions(workplaces);
+	pack_contributions(hospitals);
+	pack_contributions(carpools);
+	pack_contributions(public_transit);
+	pack_contributions(leisure_locations);
+
+	comm->all_reduce_sum(place_values);
+
+	size_t pos = 0;
+	unpack_contributions(households, pos);
+	unpack_contributions(retirement_homes, pos);
+	unpack_contributions(schools, pos);
+	unpack_contributions(workplaces, pos);
+	unpack_contributions(hospitals, pos);
+	unpack_contributions(carpools, pos);
+	unpack_contributions(public_transit, pos);
+	unpack_contributions(leisure_locations, pos);
+}
+
+// Apply household isolation of other processes
+void ABM::exchange_isolated_households()
+{
+	const std::vector<std::vector<int>> changes = 
+		comm->all_gather(contact_tracing.take_isolation_changes());
+	std::vector<int> traced;
+	for (int ir = 0; ir < changes.size(); ++ir) {
+		// Changes of this process are already applied
+		if (ir == comm->rank()) {
 			continue;
 		}
-		// Register an eligible agent at the leisure location
-		if (is_house) {
-			households.at(loc_ID-1).add_agent(aID);
-			agents.at(aID-1).set_leisure_type("household");
-			agents.at(aID-1).set_leisure_ID(loc_ID);
-			// Record this visit
-			contact_tracing.add_household(aID, loc_ID, static_cast<int>(time));
-		} else if (is_public) {
-			// Only add if leisure location is within town
-			if(!leisure_locations.at(loc_ID-1).outside_town()){
-				leisure_locations.at(loc_ID-1).add_agent(aID);
+		for (const int change : changes.at(ir)) {
+			if (change < 0) {
+				contact_tracing.set_house_isolation(-change, false);
+				continue;
+			}
+			if (contact_tracing.house_is_isolated(change)) {
+				continue;
+			}
+			contact_tracing.set_house_isolation(change, true);
+			// Residents and guests from this process, a step later
+			// than the agents traced by the other process
+			if (partition->owner_of_household(change) == comm->rank()) {
+				const std::vector<int>& present = households.at(change-1).get_agent_IDs();
+				const std::vector<int>& guests = households.at(change-1).get_visitor_IDs();
+				traced.insert(traced.end(), present.begin(), present.end());
+				traced.insert(traced.end(), guests.begin(), guests.end());
 			}
-			agents.at(aID-1).set_leisure_type("public");
-			agents.at(aID-1).set_leisure_ID(loc_ID);
 		}
 	}
+	setup_traced_isolation(traced);
 }
 
-// Verify if anything happens at this step
-void ABM::check_events()
+// Currently infected with each strain
+void ABM::count_infected_strains(std::vector<int>& all_infected)
 {
-	double tol = 1e-3;
-	
-	// New strain - random selection of the first carrier out of the susceptible poll
-	// Assumes that strain 2 didn't exist before
-	if (equal_floats<double>(time, infection_parameters.at("introduction of a new strain"), tol)){
-		// Select agent
-		std::vector<int> susceptible;
-		int new_agent_ID = 0;
-		for (const auto& agent : agents){
-			if (!agent.infected()){
-				susceptible.push_back(agent.get_ID());
+	all_infected.assign(n_strains, 0);
+	if (!comm) {
+		for (const auto& agent : agents) {
+			if (agent.infected()) {
+				++all_infected.at(agent.get_strain()-1);
 			}
 		}
-		infection.vector_shuffle(susceptible);
-		new_agent_ID = susceptible.at(0);
-		Agent& new_agent = agents.at(new_agent_ID-1);
-		// Remove from flu
-		flu.remove_susceptible_agent(new_agent_ID);
-		// Initialize properties without a possibility of testing (like initial exposed)
-		int strain_id = 2;
-		new_agent.set_infected(true);
-		new_agent.set_strain(strain_id);
-		initial_exposed(new_agent);		
+		return;
 	}
+	std::vector<double> counts(n_strains, 0.0);
+	for (const int aID : owned_agents) {
+		const Agent& agent = agents.at(aID-1);
+		if (agent.infected()) {
+			++counts.at(agent.get_strain()-1);
+		}
+	}
+	comm->all_reduce_sum(counts);
+	std::copy(counts.begin(), counts.end(), all_infected.begin());
 }
 
-// Verify if anything that requires parameter changes happens at this step 
+// Random susceptible agent, same for any number of processes
+Agent* ABM::select_susceptible_agent()
+{
+	if (!comm) {
+		// Single pass, without collecting all the susceptible
+		auto selected = infection.reservoir_sample(agents.begin(), agents.end(), 1,
+							[](const Agent& agent){ return !agent.infected(); });
+		if (selected.empty()) {
+			throw std::runtime_error("No susceptible agents to introduce the new strain");
+		}
+		return &(*selected.front());
+	}
+	// Susceptible in each process and a random number from the first one
+	auto susceptible = [this](const int aID){ return !agents.at(aID-1).infected(); };
+	std::vector<double> counts(comm->size() + 1, 0.0);
+	counts.at(comm->rank()) = std::count_if(owned_agents.begin(), owned_agents.end(), susceptible);
+	if (comm->rank() == 0) {
+		counts.back() = infection.get_uniform();
+	}
+	comm->all_reduce_sum(counts);
+	const double n_total = std::accumulate(counts.begin(), counts.end() - 1, 0.0);
+	if (n_total == 0.0) {
+		throw std::runtime_error("No susceptible agents to introduce the new strain");
+	}
+	// Process chosen with probability proportional to its susceptible
+	const double target = counts.back()*n_total;
+	int chosen = 0;
+	double n_below = counts.at(0);
+	while (chosen < comm->size() - 1 && (n_below <= target || counts.at(chosen) == 0.0)) {
+		++chosen;
+		n_below += counts.at(chosen);
+	}
+	// Target at the very end
+	while (counts.at(chosen) == 0.0) {
+		--chosen;
+	}
+	if (chosen != comm->rank()) {
+		return nullptr;
+	}
+	auto selected = infection.reservoir_sample(owned_agents.begin(), owned_agents.end(), 1, susceptible);
+	return &agents.at(*selected.front() - 1);
+}
+
+// Apply the events of the timeline due at this step
+void ABM::check_events()
+{
+	ABM_PROFILE_PHASE(step_stats, check_events);
+	Tracer::Scope trace_phase(tracer.get(), "check_events", "phase");
+	check_events(schools, workplaces);
+}
+
+// Apply the events due at this step, changes of places to the given ones
 void ABM::check_events(std::vector<School>& schools, std::vector<Workplace>& workplaces)
 {
-	;
+	const auto events = timeline.due(current_step());
+	for (auto event = events.first; event != events.second; ++event) {
+		switch (event->type) {
+			case EventTimeline::new_strain:
+				introduce_strain(static_cast<int>(event->value));
+				break;
+			case EventTimeline::testing_change:
+				testing.change_fractions(event->value, event->second_value);
+				break;
+			case EventTimeline::vaccination_rate:
+				vaccination_rate = event->value;
+				break;
+			case EventTimeline::leisure_fraction:
+				leisure_fraction = event->value;
+				break;
+			case EventTimeline::workplace_absenteeism:
+				for (auto& work : workplaces) {
+					work.change_absenteeism_correction(event->value);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+// Infect a random susceptible agent with a new strain
+void ABM::introduce_strain(const int strain_id)
+{
+	// Random selection of the first carrier out of the susceptible poll
+	Agent* selected = select_susceptible_agent();
+	// Introduced by another process
+	if (selected == nullptr) {
+		return;
+	}
+	Agent& new_agent = *selected;
+	const int new_agent_ID = new_agent.get_ID();
+	// Remove from flu
+	flu.remove_susceptible_agent(new_agent_ID);
+	// Initialize properties without a possibility of testing (like initial exposed)
+	new_agent.set_infected(true);
+	new_agent.set_strain(strain_id);
+	initial_exposed(new_agent);		
+	vaccinations.update_eligibility(new_agent);
+	ABM_PROFILE_COUNT(step_stats, check_events, agents, 1);
 }
 
 // Correct outside location fraction with relative prevalence of each strain
 void ABM::compute_outside_locations() 
 {	
-	std::vector<int> all_infected = get_num_infected_strains(n_strains);
+	ABM_PROFILE_PHASE(step_stats, compute_outside_locations);
+	Tracer::Scope trace_phase(tracer.get(), "compute_outside_locations", "phase");
+	count_infected_strains(all_infected);
 	double tot_strains = static_cast<double>(std::accumulate(all_infected.begin(),
 							all_infected.end(), 0)); 
 	for (int ist = 0; ist < n_strains; ++ist) {
@@ -1270,12 +1963,14 @@ void ABM::compute_outside_locations()
 // Update transmission dynamics in workplaces outside of the town
 void ABM::set_outside_workplace_transmission()
 {
+	const double frac_infected = infection_parameters.at(frac_estimated_infected);
 	for (auto& workplace : workplaces) {
 		if (workplace.outside_town()) {
 			for (int ist = 1; ist <= n_strains; ++ist) {
 				workplace.set_outside_infected(
-					infection_parameters.at("fraction estimated infected")*strain_correction.at(ist-1), ist);
+					frac_infected*strain_correction.at(ist-1), ist);
 			}
+			ABM_PROFILE_COUNT(step_stats, compute_outside_locations, place_updates, 1);
 		}
 	}
 }
@@ -1283,12 +1978,14 @@ void ABM::set_outside_workplace_transmission()
 // Update transmission dynamics in leisure locations outside of the town
 void ABM::set_outside_leisure_transmission()
 {
+	const double frac_infected = infection_parameters.at(frac_estimated_infected);
 	for (auto& leisure_location : leisure_locations) {
 		if (leisure_location.outside_town()) {
 			for (int ist = 1; ist <= n_strains; ++ist) {
 				leisure_location.set_outside_infected(
-					infection_parameters.at("fraction estimated infected")*strain_correction.at(ist-1), ist);
+					frac_infected*strain_correction.at(ist-1), ist);
 			}
+			ABM_PROFILE_COUNT(step_stats, compute_outside_locations, place_updates, 1);
 		}
 	}
 }
@@ -1297,10 +1994,12 @@ void ABM::set_outside_leisure_transmission()
 // Count contributions of all infectious agents in each place
 void ABM::compute_place_contributions()
 {
+	ABM_PROFILE_PHASE(step_stats, compute_place_contributions);
+	Tracer::Scope trace_phase(tracer.get(), "compute_place_contributions", "phase");
 	for (const auto& agent : agents){
 
 		// Only removed - dead don't contribute
-		if (agent.removed_dead() == true) {
+		if (agent.removed_dead() == true || !simulated_here(agent)) {
 			continue;
 		}
 
@@ -1318,6 +2017,7 @@ void ABM::compute_place_contributions()
 
 		// Consider all infectious cases, raise 
 		// exception if no existing case
+		ABM_PROFILE_COUNT(step_stats, compute_place_contributions, agents, 1);
 		if (agent.exposed() == true){
 			contributions.compute_exposed_contributions(agent, time, households, 
 							schools, workplaces, hospitals, retirement_homes,
@@ -1330,26 +2030,34 @@ void ABM::compute_place_contributions()
 			throw std::runtime_error("Agent does not have any state");
 		}
 	}
+	if (comm) {
+		reduce_place_contributions();
+	}
 	contributions.total_place_contributions(households, schools, 
 											workplaces, hospitals, retirement_homes,
 											carpools, public_transit, leisure_locations);
+	ABM_PROFILE_COUNT(step_stats, compute_place_contributions, place_updates, number_of_places());
 }
 
 // Determine infection propagation and
 // state changes 
 void ABM::compute_state_transitions()
 {
+	ABM_PROFILE_PHASE(step_stats, compute_state_transitions);
+	Tracer::Scope trace_phase(tracer.get(), "compute_state_transitions", "phase");
 	int newly_infected = 0, is_recovered = 0;
 	bool re_vac = false;
 	// Infected state change flags: 
 	// recovered - healthy, recovered - dead, tested at this step,
 	// tested positive at this step, tested false negative
-	std::vector<int> state_changes = {0, 0, 0, 0, 0};
+	InfectedChanges state_changes = {};
 	// Susceptible state changes
 	// infected, tested, tested negative, tested false positive
-	std::vector<int> s_state_changes = {0, 0, 0, 0};
-	// First entry is one if agent recovered, second if agent died
-	std::vector<int> removed = {0,0};
+	SusceptibleChanges s_state_changes = {};
+	const bool collect_data = (time >= infection_parameters.at(data_collection_start));
+	// Current states, counted after the transitions
+	n_infected_now_strain.assign(n_strains, 0);
+	n_exposed_now = 0;
 
 	// Store information for that day
 	n_infected_day.push_back(0);
@@ -1362,16 +2070,17 @@ void ABM::compute_state_transitions()
 	for (auto& agent : agents){
 
 		// Skip the removed - dead 
-		if (agent.removed_dead() == true){
+		if (agent.removed_dead() == true || !simulated_here(agent)){
 			continue;
 		}
 
-		std::fill(state_changes.begin(), state_changes.end(), 0);
-		std::fill(s_state_changes.begin(), s_state_changes.end(), 0);
+		ABM_PROFILE_COUNT(step_stats, compute_state_transitions, agents, 1);
+		state_changes.fill(0);
+		s_state_changes.fill(0);
 		re_vac = transitions.common_transitions(agent, time, 
 								schools, workplaces, hospitals, 
 								retirement_homes, carpools, public_transit, 
-								contact_tracing, infection_parameters);
+								contact_tracing, n_strains);
 		if (re_vac == true) {
 			// Subtract from total since re-vaccinating (to not count twice)
 			--total_vaccinated;
@@ -1405,7 +2114,7 @@ void ABM::compute_state_transitions()
 						   	infection_parameters);
 			n_recovered_tot += state_changes.at(0);
 			// Collect only after a specified time
-			if (time >= infection_parameters.at("time to start data collection")){
+			if (collect_data){
 				if (state_changes.at(1) == 1){
 					// Dead after testing
 					++n_dead_tested;
@@ -1421,7 +2130,7 @@ void ABM::compute_state_transitions()
 		}
 
 		// Recording testing changes for this agent
-		if (time >= infection_parameters.at("time to start data collection")){
+		if (collect_data){
 			if (agent.exposed() || agent.symptomatic()){
 				if (state_changes.at(2) == 1){
 					++tested_day.back();
@@ -1430,8 +2139,8 @@ void ABM::compute_state_transitions()
 				if (state_changes.at(3) == 1){
 					++tested_pos_day.back();
 					++tot_tested_pos;
-					// Confirmed positive - initiate contact tracing
-					contact_trace_agent(agent);
+					// Confirmed positive - trace after the transitions
+					confirmed_cases.push_back(agent.get_ID());
 				}
 				if (state_changes.at(4) == 1){
 					++tested_false_neg_day.back();
@@ -1450,27 +2159,62 @@ void ABM::compute_state_transitions()
 				if (s_state_changes.at(3) == 1){
 					++tested_false_pos_day.back();
 					++tot_tested_false_pos;
-					// False positive - initiate contact tracing
-					contact_trace_agent(agent);
+					// False positive - trace after the transitions
+					confirmed_cases.push_back(agent.get_ID());
 				}
 			}
 		}
+
+		// Vaccination eligibility after the changes
+		vaccinations.update_eligibility(agent);
+
+		// Counts of current states for this step
+		if (agent.infected()) {
+			++n_infected_now_strain.at(agent.get_strain()-1);
+		}
+		if (agent.exposed()) {
+			++n_exposed_now;
+		}
+	}
+	contact_trace_confirmed();
+	// Flu cases that replaced the recovered ones
+	for (const int aID : flu.take_new_flu_IDs()) {
+		vaccinations.update_eligibility(agents.at(aID-1));
+	}
+	if (comm) {
+		exchange_isolated_households();
 	}
+	current_counts_valid = true;
 }
 
-// Initiate contact tracing of an agent
-void ABM::contact_trace_agent(Agent& agent)
+// Contacts of all cases, each traced agent processed once
+void ABM::contact_trace_confirmed()
 {
-	// All the cases that don't need to be traced now
-	if (agent.hospital_non_covid_patient() || agent.hospitalized()
-			|| agent.hospitalized_ICU()) {
+	if (confirmed_cases.empty()) {
 		return;
 	}
+	ABM_PROFILE_PHASE(step_stats, contact_tracing);
+	all_traced.clear();
+	for (const int aID : confirmed_cases) {
+		Agent& agent = agents.at(aID-1);
+		// All the cases that don't need to be traced now
+		if (agent.hospital_non_covid_patient() || agent.hospitalized()
+				|| agent.hospitalized_ICU()) {
+			continue;
+		}
+		Tracer::Scope trace_agent(tracer.get(), "contact_trace_agent", "contact tracing", "agent", aID);
+		collect_contacts(agent, all_traced);
+	}
+	confirmed_cases.clear();
+	// Process all the traced agents
+	setup_traced_isolation(all_traced);
+	ABM_PROFILE_COUNT(step_stats, contact_tracing, agents, all_traced.size());
+}
 
+// Contacts of one case
+void ABM::collect_contacts(Agent& agent, std::vector<int>& contacts)
+{
 	int aID = agent.get_ID();
-
-	// Collect all agents to trace
-	std::unordered_set<int> all_traced;	
 	std::vector<int> traced;
 
 	// Consider each type
@@ -1479,7 +2223,7 @@ void ABM::contact_trace_agent(Agent& agent)
 					schools.at(agent.get_school_ID()-1), 
 					static_cast<int>(infection_parameters.at("max contacts at school")), 
 					infection);
-		all_traced.insert(traced.begin(), traced.end());
+		contacts.insert(contacts.end(), traced.begin(), traced.end());
 	}
 	if (agent.works() && !agent.works_from_home()) {
 		if (agent.retirement_home_employee()) {
@@ -1488,19 +2232,19 @@ void ABM::contact_trace_agent(Agent& agent)
 					static_cast<int>(infection_parameters.at("max contacts at RH")),
 					static_cast<int>(infection_parameters.at("max contacts residents at RH")),
 					infection);
-			all_traced.insert(traced.begin(), traced.end());
+			contacts.insert(contacts.end(), traced.begin(), traced.end());
 		} else if (agent.school_employee()) {
 			traced = contact_tracing.isolate_school(aID, agents, 
 					schools.at(agent.get_work_ID()-1), 
 					static_cast<int>(infection_parameters.at("max contacts at school")), 
 					infection);
-			all_traced.insert(traced.begin(), traced.end());
+			contacts.insert(contacts.end(), traced.begin(), traced.end());
 		} else {
 			traced = contact_tracing.isolate_workplace(aID, agents, 
 				workplaces.at(agent.get_work_ID()-1), 
 				static_cast<int>(infection_parameters.at("max contacts at workplace")),
 				infection);
-			all_traced.insert(traced.begin(), traced.end());
+			contacts.insert(contacts.end(), traced.begin(), traced.end());
 		}
 	}
 	if (agent.hospital_employee()) {
@@ -1508,12 +2252,12 @@ void ABM::contact_trace_agent(Agent& agent)
 				hospitals.at(agent.get_hospital_ID()-1), 
 				static_cast<int>(infection_parameters.at("max contacts at hospital")),
 				infection);
-		all_traced.insert(traced.begin(), traced.end());	
+		contacts.insert(contacts.end(), traced.begin(), traced.end());	
 	}
  	if (agent.get_work_travel_mode() == "carpool") {
 		traced = contact_tracing.isolate_carpools(aID, agents, 
 				carpools.at(agent.get_carpool_ID()-1)); 
-		all_traced.insert(traced.begin(), traced.end());
+		contacts.insert(contacts.end(), traced.begin(), traced.end());
 	}
 	if (agent.retirement_home_resident()) { 
 			traced = contact_tracing.isolate_retirement_home(aID, agents, 
@@ -1521,40 +2265,42 @@ void ABM::contact_trace_agent(Agent& agent)
 						static_cast<int>(infection_parameters.at("max contacts at RH")),
 						static_cast<int>(infection_parameters.at("max contacts residents at RH")),
 						infection);
-		all_traced.insert(traced.begin(), traced.end());
+		contacts.insert(contacts.end(), traced.begin(), traced.end());
 	} else {
 		// Private visits
 		traced = contact_tracing.isolate_visited_households(aID, households,
 					infection_parameters.at("contact tracing compliance"), infection,
 					static_cast<int>(time), dt);
-		all_traced.insert(traced.begin(), traced.end());
+		contacts.insert(contacts.end(), traced.begin(), traced.end());
 		// Agent's household (only eligible)
 		traced = contact_tracing.isolate_household(aID, 
 						households.at(agent.get_household_ID()-1));
-		all_traced.insert(traced.begin(), traced.end());
+		contacts.insert(contacts.end(), traced.begin(), traced.end());
 	}
-	// Process all the traced agents
-	setup_traced_isolation(all_traced);
 }
 
-void ABM::setup_traced_isolation(const std::unordered_set<int>& traced_IDs) 
+// Each agent once, in the order of IDs 
+void ABM::setup_traced_isolation(std::vector<int>& traced_IDs) 
 {
+	std::sort(traced_IDs.begin(), traced_IDs.end());
+	traced_IDs.erase(std::unique(traced_IDs.begin(), traced_IDs.end()), traced_IDs.end());
 	for (const auto& aID : traced_IDs) {
 		if (!agents.at(aID-1).contact_traced()) {
 			transitions.new_quarantined(agents.at(aID-1), time, dt, 
     	            infection, households, schools, workplaces, hospitals, retirement_homes,
-    	            carpools, public_transit, infection_parameters);
+    	            carpools, public_transit, infection_parameters, &quarantine_removals);
+			vaccinations.update_eligibility(agents.at(aID-1));
 		}
 	}
+	Transitions::remove_from_places(quarantine_removals);
 }
 
 // Start detection, initialize agents with flu, vaccinate
 void ABM::start_testing_flu_and_vaccination(const bool dont_vac)
 {
-	double tol = 1e-3;
 	// Initialize agents with flu the time step the testing starts 
 	// Optionally also vaccinate part of the population or/and specific groups
-	if (equal_floats<double>(time, infection_parameters.at("start testing"), tol)){
+	if (current_step() == EventTimeline::step_of(infection_parameters.at("start testing"), dt)){
 		// Vaccinate
 		if (dont_vac == false) {
 			if (random_vaccines == true){
@@ -1584,6 +2330,7 @@ void ABM::start_testing_flu_and_vaccination(const bool dont_vac)
 					   		 schools, workplaces, retirement_homes,
 							 carpools, public_transit, infection, 
 							 infection_parameters, flu, testing);
+			vaccinations.update_eligibility(agent);
 		}
 	}
 }
@@ -15,23 +15,64 @@
 // Add guest household ID to agent aID
 void Contact_tracing::add_household(const int aID, const int hID, const int time)
 {
-	std::deque<std::vector<int>>& visits = private_leisure.at(aID-1);
-	if (visits.size() < max_num_hID) {
-		visits.push_back(std::vector<int>{hID, time});
+	if (max_num_hID == 0) {
+		return;
+	}
+	const size_t first = static_cast<size_t>(aID-1)*max_num_hID;
+	int& start = visit_start.at(aID-1);
+	int& count = visit_count.at(aID-1);
+	if (count < max_num_hID) {
+		visits.at(first + (start + count)%max_num_hID) = {hID, time};
+		++count;
 	} else {
-		visits.pop_front();
-		visits.push_back(std::vector<int>{hID, time});
+		// Overwrite the oldest
+		visits.at(first + start) = {hID, time};
+		start = (start + 1)%max_num_hID;
+	}
+	assert(count <= max_num_hID); 
+}
+
+// Stored visits as separate records
+std::vector<std::deque<std::vector<int>>> Contact_tracing::get_private_leisure() const
+{
+	std::vector<std::deque<std::vector<int>>> private_leisure(num_agents);
+	for (int ia = 0; ia < num_agents; ++ia) {
+		const size_t first = static_cast<size_t>(ia)*max_num_hID;
+		for (int iv = 0; iv < visit_count.at(ia); ++iv) {
+			const Visit& visit = visits.at(first + (visit_start.at(ia) + iv)%max_num_hID);
+			private_leisure.at(ia).push_back({visit.house_ID, visit.time});
+		}
+	}
+	return private_leisure;
+}
+
+// Lift household quarantine
+void Contact_tracing::reset_house_isolation(const int hID)
+{
+	if (track_changes && is_isolated.at(hID-1)) {
+		isolation_changes.push_back(-hID);
 	}
-	assert(visits.size() <= max_num_hID); 
+	is_isolated.at(hID-1) = false;
+}
+
+// Changes since the last call
+std::vector<int> Contact_tracing::take_isolation_changes()
+{
+	std::vector<int> changes = {};
+	std::swap(changes, isolation_changes);
+	return changes;
 }
 
 // Apply isolation to the household of agent aID
 std::vector<int> Contact_tracing::isolate_household(const int aID, const Household& household)
 {
 	std::vector<int> traced;
-	for (const auto& ag : household.get_agent_IDs()) {
-		if (ag != aID) {
-			traced.push_back(ag);
+	// Residents and guests at this step
+	for (const std::vector<int>* present : {&household.get_agent_IDs(), &household.get_visitor_IDs()}) {
+		for (const auto& ag : *present) {
+			if (ag != aID) {
+				traced.push_back(ag);
+			}
 		}
 	}
 	// Abandoning for now
@@ -46,31 +87,39 @@ std::vector<int> Contact_tracing::isolate_visited_households(const int aID,
 									const int time, const double dt)
 {
 	std::vector<int> traced;
-	std::deque<std::vector<int>>& visits = private_leisure.at(aID-1);
-	while (!visits.empty()) {
-		std::vector<int> hdata = visits.front();
-		int hsID = hdata.at(0);
-		int tvis = hdata.at(1);
+	const size_t first = static_cast<size_t>(aID-1)*max_num_hID;
+	const int start = visit_start.at(aID-1);
+	const int count = visit_count.at(aID-1);
+	// All stored visits are used and then forgotten
+	visit_start.at(aID-1) = 0;
+	visit_count.at(aID-1) = 0;
+	for (int iv = 0; iv < count; ++iv) {
+		const Visit& visit = visits.at(first + (start + iv)%max_num_hID);
+		int hsID = visit.house_ID;
+		int tvis = visit.time;
 		int del_tvis = time - tvis;
 		// This is kind of hideous but will do for now
 		// Will apply CT only to households visited within an input #days		
 		if (del_tvis > static_cast<int>(max_num_hID*dt)) {
-			visits.pop_front();
 			continue;
 		}
  		// Check if guest household will isolate (if not already isolated)
 		if (!is_isolated.at(hsID-1) && infection.get_uniform() <= compliance) {
-			for (const auto& ag : households.at(hsID-1).get_agent_IDs()) {
-				if (ag != aID) {
-					// In case a guest at this step
-					traced.push_back(ag);
+			const Household& house = households.at(hsID-1);
+			for (const std::vector<int>* present : {&house.get_agent_IDs(), &house.get_visitor_IDs()}) {
+				for (const auto& ag : *present) {
+					if (ag != aID) {
+						// In case a guest at this step
+						traced.push_back(ag);
+					}
 				}
 			}
 			is_isolated.at(hsID-1) = true;		
+			if (track_changes) {
+				isolation_changes.push_back(hsID);
+			}
 		} 
-		visits.pop_front();
 	}
-	assert(visits.empty());
 	return traced;
 }
 
@@ -80,11 +129,11 @@ std::vector<int> Contact_tracing::isolate_workplace(const int aID, const std::ve
 						Infection& infection)
 {
 	std::vector<int> traced;
-	std::vector<int> coworkers = workplace.get_agent_IDs();
+	const std::vector<int>& coworkers = workplace.get_agent_IDs();
 	if (!coworkers.empty()) {
-		infection.vector_shuffle(coworkers);
 		int num_coworkers = coworkers.size() >= num_contacts ? num_contacts : coworkers.size();
-		for (int i=0; i<num_coworkers; ++i) {
+		// Random num_coworkers members without copying all
+		for (const int i : infection.sample_without_replacement(coworkers.size(), num_coworkers)) {
 			if (coworkers.at(i) == aID) {
 				continue;
 			} else {
@@ -101,23 +150,19 @@ std::vector<int> Contact_tracing::isolate_hospital(const int aID, const std::vec
 							Infection& infection)
 {
 	std::vector<int> traced;
-	std::vector<int> everyone = hospital.get_agent_IDs();
-	if (!everyone.empty()) {
-		infection.vector_shuffle(everyone);
-		int num_coworkers = 0;
-		for (const auto& ag : everyone) {
-			const Agent& agent = agents.at(ag-1);
-			if (ag == aID || !agent.hospital_employee()) {
-				continue;
-			} else {
-				traced.push_back(ag);
-				++num_coworkers;
+	const std::vector<int>& everyone = hospital.get_agent_IDs();
+	// Members in random order until enough employees, 
+	// only the members checked are drawn
+	int num_coworkers = 0;
+	infection.visit_in_random_order(everyone.size(), [&](const size_t i) {
+			const int ag = everyone.at(i);
+			if (ag == aID || !agents.at(ag-1).hospital_employee()) {
+				return true;
 			}
-			if (num_coworkers >= num_contacts) {
-				break;
-			}
-		}
-	}
+			traced.push_back(ag);
+			++num_coworkers;
+			return num_coworkers < num_contacts;
+		});
 	return traced; 	
 }
 
@@ -127,28 +172,24 @@ std::vector<int> Contact_tracing::isolate_retirement_home(const int aID, const s
 							const double num_res, Infection& infection)
 {
 	std::vector<int> traced;
-	std::vector<int> everyone = retirement_home.get_agent_IDs();
-	if (!everyone.empty()) {
-		infection.vector_shuffle(everyone);
-		int num_coworkers = 0, num_residents = 0;
-		for (const auto& ag : everyone) {
-			const Agent& agent = agents.at(ag-1);
+	const std::vector<int>& everyone = retirement_home.get_agent_IDs();
+	// Members in random order until enough employees and residents
+	int num_coworkers = 0, num_residents = 0;
+	infection.visit_in_random_order(everyone.size(), [&](const size_t i) {
+			const int ag = everyone.at(i);
 			if (ag == aID) {
-				continue;
-			} else {
-				if (agent.retirement_home_employee() && num_coworkers < num_emp) {
-					++num_coworkers;
-					traced.push_back(ag);
-				} else if (agent.retirement_home_resident() && num_residents < num_res) {
-					++num_residents;
-					traced.push_back(ag);
-				} 		
+				return true;
 			}
-			if (num_coworkers >= num_emp && num_residents >= num_res) {
-				break;
+			const Agent& agent = agents.at(ag-1);
+			if (agent.retirement_home_employee() && num_coworkers < num_emp) {
+				++num_coworkers;
+				traced.push_back(ag);
+			} else if (agent.retirement_home_resident() && num_residents < num_res) {
+				++num_residents;
+				traced.push_back(ag);
 			}
-		}
-	}
+			return num_coworkers < num_emp || num_residents < num_res;
+		});
  	return traced;	
 }
 
@@ -162,79 +203,64 @@ std::vector<int> Contact_tracing::isolate_school(const int aID, std::vector<Agen
 	const Agent& agent = agents.at(aID-1);
 	bool is_student = (agent.student() && (agent.get_school_ID() == school.get_ID()));
 	// Students and staff
- 	std::vector<int> everyone = school.get_agent_IDs();
-	if (everyone.size() <= 1) {
+	if (school.get_agent_IDs().size() <= 1) {
 		return traced;
 	}
+	// Students present, by age
+	const std::map<int, std::vector<int>>& classes = school.get_students_by_age();
 	// Select the age of the class
 	int age = 0;
 	if (is_student) {
 		age = agent.get_age();
 	} else {
-		// Select all students
-		std::vector<int> all_students;
-		for (const auto& ag : everyone) {
-			if (ag == aID) {
-				// Skip self
-				continue;
-			}
-			// Add potential student
-			if (agents.at(ag-1).student() && (agents.at(ag-1).get_school_ID() == school.get_ID())) { 
-				all_students.push_back(ag);				
-			}
+		// Randomly select a student and their age,
+		// the agent is not one of the students
+		int n_all = 0;
+		for (const auto& age_class : classes) {
+			n_all += age_class.second.size();
 		}
-		// Randomly select a student and their age
-		if (!all_students.empty()) {
-			int i = infection.get_int(0, all_students.size()-1);
-			age = agents.at(all_students.at(i)-1).get_age();
-		} else {
+		if (n_all == 0) {
 			return traced;
 		}
+		int i = infection.get_int(0, n_all-1);
+		for (const auto& age_class : classes) {
+			if (i < static_cast<int>(age_class.second.size())) {
+				age = age_class.first;
+				break;
+			}
+			i -= age_class.second.size();
+		}
 	} 	
-	// Class size counter
-	int n_class = 0;
-	// Isolate one teacher and n_student sized class
-	// Fist a teacher if infected agent is a student
-	std::vector<int> teachers;
-	if (is_student) {
-		for (const auto& ag : everyone) {
+	// Isolate an n_student sized class
+	const auto age_class = classes.find(age);
+	if (age_class != classes.end()) {
+		int n_class = 0;
+		for (const auto& ag : age_class->second) {
+			if (n_class >= n_students) {
+				break;
+			}
 			if (ag == aID) {
 				// Skip self
 				continue;
 			}
-			// Add potential teacher
-			if (agents.at(ag-1).school_employee() &&
-					(agents.at(ag-1).get_work_ID() == school.get_ID())) { 
-				teachers.push_back(ag);				
-			}
-		}
-	}
-	// Isolate an n_student sized class
-	for (const auto& ag : everyone) {
-		if (ag == aID) {
-			// Skip self
-			continue;
-		}
-		// Collect the class
-		if ((agents.at(ag-1).get_age() == age) &&
-				(agents.at(ag-1).get_school_ID() == school.get_ID())) {
 			traced.push_back(ag);
 			++n_class;	
 		}
-		if (n_class >= n_students) {
-			// Done collecting a class, add a teacher if agent is a student
-			if (is_student && !teachers.empty()) {
-				infection.vector_shuffle(teachers);
-				traced.push_back(teachers.at(0));
+	}
+	// Add a teacher if infected agent is a student
+	if (is_student) {
+		const std::vector<int>& staff = school.get_employee_IDs();
+		const auto self = std::find(staff.begin(), staff.end(), aID);
+		const int n_teachers = staff.size() - (self == staff.end() ? 0 : 1);
+		if (n_teachers > 0) {
+			int i = infection.get_int(0, n_teachers-1);
+			// Skip self
+			if (self != staff.end() && i >= self - staff.begin()) {
+				++i;
 			}
-			break;
+			traced.push_back(staff.at(i));
 		}
 	}
-	if (n_class < n_students && is_student && !teachers.empty()) {
-		// Done collecting a class, add a teacher if agent is a student
-		infection.vector_shuffle(teachers);
-		traced.push_back(teachers.at(0));
-	}
 	return traced;
 }
 
@@ -9,6 +9,27 @@
  * 
  ******************************************************/
 
+namespace {
+	// Names of the transmission rates, created once so that 
+	// the lookups for each infectious agent don't allocate
+	const std::string hospital_patients_rate("hospital patients transmission rate");
+	const std::string healthcare_employees_rate("healthcare employees transmission rate");
+	const std::string household_rate("household transmission rate");
+	const std::string school_rate("school transmission rate");
+	const std::string carpool_rate("carpool transmission rate");
+	const std::string public_transit_rate("public transit transmission rate");
+	const std::string leisure_locations_rate("leisure locations transmission rate");
+	const std::string rh_resident_rate("RH resident transmission rate");
+	const std::string rh_employee_rate("RH employee transmission rate");
+	const std::string school_employee_rate("school employee transmission rate");
+	const std::string workplace_rate("workplace transmission rate");
+	const std::string hospital_tested_rate("hospital tested transmission rate");
+	const std::string rh_home_isolated_rate("RH transmission rate of home isolated");
+	const std::string home_isolated_rate("transmission rate of home isolated");
+	const std::string hospitalized_rate("hospitalized transmission rate");
+	const std::string hospitalized_icu_rate("hospitalized ICU transmission rate");
+}
+
 // Count contributions of an exposed agent
 void Contributions::compute_exposed_contributions(const Agent& agent, const double time,	
 				std::vector<Household>& households, std::vector<School>& schools,
@@ -46,7 +67,7 @@ void Contributions::compute_exposed_contributions(const Agent& agent, const doub
 				compute_home_isolated_contributions(agent, inf_var, households, retirement_homes);
 			} else if (agent.hospital_non_covid_patient()){
 				Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
-				hospital.add_exposed_patient(inf_var, trans_rates.at("hospital patients transmission rate"), strain_id);
+				hospital.add_exposed_patient(inf_var, trans_rates.at(hospital_patients_rate), strain_id);
 			} else if (agent.hospital_employee()){
 				// Exposed confirmed COVID in home isolation or quarantined due to COVID exposure
 				if (agent.contact_traced()){
@@ -54,34 +75,34 @@ void Contributions::compute_exposed_contributions(const Agent& agent, const doub
 					return;
 				}
 				Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
-				hospital.add_exposed(inf_var, trans_rates.at("healthcare employees transmission rate"), strain_id);
+				hospital.add_exposed(inf_var, trans_rates.at(healthcare_employees_rate), strain_id);
 				// Household
 				Household& household = households.at(agent.get_household_ID()-1);
-				household.add_exposed(inf_var, trans_rates.at("household transmission rate"), strain_id);
+				household.add_exposed(inf_var, trans_rates.at(household_rate), strain_id);
 				// Other places
 				if (agent.student() == true){
 					School& school = schools.at(agent.get_school_ID()-1);
-					school.add_exposed(inf_var, trans_rates.at("school transmission rate"), strain_id);	
+					school.add_exposed(inf_var, trans_rates.at(school_rate), strain_id);	
 				}
 				// Transit
 				if (agent.get_work_travel_mode() == "carpool") {
 					Transit& carpool = carpools.at(agent.get_carpool_ID()-1);
-					carpool.add_exposed(inf_var, trans_rates.at("carpool transmission rate"), strain_id);
+					carpool.add_exposed(inf_var, trans_rates.at(carpool_rate), strain_id);
 				}
 				if (agent.get_work_travel_mode() == "public") {
 					Transit& bus = public_transit.at(agent.get_public_transit_ID()-1);
-					bus.add_exposed(inf_var, trans_rates.at("public transit transmission rate"), strain_id);
+					bus.add_exposed(inf_var, trans_rates.at(public_transit_rate), strain_id);
 				}
 				// Leisure
 				if (agent.get_leisure_ID() > 0) {
 					if (agent.get_leisure_type() == "public") {
 						Leisure& les_loc = leisure_locations.at(agent.get_leisure_ID()-1); 
 						if (!les_loc.outside_town()){
-							les_loc.add_exposed(inf_var, trans_rates.at("leisure locations transmission rate"), strain_id);
+							les_loc.add_exposed(inf_var, trans_rates.at(leisure_locations_rate), strain_id);
 						}
 					} else if (agent.get_leisure_type() == "household") {
 						Household& household = households.at(agent.get_leisure_ID()-1);
-						household.add_exposed(inf_var, trans_rates.at("household transmission rate"), strain_id);
+						household.add_exposed(inf_var, trans_rates.at(household_rate), strain_id);
 					} else {
 						throw std::invalid_argument("Wrong leisure type: " + agent.get_leisure_type());
 					}
@@ -94,7 +115,7 @@ void Contributions::compute_exposed_contributions(const Agent& agent, const doub
 		if (agent.hospital_non_covid_patient() == true &&
 				agent.tested_covid_positive() == false){
 			Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
-			hospital.add_exposed_patient(inf_var, trans_rates.at("hospital patients transmission rate"), strain_id);
+			hospital.add_exposed_patient(inf_var, trans_rates.at(hospital_patients_rate), strain_id);
 			return;
 		}
 	
@@ -107,54 +128,54 @@ void Contributions::compute_exposed_contributions(const Agent& agent, const doub
 		// Household or retirement home
 		if (agent.retirement_home_resident()){
 			RetirementHome& rh = retirement_homes.at(agent.get_household_ID()-1);
-			rh.add_exposed(inf_var, trans_rates.at("RH resident transmission rate"), strain_id);
+			rh.add_exposed(inf_var, trans_rates.at(rh_resident_rate), strain_id);
 		} else {
 			Household& household = households.at(agent.get_household_ID()-1);
-			household.add_exposed(inf_var, trans_rates.at("household transmission rate"), strain_id);
+			household.add_exposed(inf_var, trans_rates.at(household_rate), strain_id);
 		}
 
 		// Other places
 		if (agent.student() == true){
 			School& school = schools.at(agent.get_school_ID()-1);
-			school.add_exposed(inf_var, trans_rates.at("school transmission rate"), strain_id);	
+			school.add_exposed(inf_var, trans_rates.at(school_rate), strain_id);	
 		}
 		if (agent.works() && !agent.works_from_home()) {
 			if (agent.retirement_home_employee()){
 				RetirementHome& rh = retirement_homes.at(agent.get_work_ID()-1);
-				rh.add_exposed_employee(inf_var, trans_rates.at("RH employee transmission rate"), strain_id);
+				rh.add_exposed_employee(inf_var, trans_rates.at(rh_employee_rate), strain_id);
 			} else if (agent.school_employee()){
 				School& sch = schools.at(agent.get_work_ID()-1);
-				sch.add_exposed_employee(inf_var, trans_rates.at("school employee transmission rate"), strain_id);
+				sch.add_exposed_employee(inf_var, trans_rates.at(school_employee_rate), strain_id);
 			} else {
 				Workplace& workplace = workplaces.at(agent.get_work_ID()-1);
 				if (!workplace.outside_town()) {
-					workplace.add_exposed(inf_var, trans_rates.at("workplace transmission rate"), strain_id);
+					workplace.add_exposed(inf_var, trans_rates.at(workplace_rate), strain_id);
 				}
 			}
 		}
 		if (agent.hospital_employee() == true){
 			Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
-			hospital.add_exposed(inf_var, trans_rates.at("healthcare employees transmission rate"), strain_id);
+			hospital.add_exposed(inf_var, trans_rates.at(healthcare_employees_rate), strain_id);
 		}
 		// Transit
 		if (agent.get_work_travel_mode() == "carpool") {
 			Transit& carpool = carpools.at(agent.get_carpool_ID()-1);
-			carpool.add_exposed(inf_var, trans_rates.at("carpool transmission rate"), strain_id);
+			carpool.add_exposed(inf_var, trans_rates.at(carpool_rate), strain_id);
 		}
 		if (agent.get_work_travel_mode() == "public") {
 			Transit& bus = public_transit.at(agent.get_public_transit_ID()-1);
-			bus.add_exposed(inf_var, trans_rates.at("public transit transmission rate"), strain_id);
+			bus.add_exposed(inf_var, trans_rates.at(public_transit_rate), strain_id);
 		}
 		// Leisure
 		if (agent.get_leisure_ID() > 0) {
 			if (agent.get_leisure_type() == "public") {
 				Leisure& les_loc = leisure_locations.at(agent.get_leisure_ID()-1); 
 				if (!les_loc.outside_town()){
-					les_loc.add_exposed(inf_var, trans_rates.at("leisure locations transmission rate"), strain_id);
+					les_loc.add_exposed(inf_var, trans_rates.at(leisure_locations_rate), strain_id);
 				}
 			} else if (agent.get_leisure_type() == "household") {
 				Household& household = households.at(agent.get_leisure_ID()-1);
-				household.add_exposed(inf_var, trans_rates.at("household transmission rate"), strain_id);
+				household.add_exposed(inf_var, trans_rates.at(household_rate), strain_id);
 			} else {
 				throw std::invalid_argument("Wrong leisure type: " + agent.get_leisure_type());
 			}
@@ -210,7 +231,7 @@ void Contributions::compute_symptomatic_contributions(const Agent& agent, const
 		if ((agent.tested_false_negative() && (agent.hospital_non_covid_patient()))
 						|| (agent.hospital_non_covid_patient())){
 			Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
-			hospital.add_symptomatic_patient(inf_var, trans_rates.at("hospital patients transmission rate"), strain_id);	
+			hospital.add_symptomatic_patient(inf_var, trans_rates.at(hospital_patients_rate), strain_id);	
 		} else {
 			// If regular symptomatic
 			compute_regular_symptomatic_contributions(agent, inf_var, households,
@@ -256,30 +277,30 @@ void Contributions::compute_regular_symptomatic_contributions(const Agent& agent
 	// Household or retirement home
 	if (agent.retirement_home_resident()){
 		RetirementHome& rh = retirement_homes.at(agent.get_household_ID()-1);
-		rh.add_symptomatic(inf_var, trans_rates.at("RH resident transmission rate"), strain_id);
+		rh.add_symptomatic(inf_var, trans_rates.at(rh_resident_rate), strain_id);
 	} else {
 		Household& household = households.at(agent.get_household_ID()-1);
-		household.add_symptomatic(inf_var, trans_rates.at("household transmission rate"), strain_id);
+		household.add_symptomatic(inf_var, trans_rates.at(household_rate), strain_id);
 	}
 
 	// Other places
 	if (agent.student() == true){
 		School& school = schools.at(agent.get_school_ID()-1);
-		school.add_symptomatic_student(inf_var, trans_rates.at("school transmission rate"), strain_id);	
+		school.add_symptomatic_student(inf_var, trans_rates.at(school_rate), strain_id);	
 	}
 	if (agent.works() && !agent.works_from_home()) {
 		if (agent.retirement_home_employee()){
 			RetirementHome& rh = retirement_homes.at(agent.get_work_ID()-1);
-			rh.add_symptomatic_employee(inf_var, trans_rates.at("RH employee transmission rate"), strain_id);
+			rh.add_symptomatic_employee(inf_var, trans_rates.at(rh_employee_rate), strain_id);
 			psi_s = rh.get_absenteeism_correction();
 		} else if (agent.school_employee()){
 			School& sch = schools.at(agent.get_work_ID()-1);
-			sch.add_symptomatic_employee(inf_var, trans_rates.at("school employee transmission rate"), strain_id);
+			sch.add_symptomatic_employee(inf_var, trans_rates.at(school_employee_rate), strain_id);
 			psi_s = sch.get_absenteeism_correction();
 		} else {
 			Workplace& workplace = workplaces.at(agent.get_work_ID()-1);
 			if (!workplace.outside_town()) {
-				workplace.add_symptomatic(inf_var, trans_rates.at("workplace transmission rate"), strain_id);
+				workplace.add_symptomatic(inf_var, trans_rates.at(workplace_rate), strain_id);
 			}
 		}
 	}
@@ -287,17 +308,17 @@ void Contributions::compute_regular_symptomatic_contributions(const Agent& agent
 	if (agent.get_work_travel_mode() == "carpool") {
 		Transit& carpool = carpools.at(agent.get_carpool_ID()-1);
 		if (agent.retirement_home_employee() || agent.school_employee()) {
-			carpool.add_special_symptomatic(inf_var, psi_s, trans_rates.at("carpool transmission rate"), strain_id);
+			carpool.add_special_symptomatic(inf_var, psi_s, trans_rates.at(carpool_rate), strain_id);
 		} else {
-			carpool.add_symptomatic(inf_var, trans_rates.at("carpool transmission rate"), strain_id);
+			carpool.add_symptomatic(inf_var, trans_rates.at(carpool_rate), strain_id);
 		}
 	}
 	if (agent.get_work_travel_mode() == "public") {
 		Transit& bus = public_transit.at(agent.get_public_transit_ID()-1);
 		if (agent.retirement_home_employee() || agent.school_employee()) {
-			bus.add_special_symptomatic(inf_var, psi_s, trans_rates.at("public transit transmission rate"), strain_id);
+			bus.add_special_symptomatic(inf_var, psi_s, trans_rates.at(public_transit_rate), strain_id);
 		} else {
-			bus.add_symptomatic(inf_var, trans_rates.at("public transit transmission rate"), strain_id);
+			bus.add_symptomatic(inf_var, trans_rates.at(public_transit_rate), strain_id);
 		}
 	}
 	// Leisure
@@ -305,11 +326,11 @@ void Contributions::compute_regular_symptomatic_contributions(const Agent& agent
 		if (agent.get_leisure_type() == "public") {
 			Leisure& les_loc = leisure_locations.at(agent.get_leisure_ID()-1);
 			if (!les_loc.outside_town()){
-				les_loc.add_symptomatic(inf_var, trans_rates.at("leisure locations transmission rate"), strain_id);
+				les_loc.add_symptomatic(inf_var, trans_rates.at(leisure_locations_rate), strain_id);
 			}
 		} else if (agent.get_leisure_type() == "household") {
 			Household& household = households.at(agent.get_leisure_ID()-1);
-			household.add_symptomatic(inf_var, trans_rates.at("household transmission rate"), strain_id);
+			household.add_symptomatic(inf_var, trans_rates.at(household_rate), strain_id);
 		} else {
 			throw std::invalid_argument("Wrong leisure type: " + agent.get_leisure_type());
 		}
@@ -325,9 +346,9 @@ void Contributions::compute_hospital_tested_contributions(const Agent& agent,
 	const std::map<std::string, double>& trans_rates = agent.curr_strain_tr_rates();
 	const int strain_id = agent.get_strain();
 	if (agent.exposed()){
-		hospital.add_exposed_hospital_tested(inf_var, trans_rates.at("hospital tested transmission rate"), strain_id);
+		hospital.add_exposed_hospital_tested(inf_var, trans_rates.at(hospital_tested_rate), strain_id);
 	}else{
-		hospital.add_hospital_tested(inf_var, trans_rates.at("hospital tested transmission rate"), strain_id);
+		hospital.add_hospital_tested(inf_var, trans_rates.at(hospital_tested_rate), strain_id);
 	}
 	if (agent.home_isolated()){
 		hospital.increase_total_tested();
@@ -344,16 +365,16 @@ void Contributions::compute_home_isolated_contributions(const Agent& agent,
 	if (agent.retirement_home_resident()){
 		RetirementHome& rh = retirement_homes.at(agent.get_household_ID()-1);
 		if (agent.exposed()){
-			rh.add_exposed_home_isolated(inf_var, trans_rates.at("RH transmission rate of home isolated"), strain_id);
+			rh.add_exposed_home_isolated(inf_var, trans_rates.at(rh_home_isolated_rate), strain_id);
 		}else{
-			rh.add_symptomatic_home_isolated(inf_var, trans_rates.at("RH transmission rate of home isolated"), strain_id);
+			rh.add_symptomatic_home_isolated(inf_var, trans_rates.at(rh_home_isolated_rate), strain_id);
 		}			
 	} else {
 		Household& household = households.at(agent.get_household_ID()-1);
 		if (agent.exposed()){
-			household.add_exposed_home_isolated(inf_var, trans_rates.at("transmission rate of home isolated"), strain_id);
+			household.add_exposed_home_isolated(inf_var, trans_rates.at(home_isolated_rate), strain_id);
 		}else{
-			household.add_symptomatic_home_isolated(inf_var, trans_rates.at("transmission rate of home isolated"), strain_id);
+			household.add_symptomatic_home_isolated(inf_var, trans_rates.at(home_isolated_rate), strain_id);
 		}	
 	}
 }
@@ -365,7 +386,7 @@ void Contributions::compute_hospitalized_contributions(const Agent& agent,
 	const std::map<std::string, double>& trans_rates = agent.curr_strain_tr_rates();
 	const int strain_id = agent.get_strain();
 	Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
-	hospital.add_hospitalized(inf_var, trans_rates.at("hospitalized transmission rate"), strain_id);
+	hospital.add_hospitalized(inf_var, trans_rates.at(hospitalized_rate), strain_id);
 }
 
 /// \brief Count contributions of an agent hospitalized in ICU
@@ -375,7 +396,7 @@ void Contributions::compute_hospitalized_ICU_contributions(const Agent& agent,
 	const std::map<std::string, double>& trans_rates = agent.curr_strain_tr_rates();
 	const int strain_id = agent.get_strain();
 	Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
-	hospital.add_hospitalized_ICU(inf_var, trans_rates.at("hospitalized ICU transmission rate"), strain_id);
+	hospital.add_hospitalized_ICU(inf_var, trans_rates.at(hospitalized_icu_rate), strain_id);
 }
 
 /// \brief Set contributions/sums from all agents in places to 0.0 
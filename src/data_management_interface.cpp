@@ -44,6 +44,15 @@ std::vector<int> DataManagementInterface::get_num_infected_strains(const int n_s
 	return infected_count;
 }
 
+// Reserve memory of the daily statistics
+void DataManagementInterface::reserve_daily_statistics(const int n_steps)
+{
+	for (auto daily : {&n_infected_day, &n_dead_day, &n_recovered_day, &tested_day, 
+			&tested_pos_day, &tested_neg_day, &tested_false_pos_day, &tested_false_neg_day}) {
+		daily->reserve(daily->size() + n_steps);
+	}
+}
+
 // Retrieve number of exposed agents at this time step
 int DataManagementInterface::get_num_exposed() const
 {
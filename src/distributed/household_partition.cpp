@@ -0,0 +1,80 @@
+#include "../../include/distributed/household_partition.h"
+
+/*****************************************************
+ * class: HouseholdPartition
+ *
+ * Split of households and retirement homes into
+ * spatially compact parts of similar population
+ *
+ ******************************************************/
+
+// Collect the homes and bisect
+HouseholdPartition::HouseholdPartition(const std::vector<Household>& households,
+						const std::vector<RetirementHome>& retirement_homes,
+						const int parts) : n_parts(parts)
+{
+	if (n_parts < 1) {
+		throw std::invalid_argument("Partition needs at least one part");
+	}
+	household_owners.assign(households.size(), 0);
+	retirement_home_owners.assign(retirement_homes.size(), 0);
+
+	std::vector<Home> homes;
+	homes.reserve(households.size() + retirement_homes.size());
+	for (const auto& house : households) {
+		homes.push_back({house.get_x(), house.get_y(), house.get_number_of_agents(),
+							&household_owners.at(house.get_ID()-1)});
+	}
+	for (const auto& rh : retirement_homes) {
+		homes.push_back({rh.get_x(), rh.get_y(), rh.get_number_of_agents(),
+							&retirement_home_owners.at(rh.get_ID()-1)});
+	}
+	bisect(homes.begin(), homes.end(), 0, n_parts);
+
+	part_weights.assign(n_parts, 0);
+	for (const auto& home : homes) {
+		part_weights.at(*home.owner) += home.weight;
+	}
+}
+
+// Split at the weighted median along the longer side
+void HouseholdPartition::bisect(std::vector<Home>::iterator first, std::vector<Home>::iterator last,
+					const int first_part, const int n)
+{
+	if (n == 1 || last - first < 2) {
+		for (auto it = first; it != last; ++it) {
+			*(it->owner) = first_part;
+		}
+		return;
+	}
+	auto x_range = std::minmax_element(first, last,
+						[](const Home& a, const Home& b){ return a.x < b.x; });
+	auto y_range = std::minmax_element(first, last,
+						[](const Home& a, const Home& b){ return a.y < b.y; });
+	const bool along_x = (x_range.second->x - x_range.first->x) >= (y_range.second->y - y_range.first->y);
+	// Stable, so that equal coordinates keep the input order in every process
+	std::stable_sort(first, last, [along_x](const Home& a, const Home& b)
+						{ return along_x ? a.x < b.x : a.y < b.y; });
+
+	// Parts on the lower side and their share of the residents
+	const int n_lower = n/2;
+	double total = 0.0;
+	for (auto it = first; it != last; ++it) {
+		total += it->weight;
+	}
+	const double target = total*static_cast<double>(n_lower)/static_cast<double>(n);
+	auto split = first;
+	double lower = 0.0;
+	while (split != last && lower + split->weight <= target) {
+		lower += split->weight;
+		++split;
+	}
+	// Both sides get at least one home
+	if (split == first) {
+		++split;
+	} else if (split == last) {
+		--split;
+	}
+	bisect(first, split, first_part, n_lower);
+	bisect(split, last, first_part + n_lower, n - n_lower);
+}
@@ -0,0 +1,64 @@
+#include "../../include/distributed/mpi_communicator.h"
+
+/*****************************************************
+ * class: MPICommunicator
+ *
+ * Communicator of processes started with mpirun
+ *
+ ******************************************************/
+
+// Rank and size of MPI_COMM_WORLD
+MPICommunicator::MPICommunicator()
+{
+	int initialized = 0;
+	MPI_Initialized(&initialized);
+	if (!initialized) {
+		throw std::runtime_error("MPI needs to be initialized before creating a communicator");
+	}
+	// Errors are reported through return values, not by aborting
+	check(MPI_Comm_set_errhandler(MPI_COMM_WORLD, MPI_ERRORS_RETURN), "MPI_Comm_set_errhandler");
+	check(MPI_Comm_rank(MPI_COMM_WORLD, &my_rank), "MPI_Comm_rank");
+	check(MPI_Comm_size(MPI_COMM_WORLD, &n_ranks), "MPI_Comm_size");
+}
+
+// Sum in place
+void MPICommunicator::all_reduce_sum(std::vector<double>& values)
+{
+	check(MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(values.size()),
+				MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD), "MPI_Allreduce");
+}
+
+// Lengths first, then the values
+std::vector<std::vector<int>> MPICommunicator::all_gather(const std::vector<int>& values)
+{
+	int n_mine = static_cast<int>(values.size());
+	std::vector<int> counts(n_ranks, 0);
+	check(MPI_Allgather(&n_mine, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD),
+			"MPI_Allgather");
+	std::vector<int> offsets(n_ranks, 0);
+	for (int ir = 1; ir < n_ranks; ++ir) {
+		offsets.at(ir) = offsets.at(ir-1) + counts.at(ir-1);
+	}
+	std::vector<int> all_values(offsets.back() + counts.back(), 0);
+	check(MPI_Allgatherv(values.data(), n_mine, MPI_INT, all_values.data(), counts.data(),
+				offsets.data(), MPI_INT, MPI_COMM_WORLD), "MPI_Allgatherv");
+
+	std::vector<std::vector<int>> gathered(n_ranks);
+	for (int ir = 0; ir < n_ranks; ++ir) {
+		gathered.at(ir).assign(all_values.begin() + offsets.at(ir),
+						all_values.begin() + offsets.at(ir) + counts.at(ir));
+	}
+	return gathered;
+}
+
+// Throw with the MPI error message
+void MPICommunicator::check(const int err, const std::string& operation) const
+{
+	if (err == MPI_SUCCESS) {
+		return;
+	}
+	char msg[MPI_MAX_ERROR_STRING];
+	int len = 0;
+	MPI_Error_string(err, msg, &len);
+	throw std::runtime_error(operation + " failed: " + std::string(msg, len));
+}
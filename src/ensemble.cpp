@@ -0,0 +1,152 @@
+#include "../include/ensemble.h"
+
+/*****************************************************
+ * class: Ensemble
+ *
+ * Runs independent stochastic replicates of one model
+ * concurrently, in a single process
+ *
+ ******************************************************/
+
+// Set up the town and agents once
+Ensemble::Ensemble(const EnsembleSetup& _setup, const int n_rep,
+					const unsigned int seed, const int n_thr) :
+	setup(_setup), n_replicates(n_rep), base_seed(seed), prototype(_setup.dt),
+	next_replicate(0)
+{
+	if (n_replicates < 1) {
+		throw std::invalid_argument("Ensemble needs at least one replicate");
+	}
+	n_threads = (n_thr > 0) ? n_thr : std::max(1u, std::thread::hardware_concurrency());
+	n_threads = std::min(n_threads, n_replicates);
+
+	// No initially infected in the shared model - each
+	// replicate selects its own
+	std::vector<int> no_infected(setup.inf0.size(), 0);
+	prototype.simulation_setup(setup.input_files, no_infected,
+					setup.custom_vac_offsets, setup.custom_boost_offsets);
+	names = prototype.get_time_series_names();
+	for (int ti = 0; ti <= setup.n_steps; ++ti) {
+		times.push_back(ti*setup.dt);
+	}
+	trajectories.resize(n_replicates);
+}
+
+// Run all replicates on a pool of threads
+void Ensemble::run()
+{
+	next_replicate = 0;
+	error = nullptr;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < n_threads - 1; ++i) {
+		threads.emplace_back(&Ensemble::worker, this);
+	}
+	// This thread works too
+	worker();
+	for (auto& thr : threads) {
+		thr.join();
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+// Take replicates until none are left
+void Ensemble::worker()
+{
+	int i = 0;
+	while ((i = next_replicate++) < n_replicates) {
+		try {
+			run_replicate(i);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(error_mtx);
+			if (!error) {
+				error = std::current_exception();
+			}
+			// Stop handing out new replicates
+			next_replicate = n_replicates;
+		}
+	}
+}
+
+// Copy and run one replicate
+void Ensemble::run_replicate(const int i)
+{
+	ABM abm(prototype);
+	// Only this thread writes to this entry
+	simulate(abm, setup, get_seed(i), trajectories.at(i));
+}
+
+// Seed, initialize, and run one replicate
+void Ensemble::simulate(ABM& abm, const EnsembleSetup& setup, const unsigned int seed,
+							std::vector<std::vector<double>>& trajectory)
+{
+	abm.set_tracer(setup.tracer);
+	Tracer::Scope trace_replicate(setup.tracer.get(), "replicate", "ensemble", "seed", seed);
+	abm.set_seed(seed);
+	abm.seed_initially_infected(setup.inf0);
+	if (setup.initialize_simulations) {
+		abm.initialize_simulations(setup.dont_vac);
+	}
+	if (!setup.N_active.empty()) {
+		abm.initialize_active_cases(setup.N_active, setup.vaccinate,
+						setup.N_vac, setup.N_boost, setup.N_recovered);
+	}
+
+	trajectory.assign(setup.n_steps + 1, {});
+	for (int ti = 0; ti <= setup.n_steps; ++ti) {
+		abm.get_time_series_values(trajectory.at(ti));
+		if (setup.transmit_with_vac) {
+			abm.transmit_with_vac();
+		} else {
+			abm.transmit_infection();
+		}
+	}
+}
+
+// Seed of replicate i derived from a base seed
+unsigned int Ensemble::replicate_seed(const unsigned int base_seed, const int i)
+{
+	std::seed_seq seq{base_seed, static_cast<unsigned int>(i)};
+	std::vector<unsigned int> seed(1);
+	seq.generate(seed.begin(), seed.end());
+	return seed.front();
+}
+
+// Aggregate over replicates
+template <typename Reduce>
+std::vector<std::vector<double>> Ensemble::reduce(Reduce op, const bool average) const
+{
+	std::vector<std::vector<double>> result(trajectories.front());
+	for (int i = 1; i < n_replicates; ++i) {
+		for (int ti = 0; ti < result.size(); ++ti) {
+			for (int im = 0; im < result.at(ti).size(); ++im) {
+				result.at(ti).at(im) = op(result.at(ti).at(im),
+										trajectories.at(i).at(ti).at(im));
+			}
+		}
+	}
+	if (average) {
+		for (auto& step : result) {
+			for (auto& value : step) {
+				value /= n_replicates;
+			}
+		}
+	}
+	return result;
+}
+
+std::vector<std::vector<double>> Ensemble::get_mean() const
+{
+	return reduce([](const double a, const double b){ return a + b; }, true);
+}
+
+std::vector<std::vector<double>> Ensemble::get_min() const
+{
+	return reduce([](const double a, const double b){ return std::min(a, b); }, false);
+}
+
+std::vector<std::vector<double>> Ensemble::get_max() const
+{
+	return reduce([](const double a, const double b){ return std::max(a, b); }, false);
+}
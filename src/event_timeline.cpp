@@ -0,0 +1,59 @@
+#include "../include/event_timeline.h"
+
+/*****************************************************
+ * class: EventTimeline
+ *
+ * Interventions and other scheduled events of
+ * a simulation, keyed by the step they happen at
+ *
+ *****************************************************/
+
+// Add an event to the timeline
+void EventTimeline::schedule(const Event& event)
+{
+	// After all the events of the same step
+	auto iter = std::upper_bound(events.begin() + next, events.end(), event.step,
+				[](const int step, const Event& ev) { return step < ev.step; });
+	events.insert(iter, event);
+}
+
+// Add an event at the step closest to a simulation time
+void EventTimeline::schedule_at_time(const double time, const double dt, const Type type,
+						const double value, const double second_value)
+{
+	const int step = step_of(time, dt);
+	if (step < 0) {
+		return;
+	}
+	schedule(Event(step, type, value, second_value));
+}
+
+// Discard the events before step without dispatching them
+void EventTimeline::skip_to(const int step)
+{
+	while (next < events.size() && events.at(next).step < step) {
+		++next;
+	}
+}
+
+// Events due at this step
+std::pair<EventTimeline::const_iterator, EventTimeline::const_iterator> EventTimeline::due(const int step)
+{
+	const size_t first = next;
+	while (next < events.size() && events.at(next).step <= step) {
+		++next;
+	}
+	return {events.cbegin() + first, events.cbegin() + next};
+}
+
+// Type from its name in an input file
+EventTimeline::Type EventTimeline::type_from_name(const std::string& name)
+{
+	const std::vector<std::string> names = {"new_strain", "testing_change",
+				"vaccination_rate", "leisure_fraction", "workplace_absenteeism"};
+	const auto& iter = std::find(names.begin(), names.end(), name);
+	if (iter == names.end()) {
+		throw std::invalid_argument("No event type named " + name);
+	}
+	return static_cast<Type>(std::distance(names.begin(), iter));
+}
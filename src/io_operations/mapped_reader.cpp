@@ -0,0 +1,179 @@
+#include "../../include/io_operations/mapped_reader.h"
+#include <cerrno>
+#include <cstdlib>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/***************************************************************
+ * class: MappedReader
+ *
+ * Read-only, memory-mapped access to whitespace separated
+ * tabular files (population and place files)
+ **************************************************************/
+
+namespace {
+	/// Whitespace as understood by operator>> for the input files
+	inline bool is_space(const char c)
+		{ return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+}
+
+// Map the file
+MappedReader::MappedReader(const std::string& name) : fname(name)
+{
+	int fd = open(fname.c_str(), O_RDONLY);
+	if (fd == -1) {
+		std::cerr << "Error opening file " << fname << std::endl;
+		throw std::runtime_error(std::strerror(errno));
+	}
+	struct stat st;
+	if (fstat(fd, &st) == -1) {
+		close(fd);
+		throw std::runtime_error("Cannot determine size of " + fname);
+	}
+	file_size = static_cast<size_t>(st.st_size);
+	if (file_size > 0) {
+		void* addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("Cannot map file " + fname);
+		}
+		// Whole file is read front to back
+		madvise(addr, file_size, MADV_SEQUENTIAL);
+		data = static_cast<const char*>(addr);
+		mapped = true;
+	}
+	// The mapping stays valid after closing the descriptor
+	close(fd);
+	end = data + file_size;
+	pos = data;
+}
+
+MappedReader::~MappedReader()
+{
+	if (mapped) {
+		munmap(const_cast<char*>(data), file_size);
+	}
+}
+
+// Tokenize the next non-empty line
+bool MappedReader::next_row(Row& row)
+{
+	row.fields.clear();
+	while (pos < end) {
+		const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+		if (eol == nullptr) {
+			eol = end;
+		}
+		const char* cur = pos;
+		while (cur < eol) {
+			while (cur < eol && is_space(*cur)) {
+				++cur;
+			}
+			if (cur == eol) {
+				break;
+			}
+			const char* field = cur;
+			while (cur < eol && !is_space(*cur)) {
+				++cur;
+			}
+			row.fields.emplace_back(field, static_cast<size_t>(cur - field));
+		}
+		pos = (eol == end) ? end : eol + 1;
+		if (!row.fields.empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Number of non-empty lines
+size_t MappedReader::count_rows() const
+{
+	size_t n_rows = 0;
+	const char* cur = data;
+	while (cur < end) {
+		const char* eol = static_cast<const char*>(std::memchr(cur, '\n', end - cur));
+		if (eol == nullptr) {
+			eol = end;
+		}
+		for (const char* c = cur; c < eol; ++c) {
+			if (!is_space(*c)) {
+				++n_rows;
+				break;
+			}
+		}
+		cur = (eol == end) ? end : eol + 1;
+	}
+	return n_rows;
+}
+
+//
+// Row
+//
+
+// Field converted to int
+int MappedReader::Row::get_int(const size_t i) const
+{
+	const char* first = field_begin(i);
+	const char* last = first + field_length(i);
+	const char* cur = first;
+	bool negative = false;
+	if (*cur == '-' || *cur == '+') {
+		negative = (*cur == '-');
+		++cur;
+	}
+	if (cur == last) {
+		throw std::invalid_argument("Not an integer: " + get_string(i));
+	}
+	long long value = 0;
+	for (; cur < last; ++cur) {
+		if (*cur < '0' || *cur > '9') {
+			throw std::invalid_argument("Not an integer: " + get_string(i));
+		}
+		value = 10*value + (*cur - '0');
+		if (value > static_cast<long long>(INT_MAX) + 1) {
+			throw std::out_of_range("Integer out of range: " + get_string(i));
+		}
+	}
+	value = negative ? -value : value;
+	if (value > INT_MAX) {
+		throw std::out_of_range("Integer out of range: " + get_string(i));
+	}
+	return static_cast<int>(value);
+}
+
+// Field converted to double
+double MappedReader::Row::get_double(const size_t i) const
+{
+	// Fields are not null-terminated in the mapping,
+	// numeric fields are short so copy to the stack
+	char buffer[64];
+	const size_t len = field_length(i);
+	if (len >= sizeof(buffer)) {
+		return std::stod(get_string(i));
+	}
+	std::memcpy(buffer, field_begin(i), len);
+	buffer[len] = '\0';
+	char* parsed_end = nullptr;
+	const double value = std::strtod(buffer, &parsed_end);
+	if (parsed_end != buffer + len) {
+		throw std::invalid_argument("Not a number: " + get_string(i));
+	}
+	return value;
+}
+
+// Copy of the field
+std::string MappedReader::Row::get_string(const size_t i) const
+{
+	return std::string(field_begin(i), field_length(i));
+}
+
+// Compare without copying
+bool MappedReader::Row::equals(const size_t i, const char* str) const
+{
+	const size_t len = std::strlen(str);
+	return (len == field_length(i)) && (std::memcmp(field_begin(i), str, len) == 0);
+}
@@ -0,0 +1,210 @@
+#include "../../include/io_operations/recorder.h"
+
+/***************************************************************
+ * class: Recorder
+ *
+ * Streams named per-step metrics (time series) to a file
+ **************************************************************/
+
+// Open the file and start the writer
+Recorder::Recorder(const std::string& name, const Format fmt, const size_t buffer_rows) :
+	fname(name), format(fmt), max_rows(std::max<size_t>(buffer_rows, 1))
+{
+	std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+	if (format == binary) {
+		mode |= std::ios_base::binary;
+	}
+	out.open(fname, mode);
+	if (!out.is_open()) {
+		std::cerr << "Error opening file " << fname << std::endl;
+		throw std::runtime_error("Cannot open recorder output file");
+	}
+	// Counts are written as integers up to 10^12
+	out.precision(12);
+	writer = std::thread(&Recorder::write_loop, this);
+}
+
+// Register a new column
+int Recorder::add_metric(const std::string& name)
+{
+	if (header_written) {
+		throw std::runtime_error("Metrics cannot be added after recording started: " + name);
+	}
+	names.push_back(name);
+	current.push_back(0.0);
+	return static_cast<int>(names.size() - 1);
+}
+
+// Store the current row
+void Recorder::record(const double time)
+{
+	if (closed) {
+		throw std::runtime_error("Recording to a closed recorder " + fname);
+	}
+	if (!header_written) {
+		n_columns = names.size() + 1;
+		filling.reserve(max_rows*n_columns);
+		pending.reserve(max_rows*n_columns);
+		write_header();
+		header_written = true;
+	}
+	filling.push_back(time);
+	filling.insert(filling.end(), current.begin(), current.end());
+	++n_rows;
+	if (filling.size() >= max_rows*n_columns) {
+		submit();
+	}
+}
+
+// Swap the buffers with the writer
+void Recorder::submit()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	// Previous buffer has to be written first - keeps memory constant
+	cv.wait(lock, [this]{ return pending.empty(); });
+	if (write_failed) {
+		throw std::runtime_error("Error writing to " + fname);
+	}
+	pending.swap(filling);
+	lock.unlock();
+	cv.notify_all();
+}
+
+// Write everything recorded so far
+void Recorder::flush()
+{
+	if (closed) {
+		return;
+	}
+	std::shared_ptr<Tracer> trc = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		trc = tracer;
+	}
+	Tracer::Scope trace_flush(trc.get(), "Recorder::flush", "output");
+	if (!filling.empty()) {
+		submit();
+	}
+	std::unique_lock<std::mutex> lock(mtx);
+	cv.wait(lock, [this]{ return pending.empty(); });
+	out.flush();
+	if (write_failed) {
+		throw std::runtime_error("Error writing to " + fname);
+	}
+}
+
+// Finish writing and stop the thread
+void Recorder::close()
+{
+	if (closed) {
+		return;
+	}
+	// Header even if nothing was recorded
+	if (!header_written) {
+		n_columns = names.size() + 1;
+		write_header();
+		header_written = true;
+	}
+	flush();
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stop = true;
+	}
+	cv.notify_all();
+	writer.join();
+	out.close();
+	closed = true;
+}
+
+Recorder::~Recorder()
+{
+	// Destructors should not throw
+	try {
+		close();
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		if (writer.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				stop = true;
+			}
+			cv.notify_all();
+			writer.join();
+		}
+	}
+}
+
+// Shared with the writer thread
+void Recorder::set_tracer(std::shared_ptr<Tracer> trc)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	tracer = trc;
+}
+
+// Background writer
+void Recorder::write_loop()
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	while (true) {
+		cv.wait(lock, [this]{ return stop || !pending.empty(); });
+		if (pending.empty() && stop) {
+			break;
+		}
+		// The main thread only touches pending when it is empty,
+		// so it is safe to write without holding the lock
+		std::shared_ptr<Tracer> trc = tracer;
+		lock.unlock();
+		{
+			Tracer::Scope trace_write(trc.get(), "Recorder::write_rows", "output",
+										"rows", static_cast<double>(pending.size()/n_columns));
+			write_rows(pending);
+		}
+		const bool failed = !out.good();
+		lock.lock();
+		write_failed = write_failed || failed;
+		pending.clear();
+		cv.notify_all();
+	}
+}
+
+// Column names
+void Recorder::write_header()
+{
+	if (format == csv) {
+		out << "time";
+		for (const auto& name : names) {
+			out << "," << name;
+		}
+		out << "\n";
+	} else {
+		const char magic[8] = {'A', 'B', 'M', 'R', 'E', 'C', '\0', '\0'};
+		const uint32_t header[2] = {version, static_cast<uint32_t>(names.size() + 1)};
+		out.write(magic, sizeof(magic));
+		out.write(reinterpret_cast<const char*>(header), sizeof(header));
+		size_t n_bytes = 0;
+		std::vector<std::string> all_names = {"time"};
+		all_names.insert(all_names.end(), names.begin(), names.end());
+		for (const auto& name : all_names) {
+			out.write(name.c_str(), name.size() + 1);
+			n_bytes += name.size() + 1;
+		}
+		const char zeros[8] = {0};
+		out.write(zeros, (8 - n_bytes % 8) % 8);
+	}
+}
+
+// Rows as text or raw doubles
+void Recorder::write_rows(const std::vector<double>& data)
+{
+	if (format == csv) {
+		for (size_t i = 0; i < data.size(); i += n_columns) {
+			out << data[i];
+			for (size_t j = 1; j < n_columns; ++j) {
+				out << "," << data[i + j];
+			}
+			out << "\n";
+		}
+	} else {
+		out.write(reinterpret_cast<const char*>(data.data()), data.size()*sizeof(double));
+	}
+}
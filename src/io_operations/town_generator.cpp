@@ -0,0 +1,673 @@
+#include "../../include/io_operations/town_generator.h"
+#include <cmath>
+
+/***************************************************************
+ * class: TownGenerator
+ *
+ * Synthetic town with all its places and agents
+ **************************************************************/
+
+namespace {
+
+	// Input file list tags of the generated files, in PlaceType order
+	const char* place_file_tags[TownImage::n_place_types] = {"Household data",
+		"School data", "Workplace data", "Hospital data", "Retirement home data",
+		"Carpool data", "Public transit data", "Leisure location data"};
+	const char* place_file_names[TownImage::n_place_types] = {"NR_households.txt",
+		"NR_schools.txt", "NR_workplaces.txt", "NR_hospitals.txt", "NR_retirement_homes.txt",
+		"NR_carpool.txt", "NR_public.txt", "NR_leisure.txt"};
+	// School types in the order of the TownSettings school vectors
+	const std::vector<std::string> school_types = {"daycare", "primary", "middle", "high", "college"};
+	// Names of travel modes in the agent file, in Mode order
+	const char* mode_names[] = {"car", "carpool", "public", "walk", "other"};
+
+	/**
+	 * \brief Buffered text output of numbers and words
+	 * \details Formats without streams, the agent file of
+	 *		a large town has hundreds of millions of fields
+	 */
+	class TextWriter
+	{
+	public:
+		explicit TextWriter(const std::string& fname) : out(fname), name(fname)
+		{
+			if (!out.is_open()) {
+				std::cerr << "Error opening file " << fname << std::endl;
+				throw std::runtime_error("Cannot open town generator output file");
+			}
+			buffer.reserve(buffer_size + 256);
+		}
+
+		TextWriter& add(const long long value)
+		{
+			char digits[24];
+			int n = 0;
+			unsigned long long v = (value < 0) ? -static_cast<unsigned long long>(value) : value;
+			do {
+				digits[n++] = static_cast<char>('0' + v % 10);
+				v /= 10;
+			} while (v > 0);
+			if (value < 0) {
+				buffer += '-';
+			}
+			while (n > 0) {
+				buffer += digits[--n];
+			}
+			return *this;
+		}
+
+		/// Fixed point with the given number of decimals
+		TextWriter& add(const double value, const int decimals)
+		{
+			long long scale = 1;
+			for (int i = 0; i < decimals; ++i) {
+				scale *= 10;
+			}
+			const long long scaled = std::llround(std::fabs(value)*scale);
+			if (value < 0.0 && scaled > 0) {
+				buffer += '-';
+			}
+			add(scaled/scale);
+			if (decimals > 0) {
+				buffer += '.';
+				// Leading zeros of the fraction included
+				long long frac = scaled % scale;
+				char digits[24];
+				for (int i = decimals - 1; i >= 0; --i) {
+					digits[i] = static_cast<char>('0' + frac % 10);
+					frac /= 10;
+				}
+				buffer.append(digits, decimals);
+			}
+			return *this;
+		}
+
+		TextWriter& add(const char* word) { buffer += word; return *this; }
+		TextWriter& add(const std::string& word) { buffer += word; return *this; }
+		TextWriter& space() { buffer += ' '; return *this; }
+
+		/// End of a line, writes the buffer when full
+		void end_line()
+		{
+			buffer += '\n';
+			if (buffer.size() >= buffer_size) {
+				flush();
+			}
+		}
+
+		/// Write what is left and check the stream
+		void close()
+		{
+			flush();
+			out.close();
+			if (out.fail()) {
+				throw std::runtime_error("Error writing to " + name);
+			}
+		}
+
+	private:
+		static const size_t buffer_size = 1 << 20;
+		std::ofstream out;
+		std::string name;
+		std::string buffer;
+
+		void flush()
+		{
+			out.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	};
+}
+
+// Generate all places and agents
+TownGenerator::TownGenerator(const TownSettings& ts) : settings(ts), rng(ts.seed)
+{
+	check_settings();
+	create_geography();
+	create_households();
+	create_institutions();
+	create_schools();
+	create_workplaces();
+	create_transit();
+	create_leisure_locations();
+}
+
+// Sizes and distributions that generation relies on
+void TownGenerator::check_settings() const
+{
+	const TownSettings& ts = settings;
+	if (ts.n_agents < 1 || ts.agents_per_km2 <= 0.0 || ts.agents_per_neighborhood < 1
+			|| ts.agents_per_hospital < 1 || ts.agents_per_leisure < 1) {
+		throw std::invalid_argument("Town generator needs agents and positive densities");
+	}
+	if (ts.household_size_probs.empty() || ts.age_bins.size() != ts.age_bin_probs.size()
+			|| ts.age_bins.back() >= ts.max_age || ts.max_age < 75) {
+		throw std::invalid_argument("Wrong household size or age distribution");
+	}
+	const size_t n_school_types = school_types.size();
+	if (ts.school_min_age.size() != n_school_types || ts.school_max_age.size() != n_school_types
+			|| ts.school_attendance.size() != n_school_types || ts.school_mean_size.size() != n_school_types
+			|| *std::min_element(ts.school_mean_size.begin(), ts.school_mean_size.end()) < 2) {
+		throw std::invalid_argument("School settings need a value for each of the "
+										+ std::to_string(n_school_types) + " school types");
+	}
+	if (ts.workplace_min_size.size() != ts.workplace_size_probs.size()
+			|| ts.workplace_max_size.size() != ts.workplace_size_probs.size()
+			|| ts.workplace_types.size() != ts.workplace_type_probs.size()
+			|| ts.workplace_types.empty() || ts.travel_mode_probs.size() != 5) {
+		throw std::invalid_argument("Wrong workplace or travel mode distribution");
+	}
+	if (ts.min_rh_size < 1 || ts.min_rh_size > ts.max_rh_size
+			|| ts.min_carpool_size < 1 || ts.min_carpool_size > ts.max_carpool_size
+			|| ts.min_public_size < 1 || ts.min_public_size > ts.max_public_size
+			|| ts.min_travel_time > ts.max_travel_time || ts.students_per_school_staff <= 0.0
+			|| ts.rh_residents_per_staff <= 0.0) {
+		throw std::invalid_argument("Wrong place size or travel time range");
+	}
+	if (ts.fraction_rh_residents + ts.fraction_patients >= 1.0) {
+		throw std::invalid_argument("Town needs agents living in households");
+	}
+}
+
+// Town square and neighborhood centers
+void TownGenerator::create_geography()
+{
+	const double pi = std::acos(-1.0);
+	const double side_km = std::sqrt(settings.n_agents/settings.agents_per_km2);
+	lat_size = side_km/111.0;
+	lon_size = side_km/(111.0*std::cos(settings.center_lat*pi/180.0));
+	lat0 = settings.center_lat - lat_size/2.0;
+	lon0 = settings.center_lon - lon_size/2.0;
+
+	// Centers in unit square coordinates
+	const int n_nbh = std::max(1, settings.n_agents/settings.agents_per_neighborhood);
+	neighborhoods.reserve(n_nbh);
+	for (int i = 0; i < n_nbh; ++i) {
+		neighborhoods.emplace_back(rng.get_random(0.0, 1.0), rng.get_random(0.0, 1.0));
+	}
+	nbh_spread = 0.5/std::sqrt(static_cast<double>(n_nbh));
+
+	// Order along serpentine stripes, so that consecutive
+	// neighborhoods (and the schools that fill them) are close
+	const int n_stripes = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(n_nbh))));
+	auto stripe = [n_stripes](const std::pair<double, double>& c)
+		{ return std::min(n_stripes - 1, static_cast<int>(c.first*n_stripes)); };
+	std::sort(neighborhoods.begin(), neighborhoods.end(), 
+		[&stripe](const std::pair<double, double>& a, const std::pair<double, double>& b) {
+			const int sa = stripe(a), sb = stripe(b);
+			if (sa != sb) {
+				return sa < sb;
+			}
+			return (sa % 2 == 0) ? (a.second < b.second) : (a.second > b.second);
+		});
+}
+
+// Households in neighborhoods, one adult and others of any age
+void TownGenerator::create_households()
+{
+	const int n_rh = static_cast<int>(std::lround(settings.fraction_rh_residents*settings.n_agents));
+	const int n_patients = static_cast<int>(std::lround(settings.fraction_patients*settings.n_agents));
+	const int n_in_houses = settings.n_agents - n_rh - n_patients;
+	const int n_nbh = static_cast<int>(neighborhoods.size());
+
+	std::vector<GenPlace>& houses = places.at(TownImage::households);
+	agents.reserve(settings.n_agents);
+	while (static_cast<int>(agents.size()) < n_in_houses) {
+		const int n_left = n_in_houses - static_cast<int>(agents.size());
+		const int size = std::min(n_left, static_cast<int>(draw(settings.household_size_probs)) + 1);
+		// Consecutive households are in the same neighborhood
+		const int nbh = static_cast<int>(static_cast<long long>(agents.size())*n_nbh/n_in_houses);
+		houses.push_back(random_location(nbh));
+		for (int ia = 0; ia < size; ++ia) {
+			GenAgent agent;
+			agent.age = random_age(ia == 0 ? 18 : 0);
+			agent.residence_ID = static_cast<int>(houses.size());
+			agents.push_back(agent);
+		}
+	}
+}
+
+// Retirement homes and hospitals with their residents
+void TownGenerator::create_institutions()
+{
+	const int n_rh = static_cast<int>(std::lround(settings.fraction_rh_residents*settings.n_agents));
+	std::vector<GenPlace>& homes = places.at(TownImage::retirement_homes);
+	int n_residents = 0;
+	while (n_residents < n_rh) {
+		const int size = std::min(n_rh - n_residents, uniform_int(settings.min_rh_size, settings.max_rh_size));
+		homes.push_back(random_location());
+		for (int ia = 0; ia < size; ++ia) {
+			GenAgent agent;
+			agent.age = random_age(65);
+			agent.role = rh_resident;
+			agent.residence_ID = static_cast<int>(homes.size());
+			agents.push_back(agent);
+		}
+		n_residents += size;
+	}
+
+	std::vector<GenPlace>& hospitals = places.at(TownImage::hospitals);
+	const int n_hospitals = std::max(1, settings.n_agents/settings.agents_per_hospital);
+	for (int ih = 0; ih < n_hospitals; ++ih) {
+		hospitals.push_back(random_location());
+	}
+	// The rest are patients
+	while (static_cast<int>(agents.size()) < settings.n_agents) {
+		GenAgent agent;
+		agent.age = random_age(0);
+		agent.role = patient;
+		agent.residence_ID = uniform_int(1, n_hospitals);
+		agent.hospital_ID = agent.residence_ID;
+		agents.push_back(agent);
+	}
+}
+
+// Students of each type fill local schools
+void TownGenerator::create_schools()
+{
+	std::vector<GenPlace>& schools = places.at(TownImage::schools);
+	for (size_t it = 0; it < school_types.size(); ++it) {
+		// In household order, so consecutive students are neighbors
+		std::vector<int> students;
+		for (size_t ia = 0; ia < agents.size(); ++ia) {
+			const GenAgent& agent = agents.at(ia);
+			if (agent.role == regular && agent.age >= settings.school_min_age.at(it)
+					&& agent.age <= settings.school_max_age.at(it)
+					&& rng.get_random(0.0, 1.0) < settings.school_attendance.at(it)) {
+				students.push_back(static_cast<int>(ia));
+			}
+		}
+		const int mean_size = settings.school_mean_size.at(it);
+		size_t is = 0;
+		while (is < students.size()) {
+			const size_t size = std::min(students.size() - is,
+						static_cast<size_t>(uniform_int(mean_size/2, mean_size + mean_size/2)));
+			// Near its first student
+			GenPlace school = residence(agents.at(students.at(is)));
+			school.type = static_cast<int>(it);
+			schools.push_back(school);
+			for (size_t i = is; i < is + size; ++i) {
+				agents.at(students.at(i)).student = true;
+				agents.at(students.at(i)).school_ID = static_cast<int>(schools.size());
+			}
+			is += size;
+		}
+	}
+}
+
+// Staff of schools, retirement homes, and hospitals, then regular workplaces
+void TownGenerator::create_workplaces()
+{
+	std::vector<int> workers;
+	for (size_t ia = 0; ia < agents.size(); ++ia) {
+		const GenAgent& agent = agents.at(ia);
+		if (agent.role != regular || agent.age < 18 || agent.age >= 75) {
+			continue;
+		}
+		const double employment = agent.student ? settings.employment_students :
+			((agent.age < 65) ? settings.employment_adults : settings.employment_seniors);
+		if (rng.get_random(0.0, 1.0) < employment) {
+			workers.push_back(static_cast<int>(ia));
+		}
+	}
+	// Workplaces are anywhere in the town
+	rng.partial_shuffle(workers, workers.size());
+	size_t iw = 0;
+
+	// Staff, as many as there are available workers
+	std::vector<int> school_sizes(places.at(TownImage::schools).size(), 0);
+	std::vector<int> rh_sizes(places.at(TownImage::retirement_homes).size(), 0);
+	for (const auto& agent : agents) {
+		if (agent.student) {
+			++school_sizes.at(agent.school_ID - 1);
+		}
+		if (agent.role == rh_resident) {
+			++rh_sizes.at(agent.residence_ID - 1);
+		}
+	}
+	auto assign_staff = [this, &workers, &iw](const int n_staff, const Role role, const int ID) {
+		for (int i = 0; i < n_staff && iw < workers.size(); ++i, ++iw) {
+			GenAgent& agent = agents.at(workers.at(iw));
+			agent.role = role;
+			agent.occupation = 0;
+			if (role == hospital_staff) {
+				agent.hospital_ID = ID;
+			} else {
+				agent.works = true;
+				agent.work_ID = ID;
+			}
+		}
+	};
+	for (size_t is = 0; is < school_sizes.size(); ++is) {
+		assign_staff(static_cast<int>(std::ceil(school_sizes.at(is)/settings.students_per_school_staff)),
+						school_staff, static_cast<int>(is + 1));
+	}
+	for (size_t ir = 0; ir < rh_sizes.size(); ++ir) {
+		assign_staff(static_cast<int>(std::ceil(rh_sizes.at(ir)/settings.rh_residents_per_staff)),
+						rh_staff, static_cast<int>(ir + 1));
+	}
+	const int n_hospitals = static_cast<int>(places.at(TownImage::hospitals).size());
+	const int n_hsp_staff = static_cast<int>(std::lround(settings.fraction_hospital_staff*settings.n_agents));
+	for (int ih = 0; ih < n_hospitals; ++ih) {
+		assign_staff(n_hsp_staff/n_hospitals + (ih < n_hsp_staff % n_hospitals ? 1 : 0),
+						hospital_staff, ih + 1);
+	}
+
+	// Regular workplaces in and outside of the town
+	std::vector<int> in_town, outside;
+	for (; iw < workers.size(); ++iw) {
+		GenAgent& agent = agents.at(workers.at(iw));
+		agent.works = true;
+		agent.wfh = (rng.get_random(0.0, 1.0) < settings.fraction_wfh);
+		if (rng.get_random(0.0, 1.0) < settings.fraction_work_outside) {
+			outside.push_back(workers.at(iw));
+		} else {
+			in_town.push_back(workers.at(iw));
+		}
+	}
+	std::vector<GenPlace>& workplaces = places.at(TownImage::workplaces);
+	const int outside_type = static_cast<int>(settings.workplace_types.size());
+	for (const bool is_outside : {false, true}) {
+		const std::vector<int>& members = is_outside ? outside : in_town;
+		size_t im = 0;
+		while (im < members.size()) {
+			const size_t ir = draw(settings.workplace_size_probs);
+			const size_t size = std::min(members.size() - im, static_cast<size_t>(
+				uniform_int(settings.workplace_min_size.at(ir), settings.workplace_max_size.at(ir))));
+			GenPlace work = random_location();
+			work.type = static_cast<int>(draw(settings.workplace_type_probs));
+			// Occupation as the type of the workplace in town
+			const int occupation = work.type;
+			if (is_outside) {
+				// Next to the town
+				work.lat += lat_size;
+				work.type = outside_type;
+			}
+			workplaces.push_back(work);
+			for (size_t i = im; i < im + size; ++i) {
+				agents.at(members.at(i)).work_ID = static_cast<int>(workplaces.size());
+				agents.at(members.at(i)).occupation = static_cast<int8_t>(occupation);
+			}
+			im += size;
+		}
+	}
+}
+
+// Travel modes of commuters, carpools and routes of neighbors
+void TownGenerator::create_transit()
+{
+	std::vector<int> carpoolers, riders;
+	for (size_t ia = 0; ia < agents.size(); ++ia) {
+		GenAgent& agent = agents.at(ia);
+		const bool commutes = (agent.works || agent.role == hospital_staff) && !agent.wfh;
+		if (!commutes) {
+			continue;
+		}
+		agent.mode = static_cast<uint8_t>(draw(settings.travel_mode_probs));
+		agent.travel_time = static_cast<float>(rng.get_random(settings.min_travel_time, settings.max_travel_time));
+		if (agent.mode == carpool) {
+			carpoolers.push_back(static_cast<int>(ia));
+		} else if (agent.mode == public_transit) {
+			riders.push_back(static_cast<int>(ia));
+		}
+	}
+
+	std::vector<GenPlace>& carpools = places.at(TownImage::carpools);
+	for (size_t ic = 0; ic < carpoolers.size(); ) {
+		const size_t size = std::min(carpoolers.size() - ic,
+				static_cast<size_t>(uniform_int(settings.min_carpool_size, settings.max_carpool_size)));
+		carpools.push_back(GenPlace());
+		for (size_t i = ic; i < ic + size; ++i) {
+			agents.at(carpoolers.at(i)).carpool_ID = static_cast<int>(carpools.size());
+		}
+		ic += size;
+	}
+	std::vector<GenPlace>& routes = places.at(TownImage::public_transit);
+	for (size_t ir = 0; ir < riders.size(); ) {
+		const size_t size = std::min(riders.size() - ir,
+				static_cast<size_t>(uniform_int(settings.min_public_size, settings.max_public_size)));
+		routes.push_back(GenPlace());
+		for (size_t i = ir; i < ir + size; ++i) {
+			agents.at(riders.at(i)).public_ID = static_cast<int>(routes.size());
+		}
+		ir += size;
+	}
+}
+
+// Leisure locations, some just outside the town
+void TownGenerator::create_leisure_locations()
+{
+	std::vector<GenPlace>& leisure = places.at(TownImage::leisure_locations);
+	const int n_leisure = std::max(1, settings.n_agents/settings.agents_per_leisure);
+	for (int il = 0; il < n_leisure; ++il) {
+		GenPlace location = random_location();
+		if (rng.get_random(0.0, 1.0) < settings.fraction_leisure_outside) {
+			location.lon += lon_size;
+			location.type = 1;
+		}
+		leisure.push_back(location);
+	}
+}
+
+// Uniform around the neighborhood center, within the town
+TownGenerator::GenPlace TownGenerator::random_location(const int nbh)
+{
+	const std::pair<double, double>& center =
+		neighborhoods.at(nbh < 0 ? uniform_int(0, static_cast<int>(neighborhoods.size()) - 1) : nbh);
+	const double u = std::min(1.0, std::max(0.0, center.first + rng.get_random(-nbh_spread, nbh_spread)));
+	const double v = std::min(1.0, std::max(0.0, center.second + rng.get_random(-nbh_spread, nbh_spread)));
+	GenPlace place;
+	place.lat = lat0 + u*lat_size;
+	place.lon = lon0 + v*lon_size;
+	return place;
+}
+
+// Bin from the distribution, then uniform within the bin
+int TownGenerator::random_age(const int min_age)
+{
+	const std::vector<int>& bins = settings.age_bins;
+	const std::vector<double>& probs = settings.age_bin_probs;
+	// Bins that end above the minimum age
+	auto bin_end = [this, &bins](const size_t ib)
+		{ return (ib + 1 < bins.size()) ? bins[ib + 1] : settings.max_age + 1; };
+	size_t first = 0;
+	while (first + 1 < bins.size() && bin_end(first) <= min_age) {
+		++first;
+	}
+	double total = 0.0;
+	for (size_t ib = first; ib < bins.size(); ++ib) {
+		total += probs[ib];
+	}
+	double r = rng.get_random(0.0, total);
+	size_t ib = first;
+	while (ib + 1 < bins.size() && r >= probs[ib]) {
+		r -= probs[ib];
+		++ib;
+	}
+	return uniform_int(std::max(min_age, bins[ib]), bin_end(ib) - 1);
+}
+
+// Linear search, the distributions are short
+size_t TownGenerator::draw(const std::vector<double>& probs)
+{
+	double total = 0.0;
+	for (const double p : probs) {
+		total += p;
+	}
+	double r = rng.get_random(0.0, total);
+	for (size_t i = 0; i + 1 < probs.size(); ++i) {
+		if (r < probs[i]) {
+			return i;
+		}
+		r -= probs[i];
+	}
+	return probs.size() - 1;
+}
+
+// Households, retirement homes, or hospitals
+const TownGenerator::GenPlace& TownGenerator::residence(const GenAgent& agent) const
+{
+	if (agent.role == rh_resident) {
+		return places.at(TownImage::retirement_homes).at(agent.residence_ID - 1);
+	} else if (agent.role == patient) {
+		return places.at(TownImage::hospitals).at(agent.residence_ID - 1);
+	}
+	return places.at(TownImage::households).at(agent.residence_ID - 1);
+}
+
+std::string TownGenerator::place_file_name(const TownImage::PlaceType type)
+{
+	if (type < 0 || type >= TownImage::n_place_types) {
+		throw std::invalid_argument("Wrong place type " + std::to_string(type));
+	}
+	return place_file_names[type];
+}
+
+// Only schools, workplaces, transit, and leisure locations have types
+std::vector<std::string> TownGenerator::type_names(const TownImage::PlaceType type) const
+{
+	switch (type) {
+		case TownImage::schools:
+			return school_types;
+		case TownImage::workplaces: {
+			std::vector<std::string> names(settings.workplace_types);
+			names.push_back("outside");
+			return names;
+		}
+		case TownImage::carpools:
+		case TownImage::public_transit:
+			return {"intown"};
+		case TownImage::leisure_locations:
+			return {"intown", "outside"};
+		default:
+			return {};
+	}
+}
+
+// All places, then the agents
+void TownGenerator::write_files(const std::string& path) const
+{
+	for (int ip = 0; ip < TownImage::n_place_types; ++ip) {
+		write_places(path, static_cast<TownImage::PlaceType>(ip));
+	}
+	write_agents(path);
+}
+
+// ID, coordinates if the place has them, and type if it has one
+void TownGenerator::write_places(const std::string& path, const TownImage::PlaceType type) const
+{
+	TextWriter out(path + place_file_name(type));
+	const std::vector<std::string> names = type_names(type);
+	const bool has_coordinates = (type != TownImage::carpools && type != TownImage::public_transit);
+	const std::vector<GenPlace>& of_type = places.at(type);
+	for (size_t ip = 0; ip < of_type.size(); ++ip) {
+		out.add(static_cast<long long>(ip + 1));
+		if (has_coordinates) {
+			out.space().add(of_type.at(ip).lat, 6).space().add(of_type.at(ip).lon, 6);
+		}
+		if (!names.empty()) {
+			out.space().add(names.at(of_type.at(ip).type));
+		}
+		out.end_line();
+	}
+	out.close();
+}
+
+// One agent per line, columns as read by TownImage::read_agent
+void TownGenerator::write_agents(const std::string& path) const
+{
+	TextWriter out(path + agent_file_name());
+	for (const auto& agent : agents) {
+		const GenPlace& home = residence(agent);
+		const bool staff = (agent.role == school_staff || agent.role == rh_staff
+								|| agent.role == hospital_staff);
+		// Work ID of special employment, also hospital ID of hospital staff
+		const int special_ID = (agent.role == hospital_staff) ? agent.hospital_ID :
+										(staff ? agent.work_ID : 0);
+		out.add(static_cast<long long>(agent.student)).space()
+			.add(static_cast<long long>(agent.works)).space()
+			.add(static_cast<long long>(agent.age)).space()
+			.add(home.lat, 6).space().add(home.lon, 6).space()
+			.add(static_cast<long long>(agent.role == patient ? 0 : agent.residence_ID)).space()
+			.add(static_cast<long long>(agent.role == patient)).space()
+			.add(static_cast<long long>(agent.school_ID)).space()
+			.add(static_cast<long long>(agent.role == rh_resident)).space()
+			.add(static_cast<long long>(agent.role == rh_staff)).space()
+			.add(static_cast<long long>(agent.role == school_staff)).space()
+			.add(static_cast<long long>(agent.work_ID)).space()
+			.add(static_cast<long long>(agent.role == hospital_staff)).space()
+			.add(static_cast<long long>(agent.hospital_ID)).space()
+			// Initially infected are selected in the model
+			.add(0LL).space()
+			.add(static_cast<long long>(agent.wfh)).space()
+			.add(static_cast<double>(agent.travel_time), 2).space();
+		if (agent.wfh) {
+			out.add("wfh");
+		} else if (agent.mode == no_mode) {
+			out.add("None");
+		} else {
+			out.add(mode_names[agent.mode]);
+		}
+		out.space().add(static_cast<long long>(special_ID)).space()
+			.add(static_cast<long long>(agent.carpool_ID)).space()
+			.add(static_cast<long long>(agent.public_ID)).space();
+		if (agent.occupation < 0) {
+			out.add("none");
+		} else {
+			out.add(settings.workplace_types.at(agent.occupation));
+		}
+		out.end_line();
+	}
+	out.close();
+}
+
+// Copy with the town entries replaced
+void TownGenerator::write_input_files(const std::string& template_file,
+					const std::string& path, const std::string& fname)
+{
+	std::map<std::string, std::string> town_files;
+	for (int ip = 0; ip < TownImage::n_place_types; ++ip) {
+		town_files[place_file_tags[ip]] = path + place_file_names[ip];
+	}
+	town_files["Agent data"] = path + agent_file_name();
+
+	std::ifstream in(template_file);
+	if (!in.is_open()) {
+		std::cerr << "Error opening file " << template_file << std::endl;
+		throw std::runtime_error("Cannot open input file list template");
+	}
+	std::ofstream out(fname);
+	if (!out.is_open()) {
+		std::cerr << "Error opening file " << fname << std::endl;
+		throw std::runtime_error("Cannot open town generator output file");
+	}
+	std::string line;
+	while (std::getline(in, line)) {
+		if (line.find("//") == std::string::npos) {
+			out << line << "\n";
+			continue;
+		}
+		// Tag as LoadParameters reads it
+		std::istringstream data_row(line);
+		std::string word, tag;
+		data_row >> word;
+		while (data_row >> word) {
+			tag += (word + " ");
+		}
+		if (!tag.empty()) {
+			tag.pop_back();
+		}
+		if (tag == "Town image") {
+			std::getline(in, line);
+			continue;
+		}
+		out << line << "\n";
+		const auto town_file = town_files.find(tag);
+		if (town_file != town_files.end() && std::getline(in, line)) {
+			out << town_file->second << "\n";
+		}
+	}
+	if (!out.good()) {
+		throw std::runtime_error("Error writing to " + fname);
+	}
+}
@@ -0,0 +1,418 @@
+#include "../../include/io_operations/town_image.h"
+#include "../../include/io_operations/load_parameters.h"
+
+/***************************************************************
+ * class: TownImage
+ *
+ * Precompiled binary form of all the places and agents
+ * of a town
+ **************************************************************/
+
+namespace {
+
+	// First bytes of every image
+	const char magic[8] = {'A', 'B', 'M', 'T', 'O', 'W', 'N', '\0'};
+	// All blocks start at multiples of this
+	const size_t alignment = 8;
+
+	// Place files as tagged in the input file list, in PlaceType order
+	const char* place_file_tags[TownImage::n_place_types] = {"Household data",
+		"School data", "Workplace data", "Hospital data", "Retirement home data",
+		"Carpool data", "Public transit data", "Leisure location data"};
+	// False for place types whose files have no coordinates
+	const bool place_has_coordinates[TownImage::n_place_types] = {true, true, true,
+		true, true, false, false, true};
+
+	//
+	// Writing
+	//
+
+	/// Write n bytes and pad to the alignment
+	void write_block(std::ofstream& out, const void* data, const size_t n)
+	{
+		const char zeros[alignment] = {0};
+		out.write(static_cast<const char*>(data), n);
+		if (n % alignment) {
+			out.write(zeros, alignment - n % alignment);
+		}
+	}
+
+	template <typename T>
+	void write_column(std::ofstream& out, const std::vector<T>& column)
+		{ write_block(out, column.data(), column.size()*sizeof(T)); }
+
+	void write_count(std::ofstream& out, const size_t n)
+	{
+		const uint64_t n_rows = n;
+		write_block(out, &n_rows, sizeof(n_rows));
+	}
+
+	/// Number of entries, then length and characters of each
+	void write_dictionary(std::ofstream& out, const std::vector<std::string>& names)
+	{
+		std::string block;
+		const uint32_t n_names = names.size();
+		block.append(reinterpret_cast<const char*>(&n_names), sizeof(n_names));
+		for (const auto& name : names) {
+			const uint32_t len = name.size();
+			block.append(reinterpret_cast<const char*>(&len), sizeof(len));
+			block.append(name);
+		}
+		write_block(out, block.data(), block.size());
+	}
+
+	/// Index of name in the dictionary, added if not there yet
+	uint16_t dictionary_code(std::vector<std::string>& names, const std::string& name)
+	{
+		auto iter = std::find(names.begin(), names.end(), name);
+		if (iter != names.end()) {
+			return static_cast<uint16_t>(iter - names.begin());
+		}
+		if (names.size() == UINT16_MAX) {
+			throw std::runtime_error("Too many distinct types for a town image");
+		}
+		names.push_back(name);
+		return static_cast<uint16_t>(names.size() - 1);
+	}
+
+	//
+	// Reading
+	//
+
+	/// Sequential, bounds-checked access to the mapped image
+	class ImageCursor
+	{
+	public:
+		ImageCursor(const char* begin, const char* end) : pos(begin), last(end) { }
+
+		/// Pointer to a column of n values of type T
+		template <typename T>
+		const T* column(const size_t n)
+		{
+			const T* col = reinterpret_cast<const T*>(pos);
+			advance(n*sizeof(T));
+			return col;
+		}
+
+		size_t count()
+			{ return static_cast<size_t>(*column<uint64_t>(1)); }
+
+		std::vector<std::string> dictionary()
+		{
+			std::vector<std::string> names;
+			const char* start = pos;
+			const uint32_t n_names = read_u32();
+			for (uint32_t i = 0; i < n_names; ++i) {
+				const uint32_t len = read_u32();
+				check(len);
+				names.emplace_back(pos, len);
+				pos += len;
+			}
+			// Back to the beginning to skip with padding
+			const size_t n_bytes = pos - start;
+			pos = start;
+			advance(n_bytes);
+			return names;
+		}
+
+	private:
+		const char* pos = nullptr;
+		const char* last = nullptr;
+
+		void check(const size_t n) const
+		{
+			if (n > static_cast<size_t>(last - pos)) {
+				throw std::runtime_error("Corrupted or truncated town image");
+			}
+		}
+
+		void advance(size_t n)
+		{
+			if (n % alignment) {
+				n += alignment - n % alignment;
+			}
+			check(n);
+			pos += n;
+		}
+
+		uint32_t read_u32()
+		{
+			check(sizeof(uint32_t));
+			uint32_t val = 0;
+			std::memcpy(&val, pos, sizeof(val));
+			pos += sizeof(val);
+			return val;
+		}
+	};
+
+	/// Dictionary entry with bounds check
+	const std::string& dictionary_entry(const std::vector<std::string>& names, const uint16_t code)
+	{
+		if (code >= names.size()) {
+			throw std::runtime_error("Corrupted or truncated town image");
+		}
+		return names[code];
+	}
+}
+
+// Map and validate an existing image
+TownImage::TownImage(const std::string& fname) : file(fname)
+{
+	ImageCursor cursor(file.raw_data(), file.raw_data() + file.size());
+
+	// Header
+	if (file.size() < sizeof(magic) + alignment
+			|| std::memcmp(file.raw_data(), magic, sizeof(magic)) != 0) {
+		throw std::runtime_error(fname + " is not a town image");
+	}
+	cursor.column<char>(sizeof(magic));
+	const uint32_t* file_version = cursor.column<uint32_t>(2);
+	if (*file_version != version) {
+		throw std::runtime_error("Town image " + fname + " has version "
+			+ std::to_string(*file_version) + ", expected " + std::to_string(version));
+	}
+
+	// Places
+	place_tables.resize(n_place_types);
+	for (auto& table : place_tables) {
+		table.n_rows = cursor.count();
+		table.type_names = cursor.dictionary();
+		table.ID = cursor.column<int32_t>(table.n_rows);
+		table.x = cursor.column<double>(table.n_rows);
+		table.y = cursor.column<double>(table.n_rows);
+		table.type = cursor.column<uint16_t>(table.n_rows);
+	}
+
+	// Agents
+	agent_table.n_rows = cursor.count();
+	agent_table.travel_mode_names = cursor.dictionary();
+	agent_table.occupation_names = cursor.dictionary();
+	for (auto& col : agent_table.flags) {
+		col = cursor.column<uint8_t>(agent_table.n_rows);
+	}
+	for (auto& col : agent_table.ints) {
+		col = cursor.column<int32_t>(agent_table.n_rows);
+	}
+	for (auto& col : agent_table.doubles) {
+		col = cursor.column<double>(agent_table.n_rows);
+	}
+	agent_table.travel_mode = cursor.column<uint16_t>(agent_table.n_rows);
+	agent_table.occupation = cursor.column<uint16_t>(agent_table.n_rows);
+}
+
+// Create an image from text input files
+void TownImage::create(const std::string& input_files, const std::string& fname)
+{
+	LoadParameters ldparam;
+	std::map<std::string, std::string> setup_files = ldparam.load_parameter_map<std::string>(input_files);
+
+	std::ofstream out(fname, std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		throw std::runtime_error("Cannot create town image " + fname);
+	}
+	write_block(out, magic, sizeof(magic));
+	const uint32_t header[2] = {version, 0};
+	write_block(out, header, sizeof(header));
+
+	// Places
+	PlaceRecord place;
+	for (int ip = 0; ip < n_place_types; ++ip) {
+		MappedReader reader(setup_files.at(place_file_tags[ip]));
+		MappedReader::Row row;
+		const size_t n_rows = reader.count_rows();
+		std::vector<int32_t> ID;
+		std::vector<double> x, y;
+		std::vector<uint16_t> type;
+		std::vector<std::string> type_names;
+		ID.reserve(n_rows);
+		x.reserve(n_rows);
+		y.reserve(n_rows);
+		type.reserve(n_rows);
+		while (reader.next_row(row)) {
+			read_place(row, place_has_coordinates[ip], place);
+			ID.push_back(place.ID);
+			x.push_back(place.x);
+			y.push_back(place.y);
+			type.push_back(dictionary_code(type_names, place.type));
+		}
+		write_count(out, ID.size());
+		write_dictionary(out, type_names);
+		write_column(out, ID);
+		write_column(out, x);
+		write_column(out, y);
+		write_column(out, type);
+	}
+
+	// Agents
+	MappedReader reader(setup_files.at("Agent data"));
+	MappedReader::Row row;
+	AgentRecord agent;
+	const size_t n_agents = reader.count_rows();
+	std::vector<std::vector<uint8_t>> flags(8, std::vector<uint8_t>(n_agents));
+	std::vector<std::vector<int32_t>> ints(7, std::vector<int32_t>(n_agents));
+	std::vector<std::vector<double>> doubles(3, std::vector<double>(n_agents));
+	std::vector<uint16_t> travel_mode(n_agents), occupation(n_agents);
+	std::vector<std::string> travel_mode_names, occupation_names;
+	size_t ia = 0;
+	while (reader.next_row(row)) {
+		read_agent(row, agent);
+		flags[0][ia] = agent.student;
+		flags[1][ia] = agent.works;
+		flags[2][ia] = agent.patient;
+		flags[3][ia] = agent.hospital_staff;
+		flags[4][ia] = agent.lives_RH;
+		flags[5][ia] = agent.works_RH;
+		flags[6][ia] = agent.works_school;
+		flags[7][ia] = agent.works_from_home;
+		ints[0][ia] = agent.age;
+		ints[1][ia] = agent.house_ID;
+		ints[2][ia] = agent.school_ID;
+		ints[3][ia] = agent.work_ID;
+		ints[4][ia] = agent.hospital_ID;
+		ints[5][ia] = agent.carpool_ID;
+		ints[6][ia] = agent.public_ID;
+		doubles[0][ia] = agent.x;
+		doubles[1][ia] = agent.y;
+		doubles[2][ia] = agent.travel_time;
+		travel_mode[ia] = dictionary_code(travel_mode_names, agent.travel_mode);
+		occupation[ia] = dictionary_code(occupation_names, agent.occupation);
+		++ia;
+	}
+	write_count(out, n_agents);
+	write_dictionary(out, travel_mode_names);
+	write_dictionary(out, occupation_names);
+	for (const auto& col : flags) {
+		write_column(out, col);
+	}
+	for (const auto& col : ints) {
+		write_column(out, col);
+	}
+	for (const auto& col : doubles) {
+		write_column(out, col);
+	}
+	write_column(out, travel_mode);
+	write_column(out, occupation);
+
+	if (!out.good()) {
+		throw std::runtime_error("Error writing town image " + fname);
+	}
+}
+
+// Place properties from a row of a place file
+void TownImage::read_place(const MappedReader::Row& row, const bool has_coordinates,
+								PlaceRecord& record)
+{
+	record.ID = row.get_int(0);
+	size_t type_col = 1;
+	if (has_coordinates) {
+		record.x = row.get_double(1);
+		record.y = row.get_double(2);
+		type_col = 3;
+	} else {
+		record.x = 0.0;
+		record.y = 0.0;
+	}
+	if (row.size() > type_col) {
+		record.type.assign(row.field_begin(type_col), row.field_length(type_col));
+	} else {
+		record.type.clear();
+	}
+}
+
+// Agent properties from a row of the agent file, roles and transit resolved
+void TownImage::read_agent(const MappedReader::Row& row, AgentRecord& record)
+{
+	record = AgentRecord();
+
+	// Household ID only if not hospitalized with condition
+	// different than COVID-19
+	if (row.get_int(6) == 1) {
+		record.patient = true;
+		record.house_ID = 0;
+	} else {
+		record.house_ID = row.get_int(5);
+	}
+	// No school or work if patient with condition other than COVID
+	record.hospital_staff = (row.get_int(12) == 1 && !record.patient);
+	record.student = (row.get_int(0) == 1 && !record.patient);
+	// No work flag if a hospital employee
+	record.works = (row.get_int(1) == 1 && !(record.patient || record.hospital_staff));
+	// Retirement home resident or employee, school employee
+	record.lives_RH = (row.get_int(8) == 1);
+	record.works_RH = (row.get_int(9) == 1);
+	record.works_school = (row.get_int(10) == 1);
+
+	// Select correct work ID for special employment types
+	// Hospital ID is set separately, but for consistency
+	if (record.works_RH || record.works_school || record.hospital_staff) {
+		record.work_ID = row.get_int(18);
+	} else if (record.works) {
+		record.work_ID = row.get_int(11);
+	}
+
+	// Transit information
+	if (row.get_int(15) == 1) {
+		record.works_from_home = true;
+		record.travel_mode = row.get_string(17);
+	} else if (!(record.works || record.hospital_staff)) {
+		record.travel_mode = "None";
+	} else {
+		record.travel_mode = row.get_string(17);
+		if (record.travel_mode == "carpool") {
+			record.carpool_ID = row.get_int(19);
+		}
+		if (record.travel_mode == "public") {
+			record.public_ID = row.get_int(20);
+		}
+		record.travel_time = row.get_double(16);
+	}
+
+	record.age = row.get_int(2);
+	record.x = row.get_double(3);
+	record.y = row.get_double(4);
+	record.school_ID = row.get_int(7);
+	record.hospital_ID = row.get_int(13);
+	record.occupation = row.get_string(21);
+}
+
+// Properties of place with index i
+void TownImage::get_place(const PlaceType ptype, const size_t i, PlaceRecord& record) const
+{
+	const PlaceTable& table = place_tables.at(ptype);
+	if (i >= table.n_rows) {
+		throw std::out_of_range("Place index outside of the town image");
+	}
+	record.ID = table.ID[i];
+	record.x = table.x[i];
+	record.y = table.y[i];
+	record.type = dictionary_entry(table.type_names, table.type[i]);
+}
+
+// Properties of agent with index i
+void TownImage::get_agent(const size_t i, AgentRecord& record) const
+{
+	const AgentTable& table = agent_table;
+	if (i >= table.n_rows) {
+		throw std::out_of_range("Agent index outside of the town image");
+	}
+	record.student = table.flags[0][i];
+	record.works = table.flags[1][i];
+	record.patient = table.flags[2][i];
+	record.hospital_staff = table.flags[3][i];
+	record.lives_RH = table.flags[4][i];
+	record.works_RH = table.flags[5][i];
+	record.works_school = table.flags[6][i];
+	record.works_from_home = table.flags[7][i];
+	record.age = table.ints[0][i];
+	record.house_ID = table.ints[1][i];
+	record.school_ID = table.ints[2][i];
+	record.work_ID = table.ints[3][i];
+	record.hospital_ID = table.ints[4][i];
+	record.carpool_ID = table.ints[5][i];
+	record.public_ID = table.ints[6][i];
+	record.x = table.doubles[0][i];
+	record.y = table.doubles[1][i];
+	record.travel_time = table.doubles[2][i];
+	record.travel_mode = dictionary_entry(table.travel_mode_names, table.travel_mode[i]);
+	record.occupation = dictionary_entry(table.occupation_names, table.occupation[i]);
+}
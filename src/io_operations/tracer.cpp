@@ -0,0 +1,134 @@
+#include "../../include/io_operations/tracer.h"
+
+/***************************************************************
+ * class: Tracer
+ *
+ * Timeline of scoped events in Chrome trace format
+ **************************************************************/
+
+// Allocate the buffer and start the clock
+Tracer::Tracer(const size_t capacity) : origin(std::chrono::steady_clock::now())
+{
+	if (capacity == 0) {
+		throw std::invalid_argument("Tracer needs space for at least one event");
+	}
+	events.resize(capacity);
+}
+
+// Replace the oldest if full
+void Tracer::add_event(const char* name, const char* category,
+						const double start, const double duration,
+						const char* arg_name, const double arg_value)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	events[next] = {name, category, start, duration, thread_number(), arg_name, arg_value};
+	next = (next + 1) % events.size();
+	++n_added;
+}
+
+// Empty buffer, same clock and tracks
+void Tracer::clear()
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	next = 0;
+	n_added = 0;
+}
+
+size_t Tracer::number_of_events() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return std::min(n_added, events.size());
+}
+
+size_t Tracer::number_of_dropped_events() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return n_added - std::min(n_added, events.size());
+}
+
+size_t Tracer::number_of_threads() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return threads.size();
+}
+
+// Open the file and write
+void Tracer::write_json(const std::string& fname) const
+{
+	std::ofstream out(fname);
+	if (!out.is_open()) {
+		std::cerr << "Error opening file " << fname << std::endl;
+		throw std::runtime_error("Cannot open trace output file");
+	}
+	write_json(out);
+	if (!out.good()) {
+		throw std::runtime_error("Error writing to " + fname);
+	}
+}
+
+// Track names, then events from the oldest
+void Tracer::write_json(std::ostream& where) const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	const std::ios_base::fmtflags flags = where.flags();
+	const std::streamsize precision = where.precision();
+	where << std::fixed << std::setprecision(3);
+
+	where << "{\"traceEvents\":[";
+	bool first = true;
+	for (size_t it = 0; it < threads.size(); ++it) {
+		where << (first ? "\n" : ",\n");
+		where << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it
+			  << ",\"args\":{\"name\":\"thread " << it << "\"}}";
+		first = false;
+	}
+	const size_t n_stored = std::min(n_added, events.size());
+	const size_t oldest = (n_added > events.size()) ? next : 0;
+	for (size_t i = 0; i < n_stored; ++i) {
+		const Event& event = events[(oldest + i) % events.size()];
+		where << (first ? "\n" : ",\n");
+		where << "{\"name\":\"" << escape(event.name) << "\",\"cat\":\"" << escape(event.category)
+			  << "\",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration
+			  << ",\"pid\":1,\"tid\":" << event.thread;
+		if (event.arg_name) {
+			where << ",\"args\":{\"" << escape(event.arg_name) << "\":" << event.arg_value << "}";
+		}
+		where << "}";
+		first = false;
+	}
+	where << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":"
+		  << n_added - n_stored << "}}\n";
+
+	where.flags(flags);
+	where.precision(precision);
+}
+
+// New threads get the next track
+int Tracer::thread_number()
+{
+	const std::thread::id id = std::this_thread::get_id();
+	for (size_t it = 0; it < threads.size(); ++it) {
+		if (threads[it] == id) {
+			return static_cast<int>(it);
+		}
+	}
+	threads.push_back(id);
+	return static_cast<int>(threads.size() - 1);
+}
+
+// Only the characters that break a JSON string
+std::string Tracer::escape(const char* text)
+{
+	std::string escaped;
+	for (const char* c = text; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\') {
+			escaped += '\\';
+			escaped += *c;
+		} else if (static_cast<unsigned char>(*c) < 0x20) {
+			escaped += ' ';
+		} else {
+			escaped += *c;
+		}
+	}
+	return escaped;
+}
@@ -23,6 +23,8 @@ void Mobility::construct_public_probabilities(const std::vector<Household>& hous
 	}
 	// Compute the ditances and probabilities for all locations
 	double dij = 0.0, pij = 0.0;
+	std::vector<std::vector<double>> all_probabilities;
+	all_probabilities.reserve(households.size());
 	for (const auto& house : households) {
 		std::vector<double> probs = {};
 		for (const auto& leisure : leisure_locations) {
@@ -37,8 +39,10 @@ void Mobility::construct_public_probabilities(const std::vector<Household>& hous
 		if (max_p > 0.0){
 			std::for_each(probs.begin(), probs.end(), [&max_p](double &x) { x /= max_p; });
 		}
-		public_probabilities.push_back(probs);
+		all_probabilities.push_back(std::move(probs));
 	}	
+	public_probabilities = std::make_shared<const std::vector<std::vector<double>>>(
+								std::move(all_probabilities));
 }
 
 // Computes distances between two locations based
@@ -73,42 +77,6 @@ double Mobility::compute_probability(const double dist)
 	return pdij;
 }
 
-// Assign a leisure location - public or residential 
-int Mobility::assign_leisure_location(Infection& infection, const int& house_ID, 
-				bool& in_household, bool& in_public, const double& household_prob)
-{
-	in_household = false;
-	in_public = false;
-	int pub_ID = 0, guest_ID = 0;
-
-	// Determine if the location will be private of public
-	if (household_prob <= infection.get_uniform()) {	
-		// If a household, randomly select the ID that is not one of current agents
-		guest_ID = house_ID;
-		while (guest_ID == house_ID) {
-			guest_ID = infection.get_random_household_ID(public_probabilities.size());
-		}	
-		in_household = true;
-		return guest_ID;
-	} else {
-		// If a public location - assign based on the probabilities
-		int pub_ID = 0;
-		in_public = true;
-		const double prob = infection.get_uniform();
-		const std::vector<double>& a_house = public_probabilities.at(house_ID-1);
-			
-		// Iterator to the first element with probability >= to prob, 
-		// or one past last if no such element
-		const auto& iter = std::find_if(a_house.cbegin(), a_house.cend(), 
-						[&prob](const double x) { return x >= prob; });
-		// Find and return the ID
-		pub_ID = std::distance(a_house.cbegin(), iter) + 1;
-		in_public = true;
-		return pub_ID;
-	}
-	return 0;
-}
-
 // Save the matrix of probabilities to file	
 void Mobility::print_probabilities(const std::string fname)
 {
@@ -119,5 +87,5 @@ void Mobility::print_probabilities(const std::string fname)
 
 	// Write data to file
 	AbmIO abm_io(fname, delim, sflag, dims);
-	abm_io.write_vector<double>(public_probabilities);
+	abm_io.write_vector<double>(*public_probabilities);
 }
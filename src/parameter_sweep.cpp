@@ -0,0 +1,222 @@
+#include "../include/parameter_sweep.h"
+
+/*****************************************************
+ * class: ParameterSweep
+ *
+ * Runs replicates of a model on a grid of parameter
+ * values, in a single process
+ *
+ ******************************************************/
+
+// Check the grid and set up the shared model
+ParameterSweep::ParameterSweep(const EnsembleSetup& _setup, const std::vector<SweepParameter>& _parameters,
+								const int n_rep, const unsigned int seed, const int n_thr) :
+	setup(_setup), parameters(_parameters), n_replicates(n_rep), base_seed(seed),
+	next_task(0)
+{
+	if (n_replicates < 1) {
+		throw std::invalid_argument("Parameter sweep needs at least one replicate");
+	}
+	if (parameters.empty()) {
+		throw std::invalid_argument("Parameter sweep needs at least one parameter");
+	}
+	std::vector<std::string> names;
+	for (const auto& par : parameters) {
+		if (par.values.empty()) {
+			throw std::invalid_argument("No values to sweep for " + par.name);
+		}
+		if (std::find(names.begin(), names.end(), par.name) != names.end()) {
+			throw std::invalid_argument("Parameter swept more than once: " + par.name);
+		}
+		names.push_back(par.name);
+		n_points *= par.values.size();
+		if (par.target == SweepParameter::infection && ABM::is_setup_parameter(par.name)) {
+			per_point_setup = true;
+		}
+	}
+	const int n_tasks = n_points*n_replicates;
+	n_threads = (n_thr > 0) ? n_thr : std::max(1u, std::thread::hardware_concurrency());
+	n_threads = std::min(n_threads, n_tasks);
+
+	if (per_point_setup) {
+		point_models.resize(n_points);
+	} else {
+		std::vector<int> no_infected(setup.inf0.size(), 0);
+		prototype.reset(new ABM(setup.dt));
+		prototype->simulation_setup(setup.input_files, no_infected,
+						setup.custom_vac_offsets, setup.custom_boost_offsets);
+		// Every run sets all the swept parameters, so this only
+		// checks the names before anything is run
+		std::map<std::string, double> infection_values, vaccination_values;
+		point_values(0, infection_values, vaccination_values);
+		for (const auto& par : infection_values) {
+			prototype->set_infection_parameter(par.first, par.second);
+		}
+		for (const auto& par : vaccination_values) {
+			prototype->set_vaccination_parameter(par.first, par.second);
+		}
+	}
+}
+
+// Values at grid point i
+std::vector<double> ParameterSweep::get_point(const int i) const
+{
+	if (i < 0 || i >= n_points) {
+		throw std::out_of_range("Grid point out of range");
+	}
+	std::vector<double> values(parameters.size(), 0.0);
+	int rest = i;
+	for (int ip = parameters.size() - 1; ip >= 0; --ip) {
+		const int n_values = parameters.at(ip).values.size();
+		values.at(ip) = parameters.at(ip).values.at(rest % n_values);
+		rest /= n_values;
+	}
+	return values;
+}
+
+// Run all points and replicates on a pool of threads
+void ParameterSweep::run(const std::string& fname, const Recorder::Format format)
+{
+	Recorder output(fname, format);
+	output.add_metric("grid point");
+	output.add_metric("replicate");
+	for (const auto& par : parameters) {
+		output.add_metric(par.name);
+	}
+	for (auto& point : point_models) {
+		point.reset(new PointModel);
+		point->remaining = n_replicates;
+	}
+	// Metrics depend on the setup (number of strains)
+	const ABM* model = prototype.get();
+	if (per_point_setup) {
+		PointModel& first = *point_models.front();
+		std::call_once(first.built, [this, &first](){ first.abm = setup_point(0); });
+		model = first.abm.get();
+	}
+	for (const auto& name : model->get_time_series_names()) {
+		output.add_metric(name);
+	}
+
+	recorder = &output;
+	next_task = 0;
+	error = nullptr;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < n_threads - 1; ++i) {
+		threads.emplace_back(&ParameterSweep::worker, this);
+	}
+	// This thread works too
+	worker();
+	for (auto& thr : threads) {
+		thr.join();
+	}
+	recorder = nullptr;
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	output.close();
+}
+
+// Take runs until none are left
+void ParameterSweep::worker()
+{
+	const int n_tasks = n_points*n_replicates;
+	int task = 0;
+	while ((task = next_task++) < n_tasks) {
+		try {
+			run_task(task);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(error_mtx);
+			if (!error) {
+				error = std::current_exception();
+			}
+			// Stop handing out new runs
+			next_task = n_tasks;
+		}
+	}
+}
+
+// Copy, set, and run one replicate at one grid point
+void ParameterSweep::run_task(const int task)
+{
+	// Replicates of a point are consecutive so that
+	// only a few point models exist at a time
+	const int point = task / n_replicates;
+	const int replicate = task % n_replicates;
+	std::vector<std::vector<double>> trajectory;
+
+	if (per_point_setup) {
+		PointModel& model = *point_models.at(point);
+		std::call_once(model.built, [this, &model, point](){ model.abm = setup_point(point); });
+		ABM abm(*model.abm);
+		{
+			std::lock_guard<std::mutex> lock(point_mtx);
+			if (--model.remaining == 0) {
+				model.abm.reset();
+			}
+		}
+		Ensemble::simulate(abm, setup, Ensemble::replicate_seed(base_seed, replicate), trajectory);
+	} else {
+		ABM abm(*prototype);
+		std::map<std::string, double> infection_values, vaccination_values;
+		point_values(point, infection_values, vaccination_values);
+		for (const auto& par : infection_values) {
+			abm.set_infection_parameter(par.first, par.second);
+		}
+		for (const auto& par : vaccination_values) {
+			abm.set_vaccination_parameter(par.first, par.second);
+		}
+		Ensemble::simulate(abm, setup, Ensemble::replicate_seed(base_seed, replicate), trajectory);
+	}
+	write_run(point, replicate, trajectory);
+}
+
+// Setup with the parameters of point i
+std::unique_ptr<ABM> ParameterSweep::setup_point(const int i) const
+{
+	std::map<std::string, double> infection_values, vaccination_values;
+	point_values(i, infection_values, vaccination_values);
+	std::unique_ptr<ABM> abm(new ABM(setup.dt));
+	abm->set_parameter_overrides(infection_values, vaccination_values);
+	std::vector<int> no_infected(setup.inf0.size(), 0);
+	abm->simulation_setup(setup.input_files, no_infected,
+					setup.custom_vac_offsets, setup.custom_boost_offsets);
+	return abm;
+}
+
+// Infection and vaccination values of point i
+void ParameterSweep::point_values(const int i, std::map<std::string, double>& infection_values,
+									std::map<std::string, double>& vaccination_values) const
+{
+	const std::vector<double> values = get_point(i);
+	for (int ip = 0; ip < parameters.size(); ++ip) {
+		if (parameters.at(ip).target == SweepParameter::infection) {
+			infection_values[parameters.at(ip).name] = values.at(ip);
+		} else {
+			vaccination_values[parameters.at(ip).name] = values.at(ip);
+		}
+	}
+}
+
+// Rows of one run, written together
+void ParameterSweep::write_run(const int point, const int replicate,
+								const std::vector<std::vector<double>>& trajectory)
+{
+	const std::vector<double> values = get_point(point);
+	std::lock_guard<std::mutex> lock(output_mtx);
+	int col = 0;
+	recorder->set(col++, point);
+	recorder->set(col++, replicate);
+	for (const double value : values) {
+		recorder->set(col++, value);
+	}
+	const int first_metric = col;
+	for (int ti = 0; ti < trajectory.size(); ++ti) {
+		col = first_metric;
+		for (const double value : trajectory.at(ti)) {
+			recorder->set(col++, value);
+		}
+		recorder->record(ti*setup.dt);
+	}
+}
@@ -15,7 +15,7 @@
 // from exposedi and symptoamtic agents if any 
 void Hospital::compute_infected_contribution()
 {
-	num_tot = agent_IDs.size() + n_tested;
+	num_tot = agent_IDs->size() + n_tested + n_remote;
 	if (num_tot == 0) {
 		std::fill(lambda_tot.begin(), lambda_tot.end(), 0.0);
 	} else {
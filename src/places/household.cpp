@@ -21,7 +21,7 @@ void Household::print_basic(std::ostream& where) const
 // Calculates and stores fraction of infected agents if any 
 void Household::compute_infected_contribution()
 {
-	num_tot = agent_IDs.size();
+	num_tot = agent_IDs->size() + visitor_IDs.size() + n_remote;
 	
 	if (num_tot == 0) {
 		std::fill(lambda_tot.begin(), lambda_tot.end(), 0.0);
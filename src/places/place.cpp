@@ -15,7 +15,7 @@
 void Place::register_agent(const int agent_ID)
 {
 	// Store ID
-	agent_IDs.push_back(agent_ID);
+	own_agent_IDs().push_back(agent_ID);
 	// Update total
 	++num_tot;
 }
@@ -28,7 +28,7 @@ void Place::register_agent(const int agent_ID)
 // from exposed and symptoamtic agents if any 
 void Place::compute_infected_contribution()
 {
-	num_tot = agent_IDs.size();
+	num_tot = agent_IDs->size() + visitor_IDs.size() + n_remote;
 	
 	if (num_tot == 0){
 		std::fill(lambda_tot.begin(), lambda_tot.end(), 0.0);
@@ -56,10 +56,42 @@ void Place::print_basic(std::ostream& where) const
 // Remove an agent from this place
 void Place::remove_agent(const int index)
 {
+	// In place if no other copies use the IDs
+	if (agent_IDs.use_count() == 1) {
+		agent_IDs->erase(std::remove(agent_IDs->begin(), agent_IDs->end(), index), 
+							agent_IDs->end());
+		return;
+	}
 	std::vector<int> new_agent_IDs = {};
-	std::remove_copy(agent_IDs.begin(), agent_IDs.end(),
+	std::remove_copy(agent_IDs->begin(), agent_IDs->end(),
 					std::back_insert_iterator<std::vector<int>>(new_agent_IDs), index);
-	std::swap(new_agent_IDs, agent_IDs);
+	// New storage either way - no need to copy first
+	agent_IDs = std::make_shared<std::vector<int>>(std::move(new_agent_IDs));
+}
+
+// Sorted IDs, in one pass, in place if no other copies use them
+void Place::remove_agents(const std::vector<int>& IDs)
+{
+	auto removed = [&IDs](const int aID){ return std::binary_search(IDs.begin(), IDs.end(), aID); };
+	if (agent_IDs.use_count() == 1) {
+		agent_IDs->erase(std::remove_if(agent_IDs->begin(), agent_IDs->end(), removed), 
+							agent_IDs->end());
+		return;
+	}
+	std::vector<int> new_agent_IDs = {};
+	std::remove_copy_if(agent_IDs->begin(), agent_IDs->end(),
+					std::back_insert_iterator<std::vector<int>>(new_agent_IDs), removed);
+	agent_IDs = std::make_shared<std::vector<int>>(std::move(new_agent_IDs));
+}
+
+// Agent IDs safe to change
+std::vector<int>& Place::own_agent_IDs()
+{
+	// Other copies still use them
+	if (agent_IDs.use_count() > 1) {
+		agent_IDs = std::make_shared<std::vector<int>>(*agent_IDs);
+	}
+	return *agent_IDs;
 }
 
 //
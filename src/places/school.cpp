@@ -7,6 +7,60 @@
  * 
  *****************************************************/
 
+//
+// Initialization and update
+//
+
+// Student, also in the class of their age
+void School::register_student(const int agent_ID, const int age)
+{
+	register_agent(agent_ID);
+	student_ages[agent_ID] = age;
+	students_by_age[age].push_back(agent_ID);
+}
+
+// Employee, also in the staff
+void School::register_employee(const int agent_ID)
+{
+	register_agent(agent_ID);
+	employees.insert(agent_ID);
+	employee_IDs.push_back(agent_ID);
+}
+
+// Back in the school and its class or staff 
+void School::add_agent(const int index)
+{
+	Place::add_agent(index);
+	const auto student = student_ages.find(index);
+	if (student != student_ages.end()) {
+		students_by_age[student->second].push_back(index);
+	}
+	if (employees.count(index) > 0) {
+		employee_IDs.push_back(index);
+	}
+}
+
+// Out of the school and its class or staff
+void School::remove_agent(const int index)
+{
+	Place::remove_agent(index);
+	const auto student = student_ages.find(index);
+	if (student != student_ages.end()) {
+		std::vector<int>& age_class = students_by_age[student->second];
+		age_class.erase(std::remove(age_class.begin(), age_class.end(), index), age_class.end());
+	}
+	if (employees.count(index) > 0) {
+		employee_IDs.erase(std::remove(employee_IDs.begin(), employee_IDs.end(), index), employee_IDs.end());
+	}
+}
+
+// Classes and staff filtered once
+void School::remove_agents(const std::vector<int>& IDs)
+{
+	Place::remove_agents(IDs);
+	retain_classes_and_staff([&IDs](const int aID){ return !std::binary_search(IDs.begin(), IDs.end(), aID); });
+}
+
 //
 // I/O
 //
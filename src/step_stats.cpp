@@ -0,0 +1,87 @@
+#include "../include/step_stats.h"
+
+/*****************************************************
+ * class: StepStats
+ *
+ * Time and amount of work in each phase of
+ * a simulation step
+ *
+ ******************************************************/
+
+// Same as the ABM functions
+std::string StepStats::phase_name(const Phase phase)
+{
+	switch (phase) {
+		case check_events: return "check_events";
+		case vaccinate: return "vaccinate";
+		case distribute_leisure: return "distribute_leisure";
+		case compute_outside_locations: return "compute_outside_locations";
+		case compute_place_contributions: return "compute_place_contributions";
+		case compute_state_transitions: return "compute_state_transitions";
+		case reset_contributions: return "reset_contributions";
+		case contact_tracing: return "contact_tracing";
+		default: throw std::invalid_argument("Wrong phase: " + std::to_string(phase));
+	}
+}
+
+std::string StepStats::counter_name(const Counter counter)
+{
+	switch (counter) {
+		case agents: return "agents";
+		case place_updates: return "place updates";
+		case rng_draws: return "RNG draws";
+		default: throw std::invalid_argument("Wrong counter: " + std::to_string(counter));
+	}
+}
+
+// One call of a phase
+void StepStats::add_time(const Phase phase, const double seconds)
+{
+	++calls.at(phase);
+	total_time.at(phase) += seconds;
+	max_time.at(phase) = std::max(max_time.at(phase), seconds);
+}
+
+// Zero everything
+void StepStats::reset()
+{
+	n_steps = 0;
+	calls.assign(n_phases, 0);
+	total_time.assign(n_phases, 0.0);
+	max_time.assign(n_phases, 0.0);
+	counts.assign(n_phases, std::vector<unsigned long long>(n_counters, 0));
+}
+
+// Table of phases and counters
+void StepStats::print_summary(std::ostream& where) const
+{
+	if (!enabled()) {
+		where << "Step statistics disabled - compile with -DABM_PROFILING" << std::endl;
+		return;
+	}
+	const double steps = static_cast<double>(std::max(n_steps, 1ULL));
+	where << "Step statistics over " << n_steps << " steps" << std::endl;
+	where << std::left << std::setw(30) << "phase" << std::right
+		  << std::setw(10) << "calls" << std::setw(12) << "total [s]"
+		  << std::setw(12) << "step [ms]" << std::setw(12) << "max [ms]";
+	for (int ic = 0; ic < n_counters; ++ic) {
+		where << std::setw(16) << counter_name(static_cast<Counter>(ic));
+	}
+	where << std::endl;
+
+	const std::ios_base::fmtflags flags = where.flags();
+	const std::streamsize precision = where.precision();
+	where << std::fixed << std::setprecision(3);
+	for (int ip = 0; ip < n_phases; ++ip) {
+		where << std::left << std::setw(30) << phase_name(static_cast<Phase>(ip)) << std::right
+			  << std::setw(10) << calls.at(ip) << std::setw(12) << total_time.at(ip)
+			  << std::setw(12) << 1000.0*total_time.at(ip)/steps
+			  << std::setw(12) << 1000.0*max_time.at(ip);
+		for (int ic = 0; ic < n_counters; ++ic) {
+			where << std::setw(16) << counts.at(ip).at(ic);
+		}
+		where << std::endl;
+	}
+	where.flags(flags);
+	where.precision(precision);
+}
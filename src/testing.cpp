@@ -69,3 +69,11 @@ bool Testing::check_switch_time(const double time)
 	}
 	return false;
 }
+
+// Change the testing fractions from now on
+void Testing::change_fractions(const double exp_frac, const double sy_frac)
+{
+	exposed_fraction_to_get_tested = exp_frac;
+	sy_fraction_to_get_tested = sy_frac;
+	set_flu_testing();
+}
@@ -0,0 +1,42 @@
+#include "../include/town.h"
+
+/*****************************************************
+ * class: Town
+ *
+ * Read-only snapshot of the town after setup
+ *
+ ******************************************************/
+
+// Copy the places and share the probabilities
+Town::Town(const DataManagementInterface& model, const Mobility& mobility) :
+	households(model.get_vector_of_households()),
+	retirement_homes(model.get_vector_of_retirement_homes()),
+	schools(model.get_vector_of_schools()),
+	workplaces(model.get_vector_of_workplaces()),
+	hospitals(model.get_vector_of_hospitals()),
+	carpools(model.get_vector_of_carpools()),
+	public_transit(model.get_vector_of_public_transit()),
+	leisure_locations(model.get_vector_of_leisure_locations()),
+	public_probabilities(mobility.get_shared_public_probabilities())
+{ }
+
+// All places
+size_t Town::number_of_places() const
+{
+	return households.size() + retirement_homes.size() + schools.size()
+			+ workplaces.size() + hospitals.size() + carpools.size()
+			+ public_transit.size() + leisure_locations.size();
+}
+
+// Places still using the agent IDs from setup
+size_t Town::number_of_shared_places(const DataManagementInterface& model) const
+{
+	return count_shared(households, model.get_vector_of_households())
+			+ count_shared(retirement_homes, model.get_vector_of_retirement_homes())
+			+ count_shared(schools, model.get_vector_of_schools())
+			+ count_shared(workplaces, model.get_vector_of_workplaces())
+			+ count_shared(hospitals, model.get_vector_of_hospitals())
+			+ count_shared(carpools, model.get_vector_of_carpools())
+			+ count_shared(public_transit, model.get_vector_of_public_transit())
+			+ count_shared(leisure_locations, model.get_vector_of_leisure_locations());
+}
@@ -10,7 +10,7 @@
  ******************************************************/
 
 // Implement transitions relevant to susceptible
-std::vector<int> FluTransitions::susceptible_transitions(Agent& agent, const double time, Infection& infection,	
+SusceptibleChanges FluTransitions::susceptible_transitions(Agent& agent, const double time, Infection& infection,	
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 				std::vector<RetirementHome>& retirement_homes,
@@ -19,14 +19,14 @@ std::vector<int> FluTransitions::susceptible_transitions(Agent& agent, const dou
 				const std::map<std::string, double>& infection_parameters, 
 				std::vector<Agent>& agents, Flu& flu, const Testing& testing, const double dt, const int n_strains)
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
 	// Infected, tested, negative, false positive
-	std::vector<int> state_changes(4,0);
+	SusceptibleChanges state_changes = {};
 
-	lambda_tot = compute_susceptible_lambda(agent, time, households, schools, workplaces, 
-					hospitals, retirement_homes, carpools, public_transit, leisure_locations, n_strains);
+	compute_susceptible_lambda(agent, time, households, schools, workplaces, 
+					hospitals, retirement_homes, carpools, public_transit, leisure_locations, 
+					n_strains, lambda_buffer);
 	for (int ist = 1; ist <= n_strains; ++ist) {
-		if (infection.infected(lambda_tot.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true) {
+		if (infection.infected(lambda_buffer.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true) {
 			agent.set_strain(ist);
 			state_changes.at(0) = 1;
 			int new_flu = flu.swap_flu_agent(agent.get_ID());
@@ -136,15 +136,16 @@ void FluTransitions::process_new_flu(Agent& agent, const int n_hospitals, const
 }
 
 // Return total lambda of susceptible agent 
-std::vector<double> FluTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
+void FluTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
 					const std::vector<Household>& households, const std::vector<School>& schools,
 					const std::vector<Workplace>& workplaces, const std::vector<Hospital>& hospitals, 
 					const std::vector<RetirementHome>& retirement_homes, 
 					const std::vector<Transit>& carpools, 
 					const std::vector<Transit>& public_transit,
-					const std::vector<Leisure>& leisure_locations, const int n_strains)			
+					const std::vector<Leisure>& leisure_locations, const int n_strains,
+					std::vector<double>& lambda_tot)			
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
+	lambda_tot.assign(n_strains, 0.0);
 	// Regular susceptible agent
 	// Special treatment for retirement homes if not tested at that moment
     // and not tested in a hospital     
@@ -160,62 +161,62 @@ std::vector<double> FluTransitions::compute_susceptible_lambda(const Agent& agen
 			const Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
 			lambda_tot = hospital.get_infected_contribution();
 		}
-     	return lambda_tot;
+     	return;
     }
 
 	const Household& house = households.at(agent.get_household_ID()-1);
 	// Quarantining 
 	if (agent.contact_traced() && agent.home_isolated()) {
 		lambda_tot = house.get_infected_contribution();
-		return lambda_tot;
+		return;
 	}
 	if (agent.student() && agent.works() && !agent.works_from_home()){
 		const School& school = schools.at(agent.get_school_ID()-1);
 		if (agent.retirement_home_employee()){
 			const RetirementHome& rh = retirement_homes.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{rh.get_infected_contribution()},
-						{school.get_infected_contribution()}}, {{-1,{1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, rh.get_infected_contribution());
+			add_lambda(lambda_tot, school.get_infected_contribution());
 		} else if (agent.school_employee()){
 			const School& workSch = schools.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{workSch.get_infected_contribution()},
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, workSch.get_infected_contribution());
+			add_lambda(lambda_tot, school.get_infected_contribution());
 		} else {
 			const Workplace& workplace = workplaces.at(agent.get_work_ID()-1);
 			if (workplace.outside_town()) {
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-							{workplace.get_infected_contribution()},
-							{school.get_infected_contribution()}}, 
-							{{1, agent.get_occupation_transmission()}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution(), 
+							agent.get_occupation_transmission());
+				add_lambda(lambda_tot, school.get_infected_contribution());
 			} else {
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{workplace.get_infected_contribution()},
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution());
+				add_lambda(lambda_tot, school.get_infected_contribution());
 			}
 		}
 	} else if (agent.student()){
 		const School& school = schools.at(agent.get_school_ID()-1);
-		lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+		lambda_tot = house.get_infected_contribution();
+		add_lambda(lambda_tot, school.get_infected_contribution());
 	} else if (agent.works() && !agent.works_from_home()){
 		if (agent.retirement_home_employee()){
 			const RetirementHome& rh = retirement_homes.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{rh.get_infected_contribution()}}, {{-1, {1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, rh.get_infected_contribution());
 		} else if (agent.school_employee()){
 			const School& school = schools.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, school.get_infected_contribution());
 		} else {
 			const Workplace& workplace = workplaces.at(agent.get_work_ID()-1);
 			if (workplace.outside_town()) { 
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{workplace.get_infected_contribution()}},
-						{{1, agent.get_occupation_transmission()}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution(), 
+							agent.get_occupation_transmission());
 			} else {
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-							{workplace.get_infected_contribution()}}, {{-1, {1.0}}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution());
 			}
 		}
 	} else if (agent.works_from_home() || (!agent.works())) {
@@ -224,22 +225,18 @@ std::vector<double> FluTransitions::compute_susceptible_lambda(const Agent& agen
 
 	// Transit
 	if (agent.get_work_travel_mode() == "carpool") {
-		lambda_tot = add_lambdas({{lambda_tot}, 
-					{carpools.at(agent.get_carpool_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+		add_lambda(lambda_tot, carpools.at(agent.get_carpool_ID()-1).get_infected_contribution());
 	}
 	if (agent.get_work_travel_mode() == "public") {
-		lambda_tot = add_lambdas({{lambda_tot}, 
-						{public_transit.at(agent.get_public_transit_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+		add_lambda(lambda_tot, public_transit.at(agent.get_public_transit_ID()-1).get_infected_contribution());
 	}
 
 	// Leisure
 	if (agent.get_leisure_ID() > 0) {
 		if (agent.get_leisure_type() == "public") {
-			lambda_tot = add_lambdas({{lambda_tot}, 
-				{leisure_locations.at(agent.get_leisure_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+			add_lambda(lambda_tot, leisure_locations.at(agent.get_leisure_ID()-1).get_infected_contribution());
 		} else if (agent.get_leisure_type() == "household") {
-			lambda_tot = add_lambdas({{lambda_tot}, 
-				{households.at(agent.get_leisure_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+			add_lambda(lambda_tot, households.at(agent.get_leisure_ID()-1).get_infected_contribution());
 		} else {
 			throw std::invalid_argument("Wrong leisure type: " + agent.get_leisure_type());
 		}
@@ -256,7 +253,6 @@ std::vector<double> FluTransitions::compute_susceptible_lambda(const Agent& agen
 		// Otherwise if waiting for test or results - home isolation
 		lambda_tot =  house.get_infected_contribution();
 	}
-	return lambda_tot;
 }
 
 // Compte and set agent properties related to recovery without symptoms and incubation 
@@ -18,15 +18,14 @@ int HspEmployeeTransitions::susceptible_transitions(Agent& agent, const double t
 				const std::map<std::string, double>& infection_parameters, 
 				std::vector<Agent>& agents, const Testing& testing, const int n_strains)
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
 	int got_infected = 0;
-	lambda_tot = compute_susceptible_lambda(agent, time, households, schools, hospitals, 
-					carpools, public_transit, leisure_locations, n_strains);
+	compute_susceptible_lambda(agent, time, households, schools, hospitals, 
+					carpools, public_transit, leisure_locations, n_strains, lambda_buffer);
 	for (int ist = 1; ist <= n_strains; ++ist) {
 		if (agent.removed_recovered(ist)) {
 			continue;
 		}
-		if (infection.infected(lambda_tot.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true){
+		if (infection.infected(lambda_buffer.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true){
 			// To deactivate the removed flag from other strains
 			agent.set_removed(false);
 			agent.set_strain(ist);
@@ -47,54 +46,50 @@ int HspEmployeeTransitions::susceptible_transitions(Agent& agent, const double t
 }
 
 // Return total lambda of susceptible agent 
-std::vector<double> HspEmployeeTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
+void HspEmployeeTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
 					const std::vector<Household>& households, const std::vector<School>& schools,
 					const std::vector<Hospital>& hospitals, 
 					const std::vector<Transit>& carpools, const std::vector<Transit>& public_transit,
-					const std::vector<Leisure>& leisure_locations, const int n_strains)			
+					const std::vector<Leisure>& leisure_locations, const int n_strains,
+					std::vector<double>& lambda_tot)			
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
+	lambda_tot.assign(n_strains, 0.0);
 	// Count hospital instead of workplace
 	const Household& house = households.at(agent.get_household_ID()-1);
 	// Quarantining 
 	if (agent.contact_traced() && agent.home_isolated()) {
 		lambda_tot = house.get_infected_contribution();
-		return lambda_tot;
+		return;
 	}
 	const Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
 	if (agent.student()){
 		const School& school = schools.at(agent.get_school_ID()-1);
-		lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{hospital.get_infected_contribution()},
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+		lambda_tot = house.get_infected_contribution();
+		add_lambda(lambda_tot, hospital.get_infected_contribution());
+		add_lambda(lambda_tot, school.get_infected_contribution());
 	} else {
-		lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-			{hospital.get_infected_contribution()}}, {{-1, {1.0}}});	
+		lambda_tot = house.get_infected_contribution();
+		add_lambda(lambda_tot, hospital.get_infected_contribution());
 	}
 
 	// Transit
 	if (agent.get_work_travel_mode() == "carpool") {
-		lambda_tot = add_lambdas({{lambda_tot}, 
-					{carpools.at(agent.get_carpool_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+		add_lambda(lambda_tot, carpools.at(agent.get_carpool_ID()-1).get_infected_contribution());
 	}
 	if (agent.get_work_travel_mode() == "public") {
-		lambda_tot = add_lambdas({{lambda_tot}, 
-						{public_transit.at(agent.get_public_transit_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+		add_lambda(lambda_tot, public_transit.at(agent.get_public_transit_ID()-1).get_infected_contribution());
 	}
 
 	// Leisure
 	if (agent.get_leisure_ID() > 0) {
 		if (agent.get_leisure_type() == "public") {
-			lambda_tot = add_lambdas({{lambda_tot}, 
-				{leisure_locations.at(agent.get_leisure_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+			add_lambda(lambda_tot, leisure_locations.at(agent.get_leisure_ID()-1).get_infected_contribution());
 		} else if (agent.get_leisure_type() == "household") {
-			lambda_tot = add_lambdas({{lambda_tot}, 
-				{households.at(agent.get_leisure_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+			add_lambda(lambda_tot, households.at(agent.get_leisure_ID()-1).get_infected_contribution());
 		} else {
 			throw std::invalid_argument("Wrong leisure type: " + agent.get_leisure_type());
 		}
 	}
-	return lambda_tot;
 }
 
 // Compte and set agent properties related to recovery without symptoms and incubation 
@@ -127,12 +122,12 @@ void HspEmployeeTransitions::recovery_and_incubation(Agent& agent, Infection& in
 }
 
 // Implement transitions relevant to exposed 
-std::vector<int> HspEmployeeTransitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
+InfectedChanges HspEmployeeTransitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
 										std::vector<Household>& households, std::vector<School>& schools, std::vector<Hospital>& hospitals,
 										std::vector<Transit>& carpools, std::vector<Transit>& public_transit,
 										const std::map<std::string, double>& infection_parameters, const Testing& testing)
 {
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 	// Modified mortality for hospital emloyees
 	const bool is_hsp = true; 
 
@@ -263,17 +258,17 @@ void HspEmployeeTransitions::set_testing_status(Agent& agent, Infection& infecti
 }
 
 // Transitions of a symptomatic agent 
-std::vector<int> HspEmployeeTransitions::symptomatic_transitions(Agent& agent, const double time, 
+InfectedChanges HspEmployeeTransitions::symptomatic_transitions(Agent& agent, const double time, 
 				   	const double dt, Infection& infection,
 					std::vector<Household>& households, std::vector<School>& schools,
 					std::vector<Hospital>& hospitals,
 					std::vector<Transit>& carpools, std::vector<Transit>& public_transit,
 					const std::map<std::string, double>& infection_parameters)
 {
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 	int tested_pos = 0;
 	// First entry is one if agent recovered, second if agent died
-	std::vector<int> removed = {0,0};
+	RemovalChanges removed = {};
 	removed = check_agent_removal(agent, time, households, schools, hospitals,
 					carpools, public_transit, infection_parameters);
 	state_changes.at(0) = removed.at(0);
@@ -323,14 +318,14 @@ std::vector<int> HspEmployeeTransitions::symptomatic_transitions(Agent& agent, c
 }
 
 // Verify if agent is to be removed at this step
-std::vector<int> HspEmployeeTransitions::check_agent_removal(Agent& agent, const double time,
+RemovalChanges HspEmployeeTransitions::check_agent_removal(Agent& agent, const double time,
 					std::vector<Household>& households, std::vector<School>& schools,
 					std::vector<Hospital>& hospitals, std::vector<Transit>& carpools, 
 					std::vector<Transit>& public_transit,
 					const std::map<std::string, double>& infection_parameters)
 {
 	// First entry is one if agent recovered, second if agent died
-	std::vector<int> removed = {0,0};
+	RemovalChanges removed = {};
 	// If dying
 	if (agent.dying() == true){
 		if (agent.get_time_of_death() <= time){
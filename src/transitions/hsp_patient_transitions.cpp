@@ -15,15 +15,14 @@ int HspPatientTransitions::susceptible_transitions(Agent& agent, const double ti
 				std::vector<Hospital>& hospitals, const std::map<std::string, double>& infection_parameters, 
 				std::vector<Agent>& agents, const Testing& testing, const int n_strains)
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
 	int got_infected = 0;
 
-	lambda_tot = compute_susceptible_lambda(agent, time, hospitals, n_strains);
+	compute_susceptible_lambda(agent, time, hospitals, n_strains, lambda_buffer);
 	for (int ist = 1; ist <= n_strains; ++ist) {
 		if (agent.removed_recovered(ist)) {
 			continue;
 		}
-		if (infection.infected(lambda_tot.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true){
+		if (infection.infected(lambda_buffer.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true){
 			// To deactivate the removed flag from other strains
 			agent.set_removed(false);
 			agent.set_strain(ist);
@@ -44,14 +43,14 @@ int HspPatientTransitions::susceptible_transitions(Agent& agent, const double ti
 }
 
 // Return total lambda of susceptible agent 
-std::vector<double> HspPatientTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
-					const std::vector<Hospital>& hospitals, const int n_strains)			
+void HspPatientTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
+					const std::vector<Hospital>& hospitals, const int n_strains,
+					std::vector<double>& lambda_tot)			
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
+	lambda_tot.assign(n_strains, 0.0);
 	// Count only hospital
 	const Hospital& hospital = hospitals.at(agent.get_hospital_ID()-1);
 	lambda_tot = hospital.get_infected_contribution();	
-	return lambda_tot;
 }
 
 // Compte and set agent properties related to recovery without symptoms and incubation 
@@ -84,11 +83,11 @@ void HspPatientTransitions::recovery_and_incubation(Agent& agent, Infection& inf
 }
 
 // Implement transitions relevant to exposed 
-std::vector<int> HspPatientTransitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
+InfectedChanges HspPatientTransitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
 										std::vector<Household>& households, std::vector<Hospital>& hospitals, 
 										const std::map<std::string, double>& infection_parameters, const Testing& testing)
 {
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 	// Modified mortality rate for hospital patients
 	const bool is_hsp = true;
 
@@ -203,15 +202,15 @@ void HspPatientTransitions::set_testing_status(Agent& agent, Infection& infectio
 }
 
 // Transitions of a symptomatic agent 
-std::vector<int> HspPatientTransitions::symptomatic_transitions(Agent& agent, const double time, 
+InfectedChanges HspPatientTransitions::symptomatic_transitions(Agent& agent, const double time, 
 				   	const double dt, Infection& infection,
 					std::vector<Household>& households, std::vector<Hospital>& hospitals,
 					const std::map<std::string, double>& infection_parameters)
 {
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 	int tested_pos = 0;
 	// First entry is one if agent recovered, second if agent died
-	std::vector<int> removed = {0,0};
+	RemovalChanges removed = {};
 	removed = check_agent_removal(agent, time, households, hospitals, infection_parameters);
 	state_changes.at(0) = removed.at(0);
 	state_changes.at(1) = removed.at(1);
@@ -263,12 +262,12 @@ std::vector<int> HspPatientTransitions::symptomatic_transitions(Agent& agent, co
 }
 
 // Verify if agent is to be removed at this step
-std::vector<int> HspPatientTransitions::check_agent_removal(Agent& agent, const double time,
+RemovalChanges HspPatientTransitions::check_agent_removal(Agent& agent, const double time,
 					std::vector<Household>& households, 
 					std::vector<Hospital>& hospitals, const std::map<std::string, double>& infection_parameters)
 {
 	// First entry is one if agent recovered, second if agent died
-	std::vector<int> removed = {0,0};
+	RemovalChanges removed = {};
 	// If dying
 	if (agent.dying() == true){
 		if (agent.get_time_of_death() <= time){
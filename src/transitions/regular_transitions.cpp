@@ -19,15 +19,14 @@ int RegularTransitions::susceptible_transitions(Agent& agent, const double time,
 				const std::map<std::string, double>& infection_parameters, 
 				std::vector<Agent>& agents, Flu& flu, const Testing& testing, const int n_strains)
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
 	int got_infected = 0;
-	lambda_tot = compute_susceptible_lambda(agent, time, households, schools, workplaces, retirement_homes,
-					carpools, public_transit, leisure_locations, n_strains);
+	compute_susceptible_lambda(agent, time, households, schools, workplaces, retirement_homes,
+					carpools, public_transit, leisure_locations, n_strains, lambda_buffer);
 	for (int ist = 1; ist <= n_strains; ++ist) {
 		if (agent.removed_recovered(ist)) {
 			continue;
 		}
-	 	if (infection.infected(lambda_tot.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true) {
+	 	if (infection.infected(lambda_buffer.at(ist-1), agent.vaccine_effectiveness(time, ist)) == true) {
 			// To deactivate the removed flag from other strains
 			agent.set_removed(false);
 			agent.set_strain(ist);
@@ -51,73 +50,74 @@ int RegularTransitions::susceptible_transitions(Agent& agent, const double time,
 }
 
 // Return total lambda of susceptible agent 
-std::vector<double> RegularTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
+void RegularTransitions::compute_susceptible_lambda(const Agent& agent, const double time, 
 					const std::vector<Household>& households, const std::vector<School>& schools,
 					const std::vector<Workplace>& workplaces, 
 					const std::vector<RetirementHome>& retirement_homes, 
 					const std::vector<Transit>& carpools, const std::vector<Transit>& public_transit,
-					const std::vector<Leisure>& leisure_locations, const int n_strains)			
+					const std::vector<Leisure>& leisure_locations, const int n_strains,
+					std::vector<double>& lambda_tot)			
 {
-	std::vector<double> lambda_tot(n_strains, 0.0);
+	lambda_tot.assign(n_strains, 0.0);
 	if (agent.retirement_home_resident()){
 		const RetirementHome& rh = retirement_homes.at(agent.get_household_ID()-1);
 		lambda_tot = rh.get_infected_contribution();
-		return lambda_tot;
+		return;
 	}
 
 	const Household& house = households.at(agent.get_household_ID()-1);
 	// Quarantining 
 	if (agent.contact_traced() && agent.home_isolated()) {
 		lambda_tot = house.get_infected_contribution();
-		return lambda_tot;
+		return;
 	}
 	if (agent.student() && agent.works() && !agent.works_from_home()){
 		const School& school = schools.at(agent.get_school_ID()-1);
 		if (agent.retirement_home_employee()){
 			const RetirementHome& rh = retirement_homes.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{rh.get_infected_contribution()},
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, rh.get_infected_contribution());
+			add_lambda(lambda_tot, school.get_infected_contribution());
 		} else if (agent.school_employee()){
 			const School& workSch = schools.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{workSch.get_infected_contribution()},
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, workSch.get_infected_contribution());
+			add_lambda(lambda_tot, school.get_infected_contribution());
 		} else {
 			const Workplace& workplace = workplaces.at(agent.get_work_ID()-1);
 			if (workplace.outside_town()) {
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-							{workplace.get_infected_contribution()},
-							{school.get_infected_contribution()}}, 
-							{{1, {agent.get_occupation_transmission()}}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution(), 
+							agent.get_occupation_transmission());
+				add_lambda(lambda_tot, school.get_infected_contribution());
 			} else {
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{workplace.get_infected_contribution()},
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution());
+				add_lambda(lambda_tot, school.get_infected_contribution());
 			}
 		}
 	} else if (agent.student()){
 		const School& school = schools.at(agent.get_school_ID()-1);
-		lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+		lambda_tot = house.get_infected_contribution();
+		add_lambda(lambda_tot, school.get_infected_contribution());
 	} else if (agent.works() && !agent.works_from_home()){
 		if (agent.retirement_home_employee()){
 			const RetirementHome& rh = retirement_homes.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{rh.get_infected_contribution()}}, {{-1, {1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, rh.get_infected_contribution());
 		} else if (agent.school_employee()){
 			const School& school = schools.at(agent.get_work_ID()-1);
-			lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{school.get_infected_contribution()}}, {{-1, {1.0}}});
+			lambda_tot = house.get_infected_contribution();
+			add_lambda(lambda_tot, school.get_infected_contribution());
 		} else {
 			const Workplace& workplace = workplaces.at(agent.get_work_ID()-1);
 			if (workplace.outside_town()) { 
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-						{workplace.get_infected_contribution()}},
-						{{1, {agent.get_occupation_transmission()}}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution(), 
+							agent.get_occupation_transmission());
 			} else {
-				lambda_tot = add_lambdas({{house.get_infected_contribution()}, 
-							{workplace.get_infected_contribution()}}, {{-1, {1.0}}});
+				lambda_tot = house.get_infected_contribution();
+				add_lambda(lambda_tot, workplace.get_infected_contribution());
 			}
 		}
 	} else if (agent.works_from_home() || (!agent.works())) {
@@ -126,28 +126,22 @@ std::vector<double> RegularTransitions::compute_susceptible_lambda(const Agent&
 
 	// Transit
 	if (agent.get_work_travel_mode() == "carpool") {
-		lambda_tot = add_lambdas({{lambda_tot}, 
-					{carpools.at(agent.get_carpool_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+		add_lambda(lambda_tot, carpools.at(agent.get_carpool_ID()-1).get_infected_contribution());
 	}
 	if (agent.get_work_travel_mode() == "public") {
-		lambda_tot = add_lambdas({{lambda_tot}, 
-						{public_transit.at(agent.get_public_transit_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+		add_lambda(lambda_tot, public_transit.at(agent.get_public_transit_ID()-1).get_infected_contribution());
 	}
 
 	// Leisure
 	if (agent.get_leisure_ID() > 0) {
 		if (agent.get_leisure_type() == "public") {
-			lambda_tot = add_lambdas({{lambda_tot}, 
-				{leisure_locations.at(agent.get_leisure_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+			add_lambda(lambda_tot, leisure_locations.at(agent.get_leisure_ID()-1).get_infected_contribution());
 		} else if (agent.get_leisure_type() == "household") {
-			lambda_tot = add_lambdas({{lambda_tot}, 
-				{households.at(agent.get_leisure_ID()-1).get_infected_contribution()}}, {{-1, {1.0}}});
+			add_lambda(lambda_tot, households.at(agent.get_leisure_ID()-1).get_infected_contribution());
 		} else {
 			throw std::invalid_argument("Wrong leisure type: " + agent.get_leisure_type());
 		}
 	}
-
-	return lambda_tot;
 }
 
 // Compute and set agent properties related to recovery without symptoms and incubation 
@@ -178,7 +172,7 @@ void RegularTransitions::recovery_and_incubation(Agent& agent, Infection& infect
 }
 
 // Implement transitions relevant to exposed 
-std::vector<int> RegularTransitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
+InfectedChanges RegularTransitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
 										std::vector<Household>& households, std::vector<School>& schools,
 										std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 										std::vector<RetirementHome>& retirement_homes,
@@ -186,7 +180,7 @@ std::vector<int> RegularTransitions::exposed_transitions(Agent& agent, Infection
 										const std::map<std::string, double>& infection_parameters, const Testing& testing)
 {
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 
 	// First check for testing because that holds for transition changes too
 	// If being tested
@@ -418,7 +412,7 @@ bool RegularTransitions::set_testing_status(Agent& agent, Infection& infection,
 }
 
 // Transitions of a symptomatic agent 
-std::vector<int> RegularTransitions::symptomatic_transitions(Agent& agent, const double time, 
+InfectedChanges RegularTransitions::symptomatic_transitions(Agent& agent, const double time, 
 				   	const double dt, Infection& infection,
 					std::vector<Household>& households, std::vector<School>& schools,
 					std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
@@ -426,10 +420,10 @@ std::vector<int> RegularTransitions::symptomatic_transitions(Agent& agent, const
 					std::vector<Transit>& carpools, std::vector<Transit>& public_transit,
 					const std::map<std::string, double>& infection_parameters)
 {
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 	int tested_pos = 0;
 	// First entry is one if agent recovered, second if agent died
-	std::vector<int> removed = {0,0};
+	RemovalChanges removed = {};
 	removed = check_agent_removal(agent, time, households, schools, 
 					workplaces, hospitals, retirement_homes,
 					carpools, public_transit, infection_parameters);
@@ -485,7 +479,7 @@ std::vector<int> RegularTransitions::symptomatic_transitions(Agent& agent, const
 }
 
 // Verify if agent is to be removed at this step
-std::vector<int> RegularTransitions::check_agent_removal(Agent& agent, const double time,
+RemovalChanges RegularTransitions::check_agent_removal(Agent& agent, const double time,
 					std::vector<Household>& households, std::vector<School>& schools,
 					std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 					std::vector<RetirementHome>& retirement_homes,
@@ -493,7 +487,7 @@ std::vector<int> RegularTransitions::check_agent_removal(Agent& agent, const dou
 					const std::map<std::string, double>& infection_parameters)
 {
 	// First entry is one if agent recovered, second if agent died
-	std::vector<int> removed = {0,0};
+	RemovalChanges removed = {};
 	// If dying
 	if (agent.dying() == true) {
 		if (agent.get_time_of_death() <= time) {
@@ -15,7 +15,8 @@ void Transitions::new_quarantined(Agent& agent, const double time,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 				std::vector<RetirementHome>& retirement_homes,
 				std::vector<Transit>& carpools, std::vector<Transit>& public_transit,
-				const std::map<std::string, double>& infection_parameters)
+				const std::map<std::string, double>& infection_parameters,
+				PlaceRemovals* removals)
 {
 	// Set the main flag
 	agent.set_contact_traced(true);
@@ -35,34 +36,42 @@ void Transitions::new_quarantined(Agent& agent, const double time,
 	// Removal from all the public places (except leisure - in the next step anyway)
 	agent.set_quarantine_duration(time + infection_parameters.at("quarantine duration"));
 	int agent_ID = agent.get_ID();
+	// Now or together with other quarantined agents
+	auto remove_from = [agent_ID, removals](Place& place) {
+		if (removals) {
+			removals->emplace_back(&place, agent_ID);
+		} else {
+			place.remove_agent(agent_ID);
+		}
+	};
 	if (agent.student()) {
-		schools.at(agent.get_school_ID()-1).remove_agent(agent_ID);
+		remove_from(schools.at(agent.get_school_ID()-1));
 	}
 	if (agent.works()){
 		if (agent.works_from_home()) {
 			return;
 		}
 		if (agent.retirement_home_employee()){
-			retirement_homes.at(agent.get_work_ID()-1).remove_agent(agent_ID);
+			remove_from(retirement_homes.at(agent.get_work_ID()-1));
 		} else if (agent.school_employee()){
-			schools.at(agent.get_work_ID()-1).remove_agent(agent_ID);
+			remove_from(schools.at(agent.get_work_ID()-1));
 		} else {
-			workplaces.at(agent.get_work_ID()-1).remove_agent(agent_ID);
+			remove_from(workplaces.at(agent.get_work_ID()-1));
 		}
 		if (agent.get_work_travel_mode() == "carpool") {
-			carpools.at(agent.get_carpool_ID()-1).remove_agent(agent_ID);
+			remove_from(carpools.at(agent.get_carpool_ID()-1));
 		}
 		if (agent.get_work_travel_mode() == "public") {
-			public_transit.at(agent.get_public_transit_ID()-1).remove_agent(agent_ID);
+			remove_from(public_transit.at(agent.get_public_transit_ID()-1));
 		}
 	}
 	if (agent.hospital_employee()) {
-		hospitals.at(agent.get_hospital_ID()-1).remove_agent(agent_ID);
+		remove_from(hospitals.at(agent.get_hospital_ID()-1));
 		if (agent.get_work_travel_mode() == "carpool") {
-			carpools.at(agent.get_carpool_ID()-1).remove_agent(agent_ID);
+			remove_from(carpools.at(agent.get_carpool_ID()-1));
 		}
 		if (agent.get_work_travel_mode() == "public") {
-			public_transit.at(agent.get_public_transit_ID()-1).remove_agent(agent_ID);
+			remove_from(public_transit.at(agent.get_public_transit_ID()-1));
 		}
 	}
 	if (agent.symptomatic() && !agent.hospital_employee() && !agent.hospital_non_covid_patient()
@@ -81,6 +90,25 @@ void Transitions::new_quarantined(Agent& agent, const double time,
 	}	
 }
 
+// Grouped by place, sorted agents of each place
+void Transitions::remove_from_places(PlaceRemovals& removals)
+{
+	std::sort(removals.begin(), removals.end(), 
+		[](const std::pair<Place*, int>& a, const std::pair<Place*, int>& b) 
+			{ return std::less<Place*>()(a.first, b.first) 
+						|| (a.first == b.first && a.second < b.second); });
+	std::vector<int> IDs;
+	for (size_t i = 0; i < removals.size(); ) {
+		Place* place = removals.at(i).first;
+		IDs.clear();
+		for (; i < removals.size() && removals.at(i).first == place; ++i) {
+			IDs.push_back(removals.at(i).second);
+		}
+		place->remove_agents(IDs);
+	}
+	removals.clear();
+}
+
 // Implement transitions that hold for all the agents
 bool Transitions::common_transitions(Agent& agent, const double time, 
 										std::vector<School>& schools,
@@ -88,11 +116,9 @@ bool Transitions::common_transitions(Agent& agent, const double time,
 										std::vector<RetirementHome>& retirement_homes,
 										std::vector<Transit>& carpools, 
 										std::vector<Transit>& public_transit, 
-										Contact_tracing& contact_tracing,
-				const std::map<std::string, double>& infection_parameters)
+										Contact_tracing& contact_tracing, const int n_strains)
 {
 	bool re_vaccinating = false;
-	int n_strains = static_cast<int>(infection_parameters.at("number of strains"));
 	for (int ist = 1; ist<=n_strains; ++ist) {
 		// Recovered becoming susceptible again
 		if (agent.removed_recovered(ist) && agent.get_time_recovered_to_susceptible() <= time) {
@@ -187,7 +213,7 @@ void Transitions::return_from_quarantine(Agent& agent, std::vector<School>& scho
 }
 
 // Implement transitions relevant to susceptible
-std::vector<int> Transitions::susceptible_transitions(Agent& agent, const double time, 
+SusceptibleChanges Transitions::susceptible_transitions(Agent& agent, const double time, 
 				const double dt, Infection& infection,	
 				std::vector<Household>& households, std::vector<School>& schools,
 				std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
@@ -198,7 +224,7 @@ std::vector<int> Transitions::susceptible_transitions(Agent& agent, const double
 				std::vector<Agent>& agents, Flu& flu, const Testing& testing, const int n_strains)
 {
 	// Ingected, tested, negative, false positive 
-	std::vector<int> state_changes(4,0);
+	SusceptibleChanges state_changes = {};
 	int got_infected = 0;
 	if (agent.symptomatic_non_covid()){
 		// Currently only symptomatic non-COVID can reach all 4 states
@@ -227,7 +253,7 @@ std::vector<int> Transitions::susceptible_transitions(Agent& agent, const double
 }
 
 // Implement transitions relevant to exposed 
-std::vector<int> Transitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
+InfectedChanges Transitions::exposed_transitions(Agent& agent, Infection& infection, const double time, const double dt, 
 										std::vector<Household>& households, std::vector<School>& schools,
 										std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
 										std::vector<RetirementHome>& retirement_homes,
@@ -235,7 +261,7 @@ std::vector<int> Transitions::exposed_transitions(Agent& agent, Infection& infec
 										const std::map<std::string, double>& infection_parameters, const Testing& testing)
 {
 	// Recovered, dead, tested, tested positive, tested false negative
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 	if (agent.hospital_employee()){
 		state_changes = hsp_emp_tr.exposed_transitions(agent, infection, time, dt, 
 					households, schools, hospitals,
@@ -252,7 +278,7 @@ std::vector<int> Transitions::exposed_transitions(Agent& agent, Infection& infec
 }
 
 // Transitions of a symptomatic agent 
-std::vector<int> Transitions::symptomatic_transitions(Agent& agent, const double time, 
+InfectedChanges Transitions::symptomatic_transitions(Agent& agent, const double time, 
 				   	const double dt, Infection& infection,
 					std::vector<Household>& households, std::vector<School>& schools,
 					std::vector<Workplace>& workplaces, std::vector<Hospital>& hospitals,
@@ -261,7 +287,7 @@ std::vector<int> Transitions::symptomatic_transitions(Agent& agent, const double
 					const std::map<std::string, double>& infection_parameters)
 {
 	// Recovered, dead, tested, tested positive, false negative
-	std::vector<int> state_changes(5,0);
+	InfectedChanges state_changes = {};
 	if (agent.hospital_employee()){
 		// Home isolated upon developing symptoms - no travel to work or leisure
 		// This holds for symptoms of anything flu-like, people will not go to
@@ -8,24 +8,17 @@ std::string str_to_lower(std::string s)
     return s;
 }
 
-// Combine contributions from different lambdas
-// Change things into references
-std::vector<double> add_lambdas(std::vector<std::vector<double>>&& lambdas, 
-						std::map<int, const std::vector<double>&>&& mult)
+// Add contributions of a location to the total lambda
+void add_lambda(std::vector<double>& lambda_tot, const std::vector<double>& lambda)
 {
-	std::vector<double> lambda_tot(lambdas.at(0).size(), 0.0);
-	int i = 0;
-	for (auto& lambda : lambdas)
-	{
-		auto iter = mult.find(i);
-		if (iter != mult.end()) {
-			// Need to multiply this lambda with factors corresponding to each strain
-			const std::vector<double> factor = iter->second;
-			// Multiplying lambda
-			std::transform (lambda.begin(), lambda.end(), factor.cbegin(), lambda.begin(), std::multiplies<double>());
-		}
-		std::transform(lambda_tot.begin(), lambda_tot.end(), lambda.begin(), lambda_tot.begin(), std::plus<double>());
-		++i;	
+	std::transform(lambda_tot.begin(), lambda_tot.end(), lambda.cbegin(), lambda_tot.begin(), std::plus<double>());
+}
+
+// Add contributions of a location multiplied by a factor of each strain
+void add_lambda(std::vector<double>& lambda_tot, const std::vector<double>& lambda,
+					const std::vector<double>& factor)
+{
+	for (size_t i = 0; i < lambda_tot.size(); ++i) {
+		lambda_tot.at(i) += lambda.at(i)*factor.at(i);
 	}
-	return lambda_tot;
 }
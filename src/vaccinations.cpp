@@ -6,22 +6,6 @@ void Vaccinations::load_vaccination_parameters(const std::string& infile, const
 	// Collect and store the parameters
 	LoadParameters ldparam;
 	vaccination_parameters = ldparam.load_parameter_map<double>(infile);
-	// Information on other strains
-	strain_id = static_cast<int>(vaccination_parameters.at("Strain id"));
-	num_strains = static_cast<int>(vaccination_parameters.at("Number of strains"));
-	for (int i = 1; i <= num_strains; ++i) {
-		std::map<std::string, double> red_factor;
-		if (i != strain_id) {
-			red_factor["effectiveness"] = vaccination_parameters.at(std::string("Effectiveness reduction for strain ") + std::to_string(i));
-			red_factor["asymptomatic"] = vaccination_parameters.at(std::string("Asymptomatic reduction for strain ") + std::to_string(i));
-			red_factor["transmission"] = vaccination_parameters.at(std::string("Transmission reduction for strain ") + std::to_string(i));
-			red_factor["severe"] = vaccination_parameters.at(std::string("Severe reduction for strain ") + std::to_string(i));
-			red_factor["death"] = vaccination_parameters.at(std::string("Death reduction for strain ") + std::to_string(i));	
-			other_strains.push_back(red_factor);
-		} else {
-			other_strains.push_back({{"placeholder", 0.0}});
-		}
-	}
 	// Loading and storing of time, value pairs for creating the time dependencies
 	// All the one dose types 
 	int num_one_dose = static_cast<int>(vaccination_parameters.at("Number of one dose types"));
@@ -29,13 +13,6 @@ void Vaccinations::load_vaccination_parameters(const std::string& infile, const
 		std::string file_name = data_dir + "one_dose_vac_type_" + std::to_string(i) + ".txt";
 		std::string tag = "one dose - type "+ std::to_string(i);
 		vac_types_properties[tag] = ldparam.load_table(file_name);
-		vac_types_probs["one dose CDF"].push_back(vaccination_parameters.at(tag + " probability vaccinated, CDF"));	
-		for (int os = 1; os <= num_strains; ++os) {
-			if (os != strain_id) {
-				std::string other_tag = tag + " other strain " + std::to_string(os);
-				add_other_strain(tag, other_tag, other_strains.at(os-1));	
-			} 
-		}
 	}
 	// All the two dose types
 	int num_two_dose = static_cast<int>(vaccination_parameters.at("Number of two dose types"));
@@ -43,14 +20,8 @@ void Vaccinations::load_vaccination_parameters(const std::string& infile, const
 		std::string file_name = data_dir + "two_dose_vac_type_" + std::to_string(i) + ".txt";
 		std::string tag = "two dose - type "+ std::to_string(i);
 		vac_types_properties[tag] = ldparam.load_table(file_name);
-		vac_types_probs["two dose CDF"].push_back(vaccination_parameters.at(tag + " probability vaccinated, CDF"));		
-		for (int os = 1; os <= num_strains; ++os) {
-			if (os != strain_id) {
-				std::string other_tag = tag + " other strain " + std::to_string(os);
-				add_other_strain(tag, other_tag, other_strains.at(os-1));	
-			}
-		}
 	}
+	derive_from_parameters();
 
 // For debugging
 /*	if (strain_id == 1) {
@@ -67,6 +38,76 @@ void Vaccinations::load_vaccination_parameters(const std::string& infile, const
 */
 }
 
+// Change a single parameter and everything computed from it
+void Vaccinations::set_parameter(const std::string& name, const double value)
+{
+	if (vaccination_parameters.find(name) == vaccination_parameters.end()) {
+		throw std::invalid_argument("No vaccination parameter named " + name);
+	}
+	// These determine which files are loaded
+	if (name == "Strain id" || name == "Number of strains" 
+			|| name == "Number of one dose types" || name == "Number of two dose types") {
+		throw std::invalid_argument("Vaccination parameter " + name 
+					+ " can only be changed in the input file");
+	}
+	vaccination_parameters.at(name) = value;
+	derive_from_parameters();
+}
+
+// Type probabilities and properties for other strains
+void Vaccinations::derive_from_parameters()
+{
+	// Information on other strains
+	strain_id = static_cast<int>(vaccination_parameters.at("Strain id"));
+	num_strains = static_cast<int>(vaccination_parameters.at("Number of strains"));
+	min_vac_age = vaccination_parameters.at("Minimum vaccination age");
+	// Eligibility may change
+	tracking = false;
+	other_strains.clear();
+	for (int i = 1; i <= num_strains; ++i) {
+		std::map<std::string, double> red_factor;
+		if (i != strain_id) {
+			red_factor["effectiveness"] = vaccination_parameters.at(std::string("Effectiveness reduction for strain ") + std::to_string(i));
+			red_factor["asymptomatic"] = vaccination_parameters.at(std::string("Asymptomatic reduction for strain ") + std::to_string(i));
+			red_factor["transmission"] = vaccination_parameters.at(std::string("Transmission reduction for strain ") + std::to_string(i));
+			red_factor["severe"] = vaccination_parameters.at(std::string("Severe reduction for strain ") + std::to_string(i));
+			red_factor["death"] = vaccination_parameters.at(std::string("Death reduction for strain ") + std::to_string(i));	
+			other_strains.push_back(red_factor);
+		} else {
+			other_strains.push_back({{"placeholder", 0.0}});
+		}
+	}
+	// Properties with respect to other strains
+	const std::vector<std::pair<std::string, std::string>> dose_types = 
+		{{"one dose", "Number of one dose types"}, {"two dose", "Number of two dose types"}};
+	for (const auto& dose : dose_types) {
+		const int num_types = static_cast<int>(vaccination_parameters.at(dose.second));
+		for (int i = 1; i <= num_types; ++i) {
+			std::string tag = dose.first + " - type " + std::to_string(i);
+			for (int os = 1; os <= num_strains; ++os) {
+				if (os != strain_id) {
+					std::string other_tag = tag + " other strain " + std::to_string(os);
+					add_other_strain(tag, other_tag, other_strains.at(os-1));	
+				} 
+			}
+		}
+	}
+	// Types, their probabilities and benefits as used for each agent
+	compile_vaccine_types("one dose", "Number of one dose types", one_dose_types, one_dose_CDF);
+	compile_vaccine_types("two dose", "Number of two dose types", two_dose_types, two_dose_CDF);
+	auto optional = [this](const std::string& name) {
+			const auto& iter = vaccination_parameters.find(name); 
+			return iter == vaccination_parameters.end() ? 
+					std::numeric_limits<double>::quiet_NaN() : iter->second; };
+	frac_one_dose = optional("Fraction taking one dose vaccine");
+	frac_boosters = optional("Fraction with boosters");
+	third_dose_max_time = optional("Third dose max effects time");
+	third_dose_max_end = optional("Third dose max effects end time");
+	third_dose_end = optional("Third dose no effects time");
+	offset_start = optional("Start of time offset interval");
+	offset_end = optional("End of time offset interval");
+}
+
 /// Create a parameter entry in vaccination_parameters for another strain
 void Vaccinations::add_other_strain(const std::string& this_tag, const std::string& other_tag, 
 										const std::map<std::string, double>& reduction)
@@ -89,6 +130,63 @@ void Vaccinations::add_other_strain(const std::string& this_tag, const std::stri
 	vac_types_properties[other_tag] = other_strain;
 }
 
+// Types of one general type with their CDF and benefits for all strains
+void Vaccinations::compile_vaccine_types(const std::string& dose, const std::string& number_tag,
+					std::vector<VaccineType>& types, std::vector<double>& cdf)
+{
+	types.clear();
+	cdf.clear();
+	const int num_types = static_cast<int>(vaccination_parameters.at(number_tag));
+	for (int i = 1; i <= num_types; ++i) {
+		VaccineType vac_type;
+		vac_type.tag = dose + " - type " + std::to_string(i);
+		vac_type.booster_tag = "former " + vac_type.tag;
+		cdf.push_back(vaccination_parameters.at(vac_type.tag + " probability vaccinated, CDF"));
+		for (int os = 1; os <= num_strains; ++os) {
+			const std::string tag = (os == strain_id) ? vac_type.tag 
+						: vac_type.tag + " other strain " + std::to_string(os);
+			std::vector<BenefitPoints> benefits;
+			for (const auto& name : benefit_names) {
+				benefits.push_back(vac_types_properties.at(tag).at(name));
+			}
+			vac_type.benefits.push_back(benefits);
+		}
+		types.push_back(vac_type);
+	}
+}
+
+// Subtype with the probability cur_prob in the CDF
+const Vaccinations::VaccineType& Vaccinations::select_type(const std::vector<VaccineType>& types, 
+				const std::vector<double>& cdf, const double cur_prob) const
+{
+	// This assumes all types are loaded sequentially
+	const auto& iter = std::find_if(cdf.cbegin(), cdf.cend(), 
+			[&cur_prob](const double x) { return x >= cur_prob; });
+	return types.at(std::distance(cdf.cbegin(), iter));
+}
+
+// Compiled subtype with this tag
+const Vaccinations::VaccineType& Vaccinations::find_type(const std::string& tag) const
+{
+	for (const auto& types : {&one_dose_types, &two_dose_types}) {
+		for (const auto& vac_type : *types) {
+			if (vac_type.tag == tag) {
+				return vac_type;
+			}
+		}
+	}
+	throw std::out_of_range("No vaccine type " + tag);
+}
+
+// Value of a parameter used for each agent, throws if it was not in the input
+double Vaccinations::required(const double value, const char* name) const
+{
+	if (std::isnan(value)) {
+		throw std::out_of_range(std::string("No vaccination parameter named ") + name);
+	}
+	return value;
+}
+
 /// Load and shuffle time custom offsets for vaccines 
 void Vaccinations::load_and_shuffle_time_offsets(const std::string& offset_file, Infection& infection)
 {
@@ -137,15 +235,15 @@ void Vaccinations::copy_vaccination_dependencies(std::forward_list<double>&& lst
 }
 
 // Randomly vaccinates requested number of agents
-std::vector<int> Vaccinations::vaccinate_random(std::vector<Agent>& agents, int n_vac, 
+std::array<int, 2> Vaccinations::vaccinate_random(std::vector<Agent>& agents, int n_vac, 
 							int n_boost, Infection& infection, const double time)
 {
 	// Pick ones that can be vaccinated
 	int max_boost = 0;
-	std::vector<int> can_be_vaccinated = filter_general(agents, max_boost);
+	const std::vector<int>& can_be_vaccinated = eligible_agents(agents, max_boost);
 	if (can_be_vaccinated.empty()) {
 		std::cout << "No more agents eligible for random vaccination" << std::endl;
-		return {0, 0};
+		return {{0, 0}};
 	}
 	// Reduce n_vac and n_boost if larger than available
 	if (n_vac + n_boost > can_be_vaccinated.size()) {
@@ -155,15 +253,12 @@ std::vector<int> Vaccinations::vaccinate_random(std::vector<Agent>& agents, int
 				  << " larger than currently eligible -- decreasing to " 
 				  << n_vac << std::endl;
 	}
-	// If not processing all avaiblable,
-	// randomly shuffle the indices, then vaccinate first n_vac
-	if (n_vac != can_be_vaccinated.size()) {
-		infection.vector_shuffle(can_be_vaccinated);
-		can_be_vaccinated.resize(n_vac);		
-	}	
+	// Randomly selected if not all available
+	std::vector<int> selected = select_eligible(can_be_vaccinated, n_vac, infection);
 	// Vaccinate and set agent properties
-	vaccinate_and_setup(agents, can_be_vaccinated, infection, time);
-	return {n_vac - n_boost, n_boost};
+	vaccinate_and_setup(agents, selected, infection, time);
+	update_eligibility(agents, selected);
+	return {{n_vac - n_boost, n_boost}};
 }
 
 // Randomly vaccinates requested number of agents with a negative time offset
@@ -172,7 +267,7 @@ int Vaccinations::vaccinate_random_time_offset(std::vector<Agent>& agents, int n
 {
 	// Pick ones that can be vaccinated
 	int max_boost = 0;
-	std::vector<int> can_be_vaccinated = filter_general(agents, max_boost);
+	const std::vector<int>& can_be_vaccinated = eligible_agents(agents, max_boost);
 	if (can_be_vaccinated.empty()) {
 		std::cout << "No more agents eligible for random vaccination" << std::endl;
 		return 0;
@@ -184,14 +279,11 @@ int Vaccinations::vaccinate_random_time_offset(std::vector<Agent>& agents, int n
 				  << " larger than currently eligible -- decreasing to " 
 				  << n_vac << std::endl;
 	}
-	// If not processing all avaiblable,
-	// randomly shuffle the indices, then vaccinate first n_vac
-	if (n_vac != can_be_vaccinated.size()) {
-		infection.vector_shuffle(can_be_vaccinated);
-		can_be_vaccinated.resize(n_vac);		
-	}	
+	// Randomly selected if not all available
+	std::vector<int> selected = select_eligible(can_be_vaccinated, n_vac, infection);
 	// Vaccinate and set agent properties
-	vaccinate_and_setup_time_offset(agents, can_be_vaccinated, infection, time, n_boost);
+	vaccinate_and_setup_time_offset(agents, selected, infection, time, n_boost);
+	update_eligibility(agents, selected);
 	return n_vac;
 }
 
@@ -201,7 +293,7 @@ int Vaccinations::vaccinate_group(std::vector<Agent>& agents, const std::string&
 									const bool vaccinate_all)
 {
 	// Pick ones that can be vaccinated
-	std::vector<int> can_be_vaccinated = filter_general_and_group(agents, group_name);
+	const std::vector<int>& can_be_vaccinated = eligible_group_agents(agents, group_name);
 	if (can_be_vaccinated.empty()) {
 		std::cout << "No more agents eligible for vaccination of group " 
 				  << group_name << std::endl;
@@ -220,14 +312,11 @@ int Vaccinations::vaccinate_group(std::vector<Agent>& agents, const std::string&
 		std::cout << "Vaccinating all " << n_vac << " eligible agents in group "
 				  << group_name << std::endl;
 	}
-	// If not processing all avaiblable,
-	// randomly shuffle the indices, then vaccinate first n_vac
-	if (n_vac != can_be_vaccinated.size()) {
-		infection.vector_shuffle(can_be_vaccinated);
-		can_be_vaccinated.resize(n_vac);		
-	}	
+	// Randomly selected if not all available
+	std::vector<int> selected = select_eligible(can_be_vaccinated, n_vac, infection);
 	// Vaccinate and set agent properties
-	vaccinate_and_setup(agents, can_be_vaccinated, infection, time);
+	vaccinate_and_setup(agents, selected, infection, time);
+	update_eligibility(agents, selected);
 	return n_vac;
 }
 
@@ -235,15 +324,124 @@ int Vaccinations::vaccinate_group(std::vector<Agent>& agents, const std::string&
 int Vaccinations::max_eligible_random(const std::vector<Agent>& agents)
 {
 	int max_boost = 0;
-	std::vector<int> eligible_IDs = filter_general(agents, max_boost);
-	return eligible_IDs.size();
+	return eligible_agents(agents, max_boost).size();
 }
 
 // Returns maximum number of agents in a group currently eligible for vaccination
 int Vaccinations::max_eligible_group(const std::vector<Agent>& agents, const std::string& group_name)
 {
-	std::vector<int> eligible_IDs = filter_general_and_group(agents, group_name);
-	return eligible_IDs.size();
+	return eligible_group_agents(agents, group_name).size();
+}
+
+//
+// Eligibility index
+//
+
+// Index of all agents
+void Vaccinations::track_eligibility(const std::vector<Agent>& agents)
+{
+	eligible = EligibleIndex();
+	eligible.positions.assign(agents.size(), -1);
+	eligible_groups.assign(group_names.size(), eligible);
+	boost_due.assign(agents.size(), 0);
+	n_boost_due = 0;
+	agent_groups.assign(agents.size(), 0);
+	// Groups don't change
+	for (const auto& agent : agents) {
+		for (size_t ig = 0; ig < group_names.size(); ++ig) {
+			if (check_group(agent, group_names.at(ig))) {
+				agent_groups.at(agent.get_ID()-1) |= (1 << ig);
+			}
+		}
+	}
+	tracking = true;
+	for (const auto& agent : agents) {
+		update_eligibility(agent);
+	}
+}
+
+// Constant time, all criteria of check_general
+void Vaccinations::update_eligibility(const Agent& agent)
+{
+	if (!tracking) {
+		return;
+	}
+	const int aID = agent.get_ID();
+	int boost = 0;
+	const bool can_vaccinate = check_general(agent, boost);
+	if (boost != boost_due.at(aID-1)) {
+		n_boost_due += (boost == 1) ? 1 : -1;
+		boost_due.at(aID-1) = boost;
+	}
+	eligible.set(aID, can_vaccinate);
+	const unsigned char groups = agent_groups.at(aID-1);
+	for (size_t ig = 0; ig < eligible_groups.size(); ++ig) {
+		if (groups & (1 << ig)) {
+			eligible_groups.at(ig).set(aID, can_vaccinate);
+		}
+	}
+}
+
+// Agents vaccinated at this call
+void Vaccinations::update_eligibility(const std::vector<Agent>& agents, const std::vector<int>& agent_IDs)
+{
+	for (const int aID : agent_IDs) {
+		update_eligibility(agents.at(aID-1));
+	}
+}
+
+// Swap with the last to remove
+void Vaccinations::EligibleIndex::set(const int agent_ID, const bool is_eligible)
+{
+	int& pos = positions.at(agent_ID-1);
+	if (is_eligible && pos < 0) {
+		pos = IDs.size();
+		IDs.push_back(agent_ID);
+	} else if (!is_eligible && pos >= 0) {
+		const int last = IDs.back();
+		IDs.at(pos) = last;
+		positions.at(last-1) = pos;
+		IDs.pop_back();
+		pos = -1;
+	}
+}
+
+// Index or a check of all agents
+const std::vector<int>& Vaccinations::eligible_agents(const std::vector<Agent>& agents, int& max_boost)
+{
+	if (tracking) {
+		max_boost = n_boost_due;
+		return eligible.IDs;
+	}
+	checked_eligible = filter_general(agents, max_boost);
+	return checked_eligible;
+}
+
+// Index of the group, none for unknown groups
+const std::vector<int>& Vaccinations::eligible_group_agents(const std::vector<Agent>& agents, 
+											const std::string& group_name)
+{
+	const auto group = std::find(group_names.begin(), group_names.end(), group_name);
+	if (tracking && group != group_names.end()) {
+		return eligible_groups.at(group - group_names.begin()).IDs;
+	}
+	checked_eligible = filter_general_and_group(agents, group_name);
+	return checked_eligible;
+}
+
+// Random sample without changing the eligible
+std::vector<int> Vaccinations::select_eligible(const std::vector<int>& can_be_vaccinated, 
+									const int n_vac, Infection& infection)
+{
+	if (n_vac == can_be_vaccinated.size()) {
+		return can_be_vaccinated;
+	}
+	std::vector<int> selected;
+	selected.reserve(n_vac);
+	for (const int i : infection.sample_without_replacement(can_be_vaccinated.size(), n_vac)) {
+		selected.push_back(can_be_vaccinated.at(i));
+	}
+	return selected;
 }
 
 // Select agents eligible for vaccination based on criteria valid for all agents
@@ -289,7 +487,7 @@ bool Vaccinations::check_general(const Agent& agent, int& max_boost)
 	if (agent.removed_dead()) {
 		return false;
 	} 
-	if (agent.get_age() < vaccination_parameters.at("Minimum vaccination age")) {
+	if (agent.get_age() < min_vac_age) {
 		return false;	
 	}
 	if (agent.tested_covid_positive()) {
@@ -343,12 +541,10 @@ void Vaccinations::vaccinate_and_setup(std::vector<Agent>& agents, std::vector<i
 		Agent& agent = agents.at(id-1);
 		// Third dose
 		if (agent.vaccinated() && agent.needs_next_vaccination() && agent.is_vaccinated_for_strain(strain_id)) {
-			double next_step = vaccination_parameters.at("Third dose max effects time");
-			double max_end = vaccination_parameters.at("Third dose max effects end time");
-			double tot_end = vaccination_parameters.at("Third dose no effects time");
-			std::string vac_type = agent.get_vaccine_type(strain_id);
-			std::string tag = agent.get_vaccine_subtype(strain_id);
-			set_booster(agent, tag, time, next_step, max_end, tot_end);
+			const double next_step = required(third_dose_max_time, "Third dose max effects time");
+			const double max_end = required(third_dose_max_end, "Third dose max effects end time");
+			const double tot_end = required(third_dose_end, "Third dose no effects time");
+			set_booster(agent, find_type(agent.get_vaccine_subtype(strain_id)), time, next_step, max_end, tot_end);
 			agent.set_up_to_date(true);
 			agent.set_got_booster(true);
 			continue;
@@ -356,30 +552,18 @@ void Vaccinations::vaccinate_and_setup(std::vector<Agent>& agents, std::vector<i
 		// First vaccination ever
 		agent.set_vaccinated(true);
 		agent.set_needs_next_vaccination(false);
-		if (infection.get_uniform() <= vaccination_parameters.at("Fraction taking one dose vaccine")) {
+		if (infection.get_uniform() <= required(frac_one_dose, "Fraction taking one dose vaccine")) {
 			agent.set_vaccine_type("one_dose", strain_id);
 			// Select the type based on the iterator in the CDF
-			// This assumes all types are loaded sequentially
-			std::vector<double> one_dose_probs = vac_types_probs.at("one dose CDF");
-			double cur_prob = infection.get_uniform();
-			const auto& iter = std::find_if(one_dose_probs.cbegin(), one_dose_probs.cend(), 
-					[&cur_prob](const double x) { return x >= cur_prob; });
-			// Types start with 1
-			std::string tag = "one dose - type "+ std::to_string(std::distance(one_dose_probs.cbegin(), iter) + 1);
-			agent.set_vaccine_subtype(tag, strain_id);
-			set_regular_one_dose(agent, tag, time);
+			const VaccineType& vac_type = select_type(one_dose_types, one_dose_CDF, infection.get_uniform());
+			agent.set_vaccine_subtype(vac_type.tag, strain_id);
+			set_regular_one_dose(agent, vac_type, time);
 		} else {
 			agent.set_vaccine_type("two_doses", strain_id);
 			// Select the type based on the iterator in the CDF
-			// This assumes all types are loaded sequentially
-			std::vector<double> two_dose_probs = vac_types_probs.at("two dose CDF");
-			double cur_prob = infection.get_uniform();
-			const auto& iter = std::find_if(two_dose_probs.cbegin(), two_dose_probs.cend(), 
-					[&cur_prob](const double x) { return x >= cur_prob; });
-			// Types start with 1
-			std::string tag = "two dose - type "+ std::to_string(std::distance(two_dose_probs.cbegin(), iter) + 1);
-			agent.set_vaccine_subtype(tag, strain_id);
-			set_regular_two_dose(agent, tag, time);
+			const VaccineType& vac_type = select_type(two_dose_types, two_dose_CDF, infection.get_uniform());
+			agent.set_vaccine_subtype(vac_type.tag, strain_id);
+			set_regular_two_dose(agent, vac_type, time);
 		}
 	}
 }
@@ -388,8 +572,8 @@ void Vaccinations::vaccinate_and_setup(std::vector<Agent>& agents, std::vector<i
 void Vaccinations::vaccinate_and_setup_time_offset(std::vector<Agent>& agents, std::vector<int>& agent_IDs, 
 										Infection& infection, const double time, const int n_boosted)
 {
-	const double t0 = vaccination_parameters.at("Start of time offset interval");
-	const double tf = vaccination_parameters.at("End of time offset interval");
+	const double t0 = required(offset_start, "Start of time offset interval");
+	const double tf = required(offset_end, "End of time offset interval");
 	double offset = 0, offset_booster = 0;
 	for (auto& id : agent_IDs) {
 		Agent& agent = agents.at(id-1);
@@ -411,33 +595,27 @@ void Vaccinations::vaccinate_and_setup_time_offset(std::vector<Agent>& agents, s
 			offset = -1.0*infection.get_uniform(t0, tf);
 		}
 		agent.set_vac_time_offset(offset);
-		if ( infection.get_uniform() <= vaccination_parameters.at("Fraction taking one dose vaccine")) {
+		if ( infection.get_uniform() <= required(frac_one_dose, "Fraction taking one dose vaccine")) {
 			agent.set_vaccine_type("one_dose", strain_id);
 			// Select the type based on the iterator in the CDF
-			// This assumes all types are loaded sequentially
-			std::vector<double> one_dose_probs = vac_types_probs.at("one dose CDF");
-			double cur_prob = infection.get_uniform();
-			const auto& iter = std::find_if(one_dose_probs.cbegin(), one_dose_probs.cend(), 
-					[&cur_prob](const double x) { return x >= cur_prob; });
-			// Types start with 1
-			std::string tag = "one dose - type "+ std::to_string(std::distance(one_dose_probs.cbegin(), iter) + 1);
-			agent.set_vaccine_subtype(tag, strain_id);
-			set_regular_one_dose(agent, tag, offset);
+			const VaccineType& vac_type = select_type(one_dose_types, one_dose_CDF, infection.get_uniform());
+			agent.set_vaccine_subtype(vac_type.tag, strain_id);
+			set_regular_one_dose(agent, vac_type, offset);
 //			std::cout << "One dose" << std::endl;
 		} else {
 			// One of the two dose vaccines is a booster
 			agent.set_vaccine_type("two_doses", strain_id);
 			double cur_prob = infection.get_uniform();
 			// Types start with 1
-			std::string tag = "two dose - type 1";
+			const VaccineType* vac_type = &two_dose_types.at(0);
 
-			if (cur_prob <= vaccination_parameters.at("Fraction with boosters")) {
+			if (cur_prob <= required(frac_boosters, "Fraction with boosters")) {
 				offset = offset_booster;
-				tag = "two dose - type 2";
+				vac_type = &two_dose_types.at(1);
 			}
 
-			agent.set_vaccine_subtype(tag, strain_id);
-			set_regular_two_dose(agent, tag, offset);
+			agent.set_vaccine_subtype(vac_type->tag, strain_id);
+			set_regular_two_dose(agent, *vac_type, offset);
 		}
 	}
 
@@ -472,114 +650,85 @@ void Vaccinations::vaccinate_and_setup_time_offset(std::vector<Agent>& agents, s
 }
 
 // Assign benefits for this strain and other relevant strains for one dose vaccine
-void Vaccinations::set_regular_one_dose(Agent& agent, const std::string& tag, const double time)
+void Vaccinations::set_regular_one_dose(Agent& agent, const VaccineType& vac_type, const double time)
 {
 	// For the current strain
 	agent.set_vaccinated_target_strain(strain_id);
 	// Now access attributes for the three part functions and set-up agent properties		
-	agent.set_vaccine_effectiveness(ThreePartFunction(vac_types_properties.at(tag).at("effectiveness"), time), strain_id);
-	agent.set_asymptomatic_correction(ThreePartFunction(vac_types_properties.at(tag).at("asymptomatic"), time), strain_id);
-	agent.set_transmission_correction(ThreePartFunction(vac_types_properties.at(tag).at("transmission"), time), strain_id);
-	agent.set_severe_correction(ThreePartFunction(vac_types_properties.at(tag).at("severe"), time), strain_id);
-	agent.set_death_correction(ThreePartFunction(vac_types_properties.at(tag).at("death"), time), strain_id);
+	const std::vector<BenefitPoints>& props = vac_type.benefits.at(strain_id-1);
+	agent.set_vaccine_effectiveness(ThreePartFunction(props.at(effectiveness), time), strain_id);
+	agent.set_asymptomatic_correction(ThreePartFunction(props.at(asymptomatic), time), strain_id);
+	agent.set_transmission_correction(ThreePartFunction(props.at(transmission), time), strain_id);
+	agent.set_severe_correction(ThreePartFunction(props.at(severe), time), strain_id);
+	agent.set_death_correction(ThreePartFunction(props.at(death), time), strain_id);
 	// Record the time when vaccine effects start dropping (assumes all these properties follow the same trend)
-	agent.set_time_vaccine_effects_reduction(time+vac_types_properties.at(tag).at("effectiveness").at(2).at(0));
+	agent.set_time_vaccine_effects_reduction(time+props.at(effectiveness).at(2).at(0));
 	// and the time when mobility increases (at peak effectiveness)
-	agent.set_time_mobility_increase(time+vac_types_properties.at(tag).at("effectiveness").at(1).at(0));
+	agent.set_time_mobility_increase(time+props.at(effectiveness).at(1).at(0));
 
 	// For all other strains (except ones that received their target vaccine already)
 	for (int i = 1; i<=num_strains; ++i) {
 		if ((i != strain_id) && !agent.is_vaccinated_for_strain(i)) {
 			agent.set_vaccine_type("one_dose", i);
-			// Set the tag for this strain and vac type (make compatible with tag)
-			std::string other_tag = tag + " other strain " + std::to_string(i);
 			// Set the reduced benefits
-			agent.set_vaccine_effectiveness(ThreePartFunction(vac_types_properties.at(other_tag).at("effectiveness"), time), i);
-			agent.set_asymptomatic_correction(ThreePartFunction(vac_types_properties.at(other_tag).at("asymptomatic"), time), i);
-			agent.set_transmission_correction(ThreePartFunction(vac_types_properties.at(other_tag).at("transmission"), time), i);
-			agent.set_severe_correction(ThreePartFunction(vac_types_properties.at(other_tag).at("severe"), time), i);
-			agent.set_death_correction(ThreePartFunction(vac_types_properties.at(other_tag).at("death"), time), i);						
+			const std::vector<BenefitPoints>& other_props = vac_type.benefits.at(i-1);
+			agent.set_vaccine_effectiveness(ThreePartFunction(other_props.at(effectiveness), time), i);
+			agent.set_asymptomatic_correction(ThreePartFunction(other_props.at(asymptomatic), time), i);
+			agent.set_transmission_correction(ThreePartFunction(other_props.at(transmission), time), i);
+			agent.set_severe_correction(ThreePartFunction(other_props.at(severe), time), i);
+			agent.set_death_correction(ThreePartFunction(other_props.at(death), time), i);						
 		}
 	}
 }
 
 // Assign benefits for this strain and other relevant strains for two dose vaccine
-void Vaccinations::set_regular_two_dose(Agent& agent, const std::string& tag, const double time)
+void Vaccinations::set_regular_two_dose(Agent& agent, const VaccineType& vac_type, const double time)
 {
 	// For the current strain
 	agent.set_vaccinated_target_strain(strain_id);
 	// Now access attributes for the four part functions and set-up agent properties		
-	agent.set_vaccine_effectiveness(FourPartFunction(vac_types_properties.at(tag).at("effectiveness"), time), strain_id);
-	agent.set_asymptomatic_correction(FourPartFunction(vac_types_properties.at(tag).at("asymptomatic"), time), strain_id);
-	agent.set_transmission_correction(FourPartFunction(vac_types_properties.at(tag).at("transmission"), time), strain_id);
-	agent.set_severe_correction(FourPartFunction(vac_types_properties.at(tag).at("severe"), time), strain_id);
-	agent.set_death_correction(FourPartFunction(vac_types_properties.at(tag).at("death"), time), strain_id);
+	const std::vector<BenefitPoints>& props = vac_type.benefits.at(strain_id-1);
+	agent.set_vaccine_effectiveness(FourPartFunction(props.at(effectiveness), time), strain_id);
+	agent.set_asymptomatic_correction(FourPartFunction(props.at(asymptomatic), time), strain_id);
+	agent.set_transmission_correction(FourPartFunction(props.at(transmission), time), strain_id);
+	agent.set_severe_correction(FourPartFunction(props.at(severe), time), strain_id);
+	agent.set_death_correction(FourPartFunction(props.at(death), time), strain_id);
 	// Record the time when vaccine effects start dropping (assumes all these properties follow the same trend)
-	agent.set_time_vaccine_effects_reduction(time+vac_types_properties.at(tag).at("effectiveness").at(3).at(0));
+	agent.set_time_vaccine_effects_reduction(time+props.at(effectiveness).at(3).at(0));
 	// and the time when mobility increases (at peak effectiveness)
-	agent.set_time_mobility_increase(time+vac_types_properties.at(tag).at("effectiveness").at(2).at(0));
+	agent.set_time_mobility_increase(time+props.at(effectiveness).at(2).at(0));
 
 	// For all other strains (except ones that received their target vaccine already)
 	for (int i = 1; i<=num_strains; ++i) {
 		if ((i != strain_id) && !agent.is_vaccinated_for_strain(i)) {
 			agent.set_vaccine_type("two_doses", i);
-			// Set the tag for this strain and vac type (make compatible with tag)
-			std::string other_tag = tag + " other strain " + std::to_string(i);
 			// Set the reduced benefits
-			agent.set_vaccine_effectiveness(FourPartFunction(vac_types_properties.at(other_tag).at("effectiveness"), time), i);
-			agent.set_asymptomatic_correction(FourPartFunction(vac_types_properties.at(other_tag).at("asymptomatic"), time), i);
-			agent.set_transmission_correction(FourPartFunction(vac_types_properties.at(other_tag).at("transmission"), time), i);
-			agent.set_severe_correction(FourPartFunction(vac_types_properties.at(other_tag).at("severe"), time), i);
-			agent.set_death_correction(FourPartFunction(vac_types_properties.at(other_tag).at("death"), time), i);						
+			const std::vector<BenefitPoints>& other_props = vac_type.benefits.at(i-1);
+			agent.set_vaccine_effectiveness(FourPartFunction(other_props.at(effectiveness), time), i);
+			agent.set_asymptomatic_correction(FourPartFunction(other_props.at(asymptomatic), time), i);
+			agent.set_transmission_correction(FourPartFunction(other_props.at(transmission), time), i);
+			agent.set_severe_correction(FourPartFunction(other_props.at(severe), time), i);
+			agent.set_death_correction(FourPartFunction(other_props.at(death), time), i);						
 		}
 	}
 }
 
 // Assign benefits for a booster that consider other relevant strains
-void Vaccinations::set_booster(Agent& agent, const std::string& tag, const double time, 
+void Vaccinations::set_booster(Agent& agent, const VaccineType& vac_type, const double time, 
 								const double next_step, const double max_end, const double tot_end)
 {
 	// Construct for each benefit: this step, current value | next step, max value | then as usual
-	// 1) Effectiveness
-	std::vector<std::vector<double>> orig_props = vac_types_properties.at(tag).at("effectiveness");
-	double max_benefit = orig_props.at(orig_props.size()-2).at(1);
-	double ini_benefit = time < 0.0 ? max_benefit : agent.vaccine_effectiveness(time, strain_id);
-	std::vector<std::vector<double>> new_eff{{0.0, ini_benefit}, 
-										{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 0.0}};
-	agent.set_vaccine_effectiveness(ThreePartFunction(new_eff, time), strain_id);
-
-	// 2) Asymptomatic correction
-	orig_props = vac_types_properties.at(tag).at("asymptomatic");
-	max_benefit = orig_props.at(orig_props.size()-2).at(1);
-	ini_benefit = time < 0.0 ? max_benefit : agent.asymptomatic_correction(time, strain_id);
-	std::vector<std::vector<double>> new_asm{{0.0, ini_benefit}, 
-										{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-	agent.set_asymptomatic_correction(ThreePartFunction(new_asm, time), strain_id);
-
-	// 3) Transmission correction
-	orig_props = vac_types_properties.at(tag).at("transmission");
-	max_benefit = orig_props.at(orig_props.size()-2).at(1);
-	ini_benefit = time < 0.0 ? max_benefit : agent.transmission_correction(time, strain_id);
-	std::vector<std::vector<double>> new_tr{{0.0, ini_benefit}, 
-										{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-	agent.set_transmission_correction(ThreePartFunction(new_tr, time), strain_id);	
-
-	// 4) Severity correction
-	orig_props = vac_types_properties.at(tag).at("severe");
-	max_benefit = orig_props.at(orig_props.size()-2).at(1);
-	ini_benefit = time < 0.0 ? max_benefit : agent.severe_correction(time, strain_id);
-	std::vector<std::vector<double>> new_sv{{0.0, ini_benefit}, 
-										{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-	agent.set_severe_correction(ThreePartFunction(new_sv, time), strain_id);
-
-	// 5) Death correction
-	orig_props = vac_types_properties.at(tag).at("death");
-	max_benefit = orig_props.at(orig_props.size()-2).at(1);
-	ini_benefit = time < 0.0 ? max_benefit : agent.death_correction(time, strain_id);
-	std::vector<std::vector<double>> new_dth{{0.0, ini_benefit}, 
-										{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-//	std::cout << ini_benefit << " " << max_benefit << " " << time << " " << agent.death_correction(time, strain_id) <<std::endl;
-	agent.set_death_correction(ThreePartFunction(new_dth, time), strain_id);
+	const std::vector<BenefitPoints>& props = vac_type.benefits.at(strain_id-1);
+	agent.set_vaccine_effectiveness(booster_benefit(props.at(effectiveness), 
+				agent.vaccine_effectiveness(time, strain_id), 0.0, time, next_step, max_end, tot_end), strain_id);
+	agent.set_asymptomatic_correction(booster_benefit(props.at(asymptomatic), 
+				agent.asymptomatic_correction(time, strain_id), 1.0, time, next_step, max_end, tot_end), strain_id);
+	agent.set_transmission_correction(booster_benefit(props.at(transmission), 
+				agent.transmission_correction(time, strain_id), 1.0, time, next_step, max_end, tot_end), strain_id);
+	agent.set_severe_correction(booster_benefit(props.at(severe), 
+				agent.severe_correction(time, strain_id), 1.0, time, next_step, max_end, tot_end), strain_id);
+	agent.set_death_correction(booster_benefit(props.at(death), 
+				agent.death_correction(time, strain_id), 1.0, time, next_step, max_end, tot_end), strain_id);
 
 	// Other properties
 	// Record the time when vaccine effects start dropping (assumes all these properties follow the same trend)
@@ -590,60 +739,43 @@ void Vaccinations::set_booster(Agent& agent, const std::string& tag, const doubl
 	agent.set_needs_next_vaccination(false);
 	// Correct the type 
 	agent.set_vaccine_type("one_dose", strain_id);
-	agent.set_vaccine_subtype("former " + tag, strain_id);
+	agent.set_vaccine_subtype(vac_type.booster_tag, strain_id);
 
 	// For all other strains (except ones that received their target vaccine already)
 	for (int i = 1; i<=num_strains; ++i) {
 		if ((i != strain_id) && !agent.is_vaccinated_for_strain(i)) {
-			// Set the tag for this strain and vac type (make compatible with tag)
-			std::string other_tag = tag + " other strain " + std::to_string(i);
 			// Set the reduced benefits
-			// 1) Effectiveness
-			std::vector<std::vector<double>> orig_props = vac_types_properties.at(other_tag).at("effectiveness");
-			max_benefit = orig_props.at(orig_props.size()-2).at(1);
-			ini_benefit = time < 0.0 ? max_benefit : agent.vaccine_effectiveness(time, i);
-			std::vector<std::vector<double>> new_eff{{0.0, ini_benefit}, 
-												{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 0.0}};
-			agent.set_vaccine_effectiveness(ThreePartFunction(new_eff, time), i);
-		
-			// 2) Asymptomatic correction
-			orig_props = vac_types_properties.at(other_tag).at("asymptomatic");
-			max_benefit = orig_props.at(orig_props.size()-2).at(1);
-			ini_benefit = time < 0.0 ? max_benefit : agent.asymptomatic_correction(time, i);
-			std::vector<std::vector<double>> new_asm{{0.0, ini_benefit}, 
-												{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-			agent.set_asymptomatic_correction(ThreePartFunction(new_asm, time), i);
-		
-			// 3) Transmission correction
-			orig_props = vac_types_properties.at(other_tag).at("transmission");
-			max_benefit = orig_props.at(orig_props.size()-2).at(1);
-			ini_benefit = time < 0.0 ? max_benefit : agent.transmission_correction(time, i);
-			std::vector<std::vector<double>> new_tr{{0.0, ini_benefit}, 
-												{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-			agent.set_transmission_correction(ThreePartFunction(new_tr, time), i);	
-		
-			// 4) Severity correction
-			orig_props = vac_types_properties.at(other_tag).at("severe");
-			max_benefit = orig_props.at(orig_props.size()-2).at(1);
-			ini_benefit = time < 0.0 ? max_benefit : agent.severe_correction(time, i);
-			std::vector<std::vector<double>> new_sv{{0.0, ini_benefit}, 
-												{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-			agent.set_severe_correction(ThreePartFunction(new_sv, time), i);
-		
-			// 5) Death correction
-			orig_props = vac_types_properties.at(other_tag).at("death");
-			max_benefit = orig_props.at(orig_props.size()-2).at(1);
-			ini_benefit = time < 0.0 ? max_benefit : agent.death_correction(time, i);
-			std::vector<std::vector<double>> new_dth{{0.0, ini_benefit}, 
-												{next_step, max_benefit}, {max_end, max_benefit}, {tot_end, 1.0}};
-			agent.set_death_correction(ThreePartFunction(new_dth, time), i);
-
-//	std::cout << "Strain 2 pre: "<< ini_benefit << " " << max_benefit << " " << agent.death_correction(time, i)<< std::endl;
-
+			const std::vector<BenefitPoints>& other_props = vac_type.benefits.at(i-1);
+			agent.set_vaccine_effectiveness(booster_benefit(other_props.at(effectiveness), 
+						agent.vaccine_effectiveness(time, i), 0.0, time, next_step, max_end, tot_end), i);
+			agent.set_asymptomatic_correction(booster_benefit(other_props.at(asymptomatic), 
+						agent.asymptomatic_correction(time, i), 1.0, time, next_step, max_end, tot_end), i);
+			agent.set_transmission_correction(booster_benefit(other_props.at(transmission), 
+						agent.transmission_correction(time, i), 1.0, time, next_step, max_end, tot_end), i);
+			agent.set_severe_correction(booster_benefit(other_props.at(severe), 
+						agent.severe_correction(time, i), 1.0, time, next_step, max_end, tot_end), i);
+			agent.set_death_correction(booster_benefit(other_props.at(death), 
+						agent.death_correction(time, i), 1.0, time, next_step, max_end, tot_end), i);
 			// Booster type - one dose
 			agent.set_vaccine_type("one_dose", i);
-
-//	std::cout << "Strain 2: "<< ini_benefit << " " << max_benefit << " " << agent.death_correction(time, i)<< std::endl;
 		}
 	}
 }
+
+// Benefit from its current value to the maximum of the type after a booster, then as usual
+ThreePartFunction Vaccinations::booster_benefit(const BenefitPoints& type_points, const double current, 
+								const double end_value, const double time, const double next_step, 
+								const double max_end, const double tot_end)
+{
+	const double max_benefit = type_points.at(type_points.size()-2).at(1);
+	// Benefits from before a negative time are at their maximum
+	booster_points.at(0).at(0) = 0.0;
+	booster_points.at(0).at(1) = time < 0.0 ? max_benefit : current;
+	booster_points.at(1).at(0) = next_step;
+	booster_points.at(1).at(1) = max_benefit;
+	booster_points.at(2).at(0) = max_end;
+	booster_points.at(2).at(1) = max_benefit;
+	booster_points.at(3).at(0) = tot_end;
+	booster_points.at(3).at(1) = end_value;
+	return ThreePartFunction(booster_points, time);
+}
@@ -19,6 +19,8 @@ bool create_carpools_test();
 bool create_public_transit_test();
 bool create_agents_test();
 bool wrong_number_of_initially_infected_test();
+bool town_image_test();
+bool shared_town_test();
 
 // Supporting functions
 bool compare_places_files(std::string fname_in, std::string fname_out, 
@@ -34,6 +36,8 @@ bool correctly_registered(const ABM, const std::vector<std::vector<int>>,
 bool check_initially_infected(const Agent& agent, const Flu& flu, int& n_exposed_never_sy,
 								const std::map<std::string, double> infection_parameters);
 bool check_fractions(int, int, double, std::string, bool need_ge = false);
+template<typename T>
+bool same_places(const std::vector<T>&, const std::vector<T>&);
 
 int main()
 {
@@ -47,6 +51,8 @@ int main()
 	test_pass(create_public_transit_test(), "Public transit creation");
 	test_pass(create_agents_test(), "Agent creation");
 	test_pass(wrong_number_of_initially_infected_test(), "Too many initially infected");
+	test_pass(town_image_test(), "Creation from a town image");
+	test_pass(shared_town_test(), "Models sharing a town");
 }
 
 // Checks household creation from file
@@ -860,3 +866,160 @@ bool wrong_number_of_initially_infected_test()
 
 
 
+
+/**
+ * \brief Checks creation from a precompiled town image
+ * \details Creates the image from the text input files and compares 
+ *		a model set up from the image to the one set up from text 
+ */
+bool town_image_test()
+{
+	double dt = 0.25;
+	std::string fin("test_data/input_files_all.txt");
+	std::string fin_image("test_data/input_files_town_image.txt");
+	std::string fimage("test_data/town_image.bin");
+	std::vector<int> initially_infected{0, 0};
+
+	TownImage::create(fin, fimage);
+
+	ABM abm_text(dt);
+	abm_text.simulation_setup(fin, initially_infected);
+	ABM abm_image(dt);
+	abm_image.simulation_setup(fin_image, initially_infected);
+
+	if (!same_places(abm_text.get_vector_of_households(), abm_image.get_vector_of_households())
+		|| !same_places(abm_text.get_vector_of_schools(), abm_image.get_vector_of_schools())
+		|| !same_places(abm_text.get_vector_of_workplaces(), abm_image.get_vector_of_workplaces())
+		|| !same_places(abm_text.get_vector_of_hospitals(), abm_image.get_vector_of_hospitals())
+		|| !same_places(abm_text.get_vector_of_retirement_homes(), abm_image.get_vector_of_retirement_homes())
+		|| !same_places(abm_text.get_vector_of_carpools(), abm_image.get_vector_of_carpools())
+		|| !same_places(abm_text.get_vector_of_public_transit(), abm_image.get_vector_of_public_transit())
+		|| !same_places(abm_text.get_vector_of_leisure_locations(), abm_image.get_vector_of_leisure_locations())) {
+		std::cerr << "Places created from a town image differ from the ones created from text" << std::endl;
+		return false;
+	}
+
+	const std::vector<Agent>& agents_text = abm_text.get_vector_of_agents();
+	const std::vector<Agent>& agents_image = abm_image.get_vector_of_agents();
+	if (agents_text.size() != agents_image.size()) {
+		std::cerr << "Wrong number of agents created from a town image" << std::endl;
+		return false;
+	}
+	for (size_t i = 0; i < agents_text.size(); ++i) {
+		const Agent& at = agents_text.at(i);
+		const Agent& ai = agents_image.at(i);
+		std::ostringstream str_text, str_image;
+		str_text << at;
+		str_image << ai;
+		if (str_text.str() != str_image.str() 
+				|| at.get_work_travel_mode() != ai.get_work_travel_mode()
+				|| at.get_occupation() != ai.get_occupation()
+				|| at.get_occupation_transmission() != ai.get_occupation_transmission()) {
+			std::cerr << "Agent " << at.get_ID() << " differs when created from a town image" << std::endl;
+			return false;
+		}
+	}
+
+	// Not an image
+	bool verbose = false;
+	const std::runtime_error rtime("Not a town image");
+	auto open_text = [&fin](){ TownImage image(fin); };
+	if (!exception_test(verbose, &rtime, open_text)) {
+		std::cerr << "Text file accepted as a town image" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * \brief Checks models that share one read-only town
+ * \details Copies and models set up on the town use its agent IDs
+ *		until they change them; changes do not affect the town
+ */
+bool shared_town_test()
+{
+	double dt = 0.25;
+	std::string fin("test_data/input_files_all.txt");
+	std::vector<int> initially_infected{0, 0};
+
+	ABM abm(dt);
+	abm.simulation_setup(fin, initially_infected);
+	std::shared_ptr<const Town> town = abm.get_town();
+	const size_t n_places = town->number_of_places();
+	if (!town || n_places == 0 || town->number_of_shared_places(abm) != n_places) {
+		std::cerr << "Model does not share places with its town" << std::endl;
+		return false;
+	}
+
+	// Copies share the town, changes are copied
+	ABM abm_copy(abm);
+	const int agent_ID = abm_copy.get_vector_of_households().at(0).get_agent_IDs().at(0);
+	abm_copy.vector_of_households().at(0).remove_agent(agent_ID);
+	if (abm_copy.get_town() != town || town->number_of_shared_places(abm_copy) != n_places - 1
+			|| town->number_of_shared_places(abm) != n_places
+			|| town->get_households().at(0).get_agent_IDs().at(0) != agent_ID
+			|| abm.get_vector_of_households().at(0).get_agent_IDs().at(0) != agent_ID) {
+		std::cerr << "Changes in a copy of the model affect other models" << std::endl;
+		return false;
+	}
+
+	// Model set up on the town
+	ABM abm_town(dt);
+	abm_town.simulation_setup(town, fin, initially_infected);
+	if (abm_town.get_town() != town || town->number_of_shared_places(abm_town) != n_places
+			|| abm_town.get_vector_of_agents().size() != abm.get_vector_of_agents().size()
+			|| !same_places(abm.get_vector_of_households(), abm_town.get_vector_of_households())
+			|| !same_places(abm.get_vector_of_schools(), abm_town.get_vector_of_schools())
+			|| !same_places(abm.get_vector_of_workplaces(), abm_town.get_vector_of_workplaces())
+			|| !same_places(abm.get_vector_of_hospitals(), abm_town.get_vector_of_hospitals())
+			|| !same_places(abm.get_vector_of_retirement_homes(), abm_town.get_vector_of_retirement_homes())
+			|| !same_places(abm.get_vector_of_carpools(), abm_town.get_vector_of_carpools())
+			|| !same_places(abm.get_vector_of_public_transit(), abm_town.get_vector_of_public_transit())
+			|| !same_places(abm.get_vector_of_leisure_locations(), abm_town.get_vector_of_leisure_locations())) {
+		std::cerr << "Model set up on a town differs from the original" << std::endl;
+		return false;
+	}
+	// Leisure visitors are only in the model
+	for (int ti = 0; ti < 4; ++ti) {
+		abm_town.transmit_infection();
+	}
+	auto has_visitors = [](const std::vector<Household>& houses) { 
+		return std::any_of(houses.begin(), houses.end(), 
+					[](const Household& house){ return !house.get_visitor_IDs().empty(); }); };
+	if (!has_visitors(abm_town.get_vector_of_households()) || has_visitors(town->get_households())
+			|| town->number_of_shared_places(abm) != n_places
+			|| !same_places(abm.get_vector_of_households(), town->get_households())
+			|| !same_places(abm.get_vector_of_leisure_locations(), town->get_leisure_locations())) {
+		std::cerr << "Simulation on a shared town changed the town" << std::endl;
+		return false;
+	}
+
+	bool verbose = false;
+	const std::invalid_argument inv_arg("No town");
+	auto no_town = [&fin, &initially_infected, dt](){ 
+		ABM abm_none(dt); 
+		abm_none.simulation_setup(std::shared_ptr<const Town>(), fin, initially_infected); };
+	if (!exception_test(verbose, &inv_arg, no_town)) {
+		std::cerr << "Setting up on a non-existing town should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// True if places have the same IDs, locations, and registered agents
+template<typename T>
+bool same_places(const std::vector<T>& places_1, const std::vector<T>& places_2)
+{
+	if (places_1.size() != places_2.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < places_1.size(); ++i) {
+		const T& p1 = places_1.at(i);
+		const T& p2 = places_2.at(i);
+		if (p1.get_ID() != p2.get_ID() || p1.get_x() != p2.get_x() 
+				|| p1.get_y() != p2.get_y() || p1.get_agent_IDs() != p2.get_agent_IDs()) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,144 @@
+#include "abm_tests.h"
+#include "../../include/ensemble.h"
+
+/*****************************************************
+ *
+ * Test suite for running ensembles of replicates
+ *
+******************************************************/
+
+// Tests
+bool ensemble_aggregates_test(const Ensemble&, const EnsembleSetup&);
+bool ensemble_reproducibility_test(const Ensemble&, const EnsembleSetup&);
+bool ensemble_exceptions_test(const EnsembleSetup&);
+
+// Supporting functions
+EnsembleSetup create_setup();
+
+int main()
+{
+	const EnsembleSetup setup = create_setup();
+	const int n_replicates = 4, n_threads = 2;
+	const unsigned int seed = 2022;
+	Ensemble ensemble(setup, n_replicates, seed, n_threads);
+	ensemble.run();
+
+	test_pass(ensemble_aggregates_test(ensemble, setup), "Ensemble replicates and aggregates");
+	test_pass(ensemble_reproducibility_test(ensemble, setup), "Ensemble reproducibility");
+	test_pass(ensemble_exceptions_test(setup), "Ensemble exceptions");
+}
+
+/// Independent replicates, seeding, and mean, min, max
+bool ensemble_aggregates_test(const Ensemble& ensemble, const EnsembleSetup& setup)
+{
+	const std::vector<std::string>& names = ensemble.get_metric_names();
+	const int i_inf = std::find(names.begin(), names.end(), "infected") - names.begin();
+	const int i_tot = std::find(names.begin(), names.end(), "total infected") - names.begin();
+	if (i_inf == names.size() || i_tot == names.size()) {
+		std::cerr << "Missing metrics in the ensemble output" << std::endl;
+		return false;
+	}
+	if (ensemble.get_times().size() != setup.n_steps + 1) {
+		return false;
+	}
+
+	// Every replicate starts with the requested infected
+	// (initialize_active_cases adds only the first strain to the total)
+	const int n_inf0 = std::accumulate(setup.inf0.begin(), setup.inf0.end(), 0)
+						+ setup.N_active.at(0);
+	bool all_same = true;
+	for (int i = 0; i < ensemble.get_number_of_replicates(); ++i) {
+		const std::vector<std::vector<double>>& traj = ensemble.get_trajectory(i);
+		if (traj.size() != setup.n_steps + 1 || traj.front().size() != names.size()) {
+			return false;
+		}
+		if (static_cast<int>(traj.front().at(i_tot)) != n_inf0) {
+			std::cerr << "Wrong number of initially infected: " << traj.front().at(i_tot)
+					  << " instead of " << n_inf0 << std::endl;
+			return false;
+		}
+		if (!is_equal_exact(traj, ensemble.get_trajectory(0))) {
+			all_same = false;
+		}
+	}
+	if (all_same) {
+		std::cerr << "All replicates are identical" << std::endl;
+		return false;
+	}
+
+	// Aggregates
+	const std::vector<std::vector<double>> mean = ensemble.get_mean();
+	const std::vector<std::vector<double>> min = ensemble.get_min();
+	const std::vector<std::vector<double>> max = ensemble.get_max();
+	for (int ti = 0; ti < mean.size(); ++ti) {
+		double sum = 0.0;
+		for (int i = 0; i < ensemble.get_number_of_replicates(); ++i) {
+			sum += ensemble.get_trajectory(i).at(ti).at(i_inf);
+		}
+		if (!float_equality<double>(mean.at(ti).at(i_inf),
+						sum/ensemble.get_number_of_replicates(), 1e-10)) {
+			return false;
+		}
+		for (int im = 0; im < names.size(); ++im) {
+			if (min.at(ti).at(im) > mean.at(ti).at(im) + 1e-10
+					|| max.at(ti).at(im) < mean.at(ti).at(im) - 1e-10) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/// Same seeds give the same results regardless of the number of threads
+bool ensemble_reproducibility_test(const Ensemble& ensemble, const EnsembleSetup& setup)
+{
+	// Rerun only the first two with a single thread
+	Ensemble serial(setup, 2, 2022, 1);
+	serial.run();
+	for (int i = 0; i < 2; ++i) {
+		if (serial.get_seed(i) != ensemble.get_seed(i)) {
+			return false;
+		}
+		if (!is_equal_exact(serial.get_trajectory(i), ensemble.get_trajectory(i))) {
+			std::cerr << "Replicate " << i << " differs between runs with the same seed" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Invalid ensembles
+bool ensemble_exceptions_test(const EnsembleSetup& setup)
+{
+	bool verbose = false;
+	const std::invalid_argument inv_arg("Invalid argument");
+	const std::runtime_error rt_err("Runtime error");
+
+	auto no_replicates = [&setup](){ Ensemble ensemble(setup, 0); };
+	if (!exception_test(verbose, &inv_arg, no_replicates)) {
+		std::cerr << "Ensemble without replicates should throw" << std::endl;
+		return false;
+	}
+	// Errors in the threads are passed to the caller
+	EnsembleSetup too_many(setup);
+	too_many.inf0 = {0, 100000000, 0};
+	auto run_too_many = [&too_many](){ Ensemble ensemble(too_many, 2, 1, 2); ensemble.run(); };
+	if (!exception_test(verbose, &rt_err, run_too_many)) {
+		std::cerr << "Errors in replicates should be rethrown" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Small ensemble of the test town
+EnsembleSetup create_setup()
+{
+	EnsembleSetup setup;
+	setup.input_files = "test_data/input_files_all.txt";
+	setup.dt = 0.25;
+	setup.n_steps = 10;
+	setup.inf0 = {0, 5, 100};
+	setup.initialize_simulations = true;
+	setup.N_active = {150, 10, 0};
+	return setup;
+}
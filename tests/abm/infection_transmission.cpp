@@ -9,10 +9,12 @@
 // Tests
 bool abm_contributions_test();
 bool abm_leisure_dist_test();
+bool abm_threaded_leisure_test();
 bool abm_events_test();
 bool abm_time_dependent_testing();
 bool abm_vaccination();
 bool abm_seeded();
+bool abm_recording_test();
 bool abm_vac_reopening_seeded_with_vaccinated();
 
 // Supporting functions
@@ -23,10 +25,12 @@ bool vaccinated_flag_check(const Agent& agent, const int);
 int main()
 {
 	test_pass(abm_leisure_dist_test(), "Assigning leisure locations");
+	test_pass(abm_threaded_leisure_test(), "Assigning leisure locations with threads");
 	test_pass(abm_events_test(), "Events");
 	test_pass(abm_time_dependent_testing(), "Time dependent testing");
 	test_pass(abm_vaccination(), "Vaccination");
 	test_pass(abm_seeded(), "Initializing with active COVID-19 cases");
+	test_pass(abm_recording_test(), "Recording time series");
 }
 
 bool abm_leisure_dist_test()
@@ -83,14 +87,14 @@ bool abm_leisure_dist_test()
 				} else {
 					// Should be properly removed
 					if (L_type0 == "household") {
-						std::vector<int> agent_IDs = households.at(L_ID0-1).get_agent_IDs();
+						std::vector<int> agent_IDs = households.at(L_ID0-1).get_visitor_IDs();
 						if ((std::find(agent_IDs.begin(), agent_IDs.end(), aID)) 
 										!= agent_IDs.end()) {
 							std::cerr << "Agent still registered in a household as a leisure location" << std::endl;
 							return false;	
 						}
 					} else if (L_type0 == "public") {
-						std::vector<int> agent_IDs = leisure_locations.at(L_ID0-1).get_agent_IDs();
+						std::vector<int> agent_IDs = leisure_locations.at(L_ID0-1).get_visitor_IDs();
 						if ((std::find(agent_IDs.begin(), agent_IDs.end(), aID)) 
 										!= agent_IDs.end()) {
 							std::cerr << "Agent still registered in the previous leisure location" << std::endl;
@@ -110,14 +114,14 @@ bool abm_leisure_dist_test()
 				// Should be added 
 				if (L_typeF == "household") {
 					++n_lhs;
-					std::vector<int> agent_IDs = households.at(L_IDF-1).get_agent_IDs();
+					std::vector<int> agent_IDs = households.at(L_IDF-1).get_visitor_IDs();
 					if ((std::find(agent_IDs.begin(), agent_IDs.end(), aID)) 
 									== agent_IDs.end()) {
 						std::cerr << "Agent not registered in a household as a leisure location" << std::endl;
 						return false;	
 					}
 				} else if (L_typeF == "public" && !leisure_locations.at(L_IDF-1).outside_town()) {
-					std::vector<int> agent_IDs = leisure_locations.at(L_IDF-1).get_agent_IDs();
+					std::vector<int> agent_IDs = leisure_locations.at(L_IDF-1).get_visitor_IDs();
 					if ((std::find(agent_IDs.begin(), agent_IDs.end(), aID)) 
 									== agent_IDs.end()) {
 						std::cerr << "Agent not registered in the leisure location" << std::endl;
@@ -149,6 +153,82 @@ bool abm_leisure_dist_test()
 	return true;
 }
 
+// Same leisure locations for any number of threads
+bool abm_threaded_leisure_test()
+{
+	std::string fin("test_data/input_files_all.txt");
+	double dt = 0.25;
+	int tmax = 4;
+	const unsigned int seed = 2022;
+
+	ABM abm(dt);
+	abm.simulation_setup(fin, {0, 0, 0});
+	std::vector<ABM> models(2, abm);
+	const std::vector<int> n_threads = {1, 3};
+	for (size_t i = 0; i < models.size(); ++i) {
+		models.at(i).set_number_of_threads(n_threads.at(i));
+		models.at(i).set_seed(seed);
+		models.at(i).seed_initially_infected({0, 10, 100});
+	}
+	for (int ti = 0; ti <= tmax; ++ti) {
+		for (auto& model : models) {
+			model.transmit_infection();
+		}
+		const std::vector<Agent>& agents = models.at(0).get_vector_of_agents();
+		const std::vector<Household>& households = models.at(0).get_vector_of_households();
+		const std::vector<Leisure>& leisure_locations = models.at(0).get_vector_of_leisure_locations();
+		int n_visits = 0;
+		for (const auto& agent : agents) {
+			n_visits += (agent.get_leisure_ID() > 0);
+		}
+		if (n_visits == 0) {
+			std::cerr << "No agents were assigned leisure locations" << std::endl;
+			return false;
+		}
+		for (size_t i = 1; i < models.size(); ++i) {
+			const std::vector<Agent>& other_agents = models.at(i).get_vector_of_agents();
+			for (size_t ia = 0; ia < agents.size(); ++ia) {
+				if (agents.at(ia).get_leisure_ID() != other_agents.at(ia).get_leisure_ID()
+						|| agents.at(ia).get_leisure_type() != other_agents.at(ia).get_leisure_type()) {
+					std::cerr << "Leisure location depends on the number of threads" << std::endl;
+					return false;
+				}
+			}
+			// Visitors registered in the same order
+			const std::vector<Household>& other_households = models.at(i).get_vector_of_households();
+			for (size_t ih = 0; ih < households.size(); ++ih) {
+				if (households.at(ih).get_visitor_IDs() != other_households.at(ih).get_visitor_IDs()) {
+					std::cerr << "Household visitors depend on the number of threads" << std::endl;
+					return false;
+				}
+			}
+			const std::vector<Leisure>& other_leisure = models.at(i).get_vector_of_leisure_locations();
+			for (size_t il = 0; il < leisure_locations.size(); ++il) {
+				if (leisure_locations.at(il).get_visitor_IDs() != other_leisure.at(il).get_visitor_IDs()) {
+					std::cerr << "Leisure location visitors depend on the number of threads" << std::endl;
+					return false;
+				}
+			}
+		}
+	}
+	std::vector<double> values_1, values_n;
+	models.at(0).get_time_series_values(values_1);
+	models.at(1).get_time_series_values(values_n);
+	if (values_1 != values_n) {
+		std::cerr << "Simulation depends on the number of threads" << std::endl;
+		return false;
+	}
+
+	bool verbose = false;
+	const std::invalid_argument inv_arg("Negative number of threads");
+	auto negative = [&abm](){ abm.set_number_of_threads(-1); };
+	if (!exception_test(verbose, &inv_arg, negative)) {
+		std::cerr << "Negative number of threads should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
 // Checks correct occurence and effects of different events in the simulation
 bool abm_events_test()
 {
@@ -228,6 +308,10 @@ bool abm_time_dependent_testing()
 	const std::map<std::string, double> infection_parameters = abm.get_infection_parameters();
    	const std::vector<std::vector<double>> exp_values = {{27.0, 0.1, 0.5}, {60.0, 1.0, 0.4}};	
 	double tol = 1e-3;
+	// Closure of leisure locations and a workplace absenteeism change
+	const double t_closure = 15.0, t_absent = 16.0, absent_psi = 0.2;
+	abm.schedule_event(t_closure, EventTimeline::leisure_fraction, 0.0);
+	abm.schedule_event(t_absent, EventTimeline::workplace_absenteeism, absent_psi);
 	double time = 0.0;
 	double flu_prob = 0.0;
 	int exp_num_changes = exp_values.size();
@@ -264,6 +348,23 @@ bool abm_time_dependent_testing()
 				return false;
 			}	
 		}
+		// Scheduled events
+		if (time >= t_closure - tol) {
+			for (const auto& agent : abm.get_vector_of_agents()) {
+				if (agent.get_leisure_ID() != 0) {
+					std::cerr << "Agent visiting a leisure location after closure" << std::endl;
+					return false;
+				}
+			}
+		}
+		if (time >= t_absent - tol) {
+			for (const auto& work : abm.get_vector_of_workplaces()) {
+				if (!float_equality<double>(work.get_absenteeism_correction(), absent_psi, 1e-5)) {
+					std::cerr << "Wrong workplace absenteeism correction after the change" << std::endl;
+					return false;
+				}
+			}
+		}
 		// Now check each switch 
 		for (const auto& tch : exp_values){
 			if (float_equality<double>(time, tch.at(0), tol)){
@@ -276,7 +377,7 @@ bool abm_time_dependent_testing()
 					!float_equality<double>(testing.get_exp_tested_prob(), tch.at(1), 1e-5) || 
 					!float_equality<double>(testing.get_prob_flu_tested(), flu_prob, 1e-5)){
 					std::cerr << "Wrong testing values at time " << time << std::endl;
-					//return false;
+					return false;
 				}	
 			}
 		}
@@ -343,6 +444,14 @@ bool abm_vaccination_random()
 				std::cerr << "Simulated number of vaccinated agents does not match the model " << actual_vac << std::endl;
 				return false;
 			}
+			// Eligible agents kept by the model match a check of all agents
+			Vaccinations vaccinations = abm.get_vaccinations_object();
+			int max_boost = 0;
+			if (!vaccinations.tracks_eligibility() || vaccinations.max_eligible_random(agents) 
+						!= vaccinations.filter_general(agents, max_boost).size()) {
+				std::cerr << "Wrong number of agents eligible for vaccination" << std::endl;
+				return false;
+			}
 			// IDs should be unique
 			std::vector<int> orig_vac = vac_IDs;
 			auto last = std::unique(vac_IDs.begin(), vac_IDs.end());
@@ -522,3 +631,65 @@ bool vaccinated_flag_check(const Agent& agent, const int min_vac_age)
 	return true;
 }
 
+/// Recorded time series against the values from getters
+bool abm_recording_test()
+{
+	std::string fin("test_data/input_files_all.txt");
+	std::string fout("test_data/recorded_time_series.csv");
+
+	double dt = 0.25;
+	int tmax = 20;
+	std::vector<int> N_covid{1500, 10, 0};
+	std::vector<int> initially_infected{0, 5, 100};
+	
+	ABM abm(dt);
+	abm.simulation_setup(fin, initially_infected);
+	abm.record_output(fout);
+	abm.initialize_simulations();
+	abm.initialize_active_cases(N_covid);
+	const int n_strains = abm.get_total_infected_strain().size();
+
+	// Expected - time, infected, each strain, exposed, total infected, 
+	// each strain, dead, recovered, tested positive, vaccinated 
+	std::vector<std::vector<double>> expected;
+	for (int ti = 0; ti<=tmax; ++ti) {
+		std::vector<double> row = {abm.get_time(), 
+			static_cast<double>(abm.get_num_infected())};
+		for (const auto& n_inf : abm.get_num_infected_strains(n_strains)) {
+			row.push_back(n_inf);
+		}
+		row.push_back(abm.get_num_exposed());
+		row.push_back(abm.get_total_infected());
+		for (const auto& n_inf : abm.get_total_infected_strain()) {
+			row.push_back(n_inf);
+		}
+		row.push_back(abm.get_total_dead());
+		row.push_back(abm.get_total_recovered());
+		row.push_back(abm.get_total_tested_positive());
+		row.push_back(abm.get_total_vaccinated());
+		expected.push_back(row);
+		abm.transmit_infection();
+	}
+	abm.stop_recording();
+
+	std::ifstream recorded(fout);
+	std::string line, field;
+	std::getline(recorded, line);
+	if (line.find("time,infected,infected strain 1,") != 0) {
+		std::cerr << "Wrong header of the recorded output: " << line << std::endl;
+		return false;
+	}
+	std::vector<std::vector<double>> values;
+	while (std::getline(recorded, line)) {
+		std::stringstream ss(line);
+		values.push_back({});
+		while (std::getline(ss, field, ',')) {
+			values.back().push_back(std::stod(field));
+		}
+	}
+	if (!is_equal_floats<double>(expected, values, 1e-10)) {
+		std::cerr << "Recorded values differ from the ABM state" << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,294 @@
+#include "abm_tests.h"
+
+/*****************************************************
+ *
+ * Test suite for per-phase step statistics
+ * and timelines of simulations
+ *
+ * Needs to be compiled with -DABM_PROFILING
+ *
+******************************************************/
+
+// Tests
+bool step_stats_test();
+bool step_stats_collection_test();
+bool rng_draws_test();
+bool timeline_test();
+
+// Supporting functions
+bool all_zero(const StepStats&);
+int count_occurrences(const std::string&, const std::string&);
+
+int main()
+{
+	test_pass(step_stats_test(), "StepStats functionality");
+	test_pass(rng_draws_test(), "Counting of RNG draws");
+	test_pass(step_stats_collection_test(), "Step statistics of a simulation");
+	test_pass(timeline_test(), "Timeline of a simulation");
+}
+
+/// Timing, counters, names, and reset of the stats object
+bool step_stats_test()
+{
+	bool verbose = false;
+	const std::invalid_argument inv_arg("Invalid argument");
+
+	if (!StepStats::enabled()) {
+		std::cerr << "Profiling should be enabled in this test" << std::endl;
+		return false;
+	}
+	StepStats stats;
+	if (!all_zero(stats)) {
+		return false;
+	}
+	stats.add_step();
+	stats.add_time(StepStats::distribute_leisure, 0.5);
+	stats.add_time(StepStats::distribute_leisure, 1.5);
+	stats.add_count(StepStats::distribute_leisure, StepStats::place_updates, 10);
+	stats.add_count(StepStats::distribute_leisure, StepStats::place_updates, 5);
+	if (stats.get_number_of_steps() != 1
+			|| stats.get_number_of_calls(StepStats::distribute_leisure) != 2
+			|| !float_equality<double>(stats.get_total_time(StepStats::distribute_leisure), 2.0, 1e-10)
+			|| !float_equality<double>(stats.get_max_time(StepStats::distribute_leisure), 1.5, 1e-10)
+			|| stats.get_count(StepStats::distribute_leisure, StepStats::place_updates) != 15
+			|| stats.get_number_of_calls(StepStats::vaccinate) != 0) {
+		return false;
+	}
+
+	// Scoped timer
+	{
+		StepStats::Timer timer(stats, StepStats::contact_tracing);
+		RNG rng(1);
+		rng.get_random_int(0, 10);
+	}
+	if (stats.get_number_of_calls(StepStats::contact_tracing) != 1
+			|| stats.get_total_time(StepStats::contact_tracing) < 0.0
+			|| stats.get_count(StepStats::contact_tracing, StepStats::rng_draws) == 0) {
+		std::cerr << "Timer did not register the call or its random numbers" << std::endl;
+		return false;
+	}
+
+	if (StepStats::phase_name(StepStats::compute_state_transitions) != "compute_state_transitions"
+			|| StepStats::counter_name(StepStats::rng_draws) != "RNG draws") {
+		return false;
+	}
+	auto wrong_phase = [](){ StepStats::phase_name(StepStats::n_phases); };
+	auto wrong_counter = [](){ StepStats::counter_name(StepStats::n_counters); };
+	if (!exception_test(verbose, &inv_arg, wrong_phase)
+			|| !exception_test(verbose, &inv_arg, wrong_counter)) {
+		return false;
+	}
+
+	stats.reset();
+	return all_zero(stats);
+}
+
+/// Generators count their outputs per thread
+bool rng_draws_test()
+{
+	RNG first(2021), second(2022);
+	const unsigned long long n0 = RNG::draws_in_this_thread();
+	const int n_int = 100;
+	for (int i = 0; i < n_int; ++i) {
+		first.get_random_int(0, 5);
+	}
+	// At least one draw each
+	if (RNG::draws_in_this_thread() - n0 < n_int) {
+		return false;
+	}
+	const unsigned long long n1 = RNG::draws_in_this_thread();
+	std::vector<int> v(50, 0);
+	std::iota(v.begin(), v.end(), 0);
+	second.vector_shuffle(v);
+	second.get_random(0.0, 1.0);
+	if (RNG::draws_in_this_thread() <= n1) {
+		return false;
+	}
+	// Counting does not change the numbers
+	RNG third(2021);
+	std::mt19937 plain(2021);
+	for (int i = 0; i < 10; ++i) {
+		std::uniform_int_distribution<int> dist(0, 1000);
+		if (third.get_random_int(0, 1000) != dist(plain)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Phases of transmit_infection and transmit_with_vac
+bool step_stats_collection_test()
+{
+	const std::string fin("test_data/input_files_all.txt");
+	const double dt = 0.25;
+	const int n_steps = 8;
+
+	ABM abm(dt);
+	abm.simulation_setup(fin, {0, 5, 100});
+	abm.initialize_simulations();
+	// Initialization can trace contacts
+	abm.reset_step_stats();
+	if (!all_zero(abm.get_step_stats())) {
+		return false;
+	}
+	for (int ti = 0; ti < n_steps; ++ti) {
+		abm.transmit_infection();
+	}
+
+	const StepStats& stats = abm.get_step_stats();
+	const unsigned long long n_agents = abm.get_vector_of_agents().size();
+	const unsigned long long n_places = abm.get_vector_of_households().size()
+			+ abm.get_vector_of_schools().size() + abm.get_vector_of_workplaces().size()
+			+ abm.get_vector_of_hospitals().size() + abm.get_vector_of_retirement_homes().size()
+			+ abm.get_vector_of_carpools().size() + abm.get_vector_of_public_transit().size()
+			+ abm.get_vector_of_leisure_locations().size();
+
+	if (stats.get_number_of_steps() != n_steps) {
+		return false;
+	}
+	const std::vector<StepStats::Phase> every_step = {StepStats::check_events,
+			StepStats::distribute_leisure, StepStats::compute_outside_locations,
+			StepStats::compute_place_contributions, StepStats::compute_state_transitions,
+			StepStats::reset_contributions};
+	for (const auto& phase : every_step) {
+		if (stats.get_number_of_calls(phase) != n_steps) {
+			std::cerr << "Wrong number of calls of " << StepStats::phase_name(phase) << std::endl;
+			return false;
+		}
+		if (stats.get_total_time(phase) <= 0.0
+				|| stats.get_max_time(phase) > stats.get_total_time(phase)) {
+			std::cerr << "Wrong time of " << StepStats::phase_name(phase) << std::endl;
+			return false;
+		}
+	}
+	if (stats.get_number_of_calls(StepStats::vaccinate) != 0) {
+		return false;
+	}
+
+	// Work of each phase
+	if (stats.get_count(StepStats::distribute_leisure, StepStats::agents) == 0
+			|| stats.get_count(StepStats::distribute_leisure, StepStats::agents) > n_steps*n_agents
+			|| stats.get_count(StepStats::distribute_leisure, StepStats::place_updates) == 0
+			|| stats.get_count(StepStats::distribute_leisure, StepStats::rng_draws) == 0) {
+		std::cerr << "Wrong counts in leisure distribution" << std::endl;
+		return false;
+	}
+	if (stats.get_count(StepStats::compute_place_contributions, StepStats::agents) == 0
+			|| stats.get_count(StepStats::compute_place_contributions, StepStats::place_updates) != n_steps*n_places) {
+		std::cerr << "Wrong counts in place contributions" << std::endl;
+		return false;
+	}
+	if (stats.get_count(StepStats::compute_state_transitions, StepStats::agents) == 0
+			|| stats.get_count(StepStats::compute_state_transitions, StepStats::agents) > n_steps*n_agents
+			|| stats.get_count(StepStats::compute_state_transitions, StepStats::rng_draws) == 0) {
+		std::cerr << "Wrong counts in state transitions" << std::endl;
+		return false;
+	}
+	if (stats.get_count(StepStats::reset_contributions, StepStats::place_updates) != n_steps*n_places) {
+		return false;
+	}
+	// Contact tracing is a part of state transitions
+	if (stats.get_total_time(StepStats::contact_tracing) > stats.get_total_time(StepStats::compute_state_transitions)
+			|| stats.get_count(StepStats::contact_tracing, StepStats::rng_draws)
+					> stats.get_count(StepStats::compute_state_transitions, StepStats::rng_draws)) {
+		std::cerr << "Contact tracing is not nested in state transitions" << std::endl;
+		return false;
+	}
+
+	// Summary has all the phases
+	std::ostringstream summary;
+	stats.print_summary(summary);
+	for (int ip = 0; ip < StepStats::n_phases; ++ip) {
+		if (summary.str().find(StepStats::phase_name(static_cast<StepStats::Phase>(ip))) == std::string::npos) {
+			std::cerr << "Summary is missing " << StepStats::phase_name(static_cast<StepStats::Phase>(ip)) << std::endl;
+			return false;
+		}
+	}
+
+	// Restart and vaccinate
+	abm.reset_step_stats();
+	if (!all_zero(abm.get_step_stats())) {
+		return false;
+	}
+	abm.transmit_with_vac();
+	if (stats.get_number_of_steps() != 1 || stats.get_number_of_calls(StepStats::vaccinate) != 1
+			|| stats.get_number_of_calls(StepStats::compute_outside_locations) != 0
+			|| stats.get_count(StepStats::vaccinate, StepStats::agents) != n_agents) {
+		std::cerr << "Wrong statistics of a step with vaccination" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// True if nothing was collected
+bool all_zero(const StepStats& stats)
+{
+	if (stats.get_number_of_steps() != 0) {
+		return false;
+	}
+	for (int ip = 0; ip < StepStats::n_phases; ++ip) {
+		const StepStats::Phase phase = static_cast<StepStats::Phase>(ip);
+		if (stats.get_number_of_calls(phase) != 0 || stats.get_total_time(phase) != 0.0
+				|| stats.get_max_time(phase) != 0.0) {
+			return false;
+		}
+		for (int ic = 0; ic < StepStats::n_counters; ++ic) {
+			if (stats.get_count(phase, static_cast<StepStats::Counter>(ic)) != 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/// Steps and phases in the trace
+bool timeline_test()
+{
+	const std::string fin("test_data/input_files_all.txt");
+	const int n_steps = 4;
+	std::shared_ptr<Tracer> tracer = std::make_shared<Tracer>(100000);
+
+	ABM abm(0.25);
+	abm.set_tracer(tracer);
+	abm.simulation_setup(fin, {0, 5, 100});
+	abm.initialize_simulations();
+	abm.record_output("test_data/timeline_out.csv");
+	for (int ti = 0; ti < n_steps; ++ti) {
+		abm.transmit_infection();
+	}
+	abm.stop_recording();
+	if (abm.get_tracer() != tracer) {
+		return false;
+	}
+
+	std::ostringstream out;
+	tracer->write_json(out);
+	const std::string json = out.str();
+	if (count_occurrences(json, "\"name\":\"step\"") != n_steps
+			|| count_occurrences(json, "\"name\":\"initialize_mobility\"") != 1
+			|| count_occurrences(json, "\"name\":\"Recorder::flush\"") != 1) {
+		std::cerr << "Wrong number of steps or setup events in the trace" << std::endl;
+		return false;
+	}
+	const std::vector<std::string> phases = {"check_events", "distribute_leisure",
+			"compute_outside_locations", "compute_place_contributions",
+			"compute_state_transitions", "reset_contributions"};
+	for (const auto& phase : phases) {
+		if (count_occurrences(json, "\"name\":\"" + phase + "\"") != n_steps) {
+			std::cerr << "Wrong number of " << phase << " events" << std::endl;
+			return false;
+		}
+	}
+	// Main thread and the writer of the recorder
+	return tracer->number_of_threads() == 2 && tracer->number_of_dropped_events() == 0;
+}
+
+/// Number of non-overlapping occurrences of what in text
+int count_occurrences(const std::string& text, const std::string& what)
+{
+	int n = 0;
+	for (size_t pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + what.size())) {
+		++n;
+	}
+	return n;
+}
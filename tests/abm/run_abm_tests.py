@@ -24,3 +24,14 @@ subprocess.call(['./con_test'], shell=True)
 ut.msg('ABM interface - infection transmission test', CYAN)
 subprocess.call(['./trans_inf_test'], shell=True)
 
+# Test suite 3
+ut.msg('ABM interface - ensembles', CYAN)
+subprocess.call(['./ensemble_test'], shell=True)
+
+# Test suite 4
+ut.msg('ABM interface - parameter sweeps', CYAN)
+subprocess.call(['./sweep_test'], shell=True)
+
+# Test suite 5
+ut.msg('ABM interface - step statistics', CYAN)
+subprocess.call(['./profiling_test'], shell=True)
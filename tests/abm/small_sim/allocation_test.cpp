@@ -0,0 +1,123 @@
+#include <atomic>
+#include <new>
+#include "abm_tests.h"
+
+/*****************************************************
+ *
+ * Test suite for heap allocations of simulation
+ * steps without any state changes
+ *
+ * Replaces the global operator new and delete
+ * to count the allocations, needs to be compiled
+ * as its own executable
+ *
+******************************************************/
+
+// Allocations counted only while true
+std::atomic<bool> counting(false);
+std::atomic<unsigned long long> n_allocations(0);
+
+void* operator new(std::size_t size)
+{
+	if (counting) {
+		++n_allocations;
+	}
+	void* ptr = std::malloc(size == 0 ? 1 : size);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+// Tests
+bool steady_state_test();
+bool steady_state_with_vac_test();
+
+// Supporting functions
+void setup_steady_state(ABM&);
+unsigned long long count_step_allocations(ABM&, const int, const bool);
+
+int main()
+{
+	test_pass(steady_state_test(), "No allocations in a steady-state step");
+	test_pass(steady_state_with_vac_test(), "No allocations in a steady-state step with vaccination");
+}
+
+/// Steps without infected agents and flu
+bool steady_state_test()
+{
+	const double dt = 0.25;
+	const int n_warm_up = 400;
+	const int n_steps = 40;
+
+	ABM abm(dt);
+	setup_steady_state(abm);
+	abm.reserve_daily_statistics(n_warm_up + n_steps);
+	// Buffers and visitor lists of places grow during the warm-up
+	count_step_allocations(abm, n_warm_up, false);
+	const unsigned long long n_step_allocs = count_step_allocations(abm, n_steps, false);
+	if (n_step_allocs != 0) {
+		std::cerr << "Steady-state steps allocated " << n_step_allocs << " times" << std::endl;
+		return false;
+	}
+	if (abm.get_num_infected() != 0) {
+		std::cerr << "Agents infected in a steady state" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Same with vaccination, with no agents vaccinated
+bool steady_state_with_vac_test()
+{
+	const double dt = 0.25;
+	const int n_warm_up = 400;
+	const int n_steps = 40;
+
+	ABM abm(dt);
+	setup_steady_state(abm);
+	abm.set_infection_parameter("vaccination rate", 0.0);
+	abm.reserve_daily_statistics(n_warm_up + n_steps);
+	count_step_allocations(abm, n_warm_up, true);
+	const unsigned long long n_step_allocs = count_step_allocations(abm, n_steps, true);
+	if (n_step_allocs != 0) {
+		std::cerr << "Steady-state steps with vaccination allocated "
+				  << n_step_allocs << " times" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Model where nothing changes state - no infected agents, no flu, no new strains,
+/// fixed seed so that the warm-up is the same in every run
+void setup_steady_state(ABM& abm)
+{
+	const std::string fin("test_data/input_files_small.txt");
+	abm.simulation_setup(fin, {0, 0, 0});
+	abm.set_seed(2022);
+	abm.set_infection_parameter("fraction with flu", 0.0);
+	abm.set_infection_parameter("fraction estimated infected", 0.0);
+	abm.set_infection_parameter("introduction of a new strain", 1000.0);
+	abm.initialize_simulations();
+}
+
+/// Number of allocations in n_steps steps of a simulation
+unsigned long long count_step_allocations(ABM& abm, const int n_steps, const bool with_vac)
+{
+	n_allocations = 0;
+	counting = true;
+	for (int ti = 0; ti < n_steps; ++ti) {
+		if (with_vac) {
+			abm.transmit_with_vac();
+		} else {
+			abm.transmit_infection();
+		}
+	}
+	counting = false;
+	return n_allocations;
+}
@@ -10,13 +10,21 @@ path = '../../../src/'
 cx = 'g++'
 std = '-std=c++11'
 opt = '-O0'
+# Background thread of the output recorder
+threads = '-pthread'
 # Common source files
 src_files = path + 'abm.cpp' 
 src_files += ' ' + path + 'data_management_interface.cpp'
 src_files += ' ' + path + 'agent.cpp' 
 src_files += ' ' + path + 'infection.cpp'
 src_files += ' ' + path + 'mobility.cpp'
+src_files += ' ' + path + 'town.cpp'
+src_files += ' ' + path + 'step_stats.cpp'
+src_files += ' ' + path + 'event_timeline.cpp'
+src_files += ' ' + path + 'distributed/household_partition.cpp'
 src_files += ' ' + path + 'testing.cpp'
+src_files += ' ' + path + 'vaccinations.cpp'
+src_files += ' ' + path + 'contact_tracing.cpp'
 src_files += ' ' + path + 'contributions.cpp'
 src_files += ' ' + path + 'transitions/transitions.cpp'
 src_files += ' ' + path + 'transitions/regular_transitions.cpp'
@@ -28,6 +36,8 @@ src_files += ' ' + path + 'states_manager/regular_states_manager.cpp'
 src_files += ' ' + path + 'states_manager/hsp_employee_states_manager.cpp'
 src_files += ' ' + path + 'flu.cpp'
 src_files += ' ' + path + 'utils.cpp'
+src_files += ' ' + path + 'three_part_function.cpp'
+src_files += ' ' + path + 'four_part_function.cpp'
 src_files += ' ' + path + 'places/place.cpp'
 src_files += ' ' + path + 'places/household.cpp'
 src_files += ' ' + path + 'places/workplace.cpp'
@@ -38,6 +48,12 @@ src_files += ' ' + path + 'places/transit.cpp'
 src_files += ' ' + path + 'places/leisure.cpp'
 src_files += ' ' + path + 'io_operations/FileHandler.cpp'
 src_files += ' ' + path + 'io_operations/load_parameters.cpp'
+src_files += ' ' + path + 'io_operations/mapped_reader.cpp'
+src_files += ' ' + path + 'io_operations/town_image.cpp'
+src_files += ' ' + path + 'io_operations/recorder.cpp'
+src_files += ' ' + path + 'io_operations/tracer.cpp'
+src_files += ' ' + path + 'ensemble.cpp'
+src_files += ' ' + path + 'parameter_sweep.cpp'
 tst_files = '../../common/test_utils.cpp'
 # Directory with files for testing
 data_dir = './test_data/'
@@ -63,7 +79,14 @@ for file_rm in const_files:
 exe_name = 'stst'
 # Files needed only for this build
 spec_files = 'small_test.cpp '
-compile_com = ' '.join([cx, std, opt, '-o', exe_name, spec_files, tst_files, src_files])
+compile_com = ' '.join([cx, std, opt, threads, '-o', exe_name, spec_files, tst_files, src_files])
 subprocess.call([compile_com], shell=True)
 
-
+# Test 2
+# Heap allocations of steady-state steps, replaces
+# the global operator new so needs its own executable
+exe_name = 'allocation_test'
+# Files needed only for this build
+spec_files = 'allocation_test.cpp '
+compile_com = ' '.join([cx, std, opt, threads, '-o', exe_name, spec_files, tst_files, src_files])
+subprocess.call([compile_com], shell=True)
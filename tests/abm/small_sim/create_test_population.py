@@ -1,14 +1,8 @@
 #
-# Script for generating population files for 
-#	running contributions tests
+# Script for generating a small town and population 
+#	for running the small simulation tests
 #
 
-# Actual workplace IDs here will be invalid 
-# That is, special IDs are correct but not
-# the global IDs - this does not impact the
-# results of the tests and will be fixed in 
-# the future
-
 import random
 
 # Input file with info on population
@@ -23,18 +17,32 @@ n_rh = 1
 n_schools = 3
 n_carpools = 14
 n_public = 8 
+n_leisure = 10
 n_inf0 = 1
 
+# Places are the first ones of the full test town
+place_files = {'NR_households.txt' : n_houses, 'NR_workplaces.txt' : n_works,
+				'NR_hospitals.txt' : n_hsp, 'NR_retirement_homes.txt' : n_rh,
+				'NR_schools.txt' : n_schools, 'NR_carpool.txt' : n_carpools,
+				'NR_public.txt' : n_public, 'NR_leisure.txt' : n_leisure}
+for fname, n_places in place_files.items():
+	with open('../test_data/' + fname, 'r') as fin, open('test_data/' + fname, 'w') as fout:
+		for i in range(n_places):
+			fout.write(fin.readline())
+
 # Transit choices
 transit_modes = ['car', 'carpool', 'public', 'walk', 'other']
+# Occupation choices
+occupations = ['A', 'B', 'C', 'D', 'E']
 
 # IDs of initially infected
 inf_agents = random.sample(range(1,n_agents+1), n_inf0);
 
 with open(agents_in, 'w') as fout:
 	for i in range(1,n_agents+1):
-		agent = ['0']*21
-	
+		agent = ['0']*22
+		# Default occupation
+		agent[21] = 'none'	
 		# Age and location
 		agent[2] = str(random.randint(0,110))
 		agent[3] = str(random.random()*10)
@@ -67,6 +75,8 @@ with open(agents_in, 'w') as fout:
 		# Hospital staff
 		if random.random() < 0.2:
 			print('Agent works in a hospital')
+			# Occupation
+			agent[21] = 'A'
 			agent[12] = '1' 
 			agent[13] = str(random.randint(1,n_hsp))
 			# Time to reach work
@@ -89,6 +99,8 @@ with open(agents_in, 'w') as fout:
 		# Retirement homes
 		if random.random() < 0.3:
 			print('Agent works in a retirement home')
+			# Occupation
+			agent[21] = 'A'
 			agent[1] = '1' 
 			agent[9] = '1'
 			agent[11] = str(random.randint(1,n_rh))
@@ -112,6 +124,8 @@ with open(agents_in, 'w') as fout:
 		# Works at school
 		if random.random() < 0.3:
 			print('Agent works at school')
+			# Occupation
+			agent[21] = 'A'
 			agent[1] = '1' 
 			agent[10] = '1'
 			agent[11] = str(random.randint(1,n_schools))
@@ -135,6 +149,8 @@ with open(agents_in, 'w') as fout:
 		# Works elsewhere
 		if random.random() < 0.4:
 			agent[1] = '1' 
+			# Occupation
+			agent[21] = random.choice(occupations)
 			agent[11] = str(random.randint(1, n_works))
 			if random.random() < 0.1:
 				agent[15] = '1'
@@ -1,7 +1,7 @@
 import subprocess
 
 import sys
-py_path = '../../scripts/'
+py_path = '../../../scripts/'
 sys.path.insert(0, py_path)
 
 import utils as ut
@@ -12,6 +12,8 @@ from colors import *
 #
 
 # Compile
-subprocess.call(['python3.6 compilation.py'], shell=True)
-
+subprocess.call(['python3 compilation.py'], shell=True)
 
+# Test suite 1
+ut.msg('ABM interface - allocations of steady-state steps', CYAN)
+subprocess.call(['./allocation_test'], shell=True)
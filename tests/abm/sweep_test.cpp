@@ -0,0 +1,235 @@
+#include "abm_tests.h"
+#include "../../include/parameter_sweep.h"
+
+/*****************************************************
+ *
+ * Test suite for parameter sweeps and changing
+ * parameters of a set up model
+ *
+******************************************************/
+
+// Tests
+bool sweep_output_test(const EnsembleSetup&);
+bool sweep_setup_parameter_test(const EnsembleSetup&);
+bool parameter_change_test(const EnsembleSetup&);
+bool sweep_exceptions_test(const EnsembleSetup&);
+
+// Supporting functions
+EnsembleSetup create_setup();
+std::vector<std::vector<double>> read_sweep_output(const std::string&, std::vector<std::string>&);
+
+// Files created by the tests
+// ./test_data/sweep_out.csv
+// ./test_data/sweep_out_serial.csv
+// ./test_data/sweep_out_setup.csv
+
+int main()
+{
+	const EnsembleSetup setup = create_setup();
+	test_pass(sweep_output_test(setup), "Parameter sweep grid and output");
+	test_pass(sweep_setup_parameter_test(setup), "Parameter sweep over a setup parameter");
+	test_pass(parameter_change_test(setup), "Changing parameters of a set up model");
+	test_pass(sweep_exceptions_test(setup), "Parameter sweep exceptions");
+}
+
+/// Infection and vaccination parameters, replicates, and the indexed output
+bool sweep_output_test(const EnsembleSetup& setup)
+{
+	const std::vector<SweepParameter> parameters = {
+		{"fraction false negative - strain 2", SweepParameter::infection, {0.1, 0.3}},
+		{"Effectiveness reduction for strain 2", SweepParameter::vaccination, {0.5, 0.7, 0.9}}};
+	const int n_replicates = 2;
+	ParameterSweep sweep(setup, parameters, n_replicates, 2022, 2);
+	if (sweep.sets_up_each_point() || sweep.number_of_points() != 6) {
+		return false;
+	}
+	// Last parameter changes fastest
+	if (sweep.get_point(0) != std::vector<double>({0.1, 0.5})
+			|| sweep.get_point(2) != std::vector<double>({0.1, 0.9})
+			|| sweep.get_point(4) != std::vector<double>({0.3, 0.7})) {
+		std::cerr << "Wrong order of grid points" << std::endl;
+		return false;
+	}
+	sweep.run("test_data/sweep_out.csv");
+
+	std::vector<std::string> header;
+	std::vector<std::vector<double>> rows = read_sweep_output("test_data/sweep_out.csv", header);
+	const std::vector<std::string> first_columns = {"time", "grid point", "replicate",
+		"fraction false negative - strain 2", "Effectiveness reduction for strain 2", "infected"};
+	if (header.size() < first_columns.size()
+			|| !std::equal(first_columns.begin(), first_columns.end(), header.begin())) {
+		std::cerr << "Wrong columns in the sweep output" << std::endl;
+		return false;
+	}
+	const int n_steps = setup.n_steps + 1;
+	if (rows.size() != sweep.number_of_points()*n_replicates*n_steps) {
+		std::cerr << "Wrong number of rows in the sweep output: " << rows.size() << std::endl;
+		return false;
+	}
+	// Runs are contiguous and carry their parameter values
+	std::vector<int> n_runs(sweep.number_of_points()*n_replicates, 0);
+	const int i_tot = std::find(header.begin(), header.end(), "total infected") - header.begin();
+	for (int ir = 0; ir < rows.size(); ir += n_steps) {
+		const int point = static_cast<int>(rows.at(ir).at(1));
+		const int rep = static_cast<int>(rows.at(ir).at(2));
+		++n_runs.at(point*n_replicates + rep);
+		for (int ti = 0; ti < n_steps; ++ti) {
+			const std::vector<double>& row = rows.at(ir + ti);
+			if (static_cast<int>(row.at(1)) != point || static_cast<int>(row.at(2)) != rep
+					|| !float_equality<double>(row.at(0), ti*setup.dt, 1e-10)
+					|| !float_equality<double>(row.at(3), sweep.get_point(point).at(0), 1e-10)
+					|| !float_equality<double>(row.at(4), sweep.get_point(point).at(1), 1e-10)) {
+				std::cerr << "Wrong run indices, time, or parameters in the sweep output" << std::endl;
+				return false;
+			}
+		}
+		// Same seeding at every point
+		if (static_cast<int>(rows.at(ir).at(i_tot)) !=
+				std::accumulate(setup.inf0.begin(), setup.inf0.end(), 0) + setup.N_active.at(0)) {
+			return false;
+		}
+	}
+	if (std::count(n_runs.begin(), n_runs.end(), 1) != n_runs.size()) {
+		std::cerr << "Every run should be in the output exactly once" << std::endl;
+		return false;
+	}
+
+	// Same results with one thread, up to the order of runs
+	ParameterSweep serial(setup, parameters, n_replicates, 2022, 1);
+	serial.run("test_data/sweep_out_serial.csv");
+	std::vector<std::string> serial_header;
+	std::vector<std::vector<double>> serial_rows = read_sweep_output("test_data/sweep_out_serial.csv", serial_header);
+	std::sort(rows.begin(), rows.end());
+	std::sort(serial_rows.begin(), serial_rows.end());
+	if (serial_header != header || !is_equal_exact(rows, serial_rows)) {
+		std::cerr << "Sweep results depend on the number of threads" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Parameter that requires setting up each point separately
+bool sweep_setup_parameter_test(const EnsembleSetup& setup)
+{
+	const std::vector<SweepParameter> parameters = {
+		{"household scaling parameter", SweepParameter::infection, {0.5, 1.0}}};
+	ParameterSweep sweep(setup, parameters, 2, 7, 2);
+	if (!sweep.sets_up_each_point()) {
+		return false;
+	}
+	sweep.run("test_data/sweep_out_setup.csv", Recorder::csv);
+	std::vector<std::string> header;
+	std::vector<std::vector<double>> rows = read_sweep_output("test_data/sweep_out_setup.csv", header);
+	if (rows.size() != 2*2*(setup.n_steps + 1) || header.at(3) != "household scaling parameter") {
+		return false;
+	}
+	for (const auto& row : rows) {
+		if (!float_equality<double>(row.at(3), sweep.get_point(static_cast<int>(row.at(1))).at(0), 1e-10)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Direct changes of parameters and their limits
+bool parameter_change_test(const EnsembleSetup& setup)
+{
+	bool verbose = false;
+	const std::invalid_argument inv_arg("Invalid argument");
+
+	ABM abm(setup.dt);
+	abm.set_parameter_overrides({{"fraction false negative - strain 2", 0.25}},
+								{{"Effectiveness reduction for strain 2", 0.4}});
+	std::vector<int> no_infected(setup.inf0.size(), 0);
+	abm.simulation_setup(setup.input_files, no_infected);
+	if (!float_equality<double>(abm.get_infection_parameters().at("fraction false negative - strain 2"), 0.25, 1e-10)
+			|| !float_equality<double>(abm.get_vaccinations_object().get_vaccination_parameters().at("Effectiveness reduction for strain 2"), 0.4, 1e-10)) {
+		std::cerr << "Overrides were not applied during setup" << std::endl;
+		return false;
+	}
+	abm.set_infection_parameter("fraction false negative - strain 2", 0.5);
+	abm.set_vaccination_parameter("Effectiveness reduction for strain 2", 0.8);
+	if (!float_equality<double>(abm.get_infection_parameters().at("fraction false negative - strain 2"), 0.5, 1e-10)
+			|| !float_equality<double>(abm.get_vaccinations_object().get_vaccination_parameters().at("Effectiveness reduction for strain 2"), 0.8, 1e-10)) {
+		return false;
+	}
+
+	auto unknown_inf = [&abm](){ abm.set_infection_parameter("no such parameter", 1.0); };
+	auto setup_inf = [&abm](){ abm.set_infection_parameter("household scaling parameter", 1.0); };
+	auto unknown_vac = [&abm](){ abm.set_vaccination_parameter("no such parameter", 1.0); };
+	auto structural_vac = [&abm](){ abm.set_vaccination_parameter("Number of strains", 2.0); };
+	if (!exception_test(verbose, &inv_arg, unknown_inf) || !exception_test(verbose, &inv_arg, setup_inf)
+			|| !exception_test(verbose, &inv_arg, unknown_vac) || !exception_test(verbose, &inv_arg, structural_vac)) {
+		std::cerr << "Invalid parameter changes should throw" << std::endl;
+		return false;
+	}
+	ABM wrong_override(setup.dt);
+	wrong_override.set_parameter_overrides({{"no such parameter", 1.0}});
+	auto setup_wrong = [&wrong_override, &setup, &no_infected](){
+		wrong_override.simulation_setup(setup.input_files, no_infected); };
+	if (!exception_test(verbose, &inv_arg, setup_wrong)) {
+		std::cerr << "Overriding a non-existing parameter should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Invalid sweeps
+bool sweep_exceptions_test(const EnsembleSetup& setup)
+{
+	bool verbose = false;
+	const std::invalid_argument inv_arg("Invalid argument");
+
+	auto no_replicates = [&setup](){
+		ParameterSweep sweep(setup, {{"fraction false negative - strain 2", SweepParameter::infection, {0.1}}}, 0); };
+	auto no_parameters = [&setup](){ ParameterSweep sweep(setup, {}, 1); };
+	auto no_values = [&setup](){
+		ParameterSweep sweep(setup, {{"fraction false negative - strain 2", SweepParameter::infection, {}}}, 1); };
+	auto repeated = [&setup](){
+		ParameterSweep sweep(setup, {{"fraction false negative - strain 2", SweepParameter::infection, {0.1}},
+									{"fraction false negative - strain 2", SweepParameter::infection, {0.2}}}, 1); };
+	auto unknown = [&setup](){
+		ParameterSweep sweep(setup, {{"no such parameter", SweepParameter::vaccination, {0.1}}}, 1); };
+	if (!exception_test(verbose, &inv_arg, no_replicates) || !exception_test(verbose, &inv_arg, no_parameters)
+			|| !exception_test(verbose, &inv_arg, no_values) || !exception_test(verbose, &inv_arg, repeated)
+			|| !exception_test(verbose, &inv_arg, unknown)) {
+		std::cerr << "Invalid sweeps should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Short runs in the test town
+EnsembleSetup create_setup()
+{
+	EnsembleSetup setup;
+	setup.input_files = "test_data/input_files_all.txt";
+	setup.dt = 0.25;
+	setup.n_steps = 4;
+	setup.inf0 = {0, 5, 100};
+	setup.initialize_simulations = true;
+	setup.N_active = {150, 10, 0};
+	return setup;
+}
+
+/// Header and values of a CSV sweep output
+std::vector<std::vector<double>> read_sweep_output(const std::string& fname, std::vector<std::string>& header)
+{
+	std::ifstream fin(fname);
+	std::string line, field;
+	std::getline(fin, line);
+	std::stringstream ss_header(line);
+	header.clear();
+	while (std::getline(ss_header, field, ',')) {
+		header.push_back(field);
+	}
+	std::vector<std::vector<double>> rows;
+	while (std::getline(fin, line)) {
+		std::stringstream ss(line);
+		rows.push_back({});
+		while (std::getline(ss, field, ',')) {
+			rows.back().push_back(std::stod(field));
+		}
+	}
+	return rows;
+}
@@ -1,6 +1,7 @@
 #include "../../include/contact_tracing.h" 
 #include "../../include/abm.h"
 #include "../common/test_utils.h"
+#include <set>
 
 /***************************************************** 
  *
@@ -10,24 +11,32 @@
 
 // Tests
 bool tracking_visits_tests();
+bool visits_wrap_around_test();
 bool quarantining_household_test();
 bool quarantining_visits_test();
 bool quarantining_workplaces_test();
 bool quarantining_hospitals_test();
 bool quarantining_rh_test();
 bool quarantining_schools_test();
+bool school_class_index_test();
+bool bulk_removals_test();
 bool quarantining_carpools_test();
+bool isolation_changes_test();
 
 int main()
 {
 	test_pass(tracking_visits_tests(), "Collecting visited households");
+	test_pass(visits_wrap_around_test(), "Replacing and forgetting visited households");
 	test_pass(quarantining_household_test(), "Quarantining a household");
 	test_pass(quarantining_visits_test(), "Quarantining guest households");
 	test_pass(quarantining_workplaces_test(), "Quarantining workplaces");
 	test_pass(quarantining_hospitals_test(), "Quarantining hospitals");
 	test_pass(quarantining_rh_test(), "Quarantining retirement homes");
 	test_pass(quarantining_schools_test(), "Quarantining schools");
+	test_pass(school_class_index_test(), "Classes and staff of schools");
+	test_pass(bulk_removals_test(), "Removing quarantined agents from places together");
 	test_pass(quarantining_carpools_test(), "Quarantining carpools");
+	test_pass(isolation_changes_test(), "Recording changes of household isolation");
 }
 
 bool tracking_visits_tests()
@@ -115,6 +124,57 @@ bool tracking_visits_tests()
 }
 
 // Test for agent's household isolation
+// Oldest visits are replaced, isolation uses and forgets all 
+bool visits_wrap_around_test()
+{
+	const int n_agents = 3, n_houses = 20, max_visits = 3;
+	const double dt = 1.0;
+	Infection infection(dt);
+	std::vector<Household> houses;
+	for (int ih = 1; ih <= n_houses; ++ih) {
+		houses.emplace_back(ih, 0.0, 0.0, 0.8, 1.0, 1);
+		houses.back().register_agent(ih);
+	}
+	Contact_tracing contact_tracing(n_agents, n_houses, max_visits);
+
+	// Seven visits, only the last three are kept, in order
+	for (int iv = 1; iv <= 7; ++iv) {
+		contact_tracing.add_household(2, iv + 10, iv);
+	}
+	std::deque<std::vector<int>> visits = contact_tracing.get_private_leisure().at(1);
+	if (visits != std::deque<std::vector<int>>({{15, 5}, {16, 6}, {17, 7}})) {
+		std::cerr << "Wrong visits kept after replacing the oldest" << std::endl;
+		return false;
+	}
+	if (!contact_tracing.get_private_leisure().at(0).empty() 
+			|| !contact_tracing.get_private_leisure().at(2).empty()) {
+		std::cerr << "Visits of one agent stored for another" << std::endl;
+		return false;
+	}
+
+	// Visit on day 5 is too old, the other two households isolate
+	std::vector<int> traced = contact_tracing.isolate_visited_households(2, houses, 1.0, infection, 9, dt);
+	std::sort(traced.begin(), traced.end());
+	if (traced != std::vector<int>({16, 17}) || contact_tracing.house_is_isolated(15)
+			|| !contact_tracing.house_is_isolated(16) || !contact_tracing.house_is_isolated(17)) {
+		std::cerr << "Wrong households isolated from the stored visits" << std::endl;
+		return false;
+	}
+	if (!contact_tracing.get_private_leisure().at(1).empty()) {
+		std::cerr << "Visits should be forgotten after isolation" << std::endl;
+		return false;
+	}
+
+	// Storage is reused
+	contact_tracing.add_household(2, 1, 10);
+	visits = contact_tracing.get_private_leisure().at(1);
+	if (visits != std::deque<std::vector<int>>({{1, 10}})) {
+		std::cerr << "Wrong visits after reusing the storage" << std::endl;
+		return false;
+	}
+	return true;
+}
+
 bool quarantining_household_test()
 {
 	// Model parameters and output
@@ -509,6 +569,151 @@ bool quarantining_schools_test()
 	return true;
 }
 
+// Classes and staff match the school members as they leave and return
+bool school_class_index_test()
+{
+	double dt = 2.0;
+	std::string fin("test_data/input_files_all.txt");
+	std::vector<int> initially_infected{0, 5, 100};
+
+	ABM abm(dt);
+	abm.simulation_setup(fin, initially_infected);
+	std::vector<School>& schools = abm.vector_of_schools();
+	const std::vector<Agent>& agents = abm.get_vector_of_agents();
+
+	// Students and employees among the members, in the same order;
+	// agents that both study and work there are members twice
+	auto matches_members = [&agents](const School& sch) {
+		std::map<int, std::vector<int>> students;
+		std::vector<int> staff;
+		std::set<int> seen;
+		for (const auto& aID : sch.get_agent_IDs()) {
+			if (!seen.insert(aID).second) {
+				continue;
+			}
+			const Agent& agent = agents.at(aID-1);
+			if (agent.student() && agent.get_school_ID() == sch.get_ID()) {
+				students[agent.get_age()].push_back(aID);
+			}
+			if (agent.school_employee() && agent.get_work_ID() == sch.get_ID()) {
+				staff.push_back(aID);
+			}
+		}
+		for (const auto& age_class : sch.get_students_by_age()) {
+			if (age_class.second != students[age_class.first]) {
+				return false;
+			}
+		}
+		for (const auto& age_class : students) {
+			if (!age_class.second.empty() 
+					&& sch.get_students_by_age().count(age_class.first) == 0) {
+				return false;
+			}
+		}
+		return staff == sch.get_employee_IDs();
+	};
+
+	int n_students = 0;
+	for (auto& sch : schools) {
+		if (!matches_members(sch)) {
+			std::cerr << "Classes or staff differ from members of school " << sch.get_ID() << std::endl;
+			return false;
+		}
+		for (const auto& age_class : sch.get_students_by_age()) {
+			n_students += age_class.second.size();
+		}
+		// Every third member leaves, then half of them return
+		std::vector<int> leaving;
+		const std::vector<int>& members = sch.get_agent_IDs();
+		for (size_t i = 0; i < members.size(); i += 3) {
+			leaving.push_back(members.at(i));
+		}
+		for (const auto& aID : leaving) {
+			sch.remove_agent(aID);
+		}
+		if (!matches_members(sch)) {
+			std::cerr << "Classes or staff not updated after removal" << std::endl;
+			return false;
+		}
+		for (size_t i = 0; i < leaving.size(); i += 2) {
+			sch.add_agent(leaving.at(i));
+		}
+		if (!matches_members(sch)) {
+			std::cerr << "Classes or staff not updated after return" << std::endl;
+			return false;
+		}
+	}
+	if (n_students == 0) {
+		std::cerr << "No students in the classes" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Removals collected from many agents give the same places as one by one
+bool bulk_removals_test()
+{
+	double dt = 2.0;
+	std::string fin("test_data/input_files_all.txt");
+	std::vector<int> initially_infected{0, 5, 100};
+
+	ABM abm(dt);
+	abm.simulation_setup(fin, initially_infected);
+	std::vector<School> schools = abm.get_copied_vector_of_schools();
+	std::vector<Workplace> workplaces = abm.get_copied_vector_of_workplaces();
+	std::vector<School> schools_one = schools;
+	std::vector<Workplace> workplaces_one = workplaces;
+	const std::vector<Agent>& agents = abm.get_vector_of_agents();
+
+	// Every fifth student and worker, some more than once
+	PlaceRemovals removals;
+	for (const auto& agent : agents) {
+		if (agent.get_ID()%5 != 0) {
+			continue;
+		}
+		const int aID = agent.get_ID();
+		if (agent.student()) {
+			removals.emplace_back(&schools.at(agent.get_school_ID()-1), aID);
+			schools_one.at(agent.get_school_ID()-1).remove_agent(aID);
+		}
+		if (agent.works() && !agent.works_from_home() && !agent.hospital_employee()
+				&& !agent.retirement_home_employee()) {
+			if (agent.school_employee()) {
+				removals.emplace_back(&schools.at(agent.get_work_ID()-1), aID);
+				schools_one.at(agent.get_work_ID()-1).remove_agent(aID);
+			} else {
+				removals.emplace_back(&workplaces.at(agent.get_work_ID()-1), aID);
+				removals.emplace_back(&workplaces.at(agent.get_work_ID()-1), aID);
+				workplaces_one.at(agent.get_work_ID()-1).remove_agent(aID);
+			}
+		}
+	}
+	if (removals.empty()) {
+		std::cerr << "No agents to remove" << std::endl;
+		return false;
+	}
+	Transitions::remove_from_places(removals);
+	if (!removals.empty()) {
+		std::cerr << "Removals should be cleared" << std::endl;
+		return false;
+	}
+	for (size_t i = 0; i < schools.size(); ++i) {
+		if (schools.at(i).get_agent_IDs() != schools_one.at(i).get_agent_IDs()
+				|| schools.at(i).get_students_by_age() != schools_one.at(i).get_students_by_age()
+				|| schools.at(i).get_employee_IDs() != schools_one.at(i).get_employee_IDs()) {
+			std::cerr << "Wrong members of school " << i + 1 << std::endl;
+			return false;
+		}
+	}
+	for (size_t i = 0; i < workplaces.size(); ++i) {
+		if (workplaces.at(i).get_agent_IDs() != workplaces_one.at(i).get_agent_IDs()) {
+			std::cerr << "Wrong members of workplace " << i + 1 << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
 // Test for agent's carpool isolation
 bool quarantining_carpools_test()
 {
@@ -564,3 +769,55 @@ bool quarantining_carpools_test()
 	return true;
 }
 
+// Log of isolated and released households used by distributed runs
+bool isolation_changes_test()
+{
+	const int n_agents = 10, n_houses = 5, max_visits = 4;
+	const double dt = 1.0;
+	Infection infection(dt);
+	std::vector<Household> houses;
+	for (int ih = 1; ih <= n_houses; ++ih) {
+		houses.emplace_back(ih, 0.0, 0.0, 0.8, 1.0, 1);
+		houses.back().register_agent(2*ih-1);
+		houses.back().register_agent(2*ih);
+	}
+	Contact_tracing contact_tracing(n_agents, n_houses, max_visits);
+
+	// Nothing recorded unless requested
+	contact_tracing.add_household(1, 2, 0);
+	contact_tracing.isolate_visited_households(1, houses, 1.0, infection, 0, dt);
+	contact_tracing.reset_house_isolation(2);
+	if (!contact_tracing.take_isolation_changes().empty()) {
+		std::cerr << "Changes should not be recorded by default" << std::endl;
+		return false;
+	}
+
+	contact_tracing.track_isolation_changes(true);
+	contact_tracing.add_household(1, 2, 1);
+	contact_tracing.add_household(1, 4, 1);
+	std::vector<int> traced = contact_tracing.isolate_visited_households(1, houses, 1.0, infection, 1, dt);
+	if (traced.size() != 4) {
+		std::cerr << "Wrong number of traced members of visited households" << std::endl;
+		return false;
+	}
+	// Only actual changes, in order
+	contact_tracing.reset_house_isolation(4);
+	contact_tracing.reset_house_isolation(3);
+	if (contact_tracing.take_isolation_changes() != std::vector<int>({2, 4, -4})) {
+		std::cerr << "Wrong recorded isolation changes" << std::endl;
+		return false;
+	}
+	if (!contact_tracing.take_isolation_changes().empty()) {
+		std::cerr << "Changes should be cleared after they are taken" << std::endl;
+		return false;
+	}
+	// Flags set from outside are not recorded
+	contact_tracing.set_house_isolation(5, true);
+	contact_tracing.set_house_isolation(2, false);
+	if (!contact_tracing.house_is_isolated(5) || contact_tracing.house_is_isolated(2)
+			|| !contact_tracing.take_isolation_changes().empty()) {
+		std::cerr << "Setting the flags directly should not be recorded" << std::endl;
+		return false;
+	}
+	return true;
+}
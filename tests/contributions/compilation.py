@@ -10,12 +10,18 @@ path = '../../src/'
 cx = 'g++'
 std = '-std=c++11'
 opt = '-O0'
+# Background thread of the output recorder
+threads = '-pthread'
 # Common source files
 src_files = path + 'abm.cpp' 
 src_files += ' ' + path + 'data_management_interface.cpp'
 src_files += ' ' + path + 'agent.cpp' 
 src_files += ' ' + path + 'infection.cpp'
 src_files += ' ' + path + 'mobility.cpp'
+src_files += ' ' + path + 'town.cpp'
+src_files += ' ' + path + 'step_stats.cpp'
+src_files += ' ' + path + 'event_timeline.cpp'
+src_files += ' ' + path + 'distributed/household_partition.cpp'
 src_files += ' ' + path + 'testing.cpp'
 src_files += ' ' + path + 'vaccinations.cpp'
 src_files += ' ' + path + 'contact_tracing.cpp'
@@ -42,6 +48,12 @@ src_files += ' ' + path + 'places/transit.cpp'
 src_files += ' ' + path + 'places/leisure.cpp'
 src_files += ' ' + path + 'io_operations/FileHandler.cpp'
 src_files += ' ' + path + 'io_operations/load_parameters.cpp'
+src_files += ' ' + path + 'io_operations/mapped_reader.cpp'
+src_files += ' ' + path + 'io_operations/town_image.cpp'
+src_files += ' ' + path + 'io_operations/recorder.cpp'
+src_files += ' ' + path + 'io_operations/tracer.cpp'
+src_files += ' ' + path + 'ensemble.cpp'
+src_files += ' ' + path + 'parameter_sweep.cpp'
 tst_files = '../common/test_utils.cpp'
 # Directory with files for testing
 data_dir = './test_data/'
@@ -56,6 +68,6 @@ data_dir = './test_data/'
 exe_name = 'con_test'
 # Files needed only for this build
 spec_files = 'contributions_tests.cpp '
-compile_com = ' '.join([cx, std, opt, '-o', exe_name, spec_files, tst_files, src_files])
+compile_com = ' '.join([cx, std, opt, threads, '-o', exe_name, spec_files, tst_files, src_files])
 subprocess.call([compile_com], shell=True)
 
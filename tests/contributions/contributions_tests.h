@@ -20,6 +20,8 @@ bool check_regular_contributions(const std::vector<T>& locations, const std::vec
 	for (const auto& location : locations){
 		std::vector<double> lambda(n_strains, 0.0); 
 		std::vector<int> agentIDs = location.get_agent_IDs();
+		// Leisure visitors are stored separately
+		agentIDs.insert(agentIDs.end(), location.get_visitor_IDs().begin(), location.get_visitor_IDs().end());
 		double ntot = static_cast<double>(agentIDs.size());
 		// So if an agent is both a student and works at school i they are not counted twice
 		// (total will still be twice)
@@ -0,0 +1,83 @@
+import subprocess, glob, os
+
+#
+# Input 
+#
+
+# Path to the main directory
+path = '../../src/'
+# Compiler options - MPI compiler wrapper
+cx = 'mpicxx'
+std = '-std=c++11'
+opt = '-O0'
+# Background thread of the output recorder
+threads = '-pthread'
+# Common source files
+src_files = path + 'abm.cpp' 
+src_files += ' ' + path + 'data_management_interface.cpp'
+src_files += ' ' + path + 'agent.cpp' 
+src_files += ' ' + path + 'infection.cpp'
+src_files += ' ' + path + 'mobility.cpp'
+src_files += ' ' + path + 'town.cpp'
+src_files += ' ' + path + 'step_stats.cpp'
+src_files += ' ' + path + 'event_timeline.cpp'
+src_files += ' ' + path + 'distributed/household_partition.cpp'
+src_files += ' ' + path + 'testing.cpp'
+src_files += ' ' + path + 'vaccinations.cpp'
+src_files += ' ' + path + 'contact_tracing.cpp'
+src_files += ' ' + path + 'contributions.cpp'
+src_files += ' ' + path + 'transitions/transitions.cpp'
+src_files += ' ' + path + 'transitions/regular_transitions.cpp'
+src_files += ' ' + path + 'transitions/hsp_employee_transitions.cpp'
+src_files += ' ' + path + 'transitions/hsp_patient_transitions.cpp'
+src_files += ' ' + path + 'transitions/flu_transitions.cpp'
+src_files += ' ' + path + 'states_manager/states_manager.cpp'
+src_files += ' ' + path + 'states_manager/regular_states_manager.cpp'
+src_files += ' ' + path + 'states_manager/hsp_employee_states_manager.cpp'
+src_files += ' ' + path + 'flu.cpp'
+src_files += ' ' + path + 'utils.cpp'
+src_files += ' ' + path + 'three_part_function.cpp'
+src_files += ' ' + path + 'four_part_function.cpp'
+src_files += ' ' + path + 'places/place.cpp'
+src_files += ' ' + path + 'places/household.cpp'
+src_files += ' ' + path + 'places/workplace.cpp'
+src_files += ' ' + path + 'places/school.cpp'
+src_files += ' ' + path + 'places/hospital.cpp'
+src_files += ' ' + path + 'places/retirement_home.cpp'
+src_files += ' ' + path + 'places/transit.cpp'
+src_files += ' ' + path + 'places/leisure.cpp'
+src_files += ' ' + path + 'io_operations/FileHandler.cpp'
+src_files += ' ' + path + 'io_operations/load_parameters.cpp'
+src_files += ' ' + path + 'io_operations/mapped_reader.cpp'
+src_files += ' ' + path + 'io_operations/town_image.cpp'
+src_files += ' ' + path + 'io_operations/recorder.cpp'
+src_files += ' ' + path + 'io_operations/tracer.cpp'
+src_files += ' ' + path + 'ensemble.cpp'
+src_files += ' ' + path + 'parameter_sweep.cpp'
+src_files += ' ' + path + 'distributed/mpi_communicator.cpp'
+tst_files = '../common/test_utils.cpp'
+# Directory with files for testing
+data_dir = './test_data/'
+
+#
+# Remove files
+#
+
+# Test 1
+out_files = [data_dir + 'distributed_out.csv']
+for file_rm in out_files:
+	if os.path.exists(file_rm):
+		os.remove(file_rm)
+
+#
+# Tests
+#
+
+# Test 1
+# Distributed runs, started with mpirun
+# Name of the executable
+exe_name = 'distributed_test'
+# Files needed only for this build
+spec_files = 'distributed_test.cpp '
+compile_com = ' '.join([cx, std, opt, threads, '-o', exe_name, spec_files, tst_files, src_files])
+subprocess.call([compile_com], shell=True)
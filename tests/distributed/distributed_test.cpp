@@ -0,0 +1,349 @@
+#include "../../include/abm.h"
+#include "../../include/distributed/mpi_communicator.h"
+#include "../common/test_utils.h"
+
+/*****************************************************
+ *
+ * Test suite for distributed runs, needs to be
+ * started with mpirun on two or more processes
+ *
+******************************************************/
+
+// Tests
+bool partition_test(const ABM&);
+bool ownership_test(const ABM&, std::shared_ptr<Communicator>);
+bool contributions_test(const ABM&, std::shared_ptr<Communicator>);
+bool distributed_run_test(const ABM&, std::shared_ptr<Communicator>);
+bool distributed_exceptions_test(const ABM&, std::shared_ptr<Communicator>);
+
+// Supporting functions
+ABM create_model();
+void report(const bool passed, const std::string& name, Communicator& comm);
+std::vector<std::vector<double>> all_contributions(const ABM&);
+template <typename T>
+void add_contributions(const std::vector<T>&, std::vector<std::vector<double>>&);
+
+// Files created by the tests
+// ./test_data/distributed_out.csv
+
+int main(int argc, char** argv)
+{
+	MPI_Init(&argc, &argv);
+	try {
+		auto comm = std::make_shared<MPICommunicator>();
+		const ABM model = create_model();
+		report(partition_test(model), "Household partition", *comm);
+		report(ownership_test(model, comm), "Agents of each process", *comm);
+		report(contributions_test(model, comm), "Place contributions summed over processes", *comm);
+		report(distributed_run_test(model, comm), "Distributed run", *comm);
+		report(distributed_exceptions_test(model, comm), "Distributed run exceptions", *comm);
+	} catch (const std::exception& e) {
+		// Other processes would wait in a collective operation
+		std::cerr << e.what() << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
+	MPI_Finalize();
+}
+
+/// Coverage, balance, and locality of the parts
+bool partition_test(const ABM& model)
+{
+	bool verbose = false;
+	const std::invalid_argument inv_arg("Invalid argument");
+
+	const std::vector<Household>& houses = model.get_town()->get_households();
+	const std::vector<RetirementHome>& rhs = model.get_town()->get_retirement_homes();
+	int n_registered = 0, max_home = 0;
+	for (const auto& house : houses) {
+		n_registered += house.get_number_of_agents();
+		max_home = std::max(max_home, house.get_number_of_agents());
+	}
+	for (const auto& rh : rhs) {
+		n_registered += rh.get_number_of_agents();
+		max_home = std::max(max_home, rh.get_number_of_agents());
+	}
+
+	for (int n_parts = 1; n_parts <= 5; ++n_parts) {
+		HouseholdPartition partition(houses, rhs, n_parts);
+		const std::vector<int>& weights = partition.get_part_weights();
+		if (partition.number_of_parts() != n_parts || weights.size() != n_parts
+				|| std::accumulate(weights.begin(), weights.end(), 0) != n_registered) {
+			std::cerr << "Parts should cover all the registered agents" << std::endl;
+			return false;
+		}
+		for (const auto& house : houses) {
+			if (partition.owner_of_household(house.get_ID()) < 0
+					|| partition.owner_of_household(house.get_ID()) >= n_parts) {
+				std::cerr << "Household assigned to a part that does not exist" << std::endl;
+				return false;
+			}
+		}
+		// Each split is off by less than a home
+		const double mean = static_cast<double>(n_registered)/n_parts;
+		for (const int weight : weights) {
+			if (std::fabs(weight - mean) > n_parts*max_home) {
+				std::cerr << "Parts are not balanced: " << weight << " agents instead of "
+						  << mean << std::endl;
+				return false;
+			}
+		}
+	}
+
+	// Two parts are separated by a vertical or a horizontal line
+	HouseholdPartition halves(houses, rhs, 2);
+	std::vector<double> max_x(2, -1e10), min_x(2, 1e10), max_y(2, -1e10), min_y(2, 1e10);
+	for (const auto& house : houses) {
+		const int part = halves.owner_of_household(house.get_ID());
+		max_x.at(part) = std::max(max_x.at(part), house.get_x());
+		min_x.at(part) = std::min(min_x.at(part), house.get_x());
+		max_y.at(part) = std::max(max_y.at(part), house.get_y());
+		min_y.at(part) = std::min(min_y.at(part), house.get_y());
+	}
+	if (max_x.at(0) > min_x.at(1) && max_y.at(0) > min_y.at(1)) {
+		std::cerr << "Parts should not overlap" << std::endl;
+		return false;
+	}
+
+	auto no_parts = [&houses, &rhs](){ HouseholdPartition partition(houses, rhs, 0); };
+	if (!exception_test(verbose, &inv_arg, no_parts)) {
+		std::cerr << "Partition without parts should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Every agent simulated by exactly one process, together with its household
+bool ownership_test(const ABM& model, std::shared_ptr<Communicator> comm)
+{
+	ABM abm(model);
+	abm.distribute(comm, 1);
+	if (!abm.is_distributed() || abm.get_partition()->number_of_parts() != comm->size()) {
+		return false;
+	}
+	const std::vector<int>& owned = abm.get_owned_agents();
+	const std::vector<std::vector<int>> all_owned = comm->all_gather(owned);
+	const std::vector<Agent>& agents = abm.get_vector_of_agents();
+	std::vector<int> n_owners(agents.size(), 0);
+	for (int ir = 0; ir < all_owned.size(); ++ir) {
+		if (all_owned.at(ir).empty()) {
+			std::cerr << "Process " << ir << " has no agents" << std::endl;
+			return false;
+		}
+		for (const int aID : all_owned.at(ir)) {
+			++n_owners.at(aID-1);
+			if (abm.get_agent_owner(aID) != ir) {
+				std::cerr << "Wrong process of agent " << aID << std::endl;
+				return false;
+			}
+		}
+	}
+	if (std::count(n_owners.begin(), n_owners.end(), 1) != agents.size()) {
+		std::cerr << "Each agent should be simulated by exactly one process" << std::endl;
+		return false;
+	}
+	for (const auto& house : abm.get_town()->get_households()) {
+		for (const int aID : house.get_agent_IDs()) {
+			if (abm.get_agent_owner(aID) != abm.get_partition()->owner_of_household(house.get_ID())) {
+				std::cerr << "Agent and its household are in different processes" << std::endl;
+				return false;
+			}
+		}
+	}
+	// Places of this process only register its own agents
+	auto foreign = [&abm, &comm](const int aID){ return abm.get_agent_owner(aID) != comm->rank(); };
+	for (const auto& school : abm.get_vector_of_schools()) {
+		const std::vector<int>& IDs = school.get_agent_IDs();
+		if (std::any_of(IDs.begin(), IDs.end(), foreign)) {
+			std::cerr << "School has agents of another process" << std::endl;
+			return false;
+		}
+	}
+	for (const auto& work : abm.get_vector_of_workplaces()) {
+		const std::vector<int>& IDs = work.get_agent_IDs();
+		if (std::any_of(IDs.begin(), IDs.end(), foreign)) {
+			std::cerr << "Workplace has agents of another process" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Sums over processes equal the contributions computed in one model
+bool contributions_test(const ABM& model, std::shared_ptr<Communicator> comm)
+{
+	const double tol = 1e-12;
+	// One model at a time, to fit several processes on one machine
+	std::vector<std::vector<double>> expected;
+	{
+		ABM serial(model);
+		serial.compute_place_contributions();
+		expected = all_contributions(serial);
+	}
+	{
+		// All agents in one process
+		ABM single(model);
+		single.distribute(std::make_shared<SerialCommunicator>(), 1);
+		if (single.get_owned_agents().size() != single.get_vector_of_agents().size()) {
+			return false;
+		}
+		single.compute_place_contributions();
+		if (!is_equal_floats(expected, all_contributions(single), tol)) {
+			std::cerr << "Contributions with a single process differ from the ones without distributing" << std::endl;
+			return false;
+		}
+	}
+	ABM distributed(model);
+	distributed.distribute(comm, 1);
+	distributed.compute_place_contributions();
+	if (!is_equal_floats(expected, all_contributions(distributed), tol)) {
+		std::cerr << "Contributions differ from the ones computed with all the agents" << std::endl;
+		return false;
+	}
+	// Some places should have agents from more than one process
+	int n_partial = 0;
+	for (const auto& school : distributed.get_vector_of_schools()) {
+		if (school.get_number_of_agents() < model.get_vector_of_schools().at(school.get_ID()-1).get_number_of_agents()) {
+			++n_partial;
+		}
+	}
+	if (comm->size() > 1 && n_partial == 0) {
+		std::cerr << "Test town should have schools with agents from more than one process" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Time series of the whole town in every process
+bool distributed_run_test(const ABM& model, std::shared_ptr<Communicator> comm)
+{
+	const int n_steps = 12;
+	std::vector<double> values, serial_values;
+	{
+		ABM serial(model);
+		serial.get_time_series_values(serial_values);
+	}
+	ABM abm(model);
+	abm.distribute(comm, 2022);
+
+	// Same as without distributing before the first step
+	abm.get_time_series_values(values);
+	if (values != serial_values) {
+		std::cerr << "Distributing should not change the current values" << std::endl;
+		return false;
+	}
+
+	// Only one process writes
+	if (comm->rank() == 0) {
+		abm.record_output("test_data/distributed_out.csv");
+	}
+	for (int ti = 0; ti < n_steps; ++ti) {
+		abm.transmit_infection();
+	}
+	abm.stop_recording();
+
+	abm.get_time_series_values(values);
+	const std::vector<std::vector<int>> all_values =
+		comm->all_gather(std::vector<int>(values.begin(), values.end()));
+	for (const auto& other : all_values) {
+		if (other != all_values.front()) {
+			std::cerr << "Processes report different time series values" << std::endl;
+			return false;
+		}
+	}
+	const std::vector<std::string> names = abm.get_time_series_names();
+	const int i_tot = std::find(names.begin(), names.end(), "total infected") - names.begin();
+	const int n_strains = abm.get_infection_parameters().at("number of strains");
+	if (values.at(0) != std::accumulate(values.begin() + 1, values.begin() + 1 + n_strains, 0.0)
+			|| values.at(i_tot) < serial_values.at(i_tot)) {
+		std::cerr << "Inconsistent time series values" << std::endl;
+		return false;
+	}
+
+	if (comm->rank() == 0) {
+		std::ifstream fin("test_data/distributed_out.csv");
+		std::string line;
+		int n_lines = 0;
+		while (std::getline(fin, line)) {
+			++n_lines;
+		}
+		if (n_lines != n_steps + 1) {
+			std::cerr << "Wrong number of recorded steps: " << n_lines - 1 << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Invalid use of distributed runs
+bool distributed_exceptions_test(const ABM& model, std::shared_ptr<Communicator> comm)
+{
+	bool verbose = false;
+	const std::invalid_argument inv_arg("Invalid argument");
+	const std::runtime_error rt_err("Runtime error");
+
+	ABM abm(model);
+	auto no_comm = [&abm](){ abm.distribute(nullptr, 1); };
+	if (!exception_test(verbose, &inv_arg, no_comm)) {
+		return false;
+	}
+	abm.distribute(comm, 1);
+	auto twice = [&abm, &comm](){ abm.distribute(comm, 1); };
+	auto with_vac = [&abm](){ abm.transmit_with_vac(); };
+	ABM empty(0.25);
+	auto not_set_up = [&empty, &comm](){ empty.distribute(comm, 1); };
+	if (!exception_test(verbose, &rt_err, twice) || !exception_test(verbose, &rt_err, with_vac)
+			|| !exception_test(verbose, &rt_err, not_set_up)) {
+		std::cerr << "Invalid distributed runs should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Test town with early contact tracing and strain introduction,
+/// identical in all processes
+ABM create_model()
+{
+	ABM abm(0.25);
+	abm.set_parameter_overrides({{"time to start data collection", 0.0},
+								{"introduction of a new strain", 1.0}});
+	abm.simulation_setup("test_data/input_files_all.txt", {0, 0, 0});
+	abm.set_seed(2021);
+	abm.seed_initially_infected({0, 5, 100});
+	abm.initialize_simulations();
+	abm.initialize_active_cases({150, 10, 0});
+	return abm;
+}
+
+/// Passed only if passed in all processes, printed once
+void report(const bool passed, const std::string& name, Communicator& comm)
+{
+	std::vector<double> n_failed = {passed ? 0.0 : 1.0};
+	comm.all_reduce_sum(n_failed);
+	if (comm.rank() == 0) {
+		test_pass(n_failed.front() == 0.0, name + " (" + std::to_string(comm.size()) + " processes)");
+	}
+}
+
+/// Contributions of all places, in order of place types and IDs
+std::vector<std::vector<double>> all_contributions(const ABM& abm)
+{
+	std::vector<std::vector<double>> lambdas;
+	add_contributions(abm.get_vector_of_households(), lambdas);
+	add_contributions(abm.get_vector_of_retirement_homes(), lambdas);
+	add_contributions(abm.get_vector_of_schools(), lambdas);
+	add_contributions(abm.get_vector_of_workplaces(), lambdas);
+	add_contributions(abm.get_vector_of_hospitals(), lambdas);
+	add_contributions(abm.get_vector_of_carpools(), lambdas);
+	add_contributions(abm.get_vector_of_public_transit(), lambdas);
+	add_contributions(abm.get_vector_of_leisure_locations(), lambdas);
+	return lambdas;
+}
+
+/// Append contributions of each place
+template <typename T>
+void add_contributions(const std::vector<T>& places, std::vector<std::vector<double>>& lambdas)
+{
+	for (const auto& place : places) {
+		lambdas.push_back(place.get_infected_contribution());
+	}
+}
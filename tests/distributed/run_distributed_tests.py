@@ -0,0 +1,28 @@
+import subprocess
+
+import sys
+py_path = '../../scripts/'
+sys.path.insert(0, py_path)
+
+import utils as ut
+from colors import *
+
+py_version = 'python3'
+
+#
+# Compile and run all the distributed run tests
+#
+
+# Uses the test town of the ABM tests, 
+# create it there first (create_test_population.py)
+
+# Number of processes, oversubscribed if the machine has fewer cores
+n_proc = 2
+mpi_run = 'mpirun --oversubscribe -np ' + str(n_proc) + ' '
+
+# Compile
+subprocess.call([py_version + ' compilation.py'], shell=True)
+
+# Test suite 1
+ut.msg('Distributed runs (MPI)', CYAN)
+subprocess.call([mpi_run + './distributed_test'], shell=True)
@@ -0,0 +1,163 @@
+#include "../common/test_utils.h"
+#include "../../include/event_timeline.h"
+
+/*****************************************************
+ *
+ * Test suite for functionality of the EventTimeline class
+ *
+ *****************************************************/
+
+// Tests
+bool dispatch_order_test();
+bool late_schedule_test();
+bool time_conversion_test();
+bool type_names_test();
+
+// Supporting functions
+std::vector<EventTimeline::Event> collect_due(EventTimeline&, const int);
+
+int main()
+{
+	test_pass(dispatch_order_test(), "Events dispatched at their steps in order");
+	test_pass(late_schedule_test(), "Scheduling after dispatching and skipping");
+	test_pass(time_conversion_test(), "Events scheduled at simulation times");
+	test_pass(type_names_test(), "Event types from their names");
+}
+
+/// Each event is returned once, at its step, in the order of scheduling
+bool dispatch_order_test()
+{
+	EventTimeline timeline;
+	// Out of order, two at step 5
+	timeline.schedule(EventTimeline::Event(5, EventTimeline::testing_change, 0.1, 0.5));
+	timeline.schedule(EventTimeline::Event(2, EventTimeline::new_strain, 2));
+	timeline.schedule(EventTimeline::Event(5, EventTimeline::leisure_fraction, 0.0));
+	timeline.schedule(EventTimeline::Event(9, EventTimeline::vaccination_rate, 100));
+
+	if (timeline.pending() != 4 || timeline.next_step() != 2) {
+		std::cerr << "Wrong number of scheduled events or next step" << std::endl;
+		return false;
+	}
+	const std::vector<int> expected_counts = {0, 0, 1, 0, 0, 2, 0, 0, 0, 1, 0};
+	for (int step = 0; step < expected_counts.size(); ++step) {
+		std::vector<EventTimeline::Event> due = collect_due(timeline, step);
+		if (due.size() != expected_counts.at(step)) {
+			std::cerr << "Wrong number of events due at step " << step << std::endl;
+			return false;
+		}
+		for (const auto& event : due) {
+			if (event.step != step) {
+				std::cerr << "Event of step " << event.step << " due at step " << step << std::endl;
+				return false;
+			}
+		}
+		if (step == 5 && (due.at(0).type != EventTimeline::testing_change
+						|| due.at(1).type != EventTimeline::leisure_fraction
+						|| !float_equality<double>(due.at(0).second_value, 0.5, 1e-10))) {
+			std::cerr << "Events of the same step not in the scheduling order" << std::endl;
+			return false;
+		}
+	}
+	if (timeline.pending() != 0 || timeline.next_step() != -1) {
+		std::cerr << "Events left after dispatching all" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Events of past steps are returned at the next step, skipped ones never
+bool late_schedule_test()
+{
+	EventTimeline timeline;
+	timeline.schedule(EventTimeline::Event(3, EventTimeline::new_strain, 2));
+	timeline.schedule(EventTimeline::Event(6, EventTimeline::leisure_fraction, 0.3));
+	collect_due(timeline, 4);
+
+	// Scheduled for a step that was already dispatched
+	timeline.schedule(EventTimeline::Event(1, EventTimeline::vaccination_rate, 50));
+	std::vector<EventTimeline::Event> due = collect_due(timeline, 5);
+	if (due.size() != 1 || due.front().type != EventTimeline::vaccination_rate) {
+		std::cerr << "Late event not dispatched at the next step" << std::endl;
+		return false;
+	}
+
+	// Skipped events are discarded
+	timeline.schedule(EventTimeline::Event(8, EventTimeline::testing_change, 1.0, 1.0));
+	timeline.skip_to(7);
+	if (timeline.pending() != 1 || timeline.next_step() != 8) {
+		std::cerr << "Wrong events after skipping" << std::endl;
+		return false;
+	}
+	due = collect_due(timeline, 8);
+	if (due.size() != 1 || due.front().type != EventTimeline::testing_change) {
+		std::cerr << "Wrong events after skipping" << std::endl;
+		return false;
+	}
+
+	// Nothing after clearing
+	timeline.schedule(EventTimeline::Event(10, EventTimeline::new_strain, 2));
+	timeline.clear();
+	if (timeline.pending() != 0 || !collect_due(timeline, 10).empty()) {
+		std::cerr << "Events left after clearing" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Steps closest to the times, nothing before time 0
+bool time_conversion_test()
+{
+	const double dt = 0.25;
+	EventTimeline timeline;
+	timeline.schedule_at_time(10.0, dt, EventTimeline::new_strain, 2);
+	timeline.schedule_at_time(27.0001, dt, EventTimeline::testing_change, 0.1, 0.5);
+	timeline.schedule_at_time(-1.0, dt, EventTimeline::leisure_fraction, 0.0);
+	if (timeline.pending() != 2) {
+		std::cerr << "Event before time 0 scheduled" << std::endl;
+		return false;
+	}
+	if (collect_due(timeline, 39).size() != 0 || collect_due(timeline, 40).size() != 1
+			|| collect_due(timeline, 107).size() != 0 || collect_due(timeline, 108).size() != 1) {
+		std::cerr << "Events not dispatched at the steps of their times" << std::endl;
+		return false;
+	}
+	if (EventTimeline::step_of(0.0, dt) != 0 || EventTimeline::step_of(60.0, dt) != 240) {
+		std::cerr << "Wrong step of a time" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Names in the input files
+bool type_names_test()
+{
+	const std::vector<std::pair<std::string, EventTimeline::Type>> names =
+		{{"new_strain", EventTimeline::new_strain}, {"testing_change", EventTimeline::testing_change},
+		 {"vaccination_rate", EventTimeline::vaccination_rate},
+		 {"leisure_fraction", EventTimeline::leisure_fraction},
+		 {"workplace_absenteeism", EventTimeline::workplace_absenteeism}};
+	for (const auto& name : names) {
+		if (EventTimeline::type_from_name(name.first) != name.second) {
+			std::cerr << "Wrong type of " << name.first << std::endl;
+			return false;
+		}
+	}
+	bool threw = false;
+	try {
+		EventTimeline::type_from_name("school_closure");
+	} catch (const std::invalid_argument& e) {
+		threw = true;
+	}
+	if (!threw) {
+		std::cerr << "No exception for an unknown type" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Copies of the events due at step
+std::vector<EventTimeline::Event> collect_due(EventTimeline& timeline, const int step)
+{
+	const auto due = timeline.due(step);
+	return std::vector<EventTimeline::Event>(due.first, due.second);
+}
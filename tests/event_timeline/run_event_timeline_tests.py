@@ -0,0 +1,21 @@
+import subprocess
+
+import sys
+py_path = '../../scripts/'
+sys.path.insert(0, py_path)
+
+import utils as ut
+from colors import *
+
+py_version = 'python3'
+
+#
+# Compile and run all the EventTimeline class specific tests
+#
+
+# Compile
+subprocess.call([py_version + ' compilation.py'], shell=True)
+
+# Test suite 1
+ut.msg('EventTimeline class functionality tests', CYAN)
+subprocess.call(['./evt_test'], shell=True)
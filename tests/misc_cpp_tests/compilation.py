@@ -57,3 +57,35 @@ exe_name = 'ld_params_tests'
 spec_files = 'load_parameters_tests.cpp'
 compile_com = ' '.join([cx, std, opt, '-o', exe_name, spec_files, src_files, test_files])
 subprocess.call([compile_com], shell=True)
+
+# mapped_reader.h tests 
+# Name of the executable
+exe_name = 'mapped_reader_tests'
+# Files needed only for this build
+spec_files = 'mapped_reader_tests.cpp ' + path + 'io_operations/mapped_reader.cpp'
+compile_com = ' '.join([cx, std, opt, '-o', exe_name, spec_files, src_files, test_files])
+subprocess.call([compile_com], shell=True)
+
+# recorder.h tests 
+# Name of the executable
+exe_name = 'recorder_tests'
+# Files needed only for this build
+spec_files = 'recorder_tests.cpp ' + path + 'io_operations/recorder.cpp ' + path + 'io_operations/tracer.cpp ' + path + 'io_operations/mapped_reader.cpp'
+compile_com = ' '.join([cx, std, opt, '-pthread', '-o', exe_name, spec_files, src_files, test_files])
+subprocess.call([compile_com], shell=True)
+
+# tracer.h tests 
+# Name of the executable
+exe_name = 'tracer_tests'
+# Files needed only for this build
+spec_files = 'tracer_tests.cpp ' + path + 'io_operations/tracer.cpp ' + path + 'io_operations/recorder.cpp'
+compile_com = ' '.join([cx, std, opt, '-pthread', '-o', exe_name, spec_files, src_files, test_files])
+subprocess.call([compile_com], shell=True)
+
+# town_generator.h tests 
+# Name of the executable
+exe_name = 'town_generator_tests'
+# Files needed only for this build
+spec_files = 'town_generator_tests.cpp ' + path + 'io_operations/town_generator.cpp ' + path + 'io_operations/town_image.cpp ' + path + 'io_operations/mapped_reader.cpp'
+compile_com = ' '.join([cx, std, opt, '-o', exe_name, spec_files, src_files, test_files])
+subprocess.call([compile_com], shell=True)
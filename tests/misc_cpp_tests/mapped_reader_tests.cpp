@@ -0,0 +1,183 @@
+#include "../common/test_utils.h"
+#include <string>
+#include "../../include/io_operations/abm_io.h"
+#include "../../include/io_operations/mapped_reader.h"
+
+/***************************************************************
+ * Suite for testing MappedReader class for reading
+ * population and place files
+ **************************************************************/
+
+// Supporting functions
+std::vector<std::vector<std::string>> read_all_fields(const std::string&);
+std::vector<std::vector<std::string>> read_reference(const std::string&);
+
+// Tests
+bool tokenize_test();
+bool conversion_test();
+bool row_count_test();
+bool exceptions_test();
+
+// Files required to be present
+// ./test_data/r_int.txt
+// ./test_data/r_double.txt
+// ./test_data/r_string.txt
+// ./test_data/mapped_rows.txt
+
+int main()
+{
+	test_pass(tokenize_test(), "MappedReader tokenization");
+	test_pass(conversion_test(), "MappedReader numeric conversions");
+	test_pass(row_count_test(), "MappedReader row counting and rewinding");
+	test_pass(exceptions_test(), "MappedReader exceptions");
+}
+
+/**
+ * \brief Compares fields extracted by MappedReader with AbmIO reading
+ * \details AbmIO keeps empty lines as empty vectors, MappedReader skips them
+ */
+bool tokenize_test()
+{
+	std::vector<std::string> files = {"./test_data/r_int.txt", "./test_data/r_double.txt",
+				"./test_data/r_string.txt", "./test_data/mapped_rows.txt"};
+	for (const auto& fname : files) {
+		if (!is_equal_exact(read_all_fields(fname), read_reference(fname))) {
+			std::cerr << "Wrong fields when reading " << fname << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Conversions to numbers and string comparisons
+bool conversion_test()
+{
+	double tol = 1e-10;
+	MappedReader reader("./test_data/mapped_rows.txt");
+	MappedReader::Row row;
+
+	// First row
+	reader.next_row(row);
+	if (row.size() != 3 || row.get_int(0) != 1) {
+		return false;
+	}
+	if (!float_equality<double>(row.get_double(1), 40.988181, tol)
+			|| !float_equality<double>(row.get_double(2), -73.781424, tol)) {
+		return false;
+	}
+	// Second (empty line skipped, surrounded with whitespace)
+	reader.next_row(row);
+	if (row.size() != 3 || row.get_int(0) != 2) {
+		return false;
+	}
+	if (!float_equality<double>(row.get_double(1), 40.987855, tol)) {
+		return false;
+	}
+	// Last, no newline at the end of the file
+	reader.next_row(row);
+	if (row.get_int(1) != -7 || row.get_int(2) != 12) {
+		return false;
+	}
+	if (!row.equals(3, "primary") || row.equals(3, "primar") || row.equals(3, "primary school")) {
+		return false;
+	}
+	if (row.get_string(3) != "primary") {
+		return false;
+	}
+	if (reader.next_row(row) || !row.empty()) {
+		return false;
+	}
+
+	// Doubles against the standard conversion
+	MappedReader dreader("./test_data/r_double.txt");
+	std::vector<std::vector<std::string>> ref = read_reference("./test_data/r_double.txt");
+	for (const auto& ref_row : ref) {
+		dreader.next_row(row);
+		for (size_t i = 0; i < ref_row.size(); ++i) {
+			if (!float_equality<double>(row.get_double(i), std::stod(ref_row.at(i)), tol)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/// Row counting and rewinding to the beginning
+bool row_count_test()
+{
+	MappedReader reader("./test_data/mapped_rows.txt");
+	MappedReader::Row row;
+	if (reader.count_rows() != 3) {
+		return false;
+	}
+	int n_rows = 0;
+	while (reader.next_row(row)) {
+		++n_rows;
+	}
+	reader.rewind();
+	reader.next_row(row);
+	return (n_rows == 3) && (row.get_int(0) == 1);
+}
+
+/// Missing files and wrong conversions
+bool exceptions_test()
+{
+	bool verbose = false;
+	const std::runtime_error rt_err("Runtime error");
+	const std::invalid_argument inv_arg("Invalid argument");
+	const std::out_of_range out_rng("Out of range");
+
+	auto missing_file = [](){ MappedReader reader("./test_data/no_such_file.txt"); };
+	if (!exception_test(verbose, &rt_err, missing_file)) {
+		std::cerr << "Missing file should throw" << std::endl;
+		return false;
+	}
+
+	MappedReader reader("./test_data/mapped_rows.txt");
+	MappedReader::Row row;
+	reader.next_row(row);
+	auto int_from_double = [&row](){ row.get_int(1); };
+	if (!exception_test(verbose, &inv_arg, int_from_double)) {
+		std::cerr << "Double field converted to int" << std::endl;
+		return false;
+	}
+	auto out_of_row = [&row](){ row.get_int(3); };
+	if (!exception_test(verbose, &out_rng, out_of_row)) {
+		std::cerr << "Field outside the row" << std::endl;
+		return false;
+	}
+	reader.next_row(row);
+	reader.next_row(row);
+	auto double_from_string = [&row](){ row.get_double(3); };
+	if (!exception_test(verbose, &inv_arg, double_from_string)) {
+		std::cerr << "String converted to double" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// All fields, as strings, read with MappedReader
+std::vector<std::vector<std::string>> read_all_fields(const std::string& fname)
+{
+	std::vector<std::vector<std::string>> fields;
+	MappedReader reader(fname);
+	MappedReader::Row row;
+	while (reader.next_row(row)) {
+		std::vector<std::string> temp;
+		for (size_t i = 0; i < row.size(); ++i) {
+			temp.push_back(row.get_string(i));
+		}
+		fields.push_back(temp);
+	}
+	return fields;
+}
+
+/// Non-empty lines read with AbmIO
+std::vector<std::vector<std::string>> read_reference(const std::string& fname)
+{
+	AbmIO abm_io(fname, " ", true, {0,0,0});
+	std::vector<std::vector<std::string>> ref = abm_io.read_vector<std::string>();
+	ref.erase(std::remove_if(ref.begin(), ref.end(),
+		[](const std::vector<std::string>& row){ return row.empty(); }), ref.end());
+	return ref;
+}
@@ -0,0 +1,220 @@
+#include "../common/test_utils.h"
+#include <string>
+#include <cstdint>
+#include "../../include/io_operations/mapped_reader.h"
+#include "../../include/io_operations/recorder.h"
+
+/***************************************************************
+ * Suite for testing Recorder class for streaming
+ * time series output
+ **************************************************************/
+
+// Supporting functions
+std::vector<std::vector<double>> expected_rows(const int, const int);
+
+// Tests
+bool csv_test();
+bool binary_test();
+bool streaming_test();
+bool exceptions_test();
+
+// Files created by the tests
+// ./test_data/recorder_out.csv
+// ./test_data/recorder_out.bin
+
+int main()
+{
+	test_pass(csv_test(), "Recorder CSV output");
+	test_pass(binary_test(), "Recorder binary output");
+	test_pass(streaming_test(), "Recorder output available during recording");
+	test_pass(exceptions_test(), "Recorder exceptions");
+}
+
+/// Rows with time and three metrics, more rows than the buffer
+bool csv_test()
+{
+	const int n_rows = 1000;
+	const std::string fname("./test_data/recorder_out.csv");
+	std::vector<std::vector<double>> rows = expected_rows(n_rows, 3);
+	{
+		Recorder recorder(fname, Recorder::csv, 64);
+		int i_inf = recorder.add_metric("infected");
+		int i_dead = recorder.add_metric("dead");
+		int i_frac = recorder.add_metric("fraction");
+		for (const auto& row : rows) {
+			recorder.set(i_inf, row.at(1));
+			recorder.set(i_dead, row.at(2));
+			recorder.set(i_frac, row.at(3));
+			recorder.record(row.at(0));
+		}
+		if (recorder.number_of_rows() != n_rows) {
+			return false;
+		}
+		// Destructor writes the rest
+	}
+
+	std::ifstream fin(fname);
+	std::string line;
+	std::getline(fin, line);
+	if (line != "time,infected,dead,fraction") {
+		std::cerr << "Wrong header: " << line << std::endl;
+		return false;
+	}
+	std::vector<std::vector<double>> values;
+	while (std::getline(fin, line)) {
+		std::stringstream ss(line);
+		std::string field;
+		values.push_back({});
+		while (std::getline(ss, field, ',')) {
+			values.back().push_back(std::stod(field));
+		}
+	}
+	if (values.size() != n_rows || !is_equal_floats<double>(values, rows, 1e-10)) {
+		std::cerr << "Wrong values in the CSV output" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Header and rows in the binary format
+bool binary_test()
+{
+	const int n_rows = 300, n_metrics = 2;
+	const std::string fname("./test_data/recorder_out.bin");
+	std::vector<std::vector<double>> rows = expected_rows(n_rows, n_metrics);
+	{
+		Recorder recorder(fname, Recorder::binary, 7);
+		recorder.add_metric("infected strain 1");
+		recorder.add_metric("total dead");
+		for (const auto& row : rows) {
+			recorder.set(0, row.at(1));
+			recorder.set(1, row.at(2));
+			recorder.record(row.at(0));
+		}
+		recorder.close();
+	}
+
+	MappedReader reader(fname);
+	const char* data = reader.raw_data();
+	if (std::string(data, 6) != "ABMREC") {
+		return false;
+	}
+	uint32_t header[2] = {0, 0};
+	std::memcpy(header, data + 8, sizeof(header));
+	if (header[0] != Recorder::version || header[1] != n_metrics + 1) {
+		return false;
+	}
+	// Names, null-terminated, padded to 8
+	size_t offset = 16;
+	std::vector<std::string> names;
+	for (int i = 0; i < n_metrics + 1; ++i) {
+		names.push_back(std::string(data + offset));
+		offset += names.back().size() + 1;
+	}
+	if (names != std::vector<std::string>({"time", "infected strain 1", "total dead"})) {
+		return false;
+	}
+	offset += (8 - (offset - 16) % 8) % 8;
+	if (reader.size() != offset + n_rows*(n_metrics + 1)*sizeof(double)) {
+		std::cerr << "Wrong size of the binary output" << std::endl;
+		return false;
+	}
+	for (int i = 0; i < n_rows; ++i) {
+		std::vector<double> values(n_metrics + 1);
+		std::memcpy(values.data(), data + offset, values.size()*sizeof(double));
+		offset += values.size()*sizeof(double);
+		if (values != rows.at(i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Rows are in the file after flush, before the recorder is closed
+bool streaming_test()
+{
+	const std::string fname("./test_data/recorder_out.csv");
+	Recorder recorder(fname, Recorder::csv, 1000);
+	recorder.add_metric("infected");
+	for (int i = 0; i < 10; ++i) {
+		recorder.set(0, i);
+		recorder.record(0.25*i);
+	}
+	recorder.flush();
+	std::ifstream fin(fname);
+	std::string line;
+	int n_lines = 0;
+	while (std::getline(fin, line)) {
+		++n_lines;
+	}
+	if (n_lines != 11) {
+		std::cerr << "Expected 11 lines after flushing, got " << n_lines << std::endl;
+		return false;
+	}
+	// Unchanged values are repeated
+	recorder.record(2.5);
+	recorder.close();
+	std::ifstream fin_all(fname);
+	std::string last_line;
+	while (std::getline(fin_all, line)) {
+		last_line = line;
+	}
+	return last_line == "2.5,9";
+}
+
+/// Wrong use of the recorder
+bool exceptions_test()
+{
+	bool verbose = false;
+	const std::runtime_error rt_err("Runtime error");
+	const std::out_of_range out_rng("Out of range");
+
+	auto missing_dir = [](){ Recorder recorder("./no_such_dir/out.csv"); };
+	if (!exception_test(verbose, &rt_err, missing_dir)) {
+		std::cerr << "Missing output directory should throw" << std::endl;
+		return false;
+	}
+	auto late_metric = [](){
+		Recorder recorder("./test_data/recorder_out.csv");
+		recorder.add_metric("infected");
+		recorder.record(0.0);
+		recorder.add_metric("dead");
+	};
+	if (!exception_test(verbose, &rt_err, late_metric)) {
+		std::cerr << "Adding a metric after recording should throw" << std::endl;
+		return false;
+	}
+	auto wrong_metric = [](){
+		Recorder recorder("./test_data/recorder_out.csv");
+		recorder.add_metric("infected");
+		recorder.set(1, 1.0);
+	};
+	if (!exception_test(verbose, &out_rng, wrong_metric)) {
+		std::cerr << "Setting a non-existing metric should throw" << std::endl;
+		return false;
+	}
+	auto after_close = [](){
+		Recorder recorder("./test_data/recorder_out.csv");
+		recorder.close();
+		recorder.record(0.0);
+	};
+	if (!exception_test(verbose, &rt_err, after_close)) {
+		std::cerr << "Recording after closing should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Time and integer-valued metrics, last one a fraction
+std::vector<std::vector<double>> expected_rows(const int n_rows, const int n_metrics)
+{
+	std::vector<std::vector<double>> rows;
+	for (int i = 0; i < n_rows; ++i) {
+		std::vector<double> row = {0.25*i};
+		for (int j = 0; j < n_metrics; ++j) {
+			row.push_back((j == 2) ? 1.0/(i + 1) : static_cast<double>(i*(j + 1)));
+		}
+		rows.push_back(row);
+	}
+	return rows;
+}
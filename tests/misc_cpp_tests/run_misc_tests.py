@@ -31,3 +31,19 @@ subprocess.call(['./utils_tests'], shell=True)
 # LoadParameters class
 ut.msg('LoadParameters class', CYAN)
 subprocess.call(['./ld_params_tests'], shell=True)
+
+# MappedReader class
+ut.msg('MappedReader class', CYAN)
+subprocess.call(['./mapped_reader_tests'], shell=True)
+
+# Recorder class
+ut.msg('Recorder class', CYAN)
+subprocess.call(['./recorder_tests'], shell=True)
+
+# Tracer class
+ut.msg('Tracer class', CYAN)
+subprocess.call(['./tracer_tests'], shell=True)
+
+# TownGenerator class
+ut.msg('TownGenerator class', CYAN)
+subprocess.call(['./town_generator_tests'], shell=True)
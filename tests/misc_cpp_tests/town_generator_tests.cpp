@@ -0,0 +1,372 @@
+#include "../common/test_utils.h"
+#include <string>
+#include "../../include/io_operations/town_generator.h"
+
+/***************************************************************
+ * Suite for testing TownGenerator class for synthetic
+ * towns of a requested size
+ **************************************************************/
+
+// Supporting functions
+std::string read_file(const std::string&);
+std::vector<PlaceRecord> read_places(const std::string&, const TownImage::PlaceType);
+
+// Tests
+bool town_files_test();
+bool place_sizes_test();
+bool reproducibility_test();
+bool input_files_test();
+bool exceptions_test();
+
+// Files required to be present
+// ./test_data/town_generator_template.txt
+
+// Files created by the tests
+// ./test_data/gen_NR_*.txt, ./test_data/gen_a_NR_*.txt, ./test_data/gen_b_NR_*.txt
+// ./test_data/gen_input_files.txt
+// ./test_data/gen_town_image.bin
+
+int main()
+{
+	test_pass(town_files_test(), "TownGenerator place and agent files");
+	test_pass(place_sizes_test(), "TownGenerator place sizes and roles");
+	test_pass(reproducibility_test(), "TownGenerator reproducibility with a seed");
+	test_pass(input_files_test(), "TownGenerator input file list");
+	test_pass(exceptions_test(), "TownGenerator exceptions");
+}
+
+/// All files are complete and agents only refer to existing places
+bool town_files_test()
+{
+	TownSettings settings;
+	settings.n_agents = 20000;
+	const std::string path("./test_data/gen_");
+	TownGenerator town(settings);
+	town.write_files(path);
+
+	// Consecutive IDs, types where expected
+	std::vector<std::vector<PlaceRecord>> places(TownImage::n_place_types);
+	for (int ip = 0; ip < TownImage::n_place_types; ++ip) {
+		const TownImage::PlaceType ptype = static_cast<TownImage::PlaceType>(ip);
+		places.at(ip) = read_places(path, ptype);
+		if (places.at(ip).empty() || places.at(ip).size() != town.number_of_places(ptype)) {
+			std::cerr << "Wrong number of places in " << TownGenerator::place_file_name(ptype) << std::endl;
+			return false;
+		}
+		for (size_t i = 0; i < places.at(ip).size(); ++i) {
+			if (places.at(ip).at(i).ID != static_cast<int>(i + 1)) {
+				return false;
+			}
+		}
+	}
+	for (const auto& school : places.at(TownImage::schools)) {
+		if (school.type != "daycare" && school.type != "primary" && school.type != "middle"
+				&& school.type != "high" && school.type != "college") {
+			std::cerr << "Wrong school type " << school.type << std::endl;
+			return false;
+		}
+	}
+
+	// References from agents as read by the model
+	MappedReader reader(path + TownGenerator::agent_file_name());
+	MappedReader::Row row;
+	AgentRecord agent;
+	auto in_range = [&places](const int ID, const TownImage::PlaceType ptype)
+		{ return ID >= 1 && ID <= static_cast<int>(places.at(ptype).size()); };
+	std::vector<int> household_sizes(places.at(TownImage::households).size(), 0);
+	int n_agents = 0;
+	while (reader.next_row(row)) {
+		++n_agents;
+		if (row.size() != 22) {
+			std::cerr << "Wrong number of columns of agent " << n_agents << std::endl;
+			return false;
+		}
+		TownImage::read_agent(row, agent);
+		if (agent.age < 0 || agent.age > settings.max_age) {
+			return false;
+		}
+		if (agent.patient) {
+			if (!in_range(agent.hospital_ID, TownImage::hospitals) || agent.student || agent.works) {
+				std::cerr << "Wrong patient " << n_agents << std::endl;
+				return false;
+			}
+			continue;
+		}
+		if (agent.lives_RH) {
+			if (!in_range(agent.house_ID, TownImage::retirement_homes) || agent.age < 65) {
+				std::cerr << "Wrong retirement home resident " << n_agents << std::endl;
+				return false;
+			}
+		} else if (in_range(agent.house_ID, TownImage::households)) {
+			++household_sizes.at(agent.house_ID - 1);
+		} else {
+			std::cerr << "Wrong household of agent " << n_agents << std::endl;
+			return false;
+		}
+		if (agent.student) {
+			if (!in_range(agent.school_ID, TownImage::schools)) {
+				return false;
+			}
+			// Age within the range of the school type
+			const std::string& type = places.at(TownImage::schools).at(agent.school_ID - 1).type;
+			const std::vector<std::string> types = {"daycare", "primary", "middle", "high", "college"};
+			const size_t it = std::find(types.begin(), types.end(), type) - types.begin();
+			if (agent.age < settings.school_min_age.at(it) || agent.age > settings.school_max_age.at(it)) {
+				std::cerr << "Agent of age " << agent.age << " attends " << type << std::endl;
+				return false;
+			}
+		}
+		if ((agent.works_school && !in_range(agent.work_ID, TownImage::schools))
+				|| (agent.works_RH && !in_range(agent.work_ID, TownImage::retirement_homes))
+				|| (agent.hospital_staff && !in_range(agent.hospital_ID, TownImage::hospitals))
+				|| (agent.works && !agent.works_school && !agent.works_RH 
+						&& !in_range(agent.work_ID, TownImage::workplaces))) {
+			std::cerr << "Wrong workplace of agent " << n_agents << std::endl;
+			return false;
+		}
+		if ((agent.travel_mode == "carpool" && !in_range(agent.carpool_ID, TownImage::carpools))
+				|| (agent.travel_mode == "public" && !in_range(agent.public_ID, TownImage::public_transit))) {
+			std::cerr << "Wrong transit of agent " << n_agents << std::endl;
+			return false;
+		}
+		// Not working means no travel
+		if (!(agent.works || agent.hospital_staff) && agent.travel_mode != "None") {
+			return false;
+		}
+	}
+	if (n_agents != settings.n_agents || static_cast<int>(town.number_of_agents()) != n_agents) {
+		std::cerr << "Wrong number of agents" << std::endl;
+		return false;
+	}
+	// No empty households
+	return std::find(household_sizes.begin(), household_sizes.end(), 0) == household_sizes.end();
+}
+
+/// Sizes follow the settings, the town is of the expected density
+bool place_sizes_test()
+{
+	TownSettings settings;
+	settings.n_agents = 50000;
+	settings.seed = 15;
+	const std::string path("./test_data/gen_");
+	TownGenerator town(settings);
+	town.write_files(path);
+
+	std::vector<int> household_sizes(town.number_of_places(TownImage::households), 0);
+	std::vector<int> school_sizes(town.number_of_places(TownImage::schools), 0);
+	std::vector<int> workplace_sizes(town.number_of_places(TownImage::workplaces), 0);
+	std::vector<int> carpool_sizes(town.number_of_places(TownImage::carpools), 0);
+	int n_rh = 0, n_patients = 0, n_hsp_staff = 0, n_wfh = 0, n_regular_workers = 0;
+	MappedReader reader(path + TownGenerator::agent_file_name());
+	MappedReader::Row row;
+	AgentRecord agent;
+	while (reader.next_row(row)) {
+		TownImage::read_agent(row, agent);
+		if (agent.lives_RH) {
+			++n_rh;
+		} else if (agent.patient) {
+			++n_patients;
+		} else {
+			++household_sizes.at(agent.house_ID - 1);
+		}
+		if (agent.student) {
+			++school_sizes.at(agent.school_ID - 1);
+		}
+		if (agent.works && !agent.works_school && !agent.works_RH) {
+			++workplace_sizes.at(agent.work_ID - 1);
+			++n_regular_workers;
+			n_wfh += agent.works_from_home;
+		}
+		if (agent.hospital_staff) {
+			++n_hsp_staff;
+		}
+		if (agent.travel_mode == "carpool") {
+			++carpool_sizes.at(agent.carpool_ID - 1);
+		}
+	}
+
+	// Exact numbers
+	if (n_rh != std::lround(settings.fraction_rh_residents*settings.n_agents)
+			|| n_patients != std::lround(settings.fraction_patients*settings.n_agents)
+			|| n_hsp_staff != std::lround(settings.fraction_hospital_staff*settings.n_agents)
+			|| static_cast<int>(town.number_of_places(TownImage::hospitals)) 
+					!= settings.n_agents/settings.agents_per_hospital
+			|| static_cast<int>(town.number_of_places(TownImage::leisure_locations)) 
+					!= settings.n_agents/settings.agents_per_leisure) {
+		std::cerr << "Wrong number of institution agents or places" << std::endl;
+		return false;
+	}
+	// Mean household size of the distribution is 2.44
+	const double mean_household = static_cast<double>(settings.n_agents - n_rh - n_patients)
+										/household_sizes.size();
+	if (mean_household < 2.3 || mean_household > 2.6
+			|| *std::max_element(household_sizes.begin(), household_sizes.end()) 
+					> static_cast<int>(settings.household_size_probs.size())) {
+		std::cerr << "Wrong household sizes, mean " << mean_household << std::endl;
+		return false;
+	}
+	// Within the ranges, except for the last of each type
+	if (*std::max_element(school_sizes.begin(), school_sizes.end()) > 3*2500/2
+			|| *std::max_element(workplace_sizes.begin(), workplace_sizes.end()) 
+					> settings.workplace_max_size.back()
+			|| *std::min_element(workplace_sizes.begin(), workplace_sizes.end()) < 1
+			|| *std::max_element(carpool_sizes.begin(), carpool_sizes.end()) > settings.max_carpool_size) {
+		std::cerr << "Place sizes out of range" << std::endl;
+		return false;
+	}
+	// Fraction working from home
+	const double frac_wfh = static_cast<double>(n_wfh)/n_regular_workers;
+	if (std::fabs(frac_wfh - settings.fraction_wfh) > 0.02) {
+		std::cerr << "Wrong fraction working from home " << frac_wfh << std::endl;
+		return false;
+	}
+	// Households within the town area, agents per km2 and 111 km per degree of latitude;
+	// coordinates are written with 6 decimals
+	const std::vector<PlaceRecord> houses = read_places(path, TownImage::households);
+	double lat_min = houses.front().x, lat_max = lat_min;
+	for (const auto& house : houses) {
+		lat_min = std::min(lat_min, house.x);
+		lat_max = std::max(lat_max, house.x);
+	}
+	const double lat_size = std::sqrt(settings.n_agents/settings.agents_per_km2)/111.0;
+	if (lat_max - lat_min > lat_size + 2e-6 || lat_max - lat_min < 0.8*lat_size) {
+		std::cerr << "Wrong size of the town " << lat_max - lat_min << " instead of " << lat_size << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Same seed gives the same town, a different one a different town
+bool reproducibility_test()
+{
+	TownSettings settings;
+	settings.n_agents = 10000;
+	settings.seed = 7;
+	TownGenerator town_a(settings);
+	town_a.write_files("./test_data/gen_a_");
+	TownGenerator town_b(settings);
+	town_b.write_files("./test_data/gen_b_");
+	for (int ip = 0; ip < TownImage::n_place_types; ++ip) {
+		const std::string fname = TownGenerator::place_file_name(static_cast<TownImage::PlaceType>(ip));
+		if (read_file("./test_data/gen_a_" + fname) != read_file("./test_data/gen_b_" + fname)) {
+			std::cerr << "Different " << fname << " with the same seed" << std::endl;
+			return false;
+		}
+	}
+	const std::string agents_a = read_file("./test_data/gen_a_" + TownGenerator::agent_file_name());
+	if (agents_a != read_file("./test_data/gen_b_" + TownGenerator::agent_file_name())) {
+		return false;
+	}
+
+	settings.seed = 8;
+	TownGenerator town_c(settings);
+	town_c.write_files("./test_data/gen_b_");
+	return agents_a != read_file("./test_data/gen_b_" + TownGenerator::agent_file_name());
+}
+
+/// Town files replaced in the template and usable for a town image
+bool input_files_test()
+{
+	TownSettings settings;
+	settings.n_agents = 5000;
+	const std::string path("./test_data/gen_");
+	TownGenerator town(settings);
+	town.write_files(path);
+	const std::string fname("./test_data/gen_input_files.txt");
+	TownGenerator::write_input_files("./test_data/town_generator_template.txt", path, fname);
+
+	const std::string list = read_file(fname);
+	const std::string expected = "// Simulation parameters\ntest_data/infection_parameters.txt\n"
+		"// Testing manager\ntest_data/tests_with_time.txt\n"
+		"// Household data\n./test_data/gen_NR_households.txt\n"
+		"// School data\n./test_data/gen_NR_schools.txt\n"
+		"// Workplace data\n./test_data/gen_NR_workplaces.txt\n"
+		"// Hospital data\n./test_data/gen_NR_hospitals.txt\n"
+		"// Retirement home data\n./test_data/gen_NR_retirement_homes.txt\n"
+		"// Carpool data\n./test_data/gen_NR_carpool.txt\n"
+		"// Public transit data\n./test_data/gen_NR_public.txt\n"
+		"// Leisure location data\n./test_data/gen_NR_leisure.txt\n"
+		"// Agent data\n./test_data/gen_NR_agents.txt\n"
+		"// Vaccination parameters\ntest_data/vaccination_parameters.txt\n";
+	if (list != expected) {
+		std::cerr << "Wrong input file list:\n" << list << std::endl;
+		return false;
+	}
+
+	// Readable the same way as the model input
+	TownImage::create(fname, "./test_data/gen_town_image.bin");
+	TownImage image("./test_data/gen_town_image.bin");
+	if (image.number_of_agents() != town.number_of_agents()) {
+		return false;
+	}
+	for (int ip = 0; ip < TownImage::n_place_types; ++ip) {
+		const TownImage::PlaceType ptype = static_cast<TownImage::PlaceType>(ip);
+		if (image.number_of_places(ptype) != town.number_of_places(ptype)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Wrong settings and paths
+bool exceptions_test()
+{
+	bool verbose = false;
+	const std::runtime_error rt_err("Runtime error");
+	const std::invalid_argument inv_arg("Invalid argument");
+
+	auto no_agents = [](){ TownSettings settings; settings.n_agents = 0; TownGenerator town(settings); };
+	if (!exception_test(verbose, &inv_arg, no_agents)) {
+		std::cerr << "Town without agents should throw" << std::endl;
+		return false;
+	}
+	auto school_types = [](){ TownSettings settings; settings.n_agents = 100; 
+								settings.school_mean_size.pop_back(); TownGenerator town(settings); };
+	if (!exception_test(verbose, &inv_arg, school_types)) {
+		std::cerr << "Missing school type settings should throw" << std::endl;
+		return false;
+	}
+	auto workplace_sizes = [](){ TownSettings settings; settings.n_agents = 100; 
+								settings.workplace_size_probs.push_back(0.1); TownGenerator town(settings); };
+	if (!exception_test(verbose, &inv_arg, workplace_sizes)) {
+		std::cerr << "Inconsistent workplace sizes should throw" << std::endl;
+		return false;
+	}
+	auto missing_dir = [](){ TownSettings settings; settings.n_agents = 100; 
+								TownGenerator town(settings); town.write_files("./no_such_dir/"); };
+	if (!exception_test(verbose, &rt_err, missing_dir)) {
+		std::cerr << "Missing output directory should throw" << std::endl;
+		return false;
+	}
+	auto missing_template = [](){ TownGenerator::write_input_files("./test_data/no_template.txt", 
+									"./test_data/gen_", "./test_data/gen_input_files.txt"); };
+	if (!exception_test(verbose, &rt_err, missing_template)) {
+		std::cerr << "Missing template should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Contents of a file as a string
+std::string read_file(const std::string& fname)
+{
+	std::ifstream fin(fname);
+	std::stringstream buffer;
+	buffer << fin.rdbuf();
+	return buffer.str();
+}
+
+/// Places of a type written with path
+std::vector<PlaceRecord> read_places(const std::string& path, const TownImage::PlaceType ptype)
+{
+	const bool has_coordinates = (ptype != TownImage::carpools && ptype != TownImage::public_transit);
+	MappedReader reader(path + TownGenerator::place_file_name(ptype));
+	MappedReader::Row row;
+	PlaceRecord place;
+	std::vector<PlaceRecord> places;
+	while (reader.next_row(row)) {
+		TownImage::read_place(row, has_coordinates, place);
+		places.push_back(place);
+	}
+	return places;
+}
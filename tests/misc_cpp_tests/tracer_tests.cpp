@@ -0,0 +1,203 @@
+#include "../common/test_utils.h"
+#include <string>
+#include <thread>
+#include "../../include/io_operations/tracer.h"
+#include "../../include/io_operations/recorder.h"
+
+/***************************************************************
+ * Suite for testing Tracer class for Chrome trace
+ * timelines
+ **************************************************************/
+
+// Supporting functions
+int count_occurrences(const std::string&, const std::string&);
+
+// Tests
+bool scoped_events_test();
+bool ring_buffer_test();
+bool threads_test();
+bool recorder_events_test();
+bool exceptions_test();
+
+// Files created by the tests
+// ./test_data/tracer_out.json
+// ./test_data/recorder_out.csv
+
+int main()
+{
+	test_pass(scoped_events_test(), "Tracer scoped events");
+	test_pass(ring_buffer_test(), "Tracer ring buffer");
+	test_pass(threads_test(), "Tracer events from multiple threads");
+	test_pass(recorder_events_test(), "Tracer events of the Recorder");
+	test_pass(exceptions_test(), "Tracer exceptions");
+}
+
+/// Nested scopes with and without arguments
+bool scoped_events_test()
+{
+	Tracer tracer(100);
+	{
+		Tracer::Scope step(&tracer, "step", "step", "time", 0.25);
+		for (int i = 0; i < 3; ++i) {
+			Tracer::Scope phase(&tracer, "phase \"quoted\"", "phase");
+		}
+	}
+	// No tracer, no events
+	{
+		Tracer::Scope none(nullptr, "step", "step");
+	}
+	if (tracer.number_of_events() != 4 || tracer.number_of_dropped_events() != 0
+			|| tracer.number_of_threads() != 1 || tracer.get_capacity() != 100) {
+		return false;
+	}
+
+	const std::string fname("./test_data/tracer_out.json");
+	tracer.write_json(fname);
+	std::ifstream fin(fname);
+	std::stringstream buffer;
+	buffer << fin.rdbuf();
+	const std::string json = buffer.str();
+	if (json.find("{\"traceEvents\":[") != 0 || json.find("\"dropped_events\":0}}") == std::string::npos) {
+		std::cerr << "Wrong structure of the trace" << std::endl;
+		return false;
+	}
+	if (count_occurrences(json, "\"ph\":\"X\"") != 4
+			|| count_occurrences(json, "\"name\":\"phase \\\"quoted\\\"\"") != 3
+			|| count_occurrences(json, "\"args\":{\"time\":0.250}") != 1
+			|| count_occurrences(json, "\"name\":\"thread_name\"") != 1) {
+		std::cerr << "Wrong events in the trace" << std::endl;
+		return false;
+	}
+	// Inner events are stored first, the outer contains them
+	const size_t i_step = json.find("\"name\":\"step\"");
+	if (i_step == std::string::npos || i_step < json.rfind("phase")) {
+		return false;
+	}
+
+	tracer.clear();
+	return tracer.number_of_events() == 0 && tracer.number_of_dropped_events() == 0;
+}
+
+/// Oldest events are replaced when full
+bool ring_buffer_test()
+{
+	const std::vector<const char*> names = {"e0", "e1", "e2", "e3", "e4", "e5",
+												"e6", "e7", "e8", "e9", "e10", "e11"};
+	const int capacity = 5;
+	Tracer tracer(capacity);
+	for (size_t i = 0; i < names.size(); ++i) {
+		tracer.add_event(names.at(i), "test", static_cast<double>(i), 0.5);
+	}
+	if (tracer.number_of_events() != capacity
+			|| tracer.number_of_dropped_events() != names.size() - capacity) {
+		return false;
+	}
+	std::ostringstream out;
+	tracer.write_json(out);
+	const std::string json = out.str();
+	// Only the newest, in order
+	size_t previous = 0;
+	for (size_t i = 0; i < names.size(); ++i) {
+		const size_t pos = json.find("\"name\":\"" + std::string(names.at(i)) + "\"");
+		if (i < names.size() - capacity) {
+			if (pos != std::string::npos) {
+				std::cerr << "Event " << names.at(i) << " should be dropped" << std::endl;
+				return false;
+			}
+		} else if (pos == std::string::npos || pos < previous) {
+			std::cerr << "Missing or out of order event " << names.at(i) << std::endl;
+			return false;
+		} else {
+			previous = pos;
+		}
+	}
+	return json.find("\"dropped_events\":7}}") != std::string::npos;
+}
+
+/// Every thread has its own track
+bool threads_test()
+{
+	const int n_threads = 3, n_events = 200;
+	Tracer tracer(n_threads*n_events);
+	std::vector<std::thread> threads;
+	for (int it = 0; it < n_threads; ++it) {
+		threads.emplace_back([&tracer](){
+			for (int i = 0; i < n_events; ++i) {
+				Tracer::Scope scope(&tracer, "work", "test", "i", i);
+			}
+		});
+	}
+	for (auto& thr : threads) {
+		thr.join();
+	}
+	if (tracer.number_of_events() != n_threads*n_events || tracer.number_of_threads() != n_threads) {
+		return false;
+	}
+	std::ostringstream out;
+	tracer.write_json(out);
+	const std::string json = out.str();
+	for (int it = 0; it < n_threads; ++it) {
+		if (count_occurrences(json, "\"tid\":" + std::to_string(it) + ",\"args\":{\"i\"") != n_events) {
+			std::cerr << "Wrong number of events of thread " << it << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Writes in the background thread are on a separate track
+bool recorder_events_test()
+{
+	std::shared_ptr<Tracer> tracer = std::make_shared<Tracer>(100);
+	{
+		Recorder recorder("./test_data/recorder_out.csv", Recorder::csv, 16);
+		recorder.add_metric("infected");
+		recorder.set_tracer(tracer);
+		for (int i = 0; i < 100; ++i) {
+			recorder.set(0, i);
+			recorder.record(0.25*i);
+		}
+		recorder.close();
+	}
+	std::ostringstream out;
+	tracer->write_json(out);
+	const std::string json = out.str();
+	// 6 full buffers and the rest, one flush when closing
+	if (count_occurrences(json, "\"name\":\"Recorder::write_rows\"") != 7
+			|| count_occurrences(json, "\"name\":\"Recorder::flush\"") != 1
+			|| count_occurrences(json, "\"args\":{\"rows\":16.000}") != 6) {
+		std::cerr << "Wrong output events in the trace" << std::endl;
+		return false;
+	}
+	return tracer->number_of_threads() == 2;
+}
+
+/// Wrong use of the tracer
+bool exceptions_test()
+{
+	bool verbose = false;
+	const std::runtime_error rt_err("Runtime error");
+	const std::invalid_argument inv_arg("Invalid argument");
+
+	auto no_capacity = [](){ Tracer tracer(0); };
+	if (!exception_test(verbose, &inv_arg, no_capacity)) {
+		std::cerr << "Tracer without capacity should throw" << std::endl;
+		return false;
+	}
+	auto missing_dir = [](){ Tracer tracer(10); tracer.write_json("./no_such_dir/trace.json"); };
+	if (!exception_test(verbose, &rt_err, missing_dir)) {
+		std::cerr << "Missing output directory should throw" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/// Number of non-overlapping occurrences of what in text
+int count_occurrences(const std::string& text, const std::string& what)
+{
+	int n = 0;
+	for (size_t pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + what.size())) {
+		++n;
+	}
+	return n;
+}
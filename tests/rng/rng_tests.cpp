@@ -15,6 +15,11 @@ bool gamma_test(double, double, double);
 bool lognormal_test(double, double, double);
 bool weibull_test(double, double, double);
 bool random_shuffle_test();
+bool partial_shuffle_test();
+bool floyd_sample_test();
+bool reservoir_sample_test();
+bool stream_rng_test();
+bool random_order_test();
 
 int main()
 {
@@ -28,6 +33,11 @@ int main()
 	test_pass(lognormal_test(logn_meanx, logn_stx, logn_mean), "Lognormal distribution");
 	test_pass(weibull_test(wb_shape, wb_scale, wb_mean), "Weibull distribution");
 	test_pass(random_shuffle_test(), "Random shuffling");
+	test_pass(partial_shuffle_test(), "Partial Fisher-Yates shuffle");
+	test_pass(floyd_sample_test(), "Floyd's sampling without replacement");
+	test_pass(reservoir_sample_test(), "Reservoir sampling");
+	test_pass(stream_rng_test(), "Counter-based random streams");
+	test_pass(random_order_test(), "Visiting indices in random order");
 }
 
 /// Test if the uniform distribution generation is correct
@@ -165,3 +175,212 @@ bool random_shuffle_test()
 	rng.vector_shuffle(v2s);
 	return !(v2s == v_orig);
 }
+
+/** 
+ * \brief Partial shuffle selects distinct elements uniformly
+ * \details Checks that the vector remains a permutation and that
+ *		each element lands in the selected part with probability k/n
+ */
+bool partial_shuffle_test()
+{
+	RNG rng;
+	const int n = 20, k = 5, n_rep = 100000;
+	std::vector<int> counts(n, 0);
+	std::vector<int> v(n);
+	for (int i = 0; i < n_rep; ++i) {
+		std::iota(v.begin(), v.end(), 0);
+		rng.partial_shuffle(v, k);
+		for (int j = 0; j < k; ++j) {
+			++counts.at(v.at(j));
+		}
+	}
+	// Still a permutation
+	std::vector<int> sorted_v(v);
+	std::sort(sorted_v.begin(), sorted_v.end());
+	for (int i = 0; i < n; ++i) {
+		if (sorted_v.at(i) != i) {
+			return false;
+		}
+	}
+	// Frequencies
+	const double exp_freq = static_cast<double>(k)/n;
+	for (const auto& c : counts) {
+		if (!float_equality<double>(exp_freq, static_cast<double>(c)/n_rep, 0.01)) {
+			std::cout << exp_freq << " " << static_cast<double>(c)/n_rep << std::endl;
+			return false;
+		}
+	}
+	// k larger than the vector selects everything
+	std::vector<int> small = {1, 2, 3};
+	rng.partial_shuffle(small, 10);
+	std::sort(small.begin(), small.end());
+	return small == std::vector<int>({1, 2, 3});
+}
+
+/// Floyd's algorithm returns distinct, uniformly distributed values in range
+bool floyd_sample_test()
+{
+	RNG rng;
+	const int n = 20, k = 5, n_rep = 100000;
+	std::vector<int> counts(n, 0);
+	for (int i = 0; i < n_rep; ++i) {
+		std::vector<int> sample = rng.sample_without_replacement(n, k);
+		if (sample.size() != k) {
+			return false;
+		}
+		std::sort(sample.begin(), sample.end());
+		if (std::adjacent_find(sample.begin(), sample.end()) != sample.end()) {
+			std::cout << "Repeated values in the sample" << std::endl;
+			return false;
+		}
+		for (const auto& s : sample) {
+			if (s < 0 || s >= n) {
+				return false;
+			}
+			++counts.at(s);
+		}
+	}
+	const double exp_freq = static_cast<double>(k)/n;
+	for (const auto& c : counts) {
+		if (!float_equality<double>(exp_freq, static_cast<double>(c)/n_rep, 0.01)) {
+			std::cout << exp_freq << " " << static_cast<double>(c)/n_rep << std::endl;
+			return false;
+		}
+	}
+	// Edge cases
+	if (!rng.sample_without_replacement(10, 0).empty()) {
+		return false;
+	}
+	std::vector<int> all = rng.sample_without_replacement(4, 4);
+	std::sort(all.begin(), all.end());
+	return all == std::vector<int>({0, 1, 2, 3});
+}
+
+/// Reservoir sampling selects only qualifying elements, uniformly 
+bool reservoir_sample_test()
+{
+	RNG rng;
+	const int n = 20, n_rep = 100000;
+	std::vector<int> v(n);
+	std::iota(v.begin(), v.end(), 0);
+	auto is_even = [](const int x){ return x % 2 == 0; };
+	
+	// Single element
+	std::vector<int> counts(n, 0);
+	for (int i = 0; i < n_rep; ++i) {
+		auto sel = rng.reservoir_sample(v.begin(), v.end(), 1, is_even);
+		if (sel.size() != 1 || !is_even(*sel.front())) {
+			return false;
+		}
+		++counts.at(*sel.front());
+	}
+	const double exp_freq = 1.0/(n/2);
+	for (int i = 0; i < n; i += 2) {
+		if (!float_equality<double>(exp_freq, static_cast<double>(counts.at(i))/n_rep, 0.01)) {
+			std::cout << exp_freq << " " << static_cast<double>(counts.at(i))/n_rep << std::endl;
+			return false;
+		}
+	}
+	
+	// Several, distinct
+	auto sel = rng.reservoir_sample(v.begin(), v.end(), 4, is_even);
+	std::vector<int> values;
+	for (const auto& it : sel) {
+		if (!is_even(*it)) {
+			return false;
+		}
+		values.push_back(*it);
+	}
+	std::sort(values.begin(), values.end());
+	if (values.size() != 4 || std::adjacent_find(values.begin(), values.end()) != values.end()) {
+		return false;
+	}
+
+	// Not enough or no qualifying elements
+	if (rng.reservoir_sample(v.begin(), v.end(), 15, is_even).size() != n/2) {
+		return false;
+	}
+	auto none = rng.reservoir_sample(v.begin(), v.end(), 1, [](const int x){ return x < 0; });
+	return none.empty();
+}
+
+/// Streams are reproducible, distinct, and uniform
+bool stream_rng_test()
+{
+	const unsigned long long key = 2022;
+	StreamRNG first(key, 1), same(key, 1), other(key, 2), other_key(key + 1, 1);
+	int n_same_other = 0, n_same_key = 0;
+	double sum = 0.0;
+	const int n = 100000;
+	for (int i = 0; i < n; ++i) {
+		const double x = first.get_uniform();
+		if (x != same.get_uniform() || x < 0.0 || x >= 1.0) {
+			return false;
+		}
+		n_same_other += (x == other.get_uniform());
+		n_same_key += (x == other_key.get_uniform());
+		sum += x;
+	}
+	if (n_same_other > 0 || n_same_key > 0 || first.get_draws() != n) {
+		return false;
+	}
+	if (!float_equality<double>(0.5, sum/n, 0.01)) {
+		std::cout << 0.5 << " " << sum/n << std::endl;
+		return false;
+	}
+
+	// Integers in the inclusive range, all values drawn
+	StreamRNG ints(key, 3);
+	std::vector<int> counts(11, 0);
+	for (int i = 0; i < n; ++i) {
+		const int k = ints.get_int(-5, 5);
+		if (k < -5 || k > 5) {
+			return false;
+		}
+		++counts.at(k + 5);
+	}
+	for (const int count : counts) {
+		if (!float_equality<double>(n/11.0, count, 0.05)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/// Full visits are permutations, visits stop early, first index is uniform
+bool random_order_test()
+{
+	RNG rng;
+	const size_t n = 50;
+	std::vector<size_t> visited;
+	rng.visit_in_random_order(n, [&visited](const size_t i) { visited.push_back(i); return true; });
+	std::vector<size_t> sorted(visited);
+	std::sort(sorted.begin(), sorted.end());
+	for (size_t i = 0; i < n; ++i) {
+		if (sorted.at(i) != i) {
+			return false;
+		}
+	}
+
+	// Stops after the first false
+	int n_calls = 0;
+	rng.visit_in_random_order(n, [&n_calls](const size_t i) { return ++n_calls < 5; });
+	if (n_calls != 5) {
+		return false;
+	}
+	rng.visit_in_random_order(0, [](const size_t i) { return false; });
+
+	// Frequency of each index in the first position
+	const int n_rep = 100000;
+	const size_t m = 10;
+	std::vector<int> counts(m, 0);
+	for (int i = 0; i < n_rep; ++i) {
+		rng.visit_in_random_order(m, [&counts](const size_t j) { ++counts.at(j); return false; });
+	}
+	for (const int count : counts) {
+		if (!float_equality<double>(static_cast<double>(n_rep)/m, count, 0.05)) {
+			return false;
+		}
+	}
+	return true;
+}
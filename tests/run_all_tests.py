@@ -80,6 +80,13 @@ os.chdir('testing_class/')
 subprocess.call([py_version + ' run_testing_class_tests.py'], shell=True)
 os.chdir('../')
 
+# Event timeline class
+print('\n'*2)
+ut.msg('- '*nSim + 'EVENT TIMELINE CLASS TESTS' + ' -'*nSim, REVERSE+RED)
+os.chdir('event_timeline/')
+subprocess.call([py_version + ' run_event_timeline_tests.py'], shell=True)
+os.chdir('../')
+
 # Flu class
 print('\n'*2)
 ut.msg('- '*nSim + 'FLU CLASS TESTS' + ' -'*nSim, REVERSE+RED)
@@ -126,4 +133,18 @@ os.chdir('abm/')
 subprocess.call([py_version + ' run_abm_tests.py'], shell=True)
 os.chdir('../')
 
+# ABM steady-state steps on a small town
+print('\n'*2)
+ut.msg('- '*nSim + 'ABM SMALL SIMULATION TESTS' + ' -'*nSim, REVERSE+RED)
+os.chdir('abm/small_sim/')
+subprocess.call([py_version + ' run_abm_tests.py'], shell=True)
+os.chdir('../../')
+
+# Distributed runs - need MPI
+print('\n'*2)
+ut.msg('- '*nSim + 'DISTRIBUTED RUNS TESTS (MPI)' + ' -'*nSim, REVERSE+RED)
+os.chdir('distributed/')
+subprocess.call([py_version + ' run_distributed_tests.py'], shell=True)
+os.chdir('../')
+
 print('\n')
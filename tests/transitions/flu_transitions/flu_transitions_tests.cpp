@@ -52,7 +52,7 @@ bool test_susceptible_transitions()
 
 	Infection& infection = abm.get_infection_object();
     const std::map<std::string, double> infection_parameters = abm.get_infection_parameters(); 
-    std::vector<int> state_changes(4,0);
+    SusceptibleChanges state_changes = {};
 
 	FluTransitions flu_tr;
 	Flu& flu = abm.get_flu_object();
@@ -22,7 +22,7 @@ bool check_isolation(const Agent&, const std::vector<School>&,
 bool check_testing_transitions(const Agent& agent, const std::vector<Household>& households, 
 				const std::vector<School>& schools, const std::vector<Hospital>& hospitals,
 				const std::vector<Transit>&, const std::vector<Transit>&,
-				std::vector<int>& state_changes, int& n_tested_exposed, int& n_tested_sy, int& n_waiting_for_res, 
+				InfectedChanges& state_changes, int& n_tested_exposed, int& n_tested_sy, int& n_waiting_for_res, 
 				int& n_positive, int& n_false_neg, int& n_hsp, int& n_hsp_icu, int& n_ih, double time, double dt);
 bool test_leisure(const Agent&, const std::vector<Household>&, 
 				const std::vector<RetirementHome>&, const double);
@@ -37,7 +37,7 @@ bool check_hospitalized_isolation(const Agent& agent, const std::vector<Househol
 bool check_symptomatic_agent_removal(const Agent& agent, const std::vector<Household>& households,
 				const std::vector<School>& schools, const std::vector<Hospital>& hospitals,
 				const std::vector<Transit>&, const std::vector<Transit>&,
-				std::vector<int>& state_changes, int& n_rh, int& n_rd, double time, double dt);
+				InfectedChanges& state_changes, int& n_rh, int& n_rd, double time, double dt);
 
 int main()
 {
@@ -235,7 +235,7 @@ bool test_exposed_transitions()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 
 	// To initialize Flu agents
 	testing.check_switch_time(0);
@@ -399,7 +399,7 @@ bool test_symptomatic_transitions()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 
 	// To initialize Flu agents
 	testing.check_switch_time(0);
@@ -508,7 +508,7 @@ bool test_exposed_transitions_seeded()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 	int n_strains = 3;
 
 	// To initialize Flu agents
@@ -674,7 +674,7 @@ bool test_symptomatic_transitions_seeded()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 	int n_strains = 3;
 
 	// To initialize Flu agents
@@ -838,7 +838,7 @@ bool check_fractions(int num1, int num2, double fr_expected, std::string msg, bo
 bool check_testing_transitions(const Agent& agent, const std::vector<Household>& households,
 				const std::vector<School>& schools, const std::vector<Hospital>& hospitals,
 				const std::vector<Transit>& carpools, const std::vector<Transit>& public_transit,
-				std::vector<int>& state_changes, int& n_tested_exposed, int& n_tested_sy, int& n_waiting_for_res, 
+				InfectedChanges& state_changes, int& n_tested_exposed, int& n_tested_sy, int& n_waiting_for_res, 
 				int& n_positive, int& n_false_neg, int& n_hsp, int& n_hsp_icu, int& n_ih, double time, double dt)
 {
 	// Testing flags
@@ -1140,7 +1140,7 @@ bool test_leisure(const Agent& agent, const std::vector<Household>& households,
 bool check_symptomatic_agent_removal(const Agent& agent, const std::vector<Household>& households,
 				const std::vector<School>& schools, const std::vector<Hospital>& hospitals,
 				const std::vector<Transit>& carpools, const std::vector<Transit>& public_transit,
-				std::vector<int>& state_changes, int& n_rh, int& n_rd, double time, double dt)
+				InfectedChanges& state_changes, int& n_rh, int& n_rd, double time, double dt)
 {
 	const int aID = agent.get_ID();
 	if (state_changes.at(1)){
@@ -21,13 +21,13 @@ bool only_hospitals(const Agent&, const std::vector<Hospital>&, const std::vecto
 				const std::vector<School>&, const std::vector<RetirementHome>& retirement_homes,
 				const std::vector<Workplace>&);
 bool check_testing_transitions(const Agent& agent, const std::vector<Household>& households, 
-				const std::vector<Hospital>& hospitals,	std::vector<int>& state_changes, 
+				const std::vector<Hospital>& hospitals,	InfectedChanges& state_changes, 
 				int& n_tested_exposed, int& n_tested_sy, int& n_waiting_for_res, 
 				int& n_positive, int& n_false_neg, int& n_hsp, int& n_hsp_icu, int& n_ih, double time, double dt);
 bool check_treatment_setup(const Agent& agent, const std::vector<Household>& households,
 			const std::vector<Hospital>& hospitals, int& n_hsp, int& n_hsp_icu, int& n_ih, double time, double dt);
 bool check_symptomatic_agent_removal(const Agent& agent, const std::vector<Household>& households,
-				const std::vector<Hospital>& hospitals, std::vector<int>& state_changes, 
+				const std::vector<Hospital>& hospitals, InfectedChanges& state_changes, 
 				int& n_rh, int& n_rd, double time, double dt);
 
 int main()
@@ -215,7 +215,7 @@ bool test_exposed_transitions()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 
 	// To initialize Flu agents
 	testing.check_switch_time(0);
@@ -362,7 +362,7 @@ bool test_symptomatic_transitions()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 
 	// To initialize Flu agents
 	testing.check_switch_time(0);
@@ -459,7 +459,7 @@ bool test_exposed_transitions_seeded()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 
 	// To initialize Flu agents
 	testing.check_switch_time(0);
@@ -608,7 +608,7 @@ bool test_symptomatic_transitions_seeded()
 	int n_sy_recovering = 0, n_sy_dying = 0;
 	int n_tr_hsp = 0, n_hsp_icu = 0, n_ih = 0;
 	// Recovered, dead (not applicable), tested, tested positive, tested false negative
-    std::vector<int> state_changes(5,0);
+    InfectedChanges state_changes = {};
 
 	// To initialize Flu agents
 	testing.check_switch_time(0);
@@ -736,7 +736,7 @@ bool only_hospitals(const Agent& agent, const std::vector<Hospital>& hospitals,
 
 /// Tests for exposed agent that is undergoing testing or gets the results
 bool check_testing_transitions(const Agent& agent, const std::vector<Household>& households,
-				const std::vector<Hospital>& hospitals, std::vector<int>& state_changes, 
+				const std::vector<Hospital>& hospitals, InfectedChanges& state_changes, 
 				int& n_tested_exposed, int& n_tested_sy, int& n_waiting_for_res, 
 				int& n_positive, int& n_false_neg, int& n_hsp, int& n_hsp_icu, int& n_ih, double time, double dt)
 {
@@ -960,7 +960,7 @@ bool check_treatment_setup(const Agent& agent, const std::vector<Household>& hou
 
 /// Test for properties related to removal of a symptomatic agent
 bool check_symptomatic_agent_removal(const Agent& agent, const std::vector<Household>& households,
-				const std::vector<Hospital>& hospitals, std::vector<int>& state_changes, 
+				const std::vector<Hospital>& hospitals, InfectedChanges& state_changes, 
 				int& n_rh, int& n_rd, double time, double dt)
 {
 	const int aID = agent.get_ID();
@@ -20,6 +20,8 @@ bool check_random_vaccinations_functionality();
 bool check_group_vaccinations_functionality();
 bool check_random_vaccinations_neg_time_offset();
 bool check_random_revaccinations();
+bool check_eligibility_index();
+bool check_benefits_after_parameter_change();
 
 // Supporting functions
 bool check_agent_vaccination_attributes(Agent& agent, const double time, 
@@ -29,6 +31,8 @@ bool check_agent_vaccination_attributes(Agent& agent, const double time,
 
 int main()
 {
+	test_pass(check_eligibility_index(), "Index of agents eligible for vaccination");
+	test_pass(check_benefits_after_parameter_change(), "Vaccine benefits after a parameter change");
 	test_pass(check_random_vaccinations_functionality(), "Random vaccination functionality");
 	test_pass(check_random_vaccinations_neg_time_offset(), "Random vaccination functionality - negative time offset");
 	test_pass(check_random_revaccinations(), "Random re-vaccination functionality");
@@ -45,7 +49,7 @@ bool check_random_vaccinations_functionality()
 	const std::string fname_3("test_data/vaccination_parameters_strain_3.txt");
 	// Initial number to vaccinate
 	int n_vac_0 = 10000;
-	std::vector<int> temp_vac;
+	std::array<int, 2> temp_vac = {};
 	// Vaccinate this many each step
 	int n_vac = 10;
 	// Actual number of vaccinated
@@ -770,3 +774,140 @@ bool check_random_revaccinations()
 	return true;
 }
 
+
+/// Counts from the index match checks of all agents as the agents change
+bool check_eligibility_index()
+{
+	const std::string data_dir("test_data/strain_2/");
+	const std::string fname("test_data/vaccination_parameters_strain_2.txt");
+	const std::vector<std::string> groups = {"hospital employees", "school employees",
+				"retirement home employees", "retirement home residents"};
+	double time = 0.0, dt = 0.25;
+	Infection infection(dt);
+
+	// Agents in all groups and random states that affect eligibility
+	const int n_agents = 20000, tot_strains = 3;
+	std::vector<Agent> agents;
+	std::vector<setter> states = {&Agent::set_removed_dead, &Agent::set_tested_covid_positive,
+				&Agent::set_former_suspected, &Agent::set_symptomatic, &Agent::set_symptomatic_non_covid,
+				&Agent::set_home_isolated, &Agent::set_contact_traced, &Agent::set_needs_next_vaccination}; 
+	auto random_states = [&](Agent& agent) {
+		for (const auto& state : states) {
+			(agent.*state)(infection.get_uniform() < 0.05);
+		}
+	};
+	for (int i = 0; i < n_agents; ++i) {
+		const int group = infection.get_int(0, 5);
+		agents.emplace_back(false, group < 4, infection.get_int(0, 100), 0.0, 0.0, 1, false, 0,
+				group == 3, group == 2, group == 1, 1, group == 0, 1, false, "car", 0.0, 0, 0, false,
+				std::vector<std::map<std::string, double>>(), tot_strains);
+		agents.back().set_ID(i + 1);
+		random_states(agents.back());
+	}
+
+	// The one with the index and the one that checks all agents
+	Vaccinations indexed(fname, data_dir), checked(fname, data_dir);
+	indexed.track_eligibility(agents);
+	if (!indexed.tracks_eligibility() || checked.tracks_eligibility()) {
+		std::cerr << "Wrong eligibility tracking state" << std::endl;
+		return false;
+	}
+	auto same_counts = [&]() {
+		if (indexed.max_eligible_random(agents) != checked.max_eligible_random(agents)) {
+			std::cerr << "Wrong number eligible " << indexed.max_eligible_random(agents) 
+					  << " " << checked.max_eligible_random(agents) << std::endl;
+			return false;
+		}
+		for (const auto& group : groups) {
+			if (indexed.max_eligible_group(agents, group) != checked.max_eligible_group(agents, group)) {
+				std::cerr << "Wrong number eligible in group " << group << std::endl;
+				return false;
+			}
+		}
+		return true;
+	};
+	if (!same_counts() || checked.max_eligible_random(agents) == 0) {
+		return false;
+	}
+
+	// Changes of states, random vaccination, and group vaccination
+	for (int step = 0; step < 20; ++step) {
+		for (int i = 0; i < n_agents/10; ++i) {
+			Agent& agent = agents.at(infection.get_int(0, n_agents-1));
+			random_states(agent);
+			indexed.update_eligibility(agent);
+		}
+		if (!same_counts()) {
+			return false;
+		}
+		// Vaccinating all gives the same numbers of vaccinated and boosted
+		if (step%5 == 0) {
+			std::vector<Agent> agents_indexed(agents), agents_checked(agents);
+			Vaccinations indexed_all(indexed), checked_all(checked);
+			Infection infection_indexed(infection), infection_checked(infection);
+			if (indexed_all.vaccinate_random(agents_indexed, 2*n_agents, 0, infection_indexed, time)
+					!= checked_all.vaccinate_random(agents_checked, 2*n_agents, 0, infection_checked, time)) {
+				std::cerr << "Wrong number of vaccinated or boosted" << std::endl;
+				return false;
+			}
+			if (indexed_all.max_eligible_random(agents_indexed) 
+					!= checked_all.max_eligible_random(agents_checked)) {
+				std::cerr << "Wrong number eligible after vaccinating all" << std::endl;
+				return false;
+			}
+		}
+		indexed.vaccinate_random(agents, 50, 0, infection, time);
+		indexed.vaccinate_group(agents, groups.at(step%groups.size()), 20, infection, time);
+		if (!same_counts()) {
+			return false;
+		}
+		time += dt;
+	}
+
+	// New parameters need a new index
+	indexed.set_parameter("Minimum vaccination age", 30.0);
+	if (indexed.tracks_eligibility()) {
+		std::cerr << "Index should not be used after parameter change" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool check_benefits_after_parameter_change()
+{
+	const std::string data_dir("test_data/strain_2/");
+	const std::string fname("test_data/vaccination_parameters_strain_2.txt");
+	const double dt = 0.25, time = 10.0, tol = 1e-5;
+	const int n_agents = 1000, tot_strains = 3, other_strain = 1;
+	Infection infection(dt);
+	std::vector<Agent> agents;
+	for (int i = 0; i < n_agents; ++i) {
+		agents.emplace_back(false, true, 40, 0.0, 0.0, 1, false, 0, false, false, false, 
+				1, false, 1, false, "car", 0.0, 0, 0, false,
+				std::vector<std::map<std::string, double>>(), tot_strains);
+		agents.back().set_ID(i + 1);
+	}
+
+	// Both general types and a changed reduction for the other strain
+	Vaccinations vaccinations(fname, data_dir);
+	vaccinations.set_parameter("Fraction taking one dose vaccine", 0.5);
+	vaccinations.set_parameter("Effectiveness reduction for strain 1", 0.25);
+	vaccinations.vaccinate_random(agents, n_agents, 0, infection, time);
+
+	// Benefits for the other strain follow the recomputed properties
+	nested_maps& vac_data = vaccinations.get_vaccination_data();
+	for (auto& agent : agents) {
+		const std::string& tag = agent.get_vaccine_subtype(2);
+		const std::vector<std::vector<double>>& points = 
+				vac_data.at(tag + " other strain " + std::to_string(other_strain)).at("effectiveness");
+		for (const double t : {time, time + 20.0, time + 200.0}) {
+			const double expected = (agent.get_vaccine_type(2) == "one_dose") ? 
+				ThreePartFunction(points, time)(t) : FourPartFunction(points, time)(t);
+			if (!float_equality<double>(agent.vaccine_effectiveness(t, other_strain), expected, tol)) {
+				std::cerr << "Wrong effectiveness for the other strain of " << tag << std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
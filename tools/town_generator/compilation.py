@@ -0,0 +1,22 @@
+import subprocess, glob, os
+
+#
+# Input 
+#
+
+# Path to the main directory
+path = '../../src/'
+# Compiler options
+cx = 'g++'
+std = '-std=c++11'
+opt = '-O3'
+
+# Common source files
+src_files = path + 'io_operations/town_generator.cpp'
+
+# Name of the executable
+exe_name = 'generate_town'
+# Files needed only for this build
+spec_files = 'generate_town.cpp '
+compile_com = ' '.join([cx, std, opt, '-o', exe_name, spec_files, src_files])
+subprocess.call([compile_com], shell=True)
@@ -0,0 +1,54 @@
+#include <chrono>
+#include <sys/stat.h>
+#include "../../include/io_operations/town_generator.h"
+
+/***************************************************************
+ * Generates the place and agent files of a synthetic town 
+ * of a given size
+ *
+ * Usage: ./generate_town n_agents output_dir [seed] [input_files_template]
+ *
+ * Writes NR_*.txt files to output_dir, creating it if needed.
+ * With a template - a file with tagged input file names as 
+ * passed to ABM::simulation_setup - also writes 
+ * output_dir/input_files_all.txt that uses the generated 
+ * town and the parameter files of the template.
+ **************************************************************/
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3 || argc > 5) {
+		std::cerr << "Usage: " << argv[0] 
+				  << " <number of agents> <output directory> [seed] [input files template]" 
+				  << std::endl;
+		return 1;
+	}
+
+	TownSettings settings;
+	settings.n_agents = std::stoi(argv[1]);
+	if (argc > 3) {
+		settings.seed = static_cast<unsigned int>(std::stoul(argv[3]));
+	}
+	std::string path(argv[2]);
+	if (path.back() != '/') {
+		path += '/';
+	}
+	mkdir(path.c_str(), 0755);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	TownGenerator town(settings);
+	auto generated = std::chrono::high_resolution_clock::now();
+	town.write_files(path);
+	if (argc > 4) {
+		TownGenerator::write_input_files(argv[4], path, path + "input_files_all.txt");
+	}
+	auto stop = std::chrono::high_resolution_clock::now();
+
+	std::cout << "Generated a town with " << town.number_of_agents() << " agents, "
+			  << town.number_of_places(TownImage::households) << " households, "
+			  << town.number_of_places(TownImage::schools) << " schools, and "
+			  << town.number_of_places(TownImage::workplaces) << " workplaces in "
+			  << std::chrono::duration<double>(generated - start).count() << " s, written in "
+			  << std::chrono::duration<double>(stop - generated).count() << " s" << std::endl;
+	return 0;
+}
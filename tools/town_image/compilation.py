@@ -0,0 +1,26 @@
+import subprocess, glob, os
+
+#
+# Input 
+#
+
+# Path to the main directory
+path = '../../src/'
+# Compiler options
+cx = 'g++'
+std = '-std=c++11'
+opt = '-O3'
+
+# Common source files
+src_files = path + 'utils.cpp'
+src_files += ' ' + path + 'io_operations/FileHandler.cpp'
+src_files += ' ' + path + 'io_operations/load_parameters.cpp'
+src_files += ' ' + path + 'io_operations/mapped_reader.cpp'
+src_files += ' ' + path + 'io_operations/town_image.cpp'
+
+# Name of the executable
+exe_name = 'make_town_image'
+# Files needed only for this build
+spec_files = 'make_town_image.cpp '
+compile_com = ' '.join([cx, std, opt, '-o', exe_name, spec_files, src_files])
+subprocess.call([compile_com], shell=True)
@@ -0,0 +1,35 @@
+#include <chrono>
+#include "../../include/io_operations/town_image.h"
+
+/***************************************************************
+ * Converts the place and agent files of a town into a single 
+ * binary town image
+ *
+ * Usage: ./make_town_image input_files_all.txt town_image.bin
+ *
+ * The first argument is the same file with tagged input file
+ * names that is passed to ABM::simulation_setup. To run from the
+ * image, add to that file an entry
+ * // Town image
+ * path/to/town_image.bin
+ **************************************************************/
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3) {
+		std::cerr << "Usage: " << argv[0] << " <input files> <town image>" << std::endl;
+		return 1;
+	}
+	
+	auto start = std::chrono::high_resolution_clock::now();
+	TownImage::create(argv[1], argv[2]);
+	auto stop = std::chrono::high_resolution_clock::now();
+	
+	// Check that it can be read back
+	TownImage image(argv[2]);
+	std::cout << "Created town image " << argv[2] << " with " 
+			  << image.number_of_agents() << " agents and "
+			  << image.number_of_places(TownImage::households) << " households in " 
+			  << std::chrono::duration<double>(stop - start).count() << " s" << std::endl;
+	return 0;
+}